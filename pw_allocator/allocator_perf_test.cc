@@ -0,0 +1,515 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/benchmark.h"
+#include "pw_allocator/best_fit_block_allocator.h"
+#include "pw_allocator/bucket_block_allocator.h"
+#include "pw_allocator/buddy_allocator.h"
+#include "pw_allocator/bump_allocator.h"
+#include "pw_allocator/dual_first_fit_block_allocator.h"
+#include "pw_allocator/first_fit_block_allocator.h"
+#include "pw_allocator/freelist_heap.h"
+#include "pw_allocator/tlsf_block_allocator.h"
+#include "pw_allocator/worst_fit_block_allocator.h"
+#include "pw_chrono/system_clock.h"
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_perf_test/state.h"
+#include "pw_random/xor_shift.h"
+
+namespace pw::allocator {
+namespace {
+
+// Replays allocation traces and randomly generated requests against each of
+// the allocators in this module. Each test logs the median and 99th percentile
+// latencies of individual requests, as well as how much of the allocator's
+// memory was lost to metadata and fragmentation.
+
+using test::AllocationRequest;
+using test::BenchmarkGeneric;
+using test::BenchmarkResults;
+using test::DeallocationRequest;
+using test::LatencyResults;
+using test::ReallocationRequest;
+using test::Request;
+
+constexpr size_t kCapacity = 0x4000;
+constexpr size_t kMaxAllocations = 64;
+constexpr size_t kMaxSamples = 1024;
+constexpr size_t kRequestsPerIteration = 100;
+constexpr uint64_t kSeed = 1;
+
+// Benchmarks for each allocator.
+
+template <typename BlockAllocatorType>
+using BlockAllocatorBenchmark =
+    test::BlockAllocatorBenchmark<BlockAllocatorType,
+                                  kCapacity,
+                                  kMaxAllocations,
+                                  kMaxSamples>;
+
+using Benchmark = test::Benchmark<kMaxAllocations, kMaxSamples>;
+
+using FirstFitBenchmark =
+    BlockAllocatorBenchmark<FirstFitBlockAllocator<uint16_t>>;
+using BestFitBenchmark =
+    BlockAllocatorBenchmark<BestFitBlockAllocator<uint16_t>>;
+using WorstFitBenchmark =
+    BlockAllocatorBenchmark<WorstFitBlockAllocator<uint16_t>>;
+using BucketBenchmark =
+    BlockAllocatorBenchmark<BucketBlockAllocator<uint16_t, 32, 5>>;
+using TlsfBenchmark = BlockAllocatorBenchmark<TlsfBlockAllocator<uint16_t>>;
+
+class DualFirstFitBenchmark
+    : public BlockAllocatorBenchmark<DualFirstFitBlockAllocator<uint16_t>> {
+ public:
+  DualFirstFitBenchmark() { allocator().set_threshold(128); }
+};
+
+class BuddyBenchmark : public Benchmark {
+ private:
+  static constexpr size_t kMinChunkSize = 16;
+  static constexpr size_t kNumBuckets = 11;
+
+  Allocator* Init() override {
+    allocator_.Init(buffer_);
+    return &allocator_;
+  }
+
+  // Each allocation uses a chunk large enough for the request and a byte to
+  // record the chunk size.
+  Result<size_t> GetAllocatedSize(void*, Layout layout) override {
+    return std::max(kMinChunkSize, cpp20::bit_ceil(layout.size() + 1));
+  }
+
+  alignas(kMinChunkSize) std::array<std::byte, kCapacity> buffer_{};
+  BuddyAllocator<kMinChunkSize, kNumBuckets> allocator_;
+};
+
+class BumpBenchmark : public Benchmark {
+ private:
+  Allocator* Init() override {
+    allocator_.Init(buffer_);
+    return &allocator_;
+  }
+
+  // Bump allocators never reuse memory, so rewind between iterations.
+  void DoReset() override { allocator_.Init(buffer_); }
+
+  std::array<std::byte, kCapacity> buffer_{};
+  BumpAllocator allocator_;
+};
+
+/// Adapts the `malloc`-like interface of `FreeListHeap` to `Allocator`.
+class FreeListHeapAllocator : public Allocator {
+ public:
+  using BlockType = FreeListHeap::BlockType;
+
+  explicit FreeListHeapAllocator(ByteSpan region) : heap_(region) {}
+
+ private:
+  void* DoAllocate(Layout layout) override {
+    if (layout.alignment() > BlockType::kAlignment) {
+      return nullptr;
+    }
+    return heap_.Allocate(layout.size());
+  }
+
+  void DoDeallocate(void* ptr) override { heap_.Free(ptr); }
+
+  void* DoReallocate(void* ptr, Layout new_layout) override {
+    if (new_layout.alignment() > BlockType::kAlignment) {
+      return nullptr;
+    }
+    return heap_.Realloc(ptr, new_layout.size());
+  }
+
+  FreeListHeapBuffer<> heap_;
+};
+
+class FreeListHeapBenchmark : public Benchmark {
+ private:
+  using BlockType = FreeListHeapAllocator::BlockType;
+
+  Allocator* Init() override { return &allocator_.emplace(buffer_); }
+
+  std::optional<Fragmentation> MeasureFragmentation() override {
+    Fragmentation fragmentation;
+    auto* first = BlockType::FromUsableSpace(buffer_.data() +
+                                             BlockType::kBlockOverhead);
+    for (auto* block : typename BlockType::Range(first)) {
+      if (!block->Used()) {
+        fragmentation.AddFragment(block->InnerSize() / BlockType::kAlignment);
+      }
+    }
+    return fragmentation;
+  }
+
+  Result<size_t> GetAllocatedSize(void* ptr, Layout) override {
+    return BlockType::FromUsableSpace(ptr)->OuterSize();
+  }
+
+  alignas(BlockType::kAlignment) std::array<std::byte, kCapacity> buffer_{};
+  std::optional<FreeListHeapAllocator> allocator_;
+};
+
+// Recorded traces.
+//
+// These traces model common embedded workloads. Deallocation and reallocation
+// requests refer to outstanding allocations by age, i.e. index 0 is the oldest
+// allocation that has not yet been freed.
+
+constexpr Request Alloc(size_t size) {
+  return AllocationRequest{.size = size, .alignment = alignof(uint32_t)};
+}
+
+constexpr Request Free(size_t index) {
+  return DeallocationRequest{.index = index};
+}
+
+constexpr Request Realloc(size_t index, size_t new_size) {
+  return ReallocationRequest{.index = index, .new_size = new_size};
+}
+
+/// An RPC server handling a burst of unary calls, followed by a streaming
+/// call whose response grows as results are appended.
+constexpr std::array kRpcBurst = {
+    // Requests arrive back to back, and are each decoded into a buffer.
+    Alloc(72),
+    Alloc(136),
+    Alloc(48),
+    Alloc(264),
+    Alloc(96),
+    // Each call is handled in turn: its response is encoded, and then its
+    // request is released.
+    Alloc(512),
+    Free(0),
+    Alloc(64),
+    Free(0),
+    Alloc(1024),
+    Free(0),
+    Alloc(128),
+    Free(0),
+    Alloc(256),
+    Free(0),
+    // The transport sends responses as the channel allows, out of order.
+    Free(1),
+    Free(0),
+    Free(2),
+    // A streaming call starts while the remaining responses drain.
+    Alloc(96),
+    Alloc(128),
+    Realloc(3, 384),
+    Realloc(3, 768),
+    Free(0),
+    Free(0),
+    // The stream completes.
+    Free(1),
+    Free(0),
+};
+
+/// A log service that buffers entries of varying sizes, and periodically
+/// drains the oldest ones into a batch.
+constexpr std::array kLogBuffer = {
+    // The drain's state lives for the whole trace.
+    Alloc(160),
+    // Entries accumulate until the drain runs.
+    Alloc(24),
+    Alloc(36),
+    Alloc(20),
+    Alloc(52),
+    Alloc(28),
+    Alloc(44),
+    Alloc(16),
+    Alloc(92),
+    // The drain encodes the oldest entries into a batch, and releases them.
+    Alloc(256),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(4),
+    // More entries arrive, including a long, formatted message.
+    Alloc(32),
+    Alloc(20),
+    Alloc(148),
+    Alloc(24),
+    Alloc(256),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(4),
+    // The remaining entries are drained.
+    Alloc(28),
+    Alloc(40),
+    Alloc(256),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(1),
+    Free(0),
+};
+
+/// A Bluetooth host stack handling HCI events and ACL data packets, and
+/// reassembling an L2CAP SDU from fragments.
+constexpr std::array kBlePacketPool = {
+    // Events from the controller are handled and released promptly.
+    Alloc(68),
+    Free(0),
+    Alloc(14),
+    Free(0),
+    // A burst of ACL data packets arrives for two connections.
+    Alloc(255),
+    Alloc(255),
+    Alloc(255),
+    Alloc(27),
+    Alloc(255),
+    Alloc(255),
+    // An SDU is reassembled from the first connection's fragments.
+    Alloc(512),
+    Free(0),
+    Free(0),
+    Realloc(4, 1024),
+    Free(0),
+    // Outbound packets and a command are sent while credits are available.
+    Alloc(255),
+    Alloc(255),
+    Alloc(68),
+    Free(0),
+    Free(3),
+    Free(3),
+    Free(3),
+    // The SDU is delivered, and the remaining packets are handled.
+    Free(2),
+    Free(0),
+    Free(0),
+};
+
+// Synthetic distributions.
+
+/// Returns sizes of up to 512 bytes with equal probability.
+size_t UniformSize(random::RandomGenerator& prng) {
+  size_t size;
+  prng.GetInt(size, size_t(512));
+  return size + 1;
+}
+
+/// Returns sizes of 8 bytes to 1 KiB, where each power of two is equally
+/// likely, i.e. smaller sizes are more likely.
+size_t LogUniformSize(random::RandomGenerator& prng) {
+  size_t exponent;
+  prng.GetInt(exponent, size_t(7));
+  size_t base = size_t(8) << exponent;
+  size_t offset;
+  prng.GetInt(offset, base);
+  return base + offset;
+}
+
+/// Returns mostly small sizes, with occasional large buffers.
+size_t BimodalSize(random::RandomGenerator& prng) {
+  uint8_t selector;
+  prng.GetInt(selector);
+  size_t size;
+  if (selector < 230) {
+    prng.GetInt(size, size_t(56));
+    return size + 8;
+  }
+  prng.GetInt(size, size_t(1536));
+  return size + 512;
+}
+
+using SizeDistribution = size_t (*)(random::RandomGenerator&);
+
+/// Returns a random request, with allocation sizes from the given distribution.
+Request GenerateRequest(random::RandomGenerator& prng,
+                        SizeDistribution distribution) {
+  uint8_t request_type;
+  prng.GetInt(request_type, uint8_t(10));
+  size_t index;
+  prng.GetInt(index);
+  size_t lshift;
+  prng.GetInt(lshift, size_t(3));
+  if (request_type < 5) {
+    return AllocationRequest{
+        .size = distribution(prng),
+        .alignment = size_t(1) << lshift,
+    };
+  }
+  if (request_type < 9) {
+    return DeallocationRequest{.index = index};
+  }
+  return ReallocationRequest{.index = index, .new_size = distribution(prng)};
+}
+
+// Perf tests.
+
+/// Returns the time elapsed since the first call, in nanoseconds.
+///
+/// Requests are timed with the system clock, so the resolution of the results
+/// depends on its backend.
+int64_t Now() {
+  static const chrono::SystemClock::time_point kEpoch =
+      chrono::SystemClock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             chrono::SystemClock::now() - kEpoch)
+      .count();
+}
+
+template <typename BenchmarkType>
+BenchmarkType& GetBenchmark() {
+  static BenchmarkType benchmark;
+  benchmark.set_timer(Now);
+  return benchmark;
+}
+
+void LogLatency(const char* name,
+                const char* request_type,
+                const LatencyResults& results) {
+  if (results.count == 0) {
+    return;
+  }
+  PW_LOG_INFO("%s: %u %s requests: p50 is %u, p99 is %u, max is %u ns",
+              name,
+              static_cast<unsigned>(results.count),
+              request_type,
+              static_cast<unsigned>(results.p50),
+              static_cast<unsigned>(results.p99),
+              static_cast<unsigned>(results.max));
+}
+
+void LogResults(const char* name, BenchmarkGeneric& benchmark) {
+  BenchmarkResults results = benchmark.GetResults();
+  LogLatency(name, "allocate", results.allocate);
+  LogLatency(name, "deallocate", results.deallocate);
+  LogLatency(name, "reallocate", results.reallocate);
+  PW_LOG_INFO("%s: %u requests failed, peak requested bytes is %u",
+              name,
+              static_cast<unsigned>(results.num_failures),
+              static_cast<unsigned>(results.peak_requested_bytes));
+  if (results.peak_overhead_bytes.has_value()) {
+    PW_LOG_INFO("%s: peak overhead is %u bytes",
+                name,
+                static_cast<unsigned>(*results.peak_overhead_bytes));
+  }
+  if (results.peak_fragmentation.has_value()) {
+    PW_LOG_INFO("%s: peak fragmentation is %u/1000",
+                name,
+                static_cast<unsigned>(*results.peak_fragmentation));
+  }
+}
+
+/// Replays a trace in each iteration.
+template <typename BenchmarkType>
+void ReplayTrace(perf_test::State& state,
+                 const char* name,
+                 span<const Request> trace) {
+  auto& benchmark = GetBenchmark<BenchmarkType>();
+  benchmark.ClearResults();
+  while (state.KeepRunning()) {
+    benchmark.HandleRequests(trace);
+    benchmark.Reset();
+  }
+  LogResults(name, benchmark);
+}
+
+/// Handles a batch of random requests in each iteration.
+template <typename BenchmarkType>
+void GenerateRequests(perf_test::State& state,
+                      const char* name,
+                      SizeDistribution distribution) {
+  auto& benchmark = GetBenchmark<BenchmarkType>();
+  benchmark.ClearResults();
+  random::XorShiftStarRng64 prng(kSeed);
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kRequestsPerIteration; ++i) {
+      benchmark.HandleRequest(GenerateRequest(prng, distribution));
+    }
+    benchmark.Reset();
+  }
+  LogResults(name, benchmark);
+}
+
+template <typename BenchmarkType>
+void RpcBurst(perf_test::State& state, const char* name) {
+  ReplayTrace<BenchmarkType>(state, name, kRpcBurst);
+}
+
+template <typename BenchmarkType>
+void LogBuffer(perf_test::State& state, const char* name) {
+  ReplayTrace<BenchmarkType>(state, name, kLogBuffer);
+}
+
+template <typename BenchmarkType>
+void BlePacketPool(perf_test::State& state, const char* name) {
+  ReplayTrace<BenchmarkType>(state, name, kBlePacketPool);
+}
+
+template <typename BenchmarkType>
+void Uniform(perf_test::State& state, const char* name) {
+  GenerateRequests<BenchmarkType>(state, name, UniformSize);
+}
+
+template <typename BenchmarkType>
+void LogUniform(perf_test::State& state, const char* name) {
+  GenerateRequests<BenchmarkType>(state, name, LogUniformSize);
+}
+
+template <typename BenchmarkType>
+void Bimodal(perf_test::State& state, const char* name) {
+  GenerateRequests<BenchmarkType>(state, name, BimodalSize);
+}
+
+// Registers a perf test of each workload for an allocator. The logged results
+// are prefixed with the allocator's name.
+#define ALLOCATOR_PERF_TESTS(allocator)                                       \
+  PW_PERF_TEST(                                                               \
+      allocator##RpcBurst, RpcBurst<allocator##Benchmark>, #allocator);       \
+  PW_PERF_TEST(                                                               \
+      allocator##LogBuffer, LogBuffer<allocator##Benchmark>, #allocator);     \
+  PW_PERF_TEST(allocator##BlePacketPool,                                      \
+               BlePacketPool<allocator##Benchmark>,                           \
+               #allocator);                                                   \
+  PW_PERF_TEST(                                                               \
+      allocator##Uniform, Uniform<allocator##Benchmark>, #allocator);         \
+  PW_PERF_TEST(                                                               \
+      allocator##LogUniform, LogUniform<allocator##Benchmark>, #allocator);   \
+  PW_PERF_TEST(                                                               \
+      allocator##Bimodal, Bimodal<allocator##Benchmark>, #allocator)
+
+ALLOCATOR_PERF_TESTS(FirstFit);
+ALLOCATOR_PERF_TESTS(BestFit);
+ALLOCATOR_PERF_TESTS(WorstFit);
+ALLOCATOR_PERF_TESTS(DualFirstFit);
+ALLOCATOR_PERF_TESTS(Bucket);
+ALLOCATOR_PERF_TESTS(Tlsf);
+ALLOCATOR_PERF_TESTS(Buddy);
+ALLOCATOR_PERF_TESTS(FreeListHeap);
+ALLOCATOR_PERF_TESTS(Bump);
+
+#undef ALLOCATOR_PERF_TESTS
+
+}  // namespace
+}  // namespace pw::allocator
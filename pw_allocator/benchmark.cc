@@ -0,0 +1,248 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/benchmark.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <variant>
+
+#include "pw_assert/check.h"
+
+namespace pw::allocator::test {
+namespace {
+
+// Helper to allow static_assert'ing in constexpr-if branches, e.g. that a
+// visitor for a std::variant are exhaustive.
+template <typename T>
+constexpr bool not_reached(T&) {
+  return false;
+}
+
+/// Returns the integer square root of a value.
+size_t IntegerSqrt(size_t value) {
+  size_t root = 0;
+  size_t bit = size_t(1) << (std::numeric_limits<size_t>::digits - 2);
+  while (bit > value) {
+    bit >>= 2;
+  }
+  while (bit != 0) {
+    if (value >= root + bit) {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+/// Returns the fragmentation metric in thousandths, or nothing if the sum of
+/// squares is too large to take the root of.
+std::optional<uint32_t> ToPermille(const Fragmentation& fragmentation) {
+  if (fragmentation.sum_of_squares.hi != 0) {
+    return std::nullopt;
+  }
+  if (fragmentation.sum == 0) {
+    return 0;
+  }
+  size_t root = IntegerSqrt(fragmentation.sum_of_squares.lo);
+  return static_cast<uint32_t>(1000 - (root * 1000) / fragmentation.sum);
+}
+
+}  // namespace
+
+void BenchmarkGeneric::HandleRequests(span<const Request> requests) {
+  for (const auto& request : requests) {
+    HandleRequest(request);
+  }
+}
+
+void BenchmarkGeneric::HandleRequest(const Request& request) {
+  if (allocator_ == nullptr) {
+    allocator_ = Init();
+    PW_DCHECK_NOTNULL(allocator_);
+  }
+  std::visit(
+      [this](auto&& r) {
+        using T = std::decay_t<decltype(r)>;
+
+        if constexpr (std::is_same_v<T, AllocationRequest>) {
+          if (allocations_.size() < allocations_.max_size()) {
+            Layout layout(r.size, r.alignment);
+            int64_t start = Now();
+            void* ptr = allocator_->Allocate(layout);
+            int64_t end = Now();
+            AddSample(RequestType::kAllocate, end - start);
+            if (ptr == nullptr) {
+              ++num_failures_;
+            } else {
+              AddAllocation(ptr, layout);
+            }
+          }
+
+        } else if constexpr (std::is_same_v<T, DeallocationRequest>) {
+          if (!allocations_.empty()) {
+            Allocation old = RemoveAllocation(r.index);
+            int64_t start = Now();
+            allocator_->Deallocate(old.ptr);
+            int64_t end = Now();
+            AddSample(RequestType::kDeallocate, end - start);
+          }
+
+        } else if constexpr (std::is_same_v<T, ReallocationRequest>) {
+          if (!allocations_.empty()) {
+            size_t index = r.index % allocations_.size();
+            Allocation old = RemoveAllocation(index);
+            Layout new_layout = Layout(r.new_size, old.layout.alignment());
+            int64_t start = Now();
+            void* new_ptr = allocator_->Reallocate(old.ptr, new_layout);
+            int64_t end = Now();
+            AddSample(RequestType::kReallocate, end - start);
+            if (new_ptr == nullptr) {
+              ++num_failures_;
+              AddAllocation(old.ptr, old.layout);
+            } else {
+              AddAllocation(new_ptr, new_layout);
+            }
+            // Keep the allocation at the same age as the one it replaced.
+            std::rotate(allocations_.begin() + index,
+                        allocations_.end() - 1,
+                        allocations_.end());
+          }
+
+        } else {
+          static_assert(not_reached(r), "unsupported request type!");
+        }
+      },
+      request);
+  UpdatePeaks();
+}
+
+void BenchmarkGeneric::Reset() {
+  if (allocator_ == nullptr) {
+    return;
+  }
+  for (const Allocation& old : allocations_) {
+    allocator_->Deallocate(old.ptr);
+  }
+  allocations_.clear();
+  requested_bytes_ = 0;
+  allocated_bytes_ = 0;
+  DoReset();
+}
+
+void BenchmarkGeneric::ClearResults() {
+  samples_.clear();
+  num_failures_ = 0;
+  peak_requested_bytes_ = requested_bytes_;
+  peak_overhead_bytes_ =
+      overhead_supported_ ? allocated_bytes_ - requested_bytes_ : 0;
+  peak_fragmentation_.reset();
+}
+
+BenchmarkResults BenchmarkGeneric::GetResults() {
+  BenchmarkResults results;
+  results.allocate = GetLatencyResults(RequestType::kAllocate);
+  results.deallocate = GetLatencyResults(RequestType::kDeallocate);
+  results.reallocate = GetLatencyResults(RequestType::kReallocate);
+  results.num_failures = num_failures_;
+  results.peak_requested_bytes = peak_requested_bytes_;
+  if (overhead_supported_) {
+    results.peak_overhead_bytes = peak_overhead_bytes_;
+  }
+  results.peak_fragmentation = peak_fragmentation_;
+  return results;
+}
+
+void BenchmarkGeneric::AddSample(RequestType type, int64_t duration) {
+  if (timer_ == nullptr || samples_.full()) {
+    return;
+  }
+  constexpr int64_t kMaxDuration = std::numeric_limits<uint32_t>::max();
+  duration = std::clamp(duration, int64_t(0), kMaxDuration);
+  samples_.push_back(Sample{static_cast<uint32_t>(duration), type});
+}
+
+void BenchmarkGeneric::AddAllocation(void* ptr, Layout layout) {
+  size_t allocated_size = 0;
+  if (overhead_supported_) {
+    Result<size_t> result = GetAllocatedSize(ptr, layout);
+    if (result.ok()) {
+      allocated_size = *result;
+    } else {
+      overhead_supported_ = false;
+    }
+  }
+  requested_bytes_ += layout.size();
+  allocated_bytes_ += allocated_size;
+  allocations_.push_back(Allocation{ptr, layout, allocated_size});
+}
+
+BenchmarkGeneric::Allocation BenchmarkGeneric::RemoveAllocation(size_t index) {
+  auto iter = allocations_.begin() + (index % allocations_.size());
+  Allocation old = *iter;
+  allocations_.erase(iter);
+  requested_bytes_ -= old.layout.size();
+  allocated_bytes_ -= old.allocated_size;
+  return old;
+}
+
+void BenchmarkGeneric::UpdatePeaks() {
+  peak_requested_bytes_ = std::max(peak_requested_bytes_, requested_bytes_);
+  if (overhead_supported_) {
+    peak_overhead_bytes_ =
+        std::max(peak_overhead_bytes_, allocated_bytes_ - requested_bytes_);
+  }
+  std::optional<Fragmentation> fragmentation = MeasureFragmentation();
+  if (!fragmentation.has_value()) {
+    return;
+  }
+  std::optional<uint32_t> permille = ToPermille(*fragmentation);
+  if (permille.has_value() &&
+      (!peak_fragmentation_.has_value() || *permille > *peak_fragmentation_)) {
+    peak_fragmentation_ = permille;
+  }
+}
+
+LatencyResults BenchmarkGeneric::GetLatencyResults(RequestType type) {
+  // Move the samples of the requested type to the front, and sort them.
+  auto end = std::partition(
+      samples_.begin(), samples_.end(), [type](const Sample& sample) {
+        return sample.type == type;
+      });
+  size_t count = static_cast<size_t>(end - samples_.begin());
+  if (count == 0) {
+    return LatencyResults{};
+  }
+  std::sort(samples_.begin(), end, [](const Sample& lhs, const Sample& rhs) {
+    return lhs.duration < rhs.duration;
+  });
+
+  // Use the nearest-rank method to find the percentiles.
+  auto percentile = [this, count](size_t percent) {
+    size_t rank = std::max((count * percent + 99) / 100, size_t(1));
+    return samples_[rank - 1].duration;
+  };
+  return LatencyResults{
+      .count = count,
+      .p50 = percentile(50),
+      .p99 = percentile(99),
+      .max = percentile(100),
+  };
+}
+
+}  // namespace pw::allocator::test
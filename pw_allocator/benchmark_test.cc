@@ -0,0 +1,229 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/benchmark.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/first_fit_block_allocator.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::Allocator;
+using ::pw::allocator::FirstFitBlockAllocator;
+using ::pw::allocator::Layout;
+using ::pw::allocator::test::AllocationRequest;
+using ::pw::allocator::test::BenchmarkResults;
+using ::pw::allocator::test::DeallocationRequest;
+using ::pw::allocator::test::ReallocationRequest;
+
+constexpr size_t kCapacity = 0x1000;
+constexpr size_t kMaxAllocations = 128;
+constexpr size_t kMaxSamples = 256;
+
+// Fake timer that advances by `fake_step` each time it is read. Since each
+// request is timed by reading the timer before and after it, every request
+// appears to take `fake_step`.
+int64_t fake_now = 0;
+int64_t fake_step = 0;
+
+int64_t FakeTimer() {
+  int64_t now = fake_now;
+  fake_now += fake_step;
+  return now;
+}
+
+// Forwards to another allocator, and records the pointers it handles.
+class RecordingAllocator : public Allocator {
+ public:
+  explicit RecordingAllocator(Allocator& allocator) : allocator_(allocator) {}
+
+  void* last_allocated() const { return last_allocated_; }
+  void* last_deallocated() const { return last_deallocated_; }
+  void* last_reallocated() const { return last_reallocated_; }
+
+ private:
+  void* DoAllocate(Layout layout) override {
+    last_allocated_ = allocator_.Allocate(layout);
+    return last_allocated_;
+  }
+
+  void DoDeallocate(void* ptr) override {
+    last_deallocated_ = ptr;
+    allocator_.Deallocate(ptr);
+  }
+
+  void* DoReallocate(void* ptr, Layout new_layout) override {
+    last_reallocated_ = allocator_.Reallocate(ptr, new_layout);
+    return last_reallocated_;
+  }
+
+  Allocator& allocator_;
+  void* last_allocated_ = nullptr;
+  void* last_deallocated_ = nullptr;
+  void* last_reallocated_ = nullptr;
+};
+
+class TestBenchmark
+    : public ::pw::allocator::test::Benchmark<kMaxAllocations, kMaxSamples> {
+ public:
+  TestBenchmark() {
+    fake_now = 0;
+    fake_step = 1;
+    set_timer(FakeTimer);
+  }
+
+  const RecordingAllocator& recorder() const { return recorder_; }
+
+  void Allocate(size_t size) {
+    HandleRequest(AllocationRequest{.size = size, .alignment = 1});
+  }
+
+  void Deallocate(size_t index) {
+    HandleRequest(DeallocationRequest{.index = index});
+  }
+
+  void Reallocate(size_t index, size_t new_size) {
+    HandleRequest(ReallocationRequest{.index = index, .new_size = new_size});
+  }
+
+ private:
+  using BlockType = FirstFitBlockAllocator<uint16_t>::BlockType;
+
+  Allocator* Init() override {
+    allocator_.Init(buffer_);
+    return &recorder_;
+  }
+
+  alignas(BlockType::kAlignment) std::array<std::byte, kCapacity> buffer_{};
+  FirstFitBlockAllocator<uint16_t> allocator_;
+  RecordingAllocator recorder_{allocator_};
+};
+
+// Unit tests.
+
+TEST(BenchmarkTest, GetResults_NearestRankPercentiles) {
+  TestBenchmark benchmark;
+
+  // Time requests out of order, so that finding the percentiles requires
+  // sorting them.
+  for (int64_t duration = 100; duration > 0; --duration) {
+    fake_step = duration;
+    benchmark.Allocate(8);
+    benchmark.Deallocate(0);
+  }
+
+  BenchmarkResults results = benchmark.GetResults();
+  EXPECT_EQ(results.allocate.count, 100u);
+  EXPECT_EQ(results.allocate.p50, 50u);
+  EXPECT_EQ(results.allocate.p99, 99u);
+  EXPECT_EQ(results.allocate.max, 100u);
+  benchmark.Reset();
+}
+
+TEST(BenchmarkTest, GetResults_PercentilesOfFewSamplesRoundUp) {
+  TestBenchmark benchmark;
+  for (int64_t duration : {5, 1, 3}) {
+    fake_step = duration;
+    benchmark.Allocate(8);
+  }
+
+  // The 50th percentile of 3 samples is the 2nd, and the 99th is the 3rd.
+  BenchmarkResults results = benchmark.GetResults();
+  EXPECT_EQ(results.allocate.count, 3u);
+  EXPECT_EQ(results.allocate.p50, 3u);
+  EXPECT_EQ(results.allocate.p99, 5u);
+  EXPECT_EQ(results.allocate.max, 5u);
+  benchmark.Reset();
+}
+
+TEST(BenchmarkTest, GetResults_SeparatesRequestTypes) {
+  TestBenchmark benchmark;
+  fake_step = 10;
+  benchmark.Allocate(8);
+  benchmark.Allocate(8);
+  fake_step = 20;
+  benchmark.Reallocate(0, 16);
+  fake_step = 2;
+  benchmark.Deallocate(0);
+
+  BenchmarkResults results = benchmark.GetResults();
+  EXPECT_EQ(results.allocate.count, 2u);
+  EXPECT_EQ(results.allocate.max, 10u);
+  EXPECT_EQ(results.reallocate.count, 1u);
+  EXPECT_EQ(results.reallocate.p50, 20u);
+  EXPECT_EQ(results.deallocate.count, 1u);
+  EXPECT_EQ(results.deallocate.p50, 2u);
+  benchmark.Reset();
+}
+
+TEST(BenchmarkTest, ClearResults_DiscardsSamples) {
+  TestBenchmark benchmark;
+  benchmark.Allocate(8);
+  benchmark.ClearResults();
+
+  BenchmarkResults results = benchmark.GetResults();
+  EXPECT_EQ(results.allocate.count, 0u);
+  EXPECT_EQ(results.allocate.max, 0u);
+  benchmark.Reset();
+}
+
+TEST(BenchmarkTest, Reallocate_KeepsAgeOfAllocation) {
+  TestBenchmark benchmark;
+  benchmark.Allocate(16);
+  void* oldest = benchmark.recorder().last_allocated();
+  benchmark.Allocate(16);
+  benchmark.Allocate(16);
+  void* newest = benchmark.recorder().last_allocated();
+
+  // Grow the middle allocation. It is still the second oldest.
+  benchmark.Reallocate(1, 256);
+  void* reallocated = benchmark.recorder().last_reallocated();
+  ASSERT_NE(reallocated, nullptr);
+
+  benchmark.Deallocate(0);
+  EXPECT_EQ(benchmark.recorder().last_deallocated(), oldest);
+  benchmark.Deallocate(0);
+  EXPECT_EQ(benchmark.recorder().last_deallocated(), reallocated);
+  benchmark.Deallocate(0);
+  EXPECT_EQ(benchmark.recorder().last_deallocated(), newest);
+}
+
+TEST(BenchmarkTest, Reallocate_FailureKeepsAgeOfAllocation) {
+  TestBenchmark benchmark;
+  benchmark.Allocate(16);
+  void* oldest = benchmark.recorder().last_allocated();
+  benchmark.Allocate(16);
+  void* middle = benchmark.recorder().last_allocated();
+  benchmark.Allocate(16);
+  void* newest = benchmark.recorder().last_allocated();
+
+  benchmark.Reallocate(1, kCapacity);
+  EXPECT_EQ(benchmark.recorder().last_reallocated(), nullptr);
+  EXPECT_EQ(benchmark.GetResults().num_failures, 1u);
+
+  benchmark.Deallocate(0);
+  EXPECT_EQ(benchmark.recorder().last_deallocated(), oldest);
+  benchmark.Deallocate(0);
+  EXPECT_EQ(benchmark.recorder().last_deallocated(), middle);
+  benchmark.Deallocate(0);
+  EXPECT_EQ(benchmark.recorder().last_deallocated(), newest);
+}
+
+}  // namespace
@@ -14,7 +14,13 @@
 
 #include "pw_allocator/bucket_block_allocator.h"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 #include "pw_allocator/block_allocator_testing.h"
+#include "pw_allocator/test_harness.h"
+#include "pw_random/xor_shift.h"
 #include "pw_unit_test/framework.h"
 
 namespace {
@@ -157,4 +163,36 @@ TEST_F(BucketBlockAllocatorTest, CanMeasureFragmentation) {
   CanMeasureFragmentation();
 }
 
+// Handles random requests and checks that, afterwards, all memory can be
+// allocated again at once. This only succeeds if no chunk was overwritten
+// while still in a bucket, and every free block was merged correctly.
+TEST(BucketBlockAllocatorHarnessTest, GenerateRequests) {
+  constexpr size_t kCapacity = 8192;
+  constexpr size_t kMaxSize = 512;
+  constexpr size_t kNumRequests = 5000;
+
+  struct Harness : public ::pw::allocator::test::TestHarness<64> {
+    ::pw::Allocator* Init() override { return &allocator; }
+    BucketBlockAllocator allocator;
+  };
+
+  using BlockType = BucketBlockAllocator::BlockType;
+  alignas(BlockType::kAlignment) std::array<std::byte, kCapacity> buffer;
+  Harness harness;
+  harness.allocator.Init(buffer);
+  pw::random::XorShiftStarRng64 prng(1);
+  harness.GenerateRequests(prng, kMaxSize, kNumRequests);
+
+  size_t num_blocks = 0;
+  for (auto* block : harness.allocator.blocks()) {
+    EXPECT_FALSE(block->Used());
+    ++num_blocks;
+  }
+  EXPECT_EQ(num_blocks, 1U);
+  auto* block = *harness.allocator.blocks().begin();
+  void* ptr = harness.allocator.Allocate(Layout(block->InnerSize(), 1));
+  EXPECT_NE(ptr, nullptr);
+  harness.allocator.Deallocate(ptr);
+}
+
 }  // namespace
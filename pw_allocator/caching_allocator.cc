@@ -0,0 +1,163 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/caching_allocator.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_status/status.h"
+
+namespace pw::allocator::internal {
+namespace {
+
+/// Precedes every allocation made by a `CachingAllocator`.
+struct Header {
+  /// Usable size of the allocation.
+  size_t size;
+
+  /// Offset from the start of the wrapped allocation to the usable memory,
+  /// which is also the usable memory's alignment.
+  uint32_t offset;
+
+  /// Size class of the allocation, or `kNumSizeClasses` if it is not cached.
+  uint32_t size_class;
+};
+static_assert(sizeof(Header) <= CachingAllocatorBase::kAlignment);
+
+constexpr size_t kMinSizeClassBits = static_cast<size_t>(
+    cpp20::countr_zero(CachingAllocatorBase::kMinCachedSize));
+
+Header& GetHeader(void* ptr) {
+  return *reinterpret_cast<Header*>(static_cast<std::byte*>(ptr) -
+                                    sizeof(Header));
+}
+
+const Header& GetHeader(const void* ptr) {
+  return *reinterpret_cast<const Header*>(
+      static_cast<const std::byte*>(ptr) - sizeof(Header));
+}
+
+}  // namespace
+
+size_t CachingAllocatorBase::GetSizeClass(Layout layout) {
+  if (layout.size() > kMaxCachedSize || layout.alignment() > kAlignment) {
+    return kNumSizeClasses;
+  }
+  size_t bits = layout.size() == 0 ? 0 : cpp20::bit_width(layout.size() - 1);
+  return std::max(bits, kMinSizeClassBits) - kMinSizeClassBits;
+}
+
+size_t CachingAllocatorBase::GetSizeClass(const void* ptr) {
+  return GetHeader(ptr).size_class;
+}
+
+void* CachingAllocatorBase::AllocateLocked(Layout layout) {
+  size_t size_class = GetSizeClass(layout);
+  size_t size = layout.size();
+  size_t alignment = kAlignment;
+  if (size_class != kNumSizeClasses) {
+    size = GetSize(size_class);
+  } else {
+    alignment = std::max(alignment, layout.alignment());
+    if (alignment > std::numeric_limits<uint32_t>::max() ||
+        size > std::numeric_limits<size_t>::max() - alignment) {
+      return nullptr;
+    }
+  }
+  auto* bytes = static_cast<std::byte*>(
+      allocator_.Allocate(Layout(alignment + size, alignment)));
+  if (bytes == nullptr) {
+    return nullptr;
+  }
+  void* ptr = bytes + alignment;
+  GetHeader(ptr) = Header{
+      .size = size,
+      .offset = static_cast<uint32_t>(alignment),
+      .size_class = static_cast<uint32_t>(size_class),
+  };
+  return ptr;
+}
+
+void CachingAllocatorBase::DeallocateLocked(void* ptr) {
+  allocator_.Deallocate(static_cast<std::byte*>(ptr) - GetHeader(ptr).offset);
+}
+
+size_t CachingAllocatorBase::AllocateBatchLocked(size_t size_class,
+                                                 span<void*> ptrs) {
+  Layout layout(GetSize(size_class), kAlignment);
+  size_t count = 0;
+  for (void*& ptr : ptrs) {
+    ptr = AllocateLocked(layout);
+    if (ptr == nullptr) {
+      break;
+    }
+    ++count;
+  }
+  return count;
+}
+
+void CachingAllocatorBase::DeallocateBatchLocked(span<void* const> ptrs) {
+  for (void* ptr : ptrs) {
+    DeallocateLocked(ptr);
+  }
+}
+
+bool CachingAllocatorBase::ResizeLocked(void* ptr, size_t new_size) {
+  Header& header = GetHeader(ptr);
+  if (header.size_class != kNumSizeClasses) {
+    return new_size <= header.size;
+  }
+  if (new_size > std::numeric_limits<size_t>::max() - header.offset ||
+      !allocator_.Resize(static_cast<std::byte*>(ptr) - header.offset,
+                         header.offset + new_size)) {
+    return false;
+  }
+  header.size = new_size;
+  return true;
+}
+
+Result<Layout> CachingAllocatorBase::GetInfoLocked(InfoType info_type,
+                                                   const void* ptr) const {
+  switch (info_type) {
+    case InfoType::kCapacity:
+    case InfoType::kRecognizes:
+      return GetInfo(allocator_, info_type, ptr);
+    case InfoType::kUsableLayoutOf:
+    case InfoType::kAllocatedLayoutOf:
+      return GetInfoUnlocked(info_type, ptr);
+    case InfoType::kRequestedLayoutOf:
+    default:
+      return Status::Unimplemented();
+  }
+}
+
+Result<Layout> CachingAllocatorBase::GetInfoUnlocked(InfoType info_type,
+                                                     const void* ptr) {
+  switch (info_type) {
+    case InfoType::kUsableLayoutOf:
+    case InfoType::kAllocatedLayoutOf: {
+      const Header& header = GetHeader(ptr);
+      return Layout(header.size, header.offset);
+    }
+    case InfoType::kCapacity:
+    case InfoType::kRecognizes:
+    case InfoType::kRequestedLayoutOf:
+    default:
+      return Status::Unimplemented();
+  }
+}
+
+}  // namespace pw::allocator::internal
@@ -0,0 +1,161 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how a multi-threaded workload scales when its threads share an
+// allocator.
+//
+// Each iteration runs 1 to `kMaxThreads` threads that each handle a sequence of
+// randomly generated requests. Two configurations are measured:
+//
+// * In the synchronized configuration, every thread uses the same
+//   `SynchronizedAllocator`, and so takes its lock for every request.
+// * In the cached configuration, every thread has its own `ThreadCache` of a
+//   shared `CachingAllocator`, and only takes its lock when a cache misses.
+//   The caches' hit rates are logged once each test completes.
+//
+// Both configurations wrap the same kind of allocator and use a mutex. Note
+// that the time to start and join the threads is included.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_allocator/caching_allocator.h"
+#include "pw_allocator/metrics.h"
+#include "pw_allocator/synchronized_allocator.h"
+#include "pw_allocator/test_harness.h"
+#include "pw_allocator/tlsf_block_allocator.h"
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_perf_test/state.h"
+#include "pw_span/span.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_tokenizer/tokenize.h"
+
+namespace pw::allocator {
+namespace {
+
+constexpr size_t kCapacity = 0x20000;
+constexpr size_t kMagazineSize = 4;
+constexpr size_t kMaxAllocations = 16;
+constexpr size_t kMaxSize = 512;
+constexpr size_t kMaxThreads = 4;
+constexpr size_t kRequestsPerThread = 500;
+constexpr uint64_t kSeed = 1;
+constexpr metric::Token kToken = PW_TOKENIZE_STRING("ThreadCache");
+
+struct CacheMetrics {
+  PW_ALLOCATOR_METRICS_ENABLE(num_cache_hits);
+  PW_ALLOCATOR_METRICS_ENABLE(num_cache_misses);
+};
+
+using Harness = test::TestHarness<kMaxAllocations>;
+
+/// Test harness that handles requests using a shared allocator directly.
+class SharedHarness : public Harness {
+ public:
+  explicit SharedHarness(Allocator& allocator) : allocator_(allocator) {}
+
+ private:
+  Allocator* Init() override { return &allocator_; }
+
+  Allocator& allocator_;
+};
+
+/// Test harness that handles requests using its own cache of a shared
+/// allocator.
+class CachedHarness : public Harness {
+ public:
+  explicit CachedHarness(CachingAllocator<sync::Mutex>& shared)
+      : cache_(kToken, shared) {}
+
+  const CacheMetrics& metrics() const { return cache_.metrics(); }
+
+ private:
+  Allocator* Init() override { return &cache_; }
+
+  ThreadCache<kMagazineSize, CacheMetrics> cache_;
+};
+
+alignas(TlsfBlockAllocator<uint32_t>::BlockType::kAlignment)
+    std::array<std::byte, kCapacity> buffer;
+std::array<thread::test::TestThreadContext, kMaxThreads> contexts;
+
+/// Handles a sequence of requests with each of the given harnesses, on
+/// concurrent threads.
+void RunThreads(span<test::TestHarnessGeneric*> harnesses) {
+  std::array<std::optional<test::GenerateRequestsThreadCore>, kMaxThreads>
+      cores;
+  std::array<thread::Thread, kMaxThreads> threads;
+  for (size_t i = 0; i < harnesses.size(); ++i) {
+    cores[i].emplace(*harnesses[i], kSeed + i, kMaxSize, kRequestsPerThread);
+    threads[i] = thread::Thread(contexts[i].options(), *cores[i]);
+  }
+  for (size_t i = 0; i < harnesses.size(); ++i) {
+    threads[i].join();
+  }
+}
+
+void Synchronized(perf_test::State& state, size_t num_threads) {
+  TlsfBlockAllocator<uint32_t> allocator(buffer);
+  SynchronizedAllocator<sync::Mutex> shared(allocator);
+  std::array<std::optional<SharedHarness>, kMaxThreads> harnesses;
+  std::array<test::TestHarnessGeneric*, kMaxThreads> generic;
+  for (size_t i = 0; i < num_threads; ++i) {
+    generic[i] = &harnesses[i].emplace(shared);
+  }
+  while (state.KeepRunning()) {
+    RunThreads(span(generic).first(num_threads));
+  }
+}
+
+void Cached(perf_test::State& state, size_t num_threads) {
+  TlsfBlockAllocator<uint32_t> allocator(buffer);
+  CachingAllocator<sync::Mutex> shared(allocator);
+  std::array<std::optional<CachedHarness>, kMaxThreads> harnesses;
+  std::array<test::TestHarnessGeneric*, kMaxThreads> generic;
+  for (size_t i = 0; i < num_threads; ++i) {
+    generic[i] = &harnesses[i].emplace(shared);
+  }
+  while (state.KeepRunning()) {
+    RunThreads(span(generic).first(num_threads));
+  }
+
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  for (size_t i = 0; i < num_threads; ++i) {
+    hits += harnesses[i]->metrics().num_cache_hits.value();
+    misses += harnesses[i]->metrics().num_cache_misses.value();
+  }
+  const uint32_t total = hits + misses;
+  PW_LOG_INFO("ThreadCache hit rate with %u thread(s): %u%% (%u of %u)",
+              static_cast<unsigned>(num_threads),
+              static_cast<unsigned>(total == 0 ? 0 : hits * 100 / total),
+              static_cast<unsigned>(hits),
+              static_cast<unsigned>(total));
+}
+
+PW_PERF_TEST(SynchronizedOneThread, Synchronized, 1);
+PW_PERF_TEST(SynchronizedTwoThreads, Synchronized, 2);
+PW_PERF_TEST(SynchronizedFourThreads, Synchronized, 4);
+
+PW_PERF_TEST(CachedOneThread, Cached, 1);
+PW_PERF_TEST(CachedTwoThreads, Cached, 2);
+PW_PERF_TEST(CachedFourThreads, Cached, 4);
+
+}  // namespace
+}  // namespace pw::allocator
@@ -0,0 +1,261 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/caching_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_allocator/test_harness.h"
+#include "pw_allocator/testing.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_sync/mutex.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::CachingAllocator;
+using ::pw::allocator::Layout;
+using ::pw::allocator::ThreadCache;
+using ::pw::allocator::test::kToken;
+using AllocatorForTest = ::pw::allocator::test::AllocatorForTest<8192>;
+using TestMetrics = ::pw::allocator::internal::AllMetrics;
+using Base = ::pw::allocator::internal::CachingAllocatorBase;
+
+constexpr size_t kMagazineSize = 4;
+
+class CachingAllocatorTest : public ::testing::Test {
+ protected:
+  CachingAllocatorTest() : shared_(allocator_) {}
+
+  // Number of allocations made from the wrapped allocator that have not been
+  // deallocated.
+  uint32_t outstanding() const {
+    const auto& metrics = allocator_.metrics();
+    return metrics.num_allocations.value() - metrics.num_deallocations.value();
+  }
+
+  AllocatorForTest allocator_;
+  CachingAllocator<pw::sync::Mutex> shared_;
+};
+
+// Unit tests.
+
+TEST(CachingAllocatorBaseTest, GetSizeClass) {
+  EXPECT_EQ(Base::GetSizeClass(Layout(1)), 0U);
+  EXPECT_EQ(Base::GetSizeClass(Layout(16)), 0U);
+  EXPECT_EQ(Base::GetSizeClass(Layout(17)), 1U);
+  EXPECT_EQ(Base::GetSizeClass(Layout(32)), 1U);
+  EXPECT_EQ(Base::GetSizeClass(Layout(Base::kMaxCachedSize)),
+            Base::kNumSizeClasses - 1);
+  EXPECT_EQ(Base::GetSizeClass(Layout(Base::kMaxCachedSize + 1)),
+            Base::kNumSizeClasses);
+  EXPECT_EQ(Base::GetSizeClass(Layout(16, Base::kAlignment * 2)),
+            Base::kNumSizeClasses);
+}
+
+TEST_F(CachingAllocatorTest, AllocateDirectly) {
+  void* ptr = shared_.Allocate(Layout(24));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(outstanding(), 1U);
+
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % Base::kAlignment, 0U);
+
+  // The allocation was rounded up to its size class.
+  EXPECT_TRUE(shared_.Resize(ptr, 32));
+  EXPECT_FALSE(shared_.Resize(ptr, 33));
+
+  shared_.Deallocate(ptr);
+  EXPECT_EQ(outstanding(), 0U);
+}
+
+TEST_F(CachingAllocatorTest, ReusesCachedMemory) {
+  ThreadCache<kMagazineSize, TestMetrics> cache(kToken, shared_);
+
+  void* ptr1 = cache.Allocate(Layout(24));
+  ASSERT_NE(ptr1, nullptr);
+  EXPECT_EQ(cache.metrics().num_cache_misses.value(), 1U);
+  EXPECT_EQ(cache.metrics().num_cache_hits.value(), 0U);
+
+  // The first allocation refills half a magazine at once.
+  EXPECT_EQ(outstanding(), kMagazineSize / 2);
+
+  cache.Deallocate(ptr1);
+  void* ptr2 = cache.Allocate(Layout(20));
+  EXPECT_EQ(ptr2, ptr1);
+  EXPECT_EQ(cache.metrics().num_cache_misses.value(), 1U);
+  EXPECT_EQ(cache.metrics().num_cache_hits.value(), 1U);
+  EXPECT_EQ(outstanding(), kMagazineSize / 2);
+
+  cache.Deallocate(ptr2);
+  EXPECT_EQ(cache.metrics().num_allocations.value(), 2U);
+  EXPECT_EQ(cache.metrics().num_deallocations.value(), 2U);
+}
+
+TEST_F(CachingAllocatorTest, FlushesFullMagazine) {
+  ThreadCache<kMagazineSize, TestMetrics> cache(kToken, shared_);
+
+  std::array<void*, kMagazineSize + 1> ptrs;
+  for (void*& ptr : ptrs) {
+    ptr = cache.Allocate(Layout(64));
+    ASSERT_NE(ptr, nullptr);
+  }
+  // Allocations were refilled in batches of half a magazine.
+  EXPECT_EQ(outstanding(), 6U);
+
+  // Deallocating into a full magazine returned half of it to the allocator, so
+  // that only the blocks in the magazine remain.
+  for (void* ptr : ptrs) {
+    cache.Deallocate(ptr);
+  }
+  EXPECT_EQ(outstanding(), kMagazineSize);
+}
+
+TEST_F(CachingAllocatorTest, DestructorReturnsCachedMemory) {
+  {
+    ThreadCache<kMagazineSize> cache(kToken, shared_);
+    void* ptr = cache.Allocate(Layout(100));
+    ASSERT_NE(ptr, nullptr);
+    cache.Deallocate(ptr);
+    EXPECT_NE(outstanding(), 0U);
+  }
+  EXPECT_EQ(outstanding(), 0U);
+}
+
+TEST_F(CachingAllocatorTest, LargeAllocationsAreNotCached) {
+  ThreadCache<kMagazineSize, TestMetrics> cache(kToken, shared_);
+
+  constexpr size_t kLargeSize = Base::kMaxCachedSize + 1;
+  void* ptr = cache.Allocate(Layout(kLargeSize));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(outstanding(), 1U);
+
+  cache.Deallocate(ptr);
+  EXPECT_EQ(outstanding(), 0U);
+  EXPECT_EQ(cache.metrics().num_cache_misses.value(), 1U);
+}
+
+TEST_F(CachingAllocatorTest, OverAlignedAllocationsAreNotCached) {
+  ThreadCache<kMagazineSize> cache(kToken, shared_);
+
+  constexpr size_t kAlignment = Base::kAlignment * 4;
+  void* ptr = cache.Allocate(Layout(16, kAlignment));
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % kAlignment, 0U);
+
+  cache.Deallocate(ptr);
+  EXPECT_EQ(outstanding(), 0U);
+}
+
+TEST_F(CachingAllocatorTest, DeallocateWithAnotherCache) {
+  ThreadCache<kMagazineSize> cache1(kToken, shared_);
+  void* ptr = cache1.Allocate(Layout(32));
+  ASSERT_NE(ptr, nullptr);
+
+  {
+    ThreadCache<kMagazineSize> cache2(kToken, shared_);
+    cache2.Deallocate(ptr);
+  }
+  cache1.Flush();
+  EXPECT_EQ(outstanding(), 0U);
+}
+
+TEST_F(CachingAllocatorTest, ResizeWithinSizeClass) {
+  ThreadCache<kMagazineSize> cache(kToken, shared_);
+  void* ptr = cache.Allocate(Layout(20));
+  ASSERT_NE(ptr, nullptr);
+
+  EXPECT_TRUE(cache.Resize(ptr, 32));
+  EXPECT_FALSE(cache.Resize(ptr, 33));
+  cache.Deallocate(ptr);
+}
+
+TEST_F(CachingAllocatorTest, ReallocateCopiesData) {
+  ThreadCache<kMagazineSize> cache(kToken, shared_);
+  auto* ptr = static_cast<std::byte*>(cache.Allocate(Layout(16)));
+  ASSERT_NE(ptr, nullptr);
+  std::memset(ptr, 0xA5, 16);
+
+  auto* new_ptr = static_cast<std::byte*>(
+      cache.Reallocate(ptr, Layout(Base::kMaxCachedSize)));
+  ASSERT_NE(new_ptr, nullptr);
+  EXPECT_NE(new_ptr, ptr);
+  for (size_t i = 0; i < 16; ++i) {
+    EXPECT_EQ(new_ptr[i], std::byte(0xA5));
+  }
+  cache.Deallocate(new_ptr);
+}
+
+TEST_F(CachingAllocatorTest, AllocateFailsWhenExhausted) {
+  ThreadCache<kMagazineSize, TestMetrics> cache(kToken, shared_);
+  allocator_.Exhaust();
+  EXPECT_EQ(cache.Allocate(Layout(16)), nullptr);
+  EXPECT_EQ(cache.metrics().num_failures.value(), 1U);
+}
+
+// The tests below run random sequences of requests on several threads, each
+// with its own cache of a shared allocator. Memory must not be corrupted, the
+// test must not deadlock, and all memory must be returned once the caches are
+// destroyed.
+
+template <typename LockType>
+void TestGenerateRequests() {
+  constexpr size_t kNumThreads = 3;
+  constexpr size_t kNumRequests = 2000;
+  constexpr size_t kMaxSize = Base::kMaxCachedSize * 2;
+
+  struct Worker : public pw::allocator::test::TestHarness<16> {
+    Worker(CachingAllocator<LockType>& shared, uint64_t seed)
+        : cache(kToken, shared), core(*this, seed, kMaxSize, kNumRequests) {}
+
+    pw::Allocator* Init() override { return &cache; }
+
+    ThreadCache<kMagazineSize> cache;
+    pw::allocator::test::GenerateRequestsThreadCore core;
+    pw::thread::test::TestThreadContext context;
+  };
+
+  AllocatorForTest allocator;
+  CachingAllocator<LockType> shared(allocator);
+  {
+    std::array<Worker, kNumThreads> workers = {
+        Worker(shared, 1), Worker(shared, 2), Worker(shared, 3)};
+    std::array<pw::thread::Thread, kNumThreads> threads;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      threads[i] =
+          pw::thread::Thread(workers[i].context.options(), workers[i].core);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  const auto& metrics = allocator.metrics();
+  EXPECT_EQ(metrics.num_allocations.value(), metrics.num_deallocations.value());
+}
+
+TEST(CachingAllocatorThreadedTest, GenerateRequestsSpinLock) {
+  TestGenerateRequests<pw::sync::InterruptSpinLock>();
+}
+
+TEST(CachingAllocatorThreadedTest, GenerateRequestsMutex) {
+  TestGenerateRequests<pw::sync::Mutex>();
+}
+
+}  // namespace
@@ -0,0 +1,86 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/lock_free_chunk_pool.h"
+
+#include <algorithm>
+#include <new>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/alignment.h"
+
+namespace pw::allocator {
+
+static_assert(sizeof(std::atomic<uintptr_t>) <= ChunkPool::kMinSize);
+static_assert(alignof(std::atomic<uintptr_t>) <= ChunkPool::kMinAlignment);
+
+LockFreeChunkPool::LockFreeChunkPool(ByteSpan region, const Layout& layout)
+    : ChunkPool(region, layout),
+      chunk_size_(std::max(layout.size(), kMinSize)) {
+  size_t alignment = std::max(layout.alignment(), kMinAlignment);
+  region = GetAlignedSubspan(region, alignment);
+  chunks_ = region.data();
+
+  // Link every chunk to the next, and terminate the list.
+  size_t num_chunks = region.size() / chunk_size_;
+  PW_CHECK_UINT_NE(num_chunks, 0);
+  PW_CHECK_UINT_LE(num_chunks, kMaxChunks);
+  for (uintptr_t index = 0; index < num_chunks; ++index) {
+    uintptr_t next = index + 1 == num_chunks ? kNone : index + 1;
+    new (chunks_ + index * chunk_size_) std::atomic<uintptr_t>(next);
+  }
+  head_.store(0, std::memory_order_release);
+}
+
+std::atomic<uintptr_t>& LockFreeChunkPool::GetLink(uintptr_t index) const {
+  return *std::launder(
+      reinterpret_cast<std::atomic<uintptr_t>*>(chunks_ + index * chunk_size_));
+}
+
+void* LockFreeChunkPool::DoAllocate() {
+  uintptr_t head = head_.load(std::memory_order_acquire);
+  uintptr_t index;
+  uintptr_t next;
+  do {
+    index = GetIndex(head);
+    if (index == kNone) {
+      return nullptr;
+    }
+    // If another context pops this chunk first, it may overwrite the link.
+    // This is benign: the tag will have changed, and the exchange will fail.
+    next = GetLink(index).load(std::memory_order_relaxed);
+  } while (!head_.compare_exchange_weak(head,
+                                        MakeHead(head, GetIndex(next)),
+                                        std::memory_order_acquire,
+                                        std::memory_order_acquire));
+  return chunks_ + index * chunk_size_;
+}
+
+void LockFreeChunkPool::DoDeallocate(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  auto* bytes = static_cast<std::byte*>(ptr);
+  auto index = static_cast<uintptr_t>(bytes - chunks_) / chunk_size_;
+  auto* link = new (bytes) std::atomic<uintptr_t>(kNone);
+  uintptr_t head = head_.load(std::memory_order_relaxed);
+  do {
+    link->store(GetIndex(head), std::memory_order_relaxed);
+  } while (!head_.compare_exchange_weak(head,
+                                        MakeHead(head, index),
+                                        std::memory_order_release,
+                                        std::memory_order_relaxed));
+}
+
+}  // namespace pw::allocator
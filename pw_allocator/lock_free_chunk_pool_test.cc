@@ -0,0 +1,209 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/lock_free_chunk_pool.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "pw_allocator/typed_pool.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/thread_core.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::LockFreeChunkPool;
+using ::pw::allocator::TypedPool;
+
+struct U64 {
+  std::byte bytes[8];
+};
+
+// Unit tests.
+
+TEST(LockFreeChunkPoolTest, Capabilities) {
+  std::array<std::byte, 256> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+  EXPECT_EQ(pool.capabilities(), LockFreeChunkPool::kCapabilities);
+}
+
+TEST(LockFreeChunkPoolTest, AllocateDeallocate) {
+  std::array<std::byte, 256> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+
+  void* ptr = pool.Allocate();
+  ASSERT_NE(ptr, nullptr);
+  pool.Deallocate(ptr);
+}
+
+TEST(LockFreeChunkPoolTest, ReusesMostRecentlyFreedChunk) {
+  std::array<std::byte, 256> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+
+  void* ptr1 = pool.Allocate();
+  void* ptr2 = pool.Allocate();
+  ASSERT_NE(ptr1, nullptr);
+  ASSERT_NE(ptr2, nullptr);
+  EXPECT_NE(ptr1, ptr2);
+
+  pool.Deallocate(ptr1);
+  EXPECT_EQ(pool.Allocate(), ptr1);
+  pool.Deallocate(ptr1);
+  pool.Deallocate(ptr2);
+}
+
+TEST(LockFreeChunkPoolTest, ExhaustTwice) {
+  constexpr size_t kNumU64s = 32;
+  constexpr size_t kBufferSize = sizeof(U64) * kNumU64s;
+  alignas(U64) std::array<std::byte, kBufferSize> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+
+  // Allocate everything.
+  std::array<void*, kNumU64s> ptrs;
+  for (auto& ptr : ptrs) {
+    ptr = pool.Allocate();
+    ASSERT_NE(ptr, nullptr);
+  }
+
+  // At this point, the pool is empty.
+  EXPECT_EQ(pool.Allocate(), nullptr);
+
+  // Now refill the pool, and show it can be emptied again.
+  for (auto& ptr : ptrs) {
+    pool.Deallocate(ptr);
+    ptr = nullptr;
+  }
+  for (auto& ptr : ptrs) {
+    ptr = pool.Allocate();
+    ASSERT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(pool.Allocate(), nullptr);
+
+  // Release everything.
+  for (auto& ptr : ptrs) {
+    pool.Deallocate(ptr);
+    ptr = nullptr;
+  }
+}
+
+TEST(LockFreeChunkPoolTest, GetInfo) {
+  alignas(uintptr_t) std::array<std::byte, 256> buffer;
+  LockFreeChunkPool pool(buffer, Layout::Of<U64>());
+
+  void* ptr = pool.Allocate();
+  ASSERT_NE(ptr, nullptr);
+  EXPECT_EQ(pool.GetCapacity().size(), 256U);
+  pool.Deallocate(ptr);
+}
+
+TEST(LockFreeChunkPoolTest, TypedPool) {
+  struct Packet {
+    explicit Packet(uint32_t id_) : id(id_) {}
+    uint32_t id;
+    std::array<std::byte, 28> payload;
+  };
+  TypedPool<Packet, LockFreeChunkPool>::Buffer<4> buffer;
+  TypedPool<Packet, LockFreeChunkPool> pool(buffer);
+
+  auto packet = pool.MakeUnique(7u);
+  ASSERT_NE(packet, nullptr);
+  EXPECT_EQ(packet->id, 7u);
+}
+
+// The test below allocates and frees chunks concurrently on several threads.
+// Each thread fills its chunks with a pattern, and checks that pattern before
+// freeing them. A chunk handed out to two threads at once would be detected
+// as a corrupted pattern.
+
+constexpr size_t kNumThreads = 3;
+constexpr size_t kNumChunks = 16;
+constexpr size_t kChunkSize = 32;
+constexpr size_t kChunksPerThread = 4;
+constexpr size_t kNumIterations = 2000;
+
+class PoolUser : public pw::thread::ThreadCore {
+ public:
+  PoolUser(LockFreeChunkPool& pool, uint8_t id) : pool_(pool), id_(id) {}
+
+  pw::thread::test::TestThreadContext& context() { return context_; }
+  size_t num_corrupted() const { return num_corrupted_; }
+
+ private:
+  void Run() override {
+    std::array<std::byte*, kChunksPerThread> chunks{};
+    for (size_t i = 0; i < kNumIterations; ++i) {
+      std::byte*& chunk = chunks[i % kChunksPerThread];
+      if (chunk != nullptr) {
+        for (size_t j = 0; j < kChunkSize; ++j) {
+          if (chunk[j] != std::byte(id_)) {
+            ++num_corrupted_;
+            break;
+          }
+        }
+        pool_.Deallocate(chunk);
+      }
+      chunk = static_cast<std::byte*>(pool_.Allocate());
+      if (chunk != nullptr) {
+        std::memset(chunk, id_, kChunkSize);
+      }
+    }
+    for (std::byte* chunk : chunks) {
+      pool_.Deallocate(chunk);
+    }
+  }
+
+  LockFreeChunkPool& pool_;
+  uint8_t id_;
+  size_t num_corrupted_ = 0;
+  pw::thread::test::TestThreadContext context_;
+};
+
+TEST(LockFreeChunkPoolThreadedTest, ConcurrentAllocateAndDeallocate) {
+  alignas(uintptr_t) std::array<std::byte, kNumChunks * kChunkSize> buffer;
+  LockFreeChunkPool pool(buffer, Layout(kChunkSize, alignof(uintptr_t)));
+  {
+    std::array<PoolUser, kNumThreads> users = {
+        PoolUser(pool, 1), PoolUser(pool, 2), PoolUser(pool, 3)};
+    std::array<pw::thread::Thread, kNumThreads> threads;
+    for (size_t i = 0; i < kNumThreads; ++i) {
+      threads[i] = pw::thread::Thread(users[i].context().options(), users[i]);
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    for (const auto& user : users) {
+      EXPECT_EQ(user.num_corrupted(), 0U);
+    }
+  }
+
+  // Every chunk was returned exactly once.
+  std::array<void*, kNumChunks> ptrs;
+  for (auto& ptr : ptrs) {
+    ptr = pool.Allocate();
+    EXPECT_NE(ptr, nullptr);
+  }
+  EXPECT_EQ(pool.Allocate(), nullptr);
+  for (auto* ptr : ptrs) {
+    pool.Deallocate(ptr);
+  }
+}
+
+}  // namespace
@@ -0,0 +1,257 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/fragmentation.h"
+#include "pw_allocator/test_harness.h"
+#include "pw_containers/vector.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+
+namespace pw::allocator::test {
+
+/// Latencies measured for one kind of request.
+///
+/// Durations are in the units of the benchmark's timer, e.g. nanoseconds or
+/// clock cycles. See `BenchmarkGeneric::set_timer`.
+struct LatencyResults {
+  /// Number of measured requests.
+  size_t count = 0;
+
+  /// Median latency.
+  uint32_t p50 = 0;
+
+  /// 99th percentile latency.
+  uint32_t p99 = 0;
+
+  /// Largest latency.
+  uint32_t max = 0;
+};
+
+/// Summary of how an allocator handled a workload.
+struct BenchmarkResults {
+  LatencyResults allocate;
+  LatencyResults deallocate;
+  LatencyResults reallocate;
+
+  /// Number of allocation or reallocation requests that failed.
+  size_t num_failures = 0;
+
+  /// Largest number of requested bytes that were allocated at once.
+  size_t peak_requested_bytes = 0;
+
+  /// Largest difference between the bytes of the allocator's memory that were
+  /// in use and the bytes that were requested, i.e. the bytes used for
+  /// metadata and padding. Empty if the allocator cannot report it.
+  std::optional<size_t> peak_overhead_bytes;
+
+  /// Largest fragmentation of free memory measured after any request, in
+  /// thousandths. See `Fragmentation`. Empty if the allocator cannot report
+  /// it.
+  std::optional<uint32_t> peak_fragmentation;
+};
+
+/// Measures the latency and memory efficiency of an allocator.
+///
+/// This class handles the same `Request`s as `TestHarness`, but times each
+/// call to the allocator individually using a caller-provided timer, and
+/// tracks how the allocator's memory is used between calls. This allows
+/// comparing allocators on the same workloads, whether recorded from a device
+/// or randomly generated.
+///
+/// Unlike `TestHarness`, allocations are kept in the order they were made, and
+/// removing one preserves the order of the others. This lets recorded traces
+/// refer to allocations by age: index 0 is the oldest outstanding allocation.
+/// Indices larger than the number of outstanding allocations wrap around.
+///
+/// Like `TestHarness`, this class cannot be used directly. Derived classes
+/// provide storage for allocations and latency samples, as well as the
+/// allocator to measure.
+class BenchmarkGeneric {
+ public:
+  /// Returns the current time of a monotonic clock, in arbitrary units.
+  using Timer = int64_t (*)();
+
+  /// See the note on `TestHarnessGeneric::~TestHarnessGeneric`.
+  virtual ~BenchmarkGeneric() = default;
+
+  /// Sets the timer used to measure each request, e.g. one that reads
+  /// `pw_chrono`'s `SystemClock`.
+  ///
+  /// Requests are not timed until a timer is set.
+  void set_timer(Timer timer) { timer_ = timer; }
+
+  /// Handles a sequence of requests, e.g. a recorded trace.
+  ///
+  /// Unlike `TestHarnessGeneric::HandleRequests`, this does not call `Reset`,
+  /// so that traces can be replayed back to back.
+  void HandleRequests(span<const Request> requests);
+
+  /// Handles a request, and measures how long the allocator took to do so.
+  ///
+  /// If the vector of allocations is full, allocation requests are ignored. If
+  /// it is empty, deallocation and reallocation requests are ignored. If the
+  /// vector of samples is full, or no timer is set, requests are still handled
+  /// but not timed.
+  void HandleRequest(const Request& request);
+
+  /// Deallocates any outstanding allocations. These deallocations are not
+  /// measured, and results are kept.
+  void Reset();
+
+  /// Discards all results measured so far.
+  void ClearResults();
+
+  /// Returns the results measured since the last call to `ClearResults`.
+  BenchmarkResults GetResults();
+
+ protected:
+  /// Kinds of requests that are timed.
+  enum class RequestType : uint8_t {
+    kAllocate,
+    kDeallocate,
+    kReallocate,
+  };
+
+  /// Tracks an outstanding allocation.
+  struct Allocation {
+    void* ptr;
+    Layout layout;
+
+    /// Bytes of the allocator's memory used to satisfy the request, or 0 if
+    /// not known.
+    size_t allocated_size;
+  };
+
+  /// Duration of a single request.
+  struct Sample {
+    uint32_t duration;
+    RequestType type;
+  };
+
+  constexpr BenchmarkGeneric(Vector<Allocation>& allocations,
+                             Vector<Sample>& samples)
+      : allocations_(allocations), samples_(samples) {}
+
+ private:
+  /// Returns the allocator to measure. Called before the first request.
+  virtual Allocator* Init() = 0;
+
+  /// Called by `Reset` after deallocating, e.g. to rewind an allocator that
+  /// does not reuse freed memory.
+  virtual void DoReset() {}
+
+  /// Returns how fragmented the allocator's free memory is, if supported.
+  virtual std::optional<Fragmentation> MeasureFragmentation() {
+    return std::nullopt;
+  }
+
+  /// Returns the number of bytes of the allocator's memory used to satisfy
+  /// a request with the given layout, including metadata and padding.
+  virtual Result<size_t> GetAllocatedSize(void*, Layout) {
+    return Status::Unimplemented();
+  }
+
+  /// Returns the current time, or 0 if no timer is set.
+  int64_t Now() const { return timer_ == nullptr ? 0 : timer_(); }
+
+  /// Records how long a request took, if requests are being timed.
+  void AddSample(RequestType type, int64_t duration);
+
+  /// Adds an allocation to the end of the vector of allocations.
+  void AddAllocation(void* ptr, Layout layout);
+
+  /// Removes an allocation while preserving the order of the others.
+  Allocation RemoveAllocation(size_t index);
+
+  /// Updates the peak memory statistics after a request.
+  void UpdatePeaks();
+
+  /// Returns the percentiles of the samples of the given type. Reorders the
+  /// samples.
+  LatencyResults GetLatencyResults(RequestType type);
+
+  Allocator* allocator_ = nullptr;
+  Timer timer_ = nullptr;
+  Vector<Allocation>& allocations_;
+  Vector<Sample>& samples_;
+
+  size_t num_failures_ = 0;
+  size_t requested_bytes_ = 0;
+  size_t allocated_bytes_ = 0;
+  size_t peak_requested_bytes_ = 0;
+  size_t peak_overhead_bytes_ = 0;
+  bool overhead_supported_ = true;
+  std::optional<uint32_t> peak_fragmentation_;
+};
+
+/// Measures the latency and memory efficiency of an allocator.
+///
+/// This class differs from its base class only in that it uses its template
+/// parameters to explicitly size its vectors. It must be extended further with
+/// a method that provides an initialized allocator.
+///
+/// @tparam   kMaxConcurrentAllocations   Maximum outstanding allocations.
+/// @tparam   kMaxSamples                 Maximum number of timed requests
+///                                       between calls to `ClearResults`.
+template <size_t kMaxConcurrentAllocations, size_t kMaxSamples>
+class Benchmark : public BenchmarkGeneric {
+ public:
+  constexpr Benchmark() : BenchmarkGeneric(allocations_, samples_) {}
+
+ private:
+  Vector<Allocation, kMaxConcurrentAllocations> allocations_;
+  Vector<Sample, kMaxSamples> samples_;
+};
+
+/// Measures a block allocator, using a memory region it owns.
+///
+/// Block allocators can report the fragmentation of their free blocks, and
+/// how much memory each used block consumes.
+template <typename BlockAllocatorType,
+          size_t kCapacity,
+          size_t kMaxConcurrentAllocations,
+          size_t kMaxSamples>
+class BlockAllocatorBenchmark
+    : public Benchmark<kMaxConcurrentAllocations, kMaxSamples> {
+ public:
+  using BlockType = typename BlockAllocatorType::BlockType;
+
+  BlockAllocatorType& allocator() { return allocator_; }
+
+ private:
+  Allocator* Init() override {
+    allocator_.Init(buffer_);
+    return &allocator_;
+  }
+
+  std::optional<Fragmentation> MeasureFragmentation() override {
+    return allocator_.MeasureFragmentation();
+  }
+
+  Result<size_t> GetAllocatedSize(void* ptr, Layout) override {
+    return BlockType::FromUsableSpace(ptr)->OuterSize();
+  }
+
+  alignas(BlockType::kAlignment) std::array<std::byte, kCapacity> buffer_{};
+  BlockAllocatorType allocator_;
+};
+
+}  // namespace pw::allocator::test
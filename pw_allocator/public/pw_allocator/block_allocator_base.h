@@ -158,10 +158,20 @@ class BlockAllocator : public internal::GenericBlockAllocator {
   /// @param  layout  Same as ``Allocator::Allocate``.
   virtual BlockType* ChooseBlock(Layout layout) = 0;
 
+  /// Removes a free block from consideration for allocation.
+  ///
+  /// This method is called before a free block is merged with a neighboring
+  /// block that is being deallocated or resized. Allocators that track free
+  /// blocks must stop tracking the given block, since it will no longer exist
+  /// once merged. By default, it does nothing.
+  ///
+  /// @param  block   The free block about to be merged.
+  virtual void ReserveBlock(BlockType* block);
+
   /// Makes this block available for allocation again.
   ///
-  /// This method is called when a block is deallocated. By default, it does
-  /// nothing.
+  /// This method is called when a block is deallocated, or when resizing a
+  /// block leaves a free block after it. By default, it does nothing.
   ///
   /// @param  block   The block beind deallocated.
   virtual void RecycleBlock(BlockType* block);
@@ -275,6 +285,13 @@ void BlockAllocator<OffsetType, kPoisonInterval, kAlign>::DoDeallocate(
   BlockType* block = *result;
 
   // Free the block and merge it with its neighbors, if possible.
+  BlockType* prev = block->Prev();
+  if (prev != nullptr && !prev->Used()) {
+    ReserveBlock(prev);
+  }
+  if (!block->Last() && !block->Next()->Used()) {
+    ReserveBlock(block->Next());
+  }
   BlockType::Free(block);
   UpdateLast(block);
 
@@ -297,7 +314,16 @@ bool BlockAllocator<OffsetType, kPoisonInterval, kAlign>::DoResize(
   }
   BlockType* block = *result;
 
-  if (!BlockType::Resize(block, new_size).ok()) {
+  // Resizing may merge the block with the free block after it, and may split a
+  // new free block off its end.
+  if (!block->Last() && !block->Next()->Used()) {
+    ReserveBlock(block->Next());
+  }
+  bool resized = BlockType::Resize(block, new_size).ok();
+  if (!block->Last() && !block->Next()->Used()) {
+    RecycleBlock(block->Next());
+  }
+  if (!resized) {
     return false;
   }
   UpdateLast(block);
@@ -348,6 +374,10 @@ BlockAllocator<OffsetType, kPoisonInterval, kAlign>::MeasureFragmentation()
   return fragmentation;
 }
 
+template <typename OffsetType, uint16_t kPoisonInterval, uint16_t kAlign>
+void BlockAllocator<OffsetType, kPoisonInterval, kAlign>::ReserveBlock(
+    BlockType*) {}
+
 template <typename OffsetType, uint16_t kPoisonInterval, uint16_t kAlign>
 void BlockAllocator<OffsetType, kPoisonInterval, kAlign>::RecycleBlock(
     BlockType*) {}
@@ -98,26 +98,42 @@ class BucketBlockAllocator
       if (bucket.chunk_size() < layout.size()) {
         continue;
       }
-      void* leading = bucket.RemoveIf([&layout](void* chunk) {
-        BlockType* candidate = BlockType::FromUsableSpace(chunk);
-        return BlockType::AllocLast(candidate, layout).ok();
+      // Allocating may overwrite the chunk, so only check if the block is
+      // suitable while it is in the bucket.
+      void* chunk = bucket.RemoveIf([&layout](void* candidate) {
+        return BlockType::FromUsableSpace(candidate)->CanAllocLast(layout).ok();
       });
-      if (leading != nullptr) {
-        block = BlockType::FromUsableSpace(leading);
+      if (chunk != nullptr) {
+        block = BlockType::FromUsableSpace(chunk);
         break;
       }
     }
-    if (block == nullptr) {
+    if (block == nullptr || !BlockType::AllocLast(block, layout).ok()) {
       return nullptr;
     }
-    // If the chunk was split, what we have is the leading free block.
-    if (!block->Used()) {
-      RecycleBlock(block);
-      block = block->Next();
+    // If the chunk was split, recycle the leading free block.
+    BlockType* prev = block->Prev();
+    if (prev != nullptr && !prev->Used()) {
+      RecycleBlock(prev);
     }
     return block;
   }
 
+  /// @copydoc BlockAllocator::ReserveBlock
+  void ReserveBlock(BlockType* block) override {
+    size_t inner_size = block->InnerSize();
+    if (inner_size < sizeof(void*)) {
+      return;
+    }
+    std::byte* chunk = block->UsableSpace();
+    for (auto& bucket : buckets_) {
+      if (inner_size <= bucket.chunk_size()) {
+        bucket.RemoveIf([chunk](void* other) { return other == chunk; });
+        break;
+      }
+    }
+  }
+
   /// @copydoc BlockAllocator::RecycleBlock
   void RecycleBlock(BlockType* block) override {
     // Free blocks that are too small to be added to buckets will be "garbage
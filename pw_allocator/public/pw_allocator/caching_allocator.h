@@ -0,0 +1,298 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+#include "pw_allocator/allocator.h"
+#include "pw_allocator/capability.h"
+#include "pw_allocator/metrics.h"
+#include "pw_metric/metric.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+
+namespace pw::allocator {
+namespace internal {
+
+/// Base class for `CachingAllocator` that does not depend on the lock type.
+///
+/// Every allocation made through a `CachingAllocator`, directly or through a
+/// `ThreadCache`, is preceded by a small header that records its size class.
+/// This lets any thread return memory to its own cache without consulting the
+/// shared allocator.
+class CachingAllocatorBase : public Allocator {
+ public:
+  static constexpr Capabilities kCapabilities =
+      kImplementsGetUsableLayout | kImplementsGetAllocatedLayout;
+
+  /// Number of size classes. Allocations larger than the largest size class,
+  /// or with a stricter alignment than `kAlignment`, are never cached.
+  static constexpr size_t kNumSizeClasses = 8;
+
+  /// Size of the smallest size class. Each size class is twice the size of
+  /// the one before it.
+  static constexpr size_t kMinCachedSize = 16;
+
+  /// Size of the largest size class.
+  static constexpr size_t kMaxCachedSize = kMinCachedSize
+                                           << (kNumSizeClasses - 1);
+
+  /// Alignment of cached allocations, which is also the size of the header
+  /// that precedes every allocation.
+  static constexpr size_t kAlignment =
+      alignof(std::max_align_t) > 16 ? alignof(std::max_align_t) : 16;
+
+  /// Returns the size class for a layout, or `kNumSizeClasses` if memory with
+  /// the layout is not cached.
+  static size_t GetSizeClass(Layout layout);
+
+  /// Returns the size class of memory allocated by a `CachingAllocator`, or
+  /// `kNumSizeClasses` if the memory is not cached.
+  static size_t GetSizeClass(const void* ptr);
+
+  /// Returns the size of memory in a size class.
+  static constexpr size_t GetSize(size_t size_class) {
+    return kMinCachedSize << size_class;
+  }
+
+  /// Allocates up to `ptrs.size()` blocks of memory in the given size class
+  /// while holding the lock once, and returns how many were allocated.
+  size_t AllocateBatch(size_t size_class, span<void*> ptrs) {
+    return DoAllocateBatch(size_class, ptrs);
+  }
+
+  /// Deallocates blocks of memory while holding the lock once.
+  void DeallocateBatch(span<void* const> ptrs) { DoDeallocateBatch(ptrs); }
+
+ protected:
+  constexpr explicit CachingAllocatorBase(Allocator& allocator)
+      : Allocator(kCapabilities), allocator_(allocator) {}
+
+  // The following methods must only be called while holding the lock.
+
+  void* AllocateLocked(Layout layout);
+  void DeallocateLocked(void* ptr);
+  size_t AllocateBatchLocked(size_t size_class, span<void*> ptrs);
+  void DeallocateBatchLocked(span<void* const> ptrs);
+  bool ResizeLocked(void* ptr, size_t new_size);
+  Result<Layout> GetInfoLocked(InfoType info_type, const void* ptr) const;
+
+  /// Returns the layout of memory that can be queried without the lock, or
+  /// `UNIMPLEMENTED` if the lock is needed.
+  static Result<Layout> GetInfoUnlocked(InfoType info_type, const void* ptr);
+
+ private:
+  virtual size_t DoAllocateBatch(size_t size_class, span<void*> ptrs) = 0;
+  virtual void DoDeallocateBatch(span<void* const> ptrs) = 0;
+
+  Allocator& allocator_;
+};
+
+}  // namespace internal
+
+/// Wraps an `Allocator` with a lock, and lets threads cache freed memory.
+///
+/// A `CachingAllocator` may be used directly as a thread-safe allocator, just
+/// like a `SynchronizedAllocator`. In addition, each thread that allocates
+/// frequently can create its own `ThreadCache` that refers to it. A cache
+/// keeps a magazine of free blocks for each of a small number of size classes,
+/// and only takes the shared lock to refill or flush a magazine in batches.
+///
+/// Memory may be allocated with one cache and deallocated with another, or with
+/// the `CachingAllocator` itself.
+///
+/// Each allocation uses an additional `kAlignment` bytes of the wrapped
+/// allocator for a header, and cached allocations are rounded up to the next
+/// power of two.
+///
+/// @tparam LockType  The type of the lock used to synchronize allocator access.
+///                   Must be default-constructible.
+template <typename LockType>
+class CachingAllocator : public internal::CachingAllocatorBase {
+ public:
+  constexpr explicit CachingAllocator(Allocator& allocator)
+      : internal::CachingAllocatorBase(allocator) {}
+
+ private:
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override {
+    std::lock_guard lock(lock_);
+    return AllocateLocked(layout);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr) override {
+    std::lock_guard lock(lock_);
+    DeallocateLocked(ptr);
+  }
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, size_t new_size) override {
+    size_t size_class = GetSizeClass(ptr);
+    if (size_class != kNumSizeClasses) {
+      return new_size <= GetSize(size_class);
+    }
+    std::lock_guard lock(lock_);
+    return ResizeLocked(ptr, new_size);
+  }
+
+  /// @copydoc Deallocator::GetInfo
+  Result<Layout> DoGetInfo(InfoType info_type, const void* ptr) const override {
+    Result<Layout> result = GetInfoUnlocked(info_type, ptr);
+    if (result.status().IsUnimplemented()) {
+      std::lock_guard lock(lock_);
+      result = GetInfoLocked(info_type, ptr);
+    }
+    return result;
+  }
+
+  size_t DoAllocateBatch(size_t size_class, span<void*> ptrs) override {
+    std::lock_guard lock(lock_);
+    return AllocateBatchLocked(size_class, ptrs);
+  }
+
+  void DoDeallocateBatch(span<void* const> ptrs) override {
+    std::lock_guard lock(lock_);
+    DeallocateBatchLocked(ptrs);
+  }
+
+  mutable LockType lock_;
+};
+
+/// Caches memory freed by one thread so that it can reallocate it without
+/// taking the lock of a shared `CachingAllocator`.
+///
+/// A `ThreadCache` must only be used by one thread at a time. It keeps up to
+/// `kMagazineSize` free blocks of each size class. When a magazine is empty,
+/// the cache allocates half a magazine of blocks from the shared allocator at
+/// once. When a magazine is full, it returns half of its blocks. Any cached
+/// blocks are returned when the cache is destroyed.
+///
+/// @tparam kMagazineSize   Number of free blocks cached for each size class.
+/// @tparam MetricsType     The struct defining which metrics are enabled. The
+///                         `num_cache_hits` and `num_cache_misses` metrics
+///                         give the cache's hit rate.
+template <size_t kMagazineSize, typename MetricsType = NoMetrics>
+class ThreadCache : public Allocator {
+ private:
+  using Base = internal::CachingAllocatorBase;
+
+ public:
+  static_assert(kMagazineSize >= 2, "Magazines must hold at least 2 blocks");
+
+  ThreadCache(metric::Token token, Base& shared)
+      : Allocator(shared.capabilities()), shared_(shared), metrics_(token) {}
+
+  ~ThreadCache() { Flush(); }
+
+  const metric::Group& metric_group() const { return metrics_.group(); }
+  metric::Group& metric_group() { return metrics_.group(); }
+
+  const MetricsType& metrics() const { return metrics_.metrics(); }
+
+  /// Returns every cached block to the shared allocator.
+  void Flush() {
+    for (size_t size_class = 0; size_class < Base::kNumSizeClasses;
+         ++size_class) {
+      shared_.DeallocateBatch(magazine(size_class).first(counts_[size_class]));
+      counts_[size_class] = 0;
+    }
+  }
+
+ private:
+  static constexpr size_t kBatchSize = kMagazineSize / 2;
+
+  span<void*> magazine(size_t size_class) {
+    return span(magazines_).subspan(size_class * kMagazineSize, kMagazineSize);
+  }
+
+  /// @copydoc Allocator::Allocate
+  void* DoAllocate(Layout layout) override;
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr) override;
+
+  /// @copydoc Allocator::Deallocate
+  void DoDeallocate(void* ptr, Layout) override { DoDeallocate(ptr); }
+
+  /// @copydoc Allocator::Resize
+  bool DoResize(void* ptr, size_t new_size) override {
+    return shared_.Resize(ptr, new_size);
+  }
+
+  /// @copydoc Deallocator::GetInfo
+  Result<Layout> DoGetInfo(InfoType info_type, const void* ptr) const override {
+    return GetInfo(shared_, info_type, ptr);
+  }
+
+  Base& shared_;
+  std::array<void*, Base::kNumSizeClasses * kMagazineSize> magazines_{};
+  std::array<size_t, Base::kNumSizeClasses> counts_{};
+  internal::Metrics<MetricsType> metrics_;
+};
+
+// Template method implementations.
+
+template <size_t kMagazineSize, typename MetricsType>
+void* ThreadCache<kMagazineSize, MetricsType>::DoAllocate(Layout layout) {
+  size_t size_class = Base::GetSizeClass(layout);
+  void* ptr = nullptr;
+  if (size_class == Base::kNumSizeClasses) {
+    metrics_.IncrementCacheMisses();
+    ptr = shared_.Allocate(layout);
+
+  } else if (counts_[size_class] != 0) {
+    metrics_.IncrementCacheHits();
+    ptr = magazine(size_class)[--counts_[size_class]];
+
+  } else {
+    metrics_.IncrementCacheMisses();
+    size_t count = shared_.AllocateBatch(
+        size_class, magazine(size_class).first(kBatchSize));
+    if (count != 0) {
+      counts_[size_class] = count - 1;
+      ptr = magazine(size_class)[count - 1];
+    }
+  }
+  if (ptr == nullptr) {
+    metrics_.RecordFailure(layout.size());
+    return nullptr;
+  }
+  metrics_.IncrementAllocations();
+  return ptr;
+}
+
+template <size_t kMagazineSize, typename MetricsType>
+void ThreadCache<kMagazineSize, MetricsType>::DoDeallocate(void* ptr) {
+  metrics_.IncrementDeallocations();
+  size_t size_class = Base::GetSizeClass(ptr);
+  if (size_class == Base::kNumSizeClasses) {
+    shared_.Deallocate(ptr);
+    return;
+  }
+  size_t& count = counts_[size_class];
+  if (count == kMagazineSize) {
+    count -= kBatchSize;
+    shared_.DeallocateBatch(magazine(size_class).subspan(count, kBatchSize));
+  }
+  magazine(size_class)[count++] = ptr;
+}
+
+}  // namespace pw::allocator
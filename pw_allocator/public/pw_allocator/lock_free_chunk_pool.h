@@ -0,0 +1,104 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "pw_allocator/chunk_pool.h"
+#include "pw_allocator/layout.h"
+#include "pw_bytes/span.h"
+
+namespace pw::allocator {
+
+/// Implementation of ``ChunkPool`` that can be shared between threads and
+/// interrupt handlers without a lock.
+///
+/// Free chunks form a Treiber stack, i.e. a singly-linked list whose head is
+/// updated using compare-and-swap. The first ``sizeof(void*)`` bytes of each
+/// free chunk store the index of the next free chunk. The head stores both the
+/// index of the first free chunk and a tag that is incremented by every
+/// update. This prevents the "ABA problem", where a thread that is preempted
+/// while popping a chunk could otherwise restore a stale head if other
+/// contexts popped and pushed chunks in the meantime.
+///
+/// The index and tag share a single word, so that only word-sized atomic
+/// operations are needed. As a result:
+///
+/// * The pool can have at most ``kMaxChunks`` chunks.
+/// * An ABA failure is still possible, but only if a thread is preempted while
+///   allocating for exactly a multiple of ``2^(kTagBits)`` other updates.
+///
+/// ``Allocate`` and ``Deallocate`` never block, and are safe to call from
+/// interrupt handlers, provided ``std::atomic<uintptr_t>`` is lock-free on the
+/// target. This is the case on Arm Cortex-M3 and later, and on hosts. They
+/// are not wait-free: an update may be retried if it races with another.
+///
+/// This pool can be used with ``TypedPool``, e.g.
+/// ``TypedPool<MyObject, LockFreeChunkPool>``.
+class LockFreeChunkPool : public ChunkPool {
+ private:
+  static constexpr size_t kWordBits = std::numeric_limits<uintptr_t>::digits;
+
+ public:
+  /// Number of bits of the head used to store the index of a chunk.
+  static constexpr size_t kIndexBits = kWordBits / 2;
+
+  /// Number of bits of the head used to store the ABA tag.
+  static constexpr size_t kTagBits = kWordBits - kIndexBits;
+
+  /// Largest number of chunks a pool can have.
+  static constexpr size_t kMaxChunks = (uintptr_t(1) << kIndexBits) - 1;
+
+  /// Construct a `Pool` that allocates from a region of memory.
+  ///
+  /// @param  region      The memory to allocate from. Must be large enough to
+  ///                     allocate at least one chunk with the given layout,
+  ///                     and small enough to have at most ``kMaxChunks``.
+  /// @param  layout      The size and alignment of the memory to be returned
+  ///                     from this pool.
+  LockFreeChunkPool(ByteSpan region, const Layout& layout);
+
+ private:
+  /// Index used to indicate the end of the free list.
+  static constexpr uintptr_t kNone = kMaxChunks;
+  static constexpr uintptr_t kIndexMask = kMaxChunks;
+
+  static constexpr uintptr_t GetIndex(uintptr_t head) {
+    return head & kIndexMask;
+  }
+
+  /// Returns a new head with the given index, and the incremented tag of the
+  /// given head.
+  static constexpr uintptr_t MakeHead(uintptr_t head, uintptr_t index) {
+    return (((head >> kIndexBits) + 1) << kIndexBits) | index;
+  }
+
+  /// Returns the link stored in the free chunk with the given index.
+  std::atomic<uintptr_t>& GetLink(uintptr_t index) const;
+
+  /// @copydoc Pool::Allocate
+  void* DoAllocate() override;
+
+  /// @copydoc Deallocator::Deallocate
+  void DoDeallocate(void* ptr) override;
+
+  std::byte* chunks_;
+  size_t chunk_size_;
+  std::atomic<uintptr_t> head_;
+};
+
+}  // namespace pw::allocator
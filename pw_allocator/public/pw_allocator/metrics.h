@@ -61,6 +61,11 @@ PW_ALLOCATOR_METRICS_DECLARE(num_reallocations);
 PW_ALLOCATOR_METRICS_DECLARE(num_failures);
 PW_ALLOCATOR_METRICS_DECLARE(unfulfilled_bytes);
 
+// Tracks the number of allocations that a caching allocator satisfied from its
+// cache, and the number that it had to pass on to the allocator behind it.
+PW_ALLOCATOR_METRICS_DECLARE(num_cache_hits);
+PW_ALLOCATOR_METRICS_DECLARE(num_cache_misses);
+
 #undef PW_ALLOCATOR_METRICS_DECLARE
 
 /// Enables a metric for in a metrics struct.
@@ -110,6 +115,8 @@ struct AllMetrics {
   PW_ALLOCATOR_METRICS_ENABLE(num_reallocations);
   PW_ALLOCATOR_METRICS_ENABLE(num_failures);
   PW_ALLOCATOR_METRICS_ENABLE(unfulfilled_bytes);
+  PW_ALLOCATOR_METRICS_ENABLE(num_cache_hits);
+  PW_ALLOCATOR_METRICS_ENABLE(num_cache_misses);
 };
 
 /// Encapsulates the metrics struct for ``pw::allocator::TrackingAllocator``.
@@ -177,6 +184,12 @@ class Metrics final {
   ///                           call.
   void RecordFailure(size_t requested);
 
+  /// Records that an allocation was satisfied from a cache.
+  void IncrementCacheHits();
+
+  /// Records that an allocation could not be satisfied from a cache.
+  void IncrementCacheMisses();
+
  private:
   metric::Group group_;
   MetricsType metrics_;
@@ -228,6 +241,12 @@ Metrics<MetricsType>::Metrics(metric::Token token) : group_(token) {
   if constexpr (has_unfulfilled_bytes<MetricsType>::value) {
     group_.Add(metrics_.unfulfilled_bytes);
   }
+  if constexpr (has_num_cache_hits<MetricsType>::value) {
+    group_.Add(metrics_.num_cache_hits);
+  }
+  if constexpr (has_num_cache_misses<MetricsType>::value) {
+    group_.Add(metrics_.num_cache_misses);
+  }
 }
 
 template <typename MetricsType>
@@ -308,5 +327,19 @@ void Metrics<MetricsType>::RecordFailure(size_t requested) {
   }
 }
 
+template <typename MetricsType>
+void Metrics<MetricsType>::IncrementCacheHits() {
+  if constexpr (has_num_cache_hits<MetricsType>::value) {
+    metrics_.num_cache_hits.Increment();
+  }
+}
+
+template <typename MetricsType>
+void Metrics<MetricsType>::IncrementCacheMisses() {
+  if constexpr (has_num_cache_misses<MetricsType>::value) {
+    metrics_.num_cache_misses.Increment();
+  }
+}
+
 }  // namespace internal
 }  // namespace pw::allocator
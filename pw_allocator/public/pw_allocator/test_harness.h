@@ -14,11 +14,13 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <variant>
 
 #include "pw_allocator/allocator.h"
 #include "pw_containers/vector.h"
 #include "pw_random/random.h"
+#include "pw_thread/thread_core.h"
 
 namespace pw::allocator::test {
 
@@ -183,4 +185,35 @@ class TestHarness : public TestHarnessGeneric {
   Vector<Allocation, kMaxConcurrentAllocations> allocations_;
 };
 
+/// Thread body that handles a sequence of randomly generated requests.
+///
+/// Running several of these on concurrent threads models a multi-threaded
+/// workload, e.g. to benchmark how allocators behave under contention. Each
+/// thread must have its own test harness. The harnesses may share a
+/// thread-safe allocator, or may each use a per-thread allocator such as a
+/// `ThreadCache`.
+class GenerateRequestsThreadCore : public thread::ThreadCore {
+ public:
+  /// @param  harness       Test harness used to handle requests.
+  /// @param  seed          Seed for the requests' PRNG.
+  /// @param  max_size      Maximum size of generated allocation requests.
+  /// @param  num_requests  Number of requests to generate.
+  constexpr GenerateRequestsThreadCore(TestHarnessGeneric& harness,
+                                       uint64_t seed,
+                                       size_t max_size,
+                                       size_t num_requests)
+      : harness_(harness),
+        seed_(seed),
+        max_size_(max_size),
+        num_requests_(num_requests) {}
+
+ private:
+  void Run() override;
+
+  TestHarnessGeneric& harness_;
+  uint64_t seed_;
+  size_t max_size_;
+  size_t num_requests_;
+};
+
 }  // namespace pw::allocator::test
@@ -0,0 +1,428 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_allocator/block_allocator_base.h"
+#include "pw_bytes/alignment.h"
+
+namespace pw::allocator {
+namespace internal {
+
+/// Links a free block into one of the free lists of a `TlsfBlockAllocator`.
+///
+/// A node is stored in the usable space of each free block that is large
+/// enough to hold it.
+struct TlsfFreeNode {
+  TlsfFreeNode* prev;
+  TlsfFreeNode* next;
+};
+
+}  // namespace internal
+
+/// Block allocator that uses a "two-level segregated fit" (TLSF) strategy.
+///
+/// In this strategy, free blocks are kept in one of many free lists according
+/// to their size. The first level divides sizes into powers of two, and the
+/// second level divides each power of two into `2^kSecondLevelBits` equally
+/// sized ranges. A pair of bitmaps records which lists are not empty.
+///
+/// The allocator handles an allocation request by rounding the requested size
+/// up to the start of the next size range, and using the bitmaps to find the
+/// first non-empty list for that range or a larger one. Any block from that
+/// list is large enough, so the allocator takes the first one. If no larger
+/// block is available, it searches the list for the requested size itself.
+/// Freed blocks are merged with their free neighbors and added to the front of
+/// a list. As a result, both allocation and deallocation take constant time,
+/// regardless of the number of blocks.
+///
+/// Since sizes are rounded up by at most one range, the memory wasted by
+/// choosing a larger block than needed is bounded by a fraction of
+/// `2^-kSecondLevelBits` of the requested size.
+///
+/// As an example, with 2 second level bits, the lists for blocks between 64
+/// and 255 bytes may look like the following:
+///
+/// @code{.unparsed}
+/// list[ 64.. 79] --> NULL
+/// list[ 80.. 95] --> block[80B] --> block[88B] --> NULL
+/// list[ 96..111] --> NULL
+/// list[112..127] --> block[120B] --> NULL
+/// list[128..159] --> NULL
+/// list[160..191] --> block[176B] --> NULL
+/// list[192..223] --> NULL
+/// list[224..255] --> NULL
+/// @endcode
+///
+/// A request for 81 bytes is rounded up to 96, and is satisfied by the block
+/// of 120 bytes.
+///
+/// This allocator does not support poisoning free blocks, as free blocks hold
+/// the links for their lists.
+///
+/// `allocator_perf_test.cc` compares this allocator's latency and
+/// fragmentation with the other allocators in this module.
+///
+/// @tparam OffsetType        Unsigned integral type used to store offsets
+///                           between blocks.
+/// @tparam kNumFirstLevels   Number of power-of-two size ranges. Blocks larger
+///                           than `kMaxSegregatedSize` all share the last list.
+///                           Must be at most 32.
+/// @tparam kSecondLevelBits  Log2 of the number of lists per power of two.
+///                           Must be at most 5.
+/// @tparam kAlign            Minimum alignment of blocks.
+template <typename OffsetType = uintptr_t,
+          size_t kNumFirstLevels = 16,
+          size_t kSecondLevelBits = 3,
+          size_t kAlign = std::max(alignof(OffsetType), alignof(std::byte*))>
+class TlsfBlockAllocator
+    : public BlockAllocator<OffsetType,
+                            0,
+                            std::max(kAlign, alignof(std::byte*))> {
+ public:
+  using Base =
+      BlockAllocator<OffsetType, 0, std::max(kAlign, alignof(std::byte*))>;
+  using BlockType = typename Base::BlockType;
+
+  static_assert(kNumFirstLevels != 0 && kNumFirstLevels <= 32,
+                "The first level must have between 1 and 32 size ranges");
+  static_assert(kSecondLevelBits <= 5,
+                "The second level must have at most 32 lists per range");
+  static_assert(kNumFirstLevels + kSecondLevelBits <=
+                    std::numeric_limits<size_t>::digits,
+                "Size ranges exceed the range of size_t");
+
+  /// Number of lists per power-of-two size range.
+  static constexpr size_t kNumSecondLevels = size_t(1) << kSecondLevelBits;
+
+  /// Total number of free lists.
+  static constexpr size_t kNumLists = kNumFirstLevels * kNumSecondLevels;
+
+  /// Smallest block size that is not segregated from other large blocks.
+  static constexpr size_t kMaxSegregatedSize = size_t(1)
+                                               << (kNumFirstLevels +
+                                                   kSecondLevelBits - 1);
+
+  /// Constexpr constructor. Callers must explicitly call `Init`.
+  constexpr TlsfBlockAllocator() : Base() {}
+
+  /// Non-constexpr constructor that automatically calls `Init`.
+  ///
+  /// @param[in]  region  Region of memory to use when satisfying allocation
+  ///                     requests. The region MUST be large enough to fit an
+  ///                     aligned block with overhead. It MUST NOT be larger
+  ///                     than what is addressable by `OffsetType`.
+  explicit TlsfBlockAllocator(ByteSpan region) : TlsfBlockAllocator() {
+    Base::Init(region);
+  }
+
+  /// @copydoc BlockAllocator::Init
+  void Init(ByteSpan region) { Base::Init(region); }
+
+  /// @copydoc BlockAllocator::Init
+  void Init(BlockType* begin) { Base::Init(begin); }
+
+  /// @copydoc BlockAllocator::Init
+  void Init(BlockType* begin, BlockType* end) override {
+    Base::Init(begin, end);
+    first_level_bitmap_ = 0;
+    second_level_bitmaps_.fill(0);
+    lists_.fill(nullptr);
+    for (auto* block : Base::blocks()) {
+      if (!block->Used()) {
+        RecycleBlock(block);
+      }
+    }
+  }
+
+  /// Returns the index of the free list that holds blocks with the given
+  /// inner size.
+  static constexpr size_t GetListIndex(size_t size) {
+    if (size >= kMaxSegregatedSize) {
+      return kNumLists - 1;
+    }
+    if (size < kNumSecondLevels) {
+      return size;
+    }
+    // Each power of two after the first is split into `kNumSecondLevels`
+    // ranges. Conveniently, this makes the list index for sizes less than
+    // `2 * kNumSecondLevels` equal to the size itself.
+    size_t shift = cpp20::bit_width(size) - 1 - kSecondLevelBits;
+    return (shift + 1) * kNumSecondLevels + (size >> shift) - kNumSecondLevels;
+  }
+
+ private:
+  using FreeNode = internal::TlsfFreeNode;
+
+  /// Returns the smallest inner size of a block that can satisfy a request,
+  /// or 0 if no block can.
+  static size_t GetRequiredSize(Layout layout);
+
+  /// Returns the index of the first list whose blocks are all at least as
+  /// large as the given size.
+  static size_t GetSearchIndex(size_t size);
+
+  /// Returns the index of the first non-empty list at or after the given
+  /// index, or `kNumLists` if there is none.
+  size_t FindList(size_t index) const;
+
+  /// Tries to allocate a block from a list.
+  ///
+  /// If `search` is false, only the first block in the list is considered.
+  /// Otherwise, every block in the list is tried in turn.
+  BlockType* AllocateFromList(size_t index, Layout layout, bool search);
+
+  /// Returns whether a block is large enough to be kept in a free list.
+  static bool IsListable(const BlockType* block) {
+    return block->InnerSize() >= sizeof(FreeNode);
+  }
+
+  static FreeNode* ToNode(BlockType* block) {
+    return std::launder(reinterpret_cast<FreeNode*>(block->UsableSpace()));
+  }
+
+  static BlockType* ToBlock(FreeNode* node) {
+    return BlockType::FromUsableSpace(reinterpret_cast<std::byte*>(node));
+  }
+
+  /// @copydoc BlockAllocator::ChooseBlock
+  BlockType* ChooseBlock(Layout layout) override;
+
+  /// @copydoc BlockAllocator::ReserveBlock
+  void ReserveBlock(BlockType* block) override;
+
+  /// @copydoc BlockAllocator::RecycleBlock
+  void RecycleBlock(BlockType* block) override;
+
+  uint32_t first_level_bitmap_ = 0;
+  std::array<uint32_t, kNumFirstLevels> second_level_bitmaps_{};
+  std::array<FreeNode*, kNumLists> lists_{};
+};
+
+// Template method implementations
+
+template <typename OffsetType,
+          size_t kNumFirstLevels,
+          size_t kSecondLevelBits,
+          size_t kAlign>
+size_t TlsfBlockAllocator<OffsetType,
+                          kNumFirstLevels,
+                          kSecondLevelBits,
+                          kAlign>::GetRequiredSize(Layout layout) {
+  // Blocks are aligned to `kAlignment`. Allocating with a larger alignment may
+  // need to skip up to `alignment - kAlignment` bytes to find an aligned
+  // address.
+  size_t size = AlignUp(layout.size(), BlockType::kAlignment);
+  size_t padding = 0;
+  if (layout.alignment() > BlockType::kAlignment) {
+    padding = layout.alignment() - BlockType::kAlignment;
+  }
+  if (size < layout.size() ||
+      size > std::numeric_limits<size_t>::max() - padding) {
+    return 0;
+  }
+  return std::max(size + padding, size_t(1));
+}
+
+template <typename OffsetType,
+          size_t kNumFirstLevels,
+          size_t kSecondLevelBits,
+          size_t kAlign>
+size_t TlsfBlockAllocator<OffsetType,
+                          kNumFirstLevels,
+                          kSecondLevelBits,
+                          kAlign>::GetSearchIndex(size_t size) {
+  size_t index = GetListIndex(size);
+  if (size < kNumSecondLevels * 2 || index == kNumLists - 1) {
+    return index;
+  }
+  // Sizes within a range all share a list. Unless the size is the smallest in
+  // its range, the blocks of its own list may be too small.
+  size_t shift = cpp20::bit_width(size) - 1 - kSecondLevelBits;
+  size_t mask = (size_t(1) << shift) - 1;
+  return (size & mask) == 0 ? index : index + 1;
+}
+
+template <typename OffsetType,
+          size_t kNumFirstLevels,
+          size_t kSecondLevelBits,
+          size_t kAlign>
+size_t
+TlsfBlockAllocator<OffsetType, kNumFirstLevels, kSecondLevelBits, kAlign>::
+    FindList(size_t index) const {
+  if (index >= kNumLists) {
+    return kNumLists;
+  }
+  size_t first_level = index / kNumSecondLevels;
+  size_t second_level = index % kNumSecondLevels;
+  uint32_t bitmap =
+      second_level_bitmaps_[first_level] & (~uint32_t(0) << second_level);
+  if (bitmap == 0) {
+    if (first_level + 1 >= kNumFirstLevels) {
+      return kNumLists;
+    }
+    uint32_t first_level_bitmap =
+        first_level_bitmap_ & (~uint32_t(0) << (first_level + 1));
+    if (first_level_bitmap == 0) {
+      return kNumLists;
+    }
+    first_level = cpp20::countr_zero(first_level_bitmap);
+    bitmap = second_level_bitmaps_[first_level];
+  }
+  return first_level * kNumSecondLevels + cpp20::countr_zero(bitmap);
+}
+
+template <typename OffsetType,
+          size_t kNumFirstLevels,
+          size_t kSecondLevelBits,
+          size_t kAlign>
+typename TlsfBlockAllocator<OffsetType,
+                            kNumFirstLevels,
+                            kSecondLevelBits,
+                            kAlign>::BlockType*
+TlsfBlockAllocator<OffsetType, kNumFirstLevels, kSecondLevelBits, kAlign>::
+    ChooseBlock(Layout layout) {
+  size_t size = GetRequiredSize(layout);
+  if (size == 0) {
+    return nullptr;
+  }
+
+  // Every block in lists after the search index is large enough, so only the
+  // first block of each needs to be tried. This normally succeeds on the first
+  // list found. Blocks in the last list may be of any large size, and so
+  // must be searched.
+  size_t search_index = GetSearchIndex(size);
+  for (size_t index = FindList(search_index); index < kNumLists;
+       index = FindList(index + 1)) {
+    bool search = index == kNumLists - 1;
+    BlockType* block = AllocateFromList(index, layout, search);
+    if (block != nullptr) {
+      return block;
+    }
+  }
+
+  // Fall back to searching the list for the requested size itself, which may
+  // contain blocks that are large enough.
+  size_t index = GetListIndex(size);
+  if (index != search_index) {
+    return AllocateFromList(index, layout, /* search: */ true);
+  }
+  return nullptr;
+}
+
+template <typename OffsetType,
+          size_t kNumFirstLevels,
+          size_t kSecondLevelBits,
+          size_t kAlign>
+typename TlsfBlockAllocator<OffsetType,
+                            kNumFirstLevels,
+                            kSecondLevelBits,
+                            kAlign>::BlockType*
+TlsfBlockAllocator<OffsetType, kNumFirstLevels, kSecondLevelBits, kAlign>::
+    AllocateFromList(size_t index, Layout layout, bool search) {
+  FreeNode* next = nullptr;
+  for (FreeNode* node = lists_[index]; node != nullptr; node = next) {
+    next = node->next;
+    BlockType* block = ToBlock(node);
+
+    // Allocating may overwrite the node, so remove it first. On failure, the
+    // block is unmodified and can simply be returned to its list.
+    ReserveBlock(block);
+    if (!BlockType::AllocFirst(block, layout).ok()) {
+      RecycleBlock(block);
+      if (!search) {
+        break;
+      }
+      continue;
+    }
+
+    // Allocating may have split free blocks off either end of the block.
+    BlockType* prev = block->Prev();
+    if (prev != nullptr && !prev->Used()) {
+      RecycleBlock(prev);
+    }
+    if (!block->Last() && !block->Next()->Used()) {
+      RecycleBlock(block->Next());
+    }
+    return block;
+  }
+  return nullptr;
+}
+
+template <typename OffsetType,
+          size_t kNumFirstLevels,
+          size_t kSecondLevelBits,
+          size_t kAlign>
+void TlsfBlockAllocator<OffsetType,
+                        kNumFirstLevels,
+                        kSecondLevelBits,
+                        kAlign>::ReserveBlock(BlockType* block) {
+  // Free blocks that are too small to be added to lists will be "garbage
+  // collected" by merging them with their neighbors when the latter are freed.
+  if (!IsListable(block)) {
+    return;
+  }
+  FreeNode* node = ToNode(block);
+  if (node->next != nullptr) {
+    node->next->prev = node->prev;
+  }
+  if (node->prev != nullptr) {
+    node->prev->next = node->next;
+    return;
+  }
+  size_t index = GetListIndex(block->InnerSize());
+  lists_[index] = node->next;
+  if (node->next != nullptr) {
+    return;
+  }
+  size_t first_level = index / kNumSecondLevels;
+  size_t second_level = index % kNumSecondLevels;
+  second_level_bitmaps_[first_level] &= ~(uint32_t(1) << second_level);
+  if (second_level_bitmaps_[first_level] == 0) {
+    first_level_bitmap_ &= ~(uint32_t(1) << first_level);
+  }
+}
+
+template <typename OffsetType,
+          size_t kNumFirstLevels,
+          size_t kSecondLevelBits,
+          size_t kAlign>
+void TlsfBlockAllocator<OffsetType,
+                        kNumFirstLevels,
+                        kSecondLevelBits,
+                        kAlign>::RecycleBlock(BlockType* block) {
+  if (!IsListable(block)) {
+    return;
+  }
+  size_t index = GetListIndex(block->InnerSize());
+  FreeNode* head = lists_[index];
+  auto* node = ::new (block->UsableSpace()) FreeNode{nullptr, head};
+  if (head != nullptr) {
+    head->prev = node;
+  }
+  lists_[index] = node;
+  size_t first_level = index / kNumSecondLevels;
+  size_t second_level = index % kNumSecondLevels;
+  second_level_bitmaps_[first_level] |= uint32_t(1) << second_level;
+  first_level_bitmap_ |= uint32_t(1) << first_level;
+}
+
+}  // namespace pw::allocator
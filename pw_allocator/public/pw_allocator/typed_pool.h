@@ -14,6 +14,7 @@
 #pragma once
 
 #include <cstddef>
+#include <type_traits>
 
 #include "pw_allocator/allocator.h"
 #include "pw_allocator/chunk_pool.h"
@@ -30,10 +31,18 @@ namespace pw::allocator {
 /// dispatcher might use such an allocator to manage memory for a set of task
 /// objects.
 ///
-/// @tparam   T   The type of object to allocate memory for.
-template <typename T>
-class TypedPool : public ChunkPool {
+/// By default, the pool is not thread-safe. To share the pool between threads
+/// and interrupt handlers without a lock, use ``LockFreeChunkPool`` as the
+/// ``PoolType``.
+///
+/// @tparam   T         The type of object to allocate memory for.
+/// @tparam   PoolType  The ``ChunkPool`` implementation to use.
+template <typename T, typename PoolType = ChunkPool>
+class TypedPool : public PoolType {
  public:
+  static_assert(std::is_base_of_v<ChunkPool, PoolType>,
+                "PoolType must be a ChunkPool");
+
   /// Returns the amount of memory needed to allocate ``num_objects``.
   static constexpr size_t SizeNeeded(size_t num_objects) {
     size_t needed = std::max(sizeof(T), ChunkPool::kMinSize);
@@ -67,7 +76,7 @@ class TypedPool : public ChunkPool {
   /// @param  buffer  The memory to allocate from.
   template <size_t kNumObjects>
   TypedPool(Buffer<kNumObjects>& buffer)
-      : ChunkPool(buffer.data, Layout::Of<T>()) {}
+      : PoolType(buffer.data, Layout::Of<T>()) {}
 
   /// Construct a ``TypedPool``.
   ///
@@ -81,7 +90,7 @@ class TypedPool : public ChunkPool {
   ///
   /// @param  region  The memory to allocate from. Must be large enough to
   ///                 allocate memory for at least one object.
-  TypedPool(ByteSpan region) : ChunkPool(region, Layout::Of<T>()) {}
+  TypedPool(ByteSpan region) : PoolType(region, Layout::Of<T>()) {}
 
   /// Constructs and object from the given `args`
   ///
@@ -91,7 +100,7 @@ class TypedPool : public ChunkPool {
   /// @param[in]  args...     Arguments passed to the object constructor.
   template <int&... ExplicitGuard, typename... Args>
   T* New(Args&&... args) {
-    void* ptr = Allocate();
+    void* ptr = this->Allocate();
     return ptr != nullptr ? new (ptr) T(std::forward<Args>(args)...) : nullptr;
   }
 
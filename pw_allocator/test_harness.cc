@@ -21,6 +21,7 @@
 
 #include "lib/stdcompat/bit.h"
 #include "pw_assert/check.h"
+#include "pw_random/xor_shift.h"
 
 namespace pw::allocator::test {
 namespace {
@@ -196,4 +197,9 @@ TestHarnessGeneric::Allocation TestHarnessGeneric::RemoveAllocation(
   return old;
 }
 
+void GenerateRequestsThreadCore::Run() {
+  random::XorShiftStarRng64 prng(seed_);
+  harness_.GenerateRequests(prng, max_size_, num_requests_);
+}
+
 }  // namespace pw::allocator::test
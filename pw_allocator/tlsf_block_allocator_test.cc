@@ -0,0 +1,259 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_allocator/tlsf_block_allocator.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_allocator/block_allocator_testing.h"
+#include "pw_allocator/test_harness.h"
+#include "pw_random/xor_shift.h"
+#include "pw_unit_test/framework.h"
+
+namespace {
+
+// Test fixtures.
+
+constexpr size_t kNumFirstLevels = 8;
+constexpr size_t kSecondLevelBits = 2;
+
+using ::pw::allocator::Layout;
+using ::pw::allocator::test::Preallocation;
+using TlsfBlockAllocator =
+    ::pw::allocator::TlsfBlockAllocator<uint16_t,
+                                        kNumFirstLevels,
+                                        kSecondLevelBits>;
+using BlockAllocatorTest =
+    ::pw::allocator::test::BlockAllocatorTest<TlsfBlockAllocator>;
+
+class TlsfBlockAllocatorTest : public BlockAllocatorTest {
+ public:
+  TlsfBlockAllocatorTest() : BlockAllocatorTest(allocator_) {}
+
+ private:
+  TlsfBlockAllocator allocator_;
+};
+
+// Unit tests.
+
+TEST(TlsfBlockAllocatorIndexTest, GetListIndex) {
+  // Sizes less than twice the number of lists per range map to themselves.
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(0), 0U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(3), 3U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(7), 7U);
+
+  // Each larger power of two is split into 4 ranges.
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(8), 8U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(9), 8U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(10), 9U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(15), 11U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(64), 20U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(79), 20U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(80), 21U);
+
+  // Large sizes share the last list.
+  constexpr size_t kMax = TlsfBlockAllocator::kMaxSegregatedSize;
+  EXPECT_EQ(kMax, 512U);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(kMax - 1),
+            TlsfBlockAllocator::kNumLists - 1);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(kMax),
+            TlsfBlockAllocator::kNumLists - 1);
+  EXPECT_EQ(TlsfBlockAllocator::GetListIndex(kMax * 4),
+            TlsfBlockAllocator::kNumLists - 1);
+}
+
+TEST_F(TlsfBlockAllocatorTest, CanAutomaticallyInit) {
+  TlsfBlockAllocator allocator(GetBytes());
+  CanAutomaticallyInit(allocator);
+}
+
+TEST_F(TlsfBlockAllocatorTest, CanExplicitlyInit) {
+  TlsfBlockAllocator allocator;
+  CanExplicitlyInit(allocator);
+}
+
+TEST_F(TlsfBlockAllocatorTest, GetCapacity) { GetCapacity(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateLarge) { AllocateLarge(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateSmall) { AllocateSmall(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateTooLarge) { AllocateTooLarge(); }
+
+TEST_F(TlsfBlockAllocatorTest, AllocateLargeAlignment) {
+  AllocateLargeAlignment();
+}
+
+TEST_F(TlsfBlockAllocatorTest, AllocateAlignmentFailure) {
+  AllocateAlignmentFailure();
+}
+
+TEST_F(TlsfBlockAllocatorTest, AllocatesFromLargerList) {
+  // Start with everything allocated in order to recycle blocks into lists.
+  auto& allocator = GetAllocator({
+      {kSmallerOuterSize, 0},
+      {88 + BlockType::kBlockOverhead, 1},
+      {kSmallerOuterSize, 2},
+      {120 + BlockType::kBlockOverhead, 3},
+      {kSmallerOuterSize, 4},
+      {Preallocation::kSizeRemaining, 5},
+  });
+
+  void* ptr88 = Fetch(1);
+  Store(1, nullptr);
+  allocator.Deallocate(ptr88);
+
+  void* ptr120 = Fetch(3);
+  Store(3, nullptr);
+  allocator.Deallocate(ptr120);
+
+  // The list for 80 to 95 bytes holds a block of 88 bytes, but it is not
+  // guaranteed to fit 84 bytes. The next non-empty list is used instead.
+  Store(3, allocator.Allocate(Layout(84, 1)));
+  EXPECT_EQ(Fetch(3), ptr120);
+
+  // Requests that exactly match the start of a range can use its list.
+  Store(1, allocator.Allocate(Layout(80, 1)));
+  EXPECT_EQ(Fetch(1), ptr88);
+}
+
+TEST_F(TlsfBlockAllocatorTest, AllocatesFromOwnListAsLastResort) {
+  auto& allocator = GetAllocator({
+      {kSmallerOuterSize, 0},
+      {88 + BlockType::kBlockOverhead, 1},
+      {Preallocation::kSizeRemaining, 2},
+  });
+
+  void* ptr = Fetch(1);
+  Store(1, nullptr);
+  allocator.Deallocate(ptr);
+
+  // No larger block is available, but the block in the request's own list is
+  // large enough.
+  Store(1, allocator.Allocate(Layout(84, 1)));
+  EXPECT_EQ(Fetch(1), ptr);
+}
+
+TEST_F(TlsfBlockAllocatorTest, SplitsTrailingBlockIntoList) {
+  auto& allocator = GetAllocator({
+      {kSmallerOuterSize, 0},
+      {256 + BlockType::kBlockOverhead, 1},
+      {Preallocation::kSizeRemaining, 2},
+  });
+
+  void* ptr = Fetch(1);
+  Store(1, nullptr);
+  allocator.Deallocate(ptr);
+
+  // The first allocation splits the free block, and the remainder is used to
+  // satisfy the second.
+  Store(1, allocator.Allocate(Layout(64, 1)));
+  EXPECT_EQ(Fetch(1), ptr);
+  auto* block = BlockType::FromUsableSpace(Fetch(1));
+  void* next = block->Next()->UsableSpace();
+  Store(3, allocator.Allocate(Layout(64, 1)));
+  EXPECT_EQ(Fetch(3), next);
+}
+
+TEST_F(TlsfBlockAllocatorTest, MergesFreeNeighbors) {
+  auto& allocator = GetAllocator({
+      {kLargeOuterSize, 0},
+      {kLargeOuterSize, 1},
+      {kLargeOuterSize, 2},
+      {Preallocation::kSizeRemaining, 3},
+  });
+
+  // Free the outer blocks first, then the one between them. The blocks should
+  // merge into one, and none of their old list entries should remain.
+  void* ptr0 = Fetch(0);
+  for (size_t index : std::array<size_t, 3>{0, 2, 1}) {
+    void* ptr = Fetch(index);
+    Store(index, nullptr);
+    allocator.Deallocate(ptr);
+  }
+
+  size_t merged_size = kLargeOuterSize * 3 - BlockType::kBlockOverhead;
+  Store(0, allocator.Allocate(Layout(merged_size, 1)));
+  EXPECT_EQ(Fetch(0), ptr0);
+  Store(1, allocator.Allocate(Layout(kLargeInnerSize, 1)));
+  EXPECT_EQ(Fetch(1), nullptr);
+}
+
+TEST_F(TlsfBlockAllocatorTest, DeallocateNull) { DeallocateNull(); }
+
+TEST_F(TlsfBlockAllocatorTest, DeallocateShuffled) { DeallocateShuffled(); }
+
+TEST_F(TlsfBlockAllocatorTest, IterateOverBlocks) { IterateOverBlocks(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeNull) { ResizeNull(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeSame) { ResizeLargeSame(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeSmaller) { ResizeLargeSmaller(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeLarger) { ResizeLargeLarger(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeLargeLargerFailure) {
+  ResizeLargeLargerFailure();
+}
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallSame) { ResizeSmallSame(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallSmaller) { ResizeSmallSmaller(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallLarger) { ResizeSmallLarger(); }
+
+TEST_F(TlsfBlockAllocatorTest, ResizeSmallLargerFailure) {
+  ResizeSmallLargerFailure();
+}
+
+TEST_F(TlsfBlockAllocatorTest, CanMeasureFragmentation) {
+  CanMeasureFragmentation();
+}
+
+// Handles random requests and checks that, afterwards, all memory can be
+// allocated again at once. This only succeeds if every free block was merged
+// correctly and none were lost from the free lists.
+TEST(TlsfBlockAllocatorHarnessTest, GenerateRequests) {
+  constexpr size_t kCapacity = 8192;
+  constexpr size_t kMaxSize = 512;
+  constexpr size_t kNumRequests = 5000;
+
+  struct Harness : public ::pw::allocator::test::TestHarness<64> {
+    ::pw::Allocator* Init() override { return &allocator; }
+    TlsfBlockAllocator allocator;
+  };
+
+  using BlockType = TlsfBlockAllocator::BlockType;
+  alignas(BlockType::kAlignment) std::array<std::byte, kCapacity> buffer;
+  Harness harness;
+  harness.allocator.Init(buffer);
+  pw::random::XorShiftStarRng64 prng(1);
+  harness.GenerateRequests(prng, kMaxSize, kNumRequests);
+
+  size_t num_blocks = 0;
+  for (auto* block : harness.allocator.blocks()) {
+    EXPECT_FALSE(block->Used());
+    ++num_blocks;
+  }
+  EXPECT_EQ(num_blocks, 1U);
+  auto* block = *harness.allocator.blocks().begin();
+  void* ptr = harness.allocator.Allocate(Layout(block->InnerSize(), 1));
+  EXPECT_NE(ptr, nullptr);
+  harness.allocator.Deallocate(ptr);
+}
+
+}  // namespace
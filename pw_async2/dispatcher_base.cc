@@ -125,17 +125,25 @@ void Waker::RemoveFromTaskWakerListLocked() {
 
 void DispatcherBase::Deregister() {
   std::lock_guard lock(dispatcher_lock());
-  UnpostTaskList(first_woken_);
-  first_woken_ = nullptr;
-  last_woken_ = nullptr;
+  UnpostTaskList(woken_.first);
+  woken_ = RunQueue();
   UnpostTaskList(sleeping_);
   sleeping_ = nullptr;
+  while (workers_ != nullptr) {
+    WorkerBase& worker = *workers_;
+    workers_ = worker.next_;
+    UnpostTaskList(worker.queue_.first);
+    worker.queue_ = RunQueue();
+    worker.dispatcher_ = nullptr;
+    worker.next_ = nullptr;
+  }
 }
 
 void DispatcherBase::UnpostTaskList(Task* task) {
   while (task != nullptr) {
     task->state_ = Task::State::kUnposted;
     task->dispatcher_ = nullptr;
+    task->worker_ = nullptr;
     task->prev_ = nullptr;
     Task* next = task->next_;
     task->next_ = nullptr;
@@ -155,31 +163,66 @@ void DispatcherBase::RemoveTaskFromList(Task& task) {
   task.next_ = nullptr;
 }
 
-void DispatcherBase::RemoveWokenTaskLocked(Task& task) {
+void DispatcherBase::RemoveSleepingTaskLocked(Task& task) {
   RemoveTaskFromList(task);
-  if (first_woken_ == &task) {
-    first_woken_ = task.next_;
+  if (sleeping_ == &task) {
+    sleeping_ = task.next_;
   }
-  if (last_woken_ == &task) {
-    last_woken_ = task.prev_;
+}
+
+void DispatcherBase::PushBack(RunQueue& queue, Task& task) {
+  if (queue.first == nullptr) {
+    queue.first = &task;
+  } else {
+    queue.last->next_ = &task;
+    task.prev_ = queue.last;
   }
+  queue.last = &task;
 }
 
-void DispatcherBase::RemoveSleepingTaskLocked(Task& task) {
-  RemoveTaskFromList(task);
-  if (sleeping_ == &task) {
-    sleeping_ = task.next_;
+Task* DispatcherBase::PopFront(RunQueue& queue) {
+  if (queue.first == nullptr) {
+    return nullptr;
   }
+  Task& task = *queue.first;
+  if (task.next_ != nullptr) {
+    task.next_->prev_ = nullptr;
+  } else {
+    queue.last = nullptr;
+  }
+  queue.first = task.next_;
+  task.prev_ = nullptr;
+  task.next_ = nullptr;
+  return &task;
 }
 
-void DispatcherBase::AddTaskToWokenList(Task& task) {
-  if (first_woken_ == nullptr) {
-    first_woken_ = &task;
+Task* DispatcherBase::PopBack(RunQueue& queue) {
+  if (queue.last == nullptr) {
+    return nullptr;
+  }
+  Task& task = *queue.last;
+  if (task.prev_ != nullptr) {
+    task.prev_->next_ = nullptr;
   } else {
-    last_woken_->next_ = &task;
-    task.prev_ = last_woken_;
+    queue.first = nullptr;
+  }
+  queue.last = task.prev_;
+  task.prev_ = nullptr;
+  task.next_ = nullptr;
+  return &task;
+}
+
+void DispatcherBase::AddTaskToWokenList(Task& task) {
+  PushBack(task.worker_ == nullptr ? woken_ : task.worker_->queue_, task);
+}
+
+void DispatcherBase::RequeueWokenTaskLocked(Task& task) {
+  AddTaskToWokenList(task);
+  // The worker running this task will get back to it on its own, unless
+  // there are other tasks ahead of it.
+  if (task.worker_ == nullptr || task.worker_->queue_.first != &task) {
+    WakeWorkerLocked(task);
   }
-  last_woken_ = &task;
 }
 
 void DispatcherBase::AddTaskToSleepingList(Task& task) {
@@ -202,7 +245,11 @@ void DispatcherBase::WakeTask(Task& task) {
       // Wake again to indicate that this task should be run once more,
       // as the state of the world may have changed since the task
       // started running.
-      break;
+      //
+      // The task is added to a run queue when its ``Pend`` returns. Adding it
+      // now would allow another worker to run it concurrently.
+      task.state_ = Task::State::kWoken;
+      return;
     case Task::State::kSleeping:
       RemoveSleepingTaskLocked(task);
       // Wake away!
@@ -210,6 +257,7 @@ void DispatcherBase::WakeTask(Task& task) {
   }
   task.state_ = Task::State::kWoken;
   AddTaskToWokenList(task);
+  WakeWorkerLocked(task);
   if (wants_wake_) {
     // Note: it's quite annoying to make this call under the lock, as it can
     // result in extra thread wakeup/sleep cycles.
@@ -220,20 +268,143 @@ void DispatcherBase::WakeTask(Task& task) {
   }
 }
 
-Task* DispatcherBase::PopWokenTask() {
-  if (first_woken_ == nullptr) {
-    return nullptr;
+Task* DispatcherBase::PopWokenTask(WorkerBase* worker) {
+  Task* task = nullptr;
+  if (worker != nullptr) {
+    task = PopFront(worker->queue_);
   }
-  Task& task = *first_woken_;
-  if (task.next_ != nullptr) {
-    task.next_->prev_ = nullptr;
+  if (task == nullptr) {
+    task = PopFront(woken_);
+  }
+  if (task == nullptr) {
+    task = StealWokenTask(worker);
+  }
+  if (task != nullptr) {
+    task->worker_ = worker;
+  }
+  return task;
+}
+
+Task* DispatcherBase::StealWokenTask(WorkerBase* thief) {
+  // Start with the worker after the thief, so that thieves spread out across
+  // victims rather than all stealing from the first worker in the list.
+  WorkerBase* start = workers_;
+  if (thief != nullptr && thief->next_ != nullptr) {
+    start = thief->next_;
+  }
+  // Take the task most recently added to the victim's queue. The victim will
+  // run the oldest tasks in its queue itself, in order.
+  for (WorkerBase* victim = start; victim != nullptr; victim = victim->next_) {
+    if (Task* task = PopBack(victim->queue_); task != nullptr) {
+      return task;
+    }
+  }
+  for (WorkerBase* victim = workers_; victim != start;
+       victim = victim->next_) {
+    if (Task* task = PopBack(victim->queue_); task != nullptr) {
+      return task;
+    }
+  }
+  return nullptr;
+}
+
+bool DispatcherBase::HasWokenTasksLocked() const {
+  if (woken_.first != nullptr) {
+    return true;
+  }
+  for (WorkerBase* worker = workers_; worker != nullptr;
+       worker = worker->next_) {
+    if (worker->queue_.first != nullptr) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool DispatcherBase::RequestWorkerWakeLocked(WorkerBase& worker) {
+  if (HasWokenTasksLocked() || AllTasksCompleteLocked()) {
+    return false;
+  }
+  worker.wants_wake_ = true;
+  return true;
+}
+
+void DispatcherBase::WakeWorkerLocked(Task& task) {
+  WorkerBase* idle = task.worker_;
+  if (idle == nullptr || !idle->wants_wake_) {
+    idle = workers_;
+    while (idle != nullptr && !idle->wants_wake_) {
+      idle = idle->next_;
+    }
+  }
+  if (idle != nullptr) {
+    idle->wants_wake_ = false;
+    idle->DoWake();
+  }
+}
+
+void DispatcherBase::WakeAllWorkersLocked() {
+  for (WorkerBase* worker = workers_; worker != nullptr;
+       worker = worker->next_) {
+    if (worker->wants_wake_) {
+      worker->wants_wake_ = false;
+      worker->DoWake();
+    }
+  }
+}
+
+void DispatcherBase::AddWorkerLocked(WorkerBase& worker) {
+  worker.dispatcher_ = this;
+  worker.next_ = workers_;
+  workers_ = &worker;
+}
+
+void DispatcherBase::RemoveWorkerLocked(WorkerBase& worker) {
+  if (workers_ == &worker) {
+    workers_ = worker.next_;
   } else {
-    last_woken_ = nullptr;
+    WorkerBase* current = workers_;
+    while (current->next_ != &worker) {
+      current = current->next_;
+    }
+    current->next_ = worker.next_;
+  }
+  worker.dispatcher_ = nullptr;
+  worker.next_ = nullptr;
+
+  // Hand any tasks that were bound to this worker back to the dispatcher.
+  while (Task* task = PopFront(worker.queue_)) {
+    task->worker_ = nullptr;
+    PushBack(woken_, *task);
+  }
+  for (Task* task = sleeping_; task != nullptr; task = task->next_) {
+    if (task->worker_ == &worker) {
+      task->worker_ = nullptr;
+    }
+  }
+  if (woken_.first != nullptr) {
+    WakeWorkerLocked(*woken_.first);
+  }
+}
+
+WorkerBase::WorkerBase(DispatcherBase& dispatcher) {
+  std::lock_guard lock(dispatcher_lock());
+  dispatcher.AddWorkerLocked(*this);
+}
+
+SleepInfo WorkerBase::AttemptRequestWake() {
+  std::lock_guard lock(dispatcher_lock());
+  if (dispatcher_ == nullptr || !dispatcher_->RequestWorkerWakeLocked(*this)) {
+    return SleepInfo::DontSleep();
+  }
+  return SleepInfo::Indefinitely();
+}
+
+void WorkerBase::Deregister() {
+  std::lock_guard lock(dispatcher_lock());
+  if (dispatcher_ != nullptr) {
+    dispatcher_->RemoveWorkerLocked(*this);
   }
-  first_woken_ = task.next_;
-  task.prev_ = nullptr;
-  task.next_ = nullptr;
-  return &task;
 }
 
 }  // namespace pw::async2
@@ -42,6 +42,7 @@ inline pw::sync::InterruptSpinLock& dispatcher_lock() {
 class DispatcherBase;
 class Waker;
 class WaitReason;
+class WorkerBase;
 
 // Forward-declare ``Dispatcher``.
 // This concrete type must be provided by a backend.
@@ -112,6 +113,7 @@ class Context {
 class Task {
   friend class Waker;
   friend class DispatcherBase;
+  friend class WorkerBase;
   template <typename T>
   friend class DispatcherImpl;
 
@@ -215,6 +217,12 @@ class Task {
   // prevent null access.
   DispatcherBase* dispatcher_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
 
+  // The worker that most recently ran this task, if any.
+  //
+  // When woken, the task is added to this worker's run queue, or to the
+  // dispatcher's shared run queue if this is null.
+  WorkerBase* worker_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+
   // Pointers for whatever linked-list this ``Task`` is in.
   // These are controlled by the ``Dispatcher``.
   Task* prev_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
@@ -353,8 +361,8 @@ class DispatcherBase {
     return task.dispatcher_ == this;
   }
 
-  /// Removes references to this ``DispatcherBase`` from all linked ``Task`` s
-  /// and ``Waker`` s.
+  /// Removes references to this ``DispatcherBase`` from all linked ``Task`` s,
+  /// ``Waker`` s, and workers.
   ///
   /// This must be called by ``Dispatcher`` implementations in their
   /// destructors. It is not called by the ``DispatcherBase`` destructor, as
@@ -365,9 +373,17 @@ class DispatcherBase {
  private:
   friend class Task;
   friend class Waker;
+  friend class WorkerBase;
   template <typename Impl>
   friend class DispatcherImpl;
 
+  /// A FIFO queue of woken ``Task`` s, linked by their ``prev_`` and ``next_``
+  /// fields.
+  struct RunQueue {
+    Task* first = nullptr;
+    Task* last = nullptr;
+  };
+
   /// Sends a wakeup signal to this ``Dispatcher``.
   ///
   /// This method's implementation should ensure that the ``Dispatcher`` comes
@@ -382,29 +398,91 @@ class DispatcherBase {
       PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
   static void RemoveTaskFromList(Task&)
       PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
-  void RemoveWokenTaskLocked(Task&)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
   void RemoveSleepingTaskLocked(Task&)
       PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
 
+  static void PushBack(RunQueue&, Task&)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  static Task* PopFront(RunQueue&)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  static Task* PopBack(RunQueue&)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
   // For use by ``WakeTask`` and ``DispatcherImpl::Post``.
+  //
+  // Adds the task to the run queue of the worker that last ran it, or to the
+  // shared run queue.
   void AddTaskToWokenList(Task&) PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
 
   // For use by ``RunOneTask``.
   void AddTaskToSleepingList(Task&)
       PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
 
+  // For use by ``RunOneTask``.
+  //
+  // Adds a task that was woken while running to a run queue. If another
+  // task is ahead of it in the queue, a sleeping worker is woken to help.
+  void RequeueWokenTaskLocked(Task&)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
   // For use by ``Waker``.
   void WakeTask(Task&) PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
 
   // For use by ``RunOneTask``.
-  Task* PopWokenTask() PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  //
+  // Pops a task from the given worker's run queue, then from the shared run
+  // queue, and finally from the back of another worker's run queue. If
+  // ``worker`` is null, only the latter two are checked.
+  Task* PopWokenTask(WorkerBase* worker)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
+  // For use by ``PopWokenTask``.
+  Task* StealWokenTask(WorkerBase* thief)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
+  // Returns whether any run queue has a task in it.
+  bool HasWokenTasksLocked() const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
+  // Returns whether there are no posted tasks left, including running ones.
+  bool AllTasksCompleteLocked() const
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock()) {
+    return !HasWokenTasksLocked() && sleeping_ == nullptr && num_running_ == 0;
+  }
+
+  // For use by ``RunOneTask`` when running on behalf of a worker.
+  //
+  // Returns whether there is work left for the worker to wait for, in which
+  // case the worker will be sent a ``DoWake`` once there are woken tasks.
+  bool RequestWorkerWakeLocked(WorkerBase& worker)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
+  // Wakes up a sleeping worker, if any, to run the given woken task. The
+  // worker whose run queue the task was added to is preferred.
+  void WakeWorkerLocked(Task&) PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
+  // Wakes up all sleeping workers, e.g. so that they can return once all tasks
+  // are complete.
+  void WakeAllWorkersLocked() PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+
+  // For use by ``WorkerBase``.
+  void AddWorkerLocked(WorkerBase&)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
+  void RemoveWorkerLocked(WorkerBase&)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(dispatcher_lock());
 
-  Task* first_woken_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
-  Task* last_woken_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  // The run queue for tasks that have not been run by a worker, e.g. newly
+  // posted ones.
+  RunQueue woken_ PW_GUARDED_BY(dispatcher_lock());
   // Note: the sleeping list's order is not significant.
   Task* sleeping_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
   bool wants_wake_ PW_GUARDED_BY(dispatcher_lock()) = false;
+
+  // Number of tasks whose ``Pend`` is currently being called.
+  size_t num_running_ PW_GUARDED_BY(dispatcher_lock()) = 0;
+
+  // Singly-linked list of the workers running this dispatcher's tasks.
+  WorkerBase* workers_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
 };
 
 /// Information about whether and when to sleep until as returned by
@@ -412,6 +490,7 @@ class DispatcherBase {
 ///
 /// This should only be used by ``Dispatcher`` implementations.
 class [[nodiscard]] SleepInfo {
+  friend class WorkerBase;
   template <typename T>
   friend class DispatcherImpl;
 
@@ -464,6 +543,8 @@ class [[nodiscard]] RunOneTaskResult {
 /// to the ``Dispatcher`` class.
 template <typename Impl>
 class DispatcherImpl : public DispatcherBase {
+  friend class WorkerBase;
+
  public:
   /// Tells the ``Dispatcher`` to run ``Task`` to completion.
   /// This method does not block.
@@ -481,6 +562,7 @@ class DispatcherImpl : public DispatcherBase {
       task.state_ = Task::State::kWoken;
       task.dispatcher_ = this;
       AddTaskToWokenList(task);
+      WakeWorkerLocked(task);
       if (wants_wake_) {
         wake_dispatcher = true;
         wants_wake_ = false;
@@ -530,8 +612,9 @@ class DispatcherImpl : public DispatcherBase {
   /// be done.
   SleepInfo AttemptRequestWake() PW_LOCKS_EXCLUDED(dispatcher_lock()) {
     std::lock_guard lock(dispatcher_lock());
-    // Don't allow sleeping if there are already tasks waiting to be run.
-    if (first_woken_ != nullptr) {
+    // Don't allow sleeping if there are already tasks waiting to be run, or
+    // if a worker completed the last task since this dispatcher last checked.
+    if (HasWokenTasksLocked() || AllTasksCompleteLocked()) {
       return SleepInfo::DontSleep();
     }
     /// Indicate that the ``Dispatcher`` is sleeping and will need a ``DoWake``
@@ -543,20 +626,24 @@ class DispatcherImpl : public DispatcherBase {
 
   /// Attempts to run a single task, returning whether any tasks were
   /// run, and whether `task_to_look_for` was run.
-  [[nodiscard]] RunOneTaskResult RunOneTask(Task* task_to_look_for)
+  ///
+  /// If ``worker`` is provided, the task is run on its behalf, and it is
+  /// preferentially taken from that worker's run queue.
+  [[nodiscard]] RunOneTaskResult RunOneTask(Task* task_to_look_for,
+                                            WorkerBase* worker = nullptr)
       PW_LOCKS_EXCLUDED(dispatcher_lock()) {
     Task* task;
     {
       std::lock_guard lock(dispatcher_lock());
-      task = PopWokenTask();
+      task = PopWokenTask(worker);
       if (task == nullptr) {
-        bool all_complete = first_woken_ == nullptr && sleeping_ == nullptr;
         return RunOneTaskResult(
-            /*completed_all_tasks=*/all_complete,
+            /*completed_all_tasks=*/AllTasksCompleteLocked(),
             /*completed_main_task=*/false,
             /*ran_a_task=*/false);
       }
       task->state_ = Task::State::kRunning;
+      ++num_running_;
     }
 
     bool complete;
@@ -575,15 +662,27 @@ class DispatcherImpl : public DispatcherBase {
             PW_DASSERT(false);
             PW_UNREACHABLE;
           case Task::State::kRunning:
-            break;
           case Task::State::kWoken:
-            RemoveWokenTaskLocked(*task);
+            // A task woken while running is not added to a run queue until
+            // its ``Pend`` returns, so there is nothing to remove here.
             break;
         }
         task->state_ = Task::State::kUnposted;
         task->dispatcher_ = nullptr;
+        task->worker_ = nullptr;
         task->RemoveAllWakersLocked();
-        all_complete = first_woken_ == nullptr && sleeping_ == nullptr;
+        --num_running_;
+        all_complete = AllTasksCompleteLocked();
+        if (all_complete) {
+          // Wake everything that is waiting to run tasks, including the
+          // dispatcher itself if it is being run alongside workers, so that
+          // they can return.
+          WakeAllWorkersLocked();
+          if (wants_wake_) {
+            wants_wake_ = false;
+            DoWake();
+          }
+        }
       }
       task->DoDestroy();
       return RunOneTaskResult(
@@ -592,9 +691,14 @@ class DispatcherImpl : public DispatcherBase {
           /*ran_a_task=*/true);
     } else {
       std::lock_guard lock(dispatcher_lock());
+      --num_running_;
       if (task->state_ == Task::State::kRunning) {
         task->state_ = Task::State::kSleeping;
         AddTaskToSleepingList(*task);
+      } else {
+        // The task was woken while running. Only now is it safe for another
+        // worker to run it.
+        RequeueWokenTaskLocked(*task);
       }
       return RunOneTaskResult(
           /*completed_all_tasks=*/false,
@@ -608,4 +712,66 @@ class DispatcherImpl : public DispatcherBase {
   Impl& self() { return *static_cast<Impl*>(this); }
 };
 
+/// A base class used by ``Worker`` implementations.
+///
+/// A worker runs a ``Dispatcher`` 's tasks on one of several threads. Each
+/// worker has its own run queue. A task that a worker has run is added back to
+/// that worker's run queue when it is woken, keeping its state local to one
+/// thread. A worker with nothing left in its own queue takes tasks from the
+/// dispatcher's shared queue, and then steals tasks from other workers.
+///
+/// All of these queues are guarded by the ``dispatcher_lock()``, which is
+/// only held briefly to move tasks between queues. Calls to ``Task::Pend``
+/// happen outside the lock, and are what run in parallel.
+class WorkerBase {
+ public:
+  WorkerBase(WorkerBase&) = delete;
+  WorkerBase(WorkerBase&&) = delete;
+  WorkerBase& operator=(WorkerBase&) = delete;
+  WorkerBase& operator=(WorkerBase&&) = delete;
+  virtual ~WorkerBase() {}
+
+ protected:
+  /// Adds this worker to the dispatcher whose tasks it will run.
+  explicit WorkerBase(DispatcherBase& dispatcher)
+      PW_LOCKS_EXCLUDED(dispatcher_lock());
+
+  /// Runs a single task from this worker's queue, the shared queue, or another
+  /// worker's queue.
+  template <typename Impl>
+  [[nodiscard]] RunOneTaskResult RunOneTask(DispatcherImpl<Impl>& dispatcher)
+      PW_LOCKS_EXCLUDED(dispatcher_lock()) {
+    return dispatcher.RunOneTask(nullptr, this);
+  }
+
+  /// Indicates that this worker is about to go to sleep and requests that it
+  /// be awoken when more work is available, as with
+  /// ``DispatcherImpl::AttemptRequestWake``.
+  ///
+  /// The worker should not sleep if all of the dispatcher's tasks have
+  /// completed, since it would never be awoken.
+  SleepInfo AttemptRequestWake() PW_LOCKS_EXCLUDED(dispatcher_lock());
+
+  /// Removes this worker from its dispatcher. Any tasks in its run queue are
+  /// moved to the dispatcher's shared run queue.
+  ///
+  /// This must be called by ``Worker`` implementations in their destructors,
+  /// and not while the worker is running tasks.
+  void Deregister() PW_LOCKS_EXCLUDED(dispatcher_lock());
+
+ private:
+  friend class DispatcherBase;
+
+  /// Sends a wakeup signal to this worker.
+  ///
+  /// As with ``DispatcherBase::DoWake``, this must not acquire the
+  /// ``dispatcher_lock()``.
+  virtual void DoWake() = 0;
+
+  DispatcherBase* dispatcher_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  WorkerBase* next_ PW_GUARDED_BY(dispatcher_lock()) = nullptr;
+  DispatcherBase::RunQueue queue_ PW_GUARDED_BY(dispatcher_lock());
+  bool wants_wake_ PW_GUARDED_BY(dispatcher_lock()) = false;
+};
+
 }  // namespace pw::async2
@@ -0,0 +1,72 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "pw_async2/dispatcher.h"
+#include "pw_sync/thread_notification.h"
+#include "pw_thread/thread_core.h"
+
+namespace pw::async2 {
+
+/// Runs a ``Dispatcher`` 's tasks on one of several threads.
+///
+/// Each ``Worker`` has its own run queue. A woken ``Task`` is added to the
+/// queue of the worker that last ran it, and a worker that runs out of tasks
+/// steals them from the dispatcher's shared queue and from other workers. See
+/// ``WorkerBase`` for details.
+///
+/// ``Task`` s, ``Waker`` s, and ``Context`` s behave the same as when running
+/// the ``Dispatcher`` directly. A ``Task`` is never ``Pend`` 'd by more than
+/// one worker at a time, but successive calls to its ``Pend`` may be made from
+/// different threads.
+///
+/// Example:
+///
+/// @code{.cpp}
+///   Dispatcher dispatcher;
+///   dispatcher.Post(task1);
+///   dispatcher.Post(task2);
+///
+///   std::array<Worker, 2> workers = {Worker(dispatcher), Worker(dispatcher)};
+///   Thread thread1(options1, workers[0]);
+///   Thread thread2(options2, workers[1]);
+///   thread1.join();
+///   thread2.join();
+/// @endcode
+///
+/// Workers must be destroyed before their ``Dispatcher``, and must not be
+/// destroyed while running.
+class Worker final : public WorkerBase, public thread::ThreadCore {
+ public:
+  explicit Worker(Dispatcher& dispatcher)
+      : WorkerBase(dispatcher), dispatcher_(dispatcher) {}
+
+  ~Worker() final { Deregister(); }
+
+  /// Runs the dispatcher's tasks until all of them complete.
+  ///
+  /// Tasks should be posted before calling this method, as it returns
+  /// immediately if no tasks are posted.
+  void RunToCompletion();
+
+ private:
+  void Run() final { RunToCompletion(); }
+
+  void DoWake() final { notify_.release(); }
+
+  Dispatcher& dispatcher_;
+  sync::ThreadNotification notify_;
+};
+
+}  // namespace pw::async2
@@ -0,0 +1,34 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/worker.h"
+
+namespace pw::async2 {
+
+void Worker::RunToCompletion() {
+  while (true) {
+    RunOneTaskResult result = RunOneTask(dispatcher_);
+    if (result.completed_all_tasks()) {
+      return;
+    }
+    if (!result.ran_a_task()) {
+      SleepInfo sleep_info = AttemptRequestWake();
+      if (sleep_info.should_sleep()) {
+        notify_.acquire();
+      }
+    }
+  }
+}
+
+}  // namespace pw::async2
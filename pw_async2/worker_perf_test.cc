@@ -0,0 +1,154 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Measures how running a dispatcher's tasks scales with the number of workers.
+//
+// Each iteration posts a fixed set of tasks and runs them to completion on 1
+// to `kMaxWorkers` worker threads. A baseline runs the same tasks on the
+// dispatcher itself. Two workloads are measured:
+//
+// * In the compute-bound workload, every task does a fixed amount of work
+//   each time it is polled. This shows how well workers run tasks in parallel.
+// * In the yield-bound workload, tasks do no work and immediately yield. This
+//   shows the overhead of the dispatcher, including contention for the
+//   `dispatcher_lock()`.
+//
+// Note that the time to start and join worker threads is included.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_async2/worker.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_perf_test/state.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+
+namespace pw::async2 {
+namespace {
+
+constexpr size_t kMaxWorkers = 4;
+constexpr size_t kNumTasks = 64;
+
+constexpr size_t kComputeBoundPolls = 16;
+constexpr size_t kComputeBoundWorkPerPoll = 4096;
+
+constexpr size_t kYieldBoundPolls = 64;
+
+/// Task that does some work and yields, until it has been polled a given
+/// number of times.
+class BusyTask : public Task {
+ public:
+  void Reset(size_t num_polls, size_t work_per_poll) {
+    num_polls_ = num_polls;
+    work_per_poll_ = work_per_poll;
+    polled_ = 0;
+  }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    // Step a xorshift PRNG to simulate work.
+    for (size_t i = 0; i < work_per_poll_; ++i) {
+      value_ ^= value_ << 13;
+      value_ ^= value_ >> 17;
+      value_ ^= value_ << 5;
+    }
+    if (++polled_ < num_polls_) {
+      cx.ReEnqueue();
+      return Pending();
+    }
+    return Ready();
+  }
+
+  size_t num_polls_ = 0;
+  size_t work_per_poll_ = 0;
+  size_t polled_ = 0;
+  uint32_t value_ = 1;
+};
+
+std::array<BusyTask, kNumTasks> tasks;
+std::array<thread::test::TestThreadContext, kMaxWorkers> contexts;
+
+void PostTasks(Dispatcher& dispatcher,
+               size_t num_polls,
+               size_t work_per_poll) {
+  for (auto& task : tasks) {
+    task.Reset(num_polls, work_per_poll);
+    dispatcher.Post(task);
+  }
+}
+
+/// Runs the tasks on the dispatcher itself, on the calling thread.
+void RunOnDispatcher(perf_test::State& state,
+                     size_t num_polls,
+                     size_t work_per_poll) {
+  while (state.KeepRunning()) {
+    Dispatcher dispatcher;
+    PostTasks(dispatcher, num_polls, work_per_poll);
+    dispatcher.RunToCompletion();
+  }
+}
+
+/// Runs the tasks on the given number of worker threads.
+void RunOnWorkers(perf_test::State& state,
+                  size_t num_workers,
+                  size_t num_polls,
+                  size_t work_per_poll) {
+  while (state.KeepRunning()) {
+    Dispatcher dispatcher;
+    PostTasks(dispatcher, num_polls, work_per_poll);
+    std::array<std::optional<Worker>, kMaxWorkers> workers;
+    std::array<thread::Thread, kMaxWorkers> threads;
+    for (size_t i = 0; i < num_workers; ++i) {
+      workers[i].emplace(dispatcher);
+      threads[i] = thread::Thread(contexts[i].options(), *workers[i]);
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
+      threads[i].join();
+    }
+  }
+}
+
+void ComputeBound(perf_test::State& state, size_t num_workers) {
+  if (num_workers == 0) {
+    RunOnDispatcher(state, kComputeBoundPolls, kComputeBoundWorkPerPoll);
+  } else {
+    RunOnWorkers(
+        state, num_workers, kComputeBoundPolls, kComputeBoundWorkPerPoll);
+  }
+}
+
+void YieldBound(perf_test::State& state, size_t num_workers) {
+  if (num_workers == 0) {
+    RunOnDispatcher(state, kYieldBoundPolls, 0);
+  } else {
+    RunOnWorkers(state, num_workers, kYieldBoundPolls, 0);
+  }
+}
+
+PW_PERF_TEST(ComputeBoundDispatcher, ComputeBound, 0);
+PW_PERF_TEST(ComputeBoundOneWorker, ComputeBound, 1);
+PW_PERF_TEST(ComputeBoundTwoWorkers, ComputeBound, 2);
+PW_PERF_TEST(ComputeBoundFourWorkers, ComputeBound, 4);
+
+PW_PERF_TEST(YieldBoundDispatcher, YieldBound, 0);
+PW_PERF_TEST(YieldBoundOneWorker, YieldBound, 1);
+PW_PERF_TEST(YieldBoundTwoWorkers, YieldBound, 2);
+PW_PERF_TEST(YieldBoundFourWorkers, YieldBound, 4);
+
+}  // namespace
+}  // namespace pw::async2
@@ -0,0 +1,322 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_async2/worker.h"
+
+#include <array>
+#include <atomic>
+
+#include "pw_async2/dispatcher.h"
+#include "pw_sync/interrupt_spin_lock.h"
+#include "pw_thread/sleep.h"
+#include "pw_thread/test_thread_context.h"
+#include "pw_thread/thread.h"
+#include "pw_unit_test/framework.h"
+
+namespace pw::async2 {
+namespace {
+
+using namespace std::chrono_literals;
+
+// Re-enqueues itself until it has been polled a given number of times, and
+// records whether it was ever polled by two workers at once.
+class YieldingTask : public Task {
+ public:
+  YieldingTask() = default;
+  explicit YieldingTask(int num_polls) : num_polls_(num_polls) {}
+
+  void set_num_polls(int num_polls) { num_polls_ = num_polls; }
+  int polled() const { return polled_.load(); }
+  int destroyed() const { return destroyed_.load(); }
+  bool overlapped() const { return overlapped_.load(); }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    if (running_.exchange(true)) {
+      overlapped_ = true;
+    }
+    int polled = ++polled_;
+    running_ = false;
+    if (polled < num_polls_) {
+      cx.ReEnqueue();
+      return Pending();
+    }
+    return Ready();
+  }
+
+  void DoDestroy() override { ++destroyed_; }
+
+  int num_polls_ = 1;
+  std::atomic_int polled_ = 0;
+  std::atomic_int destroyed_ = 0;
+  std::atomic_bool running_ = false;
+  std::atomic_bool overlapped_ = false;
+};
+
+// Completes once woken by another thread.
+class WaitingTask : public Task {
+ public:
+  int polled() const { return polled_.load(); }
+
+  // Returns whether the task was waiting, and if so, wakes it.
+  bool WakeToComplete() {
+    Waker waker;
+    {
+      std::lock_guard lock(lock_);
+      if (waker_.IsEmpty()) {
+        return false;
+      }
+      should_complete_ = true;
+      waker = std::move(waker_);
+    }
+    std::move(waker).Wake();
+    return true;
+  }
+
+ private:
+  Poll<> DoPend(Context& cx) override {
+    ++polled_;
+    std::lock_guard lock(lock_);
+    if (should_complete_) {
+      return Ready();
+    }
+    waker_ = cx.GetWaker(WaitReason::Unspecified());
+    return Pending();
+  }
+
+  std::atomic_int polled_ = 0;
+  sync::InterruptSpinLock lock_;
+  bool should_complete_ = false;
+  Waker waker_;
+};
+
+// Worker that runs tasks one at a time when asked, on the calling thread.
+class ManualWorker : public WorkerBase {
+ public:
+  explicit ManualWorker(Dispatcher& dispatcher)
+      : WorkerBase(dispatcher), dispatcher_(dispatcher) {}
+
+  ~ManualWorker() override { Deregister(); }
+
+  RunOneTaskResult RunOne() { return RunOneTask(dispatcher_); }
+
+ private:
+  void DoWake() override {}
+
+  Dispatcher& dispatcher_;
+};
+
+TEST(Worker, RunToCompletion_SingleWorkerOnCallingThread) {
+  Dispatcher dispatcher;
+  std::array<YieldingTask, 4> tasks = {
+      YieldingTask(1), YieldingTask(2), YieldingTask(3), YieldingTask(4)};
+  for (auto& task : tasks) {
+    dispatcher.Post(task);
+  }
+
+  Worker worker(dispatcher);
+  worker.RunToCompletion();
+
+  for (size_t i = 0; i < tasks.size(); ++i) {
+    EXPECT_EQ(tasks[i].polled(), static_cast<int>(i + 1));
+    EXPECT_EQ(tasks[i].destroyed(), 1);
+  }
+}
+
+TEST(Worker, RunToCompletion_ReturnsImmediatelyWithoutTasks) {
+  Dispatcher dispatcher;
+  Worker worker(dispatcher);
+  worker.RunToCompletion();
+}
+
+TEST(Worker, Dispatcher_RunsTasksAfterWorkerDestroyed) {
+  Dispatcher dispatcher;
+  YieldingTask task(3);
+  dispatcher.Post(task);
+  {
+    Worker worker(dispatcher);
+  }
+  dispatcher.RunToCompletion();
+  EXPECT_EQ(task.polled(), 3);
+  EXPECT_EQ(task.destroyed(), 1);
+}
+
+TEST(Worker, RunOneTask_StealsWokenTaskFromOtherWorker) {
+  Dispatcher dispatcher;
+  WaitingTask task1;
+  WaitingTask task2;
+  dispatcher.Post(task1);
+  dispatcher.Post(task2);
+
+  ManualWorker owner(dispatcher);
+  ManualWorker thief(dispatcher);
+
+  // Both tasks are bound to the worker that ran them.
+  EXPECT_TRUE(owner.RunOne().ran_a_task());
+  EXPECT_TRUE(owner.RunOne().ran_a_task());
+  EXPECT_TRUE(task1.WakeToComplete());
+  EXPECT_TRUE(task2.WakeToComplete());
+
+  // The thief takes the most recently woken task from the owner's queue.
+  RunOneTaskResult result = thief.RunOne();
+  EXPECT_TRUE(result.ran_a_task());
+  EXPECT_FALSE(result.completed_all_tasks());
+  EXPECT_EQ(task1.polled(), 1);
+  EXPECT_EQ(task2.polled(), 2);
+
+  // The owner runs the oldest task in its queue itself.
+  result = owner.RunOne();
+  EXPECT_TRUE(result.ran_a_task());
+  EXPECT_TRUE(result.completed_all_tasks());
+  EXPECT_EQ(task1.polled(), 2);
+}
+
+TEST(Worker, Dispatcher_RunsQueuedAndSleepingTasksAfterWorkerDestroyed) {
+  Dispatcher dispatcher;
+  WaitingTask queued;
+  WaitingTask sleeping;
+  dispatcher.Post(queued);
+  dispatcher.Post(sleeping);
+
+  {
+    ManualWorker worker(dispatcher);
+    EXPECT_TRUE(worker.RunOne().ran_a_task());
+    EXPECT_TRUE(worker.RunOne().ran_a_task());
+
+    // One task waits in the worker's queue, and the other sleeps while still
+    // bound to the worker.
+    EXPECT_TRUE(queued.WakeToComplete());
+  }
+
+  // The queued task was handed back to the dispatcher.
+  EXPECT_FALSE(dispatcher.RunUntilStalled().IsReady());
+  EXPECT_EQ(queued.polled(), 2);
+  EXPECT_EQ(sleeping.polled(), 1);
+
+  // The sleeping task is no longer bound to the destroyed worker when woken.
+  EXPECT_TRUE(sleeping.WakeToComplete());
+  EXPECT_TRUE(dispatcher.RunUntilStalled().IsReady());
+  EXPECT_EQ(sleeping.polled(), 2);
+}
+
+// Blocks in its first ``Pend`` until released by another thread.
+class BlockingTask : public Task {
+ public:
+  bool started() const { return started_.load(); }
+  void Release() { released_ = true; }
+
+ private:
+  Poll<> DoPend(Context&) override {
+    started_ = true;
+    while (!released_.load()) {
+      this_thread::sleep_for(1ms);
+    }
+    return Ready();
+  }
+
+  std::atomic_bool started_ = false;
+  std::atomic_bool released_ = false;
+};
+
+TEST(Worker, Dispatcher_RunToCompletionReturnsWhenWorkerCompletesLastTask) {
+  Dispatcher dispatcher;
+  BlockingTask task;
+  dispatcher.Post(task);
+
+  Worker worker(dispatcher);
+  thread::test::TestThreadContext worker_context;
+  thread::Thread worker_thread(worker_context.options(), worker);
+  while (!task.started()) {
+    this_thread::sleep_for(1ms);
+  }
+
+  // Release the task once the dispatcher has found nothing to run and gone to
+  // sleep, so that the worker completes the last task.
+  thread::test::TestThreadContext release_context;
+  thread::Thread release_thread(release_context.options(), [&task] {
+    this_thread::sleep_for(10ms);
+    task.Release();
+  });
+
+  dispatcher.RunToCompletion();
+  release_thread.join();
+  worker_thread.join();
+}
+
+constexpr size_t kNumWorkers = 3;
+
+// Runs the workers on their own threads until all tasks complete.
+void RunWorkers(std::array<Worker, kNumWorkers>& workers) {
+  std::array<thread::test::TestThreadContext, kNumWorkers> contexts;
+  std::array<thread::Thread, kNumWorkers> threads;
+  for (size_t i = 0; i < kNumWorkers; ++i) {
+    threads[i] = thread::Thread(contexts[i].options(), workers[i]);
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(Worker, RunToCompletion_ManyWorkersRunEachTaskExclusively) {
+  constexpr int kNumPolls = 200;
+  Dispatcher dispatcher;
+  std::array<YieldingTask, 16> tasks;
+  for (auto& task : tasks) {
+    task.set_num_polls(kNumPolls);
+    dispatcher.Post(task);
+  }
+
+  std::array<Worker, kNumWorkers> workers = {
+      Worker(dispatcher), Worker(dispatcher), Worker(dispatcher)};
+  RunWorkers(workers);
+
+  for (const auto& task : tasks) {
+    EXPECT_EQ(task.polled(), kNumPolls);
+    EXPECT_EQ(task.destroyed(), 1);
+    EXPECT_FALSE(task.overlapped());
+  }
+}
+
+TEST(Worker, RunToCompletion_WorkersSleepUntilWoken) {
+  Dispatcher dispatcher;
+  std::array<WaitingTask, 4> tasks;
+  for (auto& task : tasks) {
+    dispatcher.Post(task);
+  }
+
+  std::array<Worker, kNumWorkers> workers = {
+      Worker(dispatcher), Worker(dispatcher), Worker(dispatcher)};
+  std::array<thread::test::TestThreadContext, kNumWorkers> contexts;
+  std::array<thread::Thread, kNumWorkers> threads;
+  for (size_t i = 0; i < kNumWorkers; ++i) {
+    threads[i] = thread::Thread(contexts[i].options(), workers[i]);
+  }
+
+  // Wake each task once it is waiting, from this thread.
+  for (auto& task : tasks) {
+    while (!task.WakeToComplete()) {
+      this_thread::sleep_for(1ms);
+    }
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (const auto& task : tasks) {
+    EXPECT_EQ(task.polled(), 2);
+  }
+}
+
+}  // namespace
+}  // namespace pw::async2
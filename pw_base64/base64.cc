@@ -14,9 +14,32 @@
 
 #include "pw_base64/base64.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/check.h"
+#include "pw_base64/internal/config.h"
+
+// Blocks of input are encoded and decoded with SSSE3 on x86-64 GCC and Clang
+// builds if the CPU supports it, and with NEON on AArch64 if
+// PW_BASE64_CONFIG_ENABLE_NEON is set. Blocks that the vector code can't handle
+// fall back to the scalar code, so the output is always the same.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define _PW_BASE64_SSSE3 1
+#include <immintrin.h>
+#else
+#define _PW_BASE64_SSSE3 0
+#endif  // defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#if PW_BASE64_CONFIG_ENABLE_NEON && defined(__aarch64__) && \
+    defined(__ARM_NEON)
+#define _PW_BASE64_NEON 1
+#include <arm_neon.h>
+#else
+#define _PW_BASE64_NEON 0
+#endif  // PW_BASE64_CONFIG_ENABLE_NEON && defined(__aarch64__) &&
+        // defined(__ARM_NEON)
 
 namespace pw::base64 {
 namespace {
@@ -84,15 +107,303 @@ constexpr uint8_t Byte2(uint8_t bits2, uint8_t bits3) {
   return static_cast<uint8_t>((bits2 & 0b000011) << 6) | bits3;
 }
 
+#if _PW_BASE64_SSSE3
+
+// The vector code follows "Faster Base64 Encoding and Decoding Using AVX2
+// Instructions" by Wojciech Mula and Daniel Lemire, using 128-bit vectors.
+
+// Encodes 12 bytes, loaded as the first 12 of 16, to 16 characters.
+__attribute__((target("ssse3"))) inline __m128i EncodeBlockSsse3(__m128i in) {
+  // Put the 3 bytes of each group in a 32-bit lane as [b1, b0, b2, b1].
+  in = _mm_shuffle_epi8(
+      in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+
+  // Move each 6-bit group to its own byte.
+  const __m128i t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+  const __m128i t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+  const __m128i t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+  const __m128i t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+  const __m128i indices = _mm_or_si128(t1, t3);
+
+  // Map each range of indices (A-Z, a-z, 0-9, +, /) to the offset that turns
+  // it into its character.
+  __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  const __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+  const __m128i offsets = _mm_setr_epi8('a' - 26,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        '0' - 52,
+                                        kChar62 - 62,
+                                        kChar63 - 63,
+                                        'A',
+                                        0,
+                                        0);
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+// Encodes 12 bytes at a time while 16 can be read. Returns the number of bytes
+// encoded.
+__attribute__((target("ssse3"))) size_t EncodeSsse3(const uint8_t* bytes,
+                                                    size_t size_bytes,
+                                                    char* output) {
+  size_t encoded = 0;
+  for (; size_bytes - encoded >= 16u; encoded += 12u, output += 16) {
+    const __m128i in = _mm_loadu_si128(
+        reinterpret_cast<const __m128i*>(bytes + encoded));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(output),
+                     EncodeBlockSsse3(in));
+  }
+  return encoded;
+}
+
+// Converts 16 characters to their 6-bit values. Returns false if any of them
+// is not in the standard alphabet, including padding and URL-safe characters,
+// which are left to the scalar code.
+__attribute__((target("ssse3"))) inline bool TranslateSsse3(__m128i chars,
+                                                           __m128i* values) {
+  const __m128i hi_nibbles =
+      _mm_and_si128(_mm_srli_epi32(chars, 4), _mm_set1_epi8(0x0f));
+  const __m128i lo_nibbles = _mm_and_si128(chars, _mm_set1_epi8(0x0f));
+
+  // Each character's nibbles select bit masks that only overlap if the
+  // character is invalid.
+  const __m128i lo_masks = _mm_shuffle_epi8(_mm_setr_epi8(0x15,
+                                                          0x11,
+                                                          0x11,
+                                                          0x11,
+                                                          0x11,
+                                                          0x11,
+                                                          0x11,
+                                                          0x11,
+                                                          0x11,
+                                                          0x11,
+                                                          0x13,
+                                                          0x1a,
+                                                          0x1b,
+                                                          0x1b,
+                                                          0x1b,
+                                                          0x1a),
+                                            lo_nibbles);
+  const __m128i hi_masks = _mm_shuffle_epi8(_mm_setr_epi8(0x10,
+                                                          0x10,
+                                                          0x01,
+                                                          0x02,
+                                                          0x04,
+                                                          0x08,
+                                                          0x04,
+                                                          0x08,
+                                                          0x10,
+                                                          0x10,
+                                                          0x10,
+                                                          0x10,
+                                                          0x10,
+                                                          0x10,
+                                                          0x10,
+                                                          0x10),
+                                            hi_nibbles);
+  const __m128i invalid = _mm_cmpgt_epi8(_mm_and_si128(lo_masks, hi_masks),
+                                         _mm_setzero_si128());
+  if (_mm_movemask_epi8(invalid) != 0) {
+    return false;
+  }
+
+  // Add the offset for each character's range. '/' shares its high nibble
+  // with '+', so it is told apart by comparison.
+  const __m128i is_slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8(kChar63));
+  const __m128i offsets = _mm_shuffle_epi8(
+      _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0),
+      _mm_add_epi8(is_slash, hi_nibbles));
+  *values = _mm_add_epi8(chars, offsets);
+  return true;
+}
+
+// Decodes 16 characters to 12 bytes at a time. Stops at the first block with
+// a character that is not in the standard alphabet. Returns the number of
+// characters decoded.
+__attribute__((target("ssse3"))) size_t DecodeSsse3(const char* base64,
+                                                    size_t size_bytes,
+                                                    uint8_t* output) {
+  size_t decoded = 0;
+  for (; size_bytes - decoded >= 16u; decoded += 16u, output += 12) {
+    __m128i values;
+    if (!TranslateSsse3(_mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(base64 + decoded)),
+                        &values)) {
+      break;
+    }
+
+    // Pack the 6-bit values into 3 bytes per 32-bit lane, then pack the lanes.
+    const __m128i pairs =
+        _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i groups = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    const __m128i packed = _mm_shuffle_epi8(
+        groups,
+        _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+    // Store exactly 12 bytes, which is safe when decoding in place.
+    uint8_t block[16];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(block), packed);
+    std::memcpy(output, block, 12);
+  }
+  return decoded;
+}
+
+// Returns the number of characters at the start of base64 that are in the
+// standard alphabet, checked 16 at a time.
+__attribute__((target("ssse3"))) size_t ValidPrefixSsse3(const char* base64,
+                                                         size_t size_bytes) {
+  size_t checked = 0;
+  for (; size_bytes - checked >= 16u; checked += 16u) {
+    __m128i values;
+    if (!TranslateSsse3(_mm_loadu_si128(
+                            reinterpret_cast<const __m128i*>(base64 + checked)),
+                        &values)) {
+      break;
+    }
+  }
+  return checked;
+}
+
+bool CpuSupportsSsse3() { return __builtin_cpu_supports("ssse3"); }
+
+#elif _PW_BASE64_NEON
+
+// Encodes 48 bytes to 64 characters at a time. Returns the number of bytes
+// encoded.
+size_t EncodeNeon(const uint8_t* bytes, size_t size_bytes, char* output) {
+  const uint8x16x4_t table = vld1q_u8_x4(
+      reinterpret_cast<const uint8_t*>(kEncodeTable));
+  const uint8x16_t mask = vdupq_n_u8(0x3f);
+
+  size_t encoded = 0;
+  for (; size_bytes - encoded >= 48u; encoded += 48u, output += 64) {
+    const uint8x16x3_t in = vld3q_u8(bytes + encoded);
+
+    uint8x16x4_t indices;
+    indices.val[0] = vshrq_n_u8(in.val[0], 2);
+    indices.val[1] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[0], 4), vshrq_n_u8(in.val[1], 4)), mask);
+    indices.val[2] = vandq_u8(
+        vorrq_u8(vshlq_n_u8(in.val[1], 2), vshrq_n_u8(in.val[2], 6)), mask);
+    indices.val[3] = vandq_u8(in.val[2], mask);
+
+    uint8x16x4_t chars;
+    for (int i = 0; i < 4; ++i) {
+      chars.val[i] = vqtbl4q_u8(table, indices.val[i]);
+    }
+    vst4q_u8(reinterpret_cast<uint8_t*>(output), chars);
+  }
+  return encoded;
+}
+
+// Converts 16 characters to their 6-bit values with the scalar decode table,
+// so the results match the scalar code. Returns false if any of them is
+// invalid.
+inline bool TranslateNeon(uint8x16_t chars,
+                          const uint8x16x4_t& table_low,
+                          const uint8x16_t& table_high,
+                          uint8x16_t* values) {
+  const uint8x16_t index =
+      vsubq_u8(chars, vdupq_n_u8(static_cast<uint8_t>(kMinValidChar)));
+  // Lookups past the end of a table return 0, so OR the two halves together.
+  const uint8x16_t result =
+      vorrq_u8(vqtbl4q_u8(table_low, index),
+               vqtbl1q_u8(table_high, vsubq_u8(index, vdupq_n_u8(64))));
+  const uint8x16_t invalid =
+      vorrq_u8(vcgtq_u8(index, vdupq_n_u8(sizeof(kDecodeTable) - 1)),
+               vceqq_u8(result, vdupq_n_u8(kX)));
+  if (vmaxvq_u8(invalid) != 0) {
+    return false;
+  }
+  *values = result;
+  return true;
+}
+
+// Decodes 64 characters to 48 bytes at a time. Stops at the first block with
+// an invalid character. Returns the number of characters decoded.
+size_t DecodeNeon(const char* base64, size_t size_bytes, uint8_t* output) {
+  const uint8x16x4_t table_low = vld1q_u8_x4(kDecodeTable);
+  const uint8x16_t table_high = vld1q_u8(kDecodeTable + 64);
+
+  size_t decoded = 0;
+  for (; size_bytes - decoded >= 64u; decoded += 64u, output += 48) {
+    const uint8x16x4_t chars =
+        vld4q_u8(reinterpret_cast<const uint8_t*>(base64 + decoded));
+
+    uint8x16x4_t values;
+    bool valid = true;
+    for (int i = 0; i < 4; ++i) {
+      valid &=
+          TranslateNeon(chars.val[i], table_low, table_high, &values.val[i]);
+    }
+    if (!valid) {
+      break;
+    }
+
+    uint8x16x3_t out;
+    out.val[0] =
+        vorrq_u8(vshlq_n_u8(values.val[0], 2), vshrq_n_u8(values.val[1], 4));
+    out.val[1] =
+        vorrq_u8(vshlq_n_u8(values.val[1], 4), vshrq_n_u8(values.val[2], 2));
+    out.val[2] = vorrq_u8(vshlq_n_u8(values.val[2], 6), values.val[3]);
+    vst3q_u8(output, out);
+  }
+  return decoded;
+}
+
+// Returns the number of characters at the start of base64 that are valid,
+// checked 16 at a time.
+size_t ValidPrefixNeon(const char* base64, size_t size_bytes) {
+  const uint8x16x4_t table_low = vld1q_u8_x4(kDecodeTable);
+  const uint8x16_t table_high = vld1q_u8(kDecodeTable + 64);
+
+  size_t checked = 0;
+  for (; size_bytes - checked >= 16u; checked += 16u) {
+    uint8x16_t values;
+    if (!TranslateNeon(
+            vld1q_u8(reinterpret_cast<const uint8_t*>(base64 + checked)),
+            table_low,
+            table_high,
+            &values)) {
+      break;
+    }
+  }
+  return checked;
+}
+
+#endif  // _PW_BASE64_SSSE3
+
 }  // namespace
 
 extern "C" void pw_Base64Encode(const void* binary_data,
                                 const size_t binary_size_bytes,
                                 char* output) {
   const uint8_t* bytes = static_cast<const uint8_t*>(binary_data);
+  size_t remaining = binary_size_bytes;
+
+#if _PW_BASE64_SSSE3
+  if (remaining >= 16u && CpuSupportsSsse3()) {
+    const size_t encoded = EncodeSsse3(bytes, remaining, output);
+    bytes += encoded;
+    remaining -= encoded;
+    output += EncodedSize(encoded);
+  }
+#elif _PW_BASE64_NEON
+  const size_t encoded = EncodeNeon(bytes, remaining, output);
+  bytes += encoded;
+  remaining -= encoded;
+  output += EncodedSize(encoded);
+#endif  // _PW_BASE64_SSSE3
 
   // Encode groups of 3 source bytes into 4 output characters.
-  size_t remaining = binary_size_bytes;
   for (; remaining >= 3u; remaining -= 3u, bytes += 3) {
     *output++ = BitGroup0Char(bytes[0]);
     *output++ = BitGroup1Char(bytes[0], bytes[1]);
@@ -123,8 +434,28 @@ extern "C" size_t pw_Base64Decode(const char* base64,
     return 0;
   }
 
+  // Check for padding first, since decoding in place overwrites the input.
+  size_t pad = 0;
+  if (base64[base64_size_bytes - 2] == kPadding) {
+    pad = 2;
+  } else if (base64[base64_size_bytes - 1] == kPadding) {
+    pad = 1;
+  }
+
   uint8_t* binary = static_cast<uint8_t*>(output);
-  for (size_t ch = 0; ch < base64_size_bytes; ch += kEncodedGroupSize) {
+  size_t ch = 0;
+
+#if _PW_BASE64_SSSE3
+  if (base64_size_bytes >= 16u && CpuSupportsSsse3()) {
+    ch = DecodeSsse3(base64, base64_size_bytes, binary);
+    binary += MaxDecodedSize(ch);
+  }
+#elif _PW_BASE64_NEON
+  ch = DecodeNeon(base64, base64_size_bytes, binary);
+  binary += MaxDecodedSize(ch);
+#endif  // _PW_BASE64_SSSE3
+
+  for (; ch < base64_size_bytes; ch += kEncodedGroupSize) {
     const uint8_t char0 = CharToBits(base64[ch + 0]);
     const uint8_t char1 = CharToBits(base64[ch + 1]);
     const uint8_t char2 = CharToBits(base64[ch + 2]);
@@ -135,13 +466,6 @@ extern "C" size_t pw_Base64Decode(const char* base64,
     *binary++ = Byte2(char2, char3);
   }
 
-  size_t pad = 0;
-  if (base64[base64_size_bytes - 2] == kPadding) {
-    pad = 2;
-  } else if (base64[base64_size_bytes - 1] == kPadding) {
-    pad = 1;
-  }
-
   return static_cast<size_t>(binary - static_cast<uint8_t*>(output)) - pad;
 }
 
@@ -155,7 +479,17 @@ extern "C" bool pw_Base64IsValid(const char* base64_data, size_t base64_size) {
     return false;
   }
 
-  for (size_t i = 0; i < base64_size; ++i) {
+  size_t i = 0;
+
+#if _PW_BASE64_SSSE3
+  if (base64_size >= 16u && CpuSupportsSsse3()) {
+    i = ValidPrefixSsse3(base64_data, base64_size);
+  }
+#elif _PW_BASE64_NEON
+  i = ValidPrefixNeon(base64_data, base64_size);
+#endif  // _PW_BASE64_SSSE3
+
+  for (; i < base64_size; ++i) {
     if (!pw_Base64IsValidChar(base64_data[i])) {
       return false;
     }
@@ -192,4 +526,133 @@ void Encode(span<const std::byte> binary, InlineString<>& output) {
   });
 }
 
+StatusWithSize Encoder::Encode(span<const std::byte> data, span<char> output) {
+  const size_t required_size = EncodedSize(data.size());
+  if (output.size() < required_size) {
+    return StatusWithSize::ResourceExhausted();
+  }
+
+  char* out = output.data();
+
+  // Complete the held group first.
+  if (pending_size_ > 0u) {
+    const size_t count =
+        std::min(data.size(), size_t{3} - pending_size_);
+    if (pending_size_ + count < 3u) {
+      std::copy_n(data.begin(), count, pending_.begin() + pending_size_);
+      pending_size_ = static_cast<uint8_t>(pending_size_ + count);
+      return StatusWithSize(0);
+    }
+    std::array<std::byte, 3> group;
+    std::copy_n(pending_.begin(), pending_size_, group.begin());
+    std::copy_n(data.begin(), count, group.begin() + pending_size_);
+    pw_Base64Encode(group.data(), group.size(), out);
+    out += kEncodedGroupSize;
+    data = data.subspan(count);
+    pending_size_ = 0;
+  }
+
+  const size_t whole_groups_size = data.size() / 3 * 3;
+  pw_Base64Encode(data.data(), whole_groups_size, out);
+
+  data = data.subspan(whole_groups_size);
+  std::copy(data.begin(), data.end(), pending_.begin());
+  pending_size_ = static_cast<uint8_t>(data.size());
+  return StatusWithSize(required_size);
+}
+
+StatusWithSize Encoder::Finish(span<char> output) {
+  if (pending_size_ == 0u) {
+    return StatusWithSize(0);
+  }
+  if (output.size() < kEncodedGroupSize) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  pw_Base64Encode(pending_.data(), pending_size_, output.data());
+  pending_size_ = 0;
+  return StatusWithSize(kEncodedGroupSize);
+}
+
+StatusWithSize Decoder::Decode(std::string_view base64,
+                               span<std::byte> output) {
+  if (output.size() < MaxDecodedSize(base64.size())) {
+    return StatusWithSize::ResourceExhausted();
+  }
+  if (padded_ && !base64.empty()) {
+    return StatusWithSize::DataLoss();
+  }
+
+  std::byte* out = output.data();
+
+  // Complete the held group first.
+  if (pending_size_ > 0u) {
+    const size_t count =
+        std::min(base64.size(), kEncodedGroupSize - pending_size_);
+    std::copy_n(base64.begin(), count, pending_.begin() + pending_size_);
+    pending_size_ = static_cast<uint8_t>(pending_size_ + count);
+    base64.remove_prefix(count);
+
+    if (pending_size_ < kEncodedGroupSize) {
+      return StatusWithSize(0);
+    }
+    const StatusWithSize result =
+        DecodeGroups(std::string_view(pending_.data(), pending_.size()),
+                     !base64.empty(),
+                     out);
+    if (!result.ok()) {
+      return result;
+    }
+    out += result.size();
+    pending_size_ = 0;
+  }
+
+  const size_t whole_groups_size =
+      base64.size() / kEncodedGroupSize * kEncodedGroupSize;
+  const StatusWithSize result =
+      DecodeGroups(base64.substr(0, whole_groups_size),
+                   whole_groups_size != base64.size(),
+                   out);
+  if (!result.ok()) {
+    return StatusWithSize::DataLoss(
+        static_cast<size_t>(out - output.data()));
+  }
+  out += result.size();
+
+  base64.remove_prefix(whole_groups_size);
+  std::copy(base64.begin(), base64.end(), pending_.begin());
+  pending_size_ = static_cast<uint8_t>(base64.size());
+  return StatusWithSize(static_cast<size_t>(out - output.data()));
+}
+
+StatusWithSize Decoder::DecodeGroups(std::string_view base64,
+                                     bool more_input,
+                                     std::byte* output) {
+  if (base64.empty()) {
+    return StatusWithSize(0);
+  }
+  if (!IsValid(base64)) {
+    return StatusWithSize::DataLoss();
+  }
+
+  // Padding is only allowed at the end of the last group: "xx==" or "xxx=".
+  const size_t padding = base64.find(kPadding);
+  if (padding != std::string_view::npos) {
+    const size_t padding_size = base64.size() - padding;
+    if (more_input || padding_size > 2u ||
+        base64.find_first_not_of(kPadding, padding) !=
+            std::string_view::npos) {
+      return StatusWithSize::DataLoss();
+    }
+    padded_ = true;
+  }
+
+  return StatusWithSize(base64::Decode(base64, output));
+}
+
+Status Decoder::Finish() {
+  const bool complete = pending_size_ == 0u;
+  clear();
+  return complete ? OkStatus() : Status::DataLoss();
+}
+
 }  // namespace pw::base64
@@ -0,0 +1,97 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_base64/base64.h"
+#include "pw_perf_test/perf_test.h"
+
+namespace pw::base64 {
+namespace {
+
+constexpr size_t kMaxDataSize = 1024;
+
+std::array<std::byte, kMaxDataSize> data;
+std::array<char, EncodedSize(kMaxDataSize)> encoded;
+std::array<std::byte, MaxDecodedSize(EncodedSize(kMaxDataSize))> decoded;
+
+// Fills the first size bytes of the data and encodes them.
+std::string_view Fill(size_t size) {
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = static_cast<std::byte>(i * 97 + (i >> 3));
+  }
+  return std::string_view(encoded.data(),
+                          Encode(span(data).first(size), encoded));
+}
+
+// Measures how long it takes to encode size bytes.
+void EncodeData(perf_test::State& state, size_t size) {
+  Fill(size);
+
+  while (state.KeepRunning()) {
+    Encode(span(data).first(size), encoded.data());
+  }
+}
+
+// Measures how long it takes to decode size bytes, without validation.
+void DecodeData(perf_test::State& state, size_t size) {
+  const std::string_view base64 = Fill(size);
+
+  while (state.KeepRunning()) {
+    Decode(base64, decoded.data());
+  }
+}
+
+// Measures how long it takes to validate and decode size bytes.
+void ValidateAndDecodeData(perf_test::State& state, size_t size) {
+  const std::string_view base64 = Fill(size);
+
+  while (state.KeepRunning()) {
+    Decode(base64, decoded);
+  }
+}
+
+// Measures how long it takes to decode size bytes 16 characters at a time
+// with a Decoder.
+void StreamDecodeData(perf_test::State& state, size_t size) {
+  const std::string_view base64 = Fill(size);
+  Decoder decoder;
+
+  while (state.KeepRunning()) {
+    size_t decoded_size = 0;
+    for (size_t i = 0; i < base64.size(); i += 16) {
+      decoded_size += decoder
+                          .Decode(base64.substr(i, 16),
+                                  span(decoded).subspan(decoded_size))
+                          .size();
+    }
+    decoder.Finish().IgnoreError();
+  }
+}
+
+PW_PERF_TEST(Encode16Bytes, EncodeData, 16);
+PW_PERF_TEST(Encode1024Bytes, EncodeData, 1024);
+
+PW_PERF_TEST(Decode16Bytes, DecodeData, 16);
+PW_PERF_TEST(Decode1024Bytes, DecodeData, 1024);
+
+PW_PERF_TEST(ValidateAndDecode16Bytes, ValidateAndDecodeData, 16);
+PW_PERF_TEST(ValidateAndDecode1024Bytes, ValidateAndDecodeData, 1024);
+
+PW_PERF_TEST(StreamDecode1024Bytes, StreamDecodeData, 1024);
+
+}  // namespace
+}  // namespace pw::base64
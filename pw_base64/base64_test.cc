@@ -14,7 +14,10 @@
 
 #include "pw_base64/base64.h"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
+#include <string_view>
 
 #include "pw_unit_test/framework.h"
 
@@ -449,5 +452,243 @@ TEST(Base64CLinkage, Decode) {
   EXPECT_STREQ("fo", output);
 }
 
+// Long enough for several blocks of the vector code plus a partial block.
+constexpr size_t kLongDataSize = 200;
+
+std::array<std::byte, kLongDataSize> LongData() {
+  std::array<std::byte, kLongDataSize> data;
+  for (size_t i = 0; i < data.size(); ++i) {
+    data[i] = static_cast<std::byte>(i * 97 + (i >> 3));
+  }
+  return data;
+}
+
+// A straightforward encoder to compare the optimized one against.
+void ReferenceEncode(span<const std::byte> data, char* output) {
+  constexpr std::string_view kChars =
+      "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  for (size_t i = 0; i < data.size(); i += 3) {
+    uint32_t group = static_cast<uint32_t>(data[i]) << 16;
+    if (i + 1 < data.size()) {
+      group |= static_cast<uint32_t>(data[i + 1]) << 8;
+    }
+    if (i + 2 < data.size()) {
+      group |= static_cast<uint32_t>(data[i + 2]);
+    }
+    *output++ = kChars[(group >> 18) & 0x3f];
+    *output++ = kChars[(group >> 12) & 0x3f];
+    *output++ = i + 1 < data.size() ? kChars[(group >> 6) & 0x3f] : '=';
+    *output++ = i + 2 < data.size() ? kChars[group & 0x3f] : '=';
+  }
+}
+
+TEST(Base64, EncodeDecode_LongData_AllSizes) {
+  const auto data = LongData();
+  for (size_t size = 0; size <= data.size(); ++size) {
+    const span<const std::byte> input = span(data).first(size);
+
+    std::array<char, EncodedSize(kLongDataSize) + 1> expected{};
+    ReferenceEncode(input, expected.data());
+
+    // Check that nothing past the end of the output is written.
+    std::array<char, EncodedSize(kLongDataSize) + 1> encoded;
+    encoded.fill('!');
+    const size_t encoded_size = EncodedSize(size);
+    ASSERT_EQ(encoded_size, Encode(input, span(encoded).first(encoded_size)));
+    EXPECT_EQ(std::string_view(expected.data(), encoded_size),
+              std::string_view(encoded.data(), encoded_size));
+    EXPECT_EQ('!', encoded[encoded_size]);
+
+    const std::string_view base64(encoded.data(), encoded_size);
+    const size_t max_decoded_size = MaxDecodedSize(encoded_size);
+    std::array<std::byte, MaxDecodedSize(EncodedSize(kLongDataSize)) + 1>
+        decoded;
+    decoded.fill(std::byte{0xa5});
+    ASSERT_EQ(size, Decode(base64, span(decoded).first(max_decoded_size)));
+    EXPECT_EQ(0, std::memcmp(data.data(), decoded.data(), size));
+    EXPECT_EQ(std::byte{0xa5}, decoded[max_decoded_size]);
+
+    // Decode in place.
+    ASSERT_EQ(size, Decode(base64, encoded.data()));
+    EXPECT_EQ(0, std::memcmp(data.data(), encoded.data(), size));
+  }
+}
+
+TEST(Base64, Decode_LongData_UrlSafe) {
+  const auto data = LongData();
+  std::array<char, EncodedSize(kLongDataSize)> encoded;
+  ASSERT_EQ(encoded.size(), Encode(data, encoded));
+
+  // Replace the standard characters with URL-safe ones in a few places, so
+  // some blocks mix both alphabets.
+  size_t replaced = 0;
+  for (size_t i = 0; i < encoded.size(); i += 7) {
+    if (encoded[i] == '+') {
+      encoded[i] = '-';
+      replaced += 1;
+    } else if (encoded[i] == '/') {
+      encoded[i] = '_';
+      replaced += 1;
+    }
+  }
+  ASSERT_GT(replaced, 0u);
+
+  std::array<std::byte, MaxDecodedSize(EncodedSize(kLongDataSize))> decoded;
+  ASSERT_EQ(data.size(),
+            Decode(std::string_view(encoded.data(), encoded.size()), decoded));
+  EXPECT_EQ(0, std::memcmp(data.data(), decoded.data(), data.size()));
+}
+
+TEST(Base64, IsValid_LongData_InvalidCharacterAnywhere) {
+  const auto data = LongData();
+  std::array<char, EncodedSize(kLongDataSize)> encoded;
+  ASSERT_EQ(encoded.size(), Encode(data, encoded));
+  const std::string_view base64(encoded.data(), encoded.size());
+  ASSERT_TRUE(IsValid(base64));
+
+  for (size_t i = 0; i < encoded.size(); ++i) {
+    const char original = encoded[i];
+    encoded[i] = '*';
+    EXPECT_FALSE(IsValid(base64));
+    encoded[i] = original;
+  }
+}
+
+TEST(Base64Encoder, MatchesEncode_AllPieceSizes) {
+  const auto data = LongData();
+  std::array<char, EncodedSize(kLongDataSize)> expected;
+  ASSERT_EQ(expected.size(), Encode(data, expected));
+
+  for (size_t piece_size = 1; piece_size <= 17; ++piece_size) {
+    Encoder encoder;
+    std::array<char, EncodedSize(kLongDataSize)> encoded{};
+    size_t encoded_size = 0;
+
+    for (size_t i = 0; i < data.size(); i += piece_size) {
+      const auto piece =
+          span(data).subspan(i, std::min(piece_size, data.size() - i));
+      const StatusWithSize result =
+          encoder.Encode(piece, span(encoded).subspan(encoded_size));
+      ASSERT_EQ(OkStatus(), result.status());
+      encoded_size += result.size();
+    }
+    const StatusWithSize result =
+        encoder.Finish(span(encoded).subspan(encoded_size));
+    ASSERT_EQ(OkStatus(), result.status());
+    encoded_size += result.size();
+
+    EXPECT_EQ(std::string_view(expected.data(), expected.size()),
+              std::string_view(encoded.data(), encoded_size));
+  }
+}
+
+TEST(Base64Encoder, OutputTooSmall) {
+  Encoder encoder;
+  std::array<char, 8> output{};
+  constexpr std::byte kData[] = {
+      std::byte{'f'}, std::byte{'o'}, std::byte{'o'}, std::byte{'b'}};
+
+  EXPECT_EQ(4u, encoder.EncodedSize(sizeof(kData)));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            encoder.Encode(kData, span(output).first(3)).status());
+
+  StatusWithSize result = encoder.Encode(kData, output);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(4u, result.size());
+
+  EXPECT_EQ(Status::ResourceExhausted(),
+            encoder.Finish(span(output).subspan(4, 3)).status());
+  result = encoder.Finish(span(output).subspan(4));
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(4u, result.size());
+  EXPECT_EQ("Zm9vYg==", std::string_view(output.data(), output.size()));
+}
+
+TEST(Base64Encoder, Finish_NothingHeld) {
+  Encoder encoder;
+  const StatusWithSize result = encoder.Finish({});
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+}
+
+TEST(Base64Decoder, MatchesDecode_AllPieceSizes) {
+  const auto data = LongData();
+  // Drop a byte so that the encoded data ends with padding.
+  const auto input = span(data).first(data.size() - 1);
+  std::array<char, EncodedSize(kLongDataSize)> encoded;
+  const size_t encoded_size = Encode(input, encoded);
+  ASSERT_EQ('=', encoded[encoded_size - 1]);
+  const std::string_view base64(encoded.data(), encoded_size);
+
+  for (size_t piece_size = 1; piece_size <= 17; ++piece_size) {
+    Decoder decoder;
+    std::array<std::byte, MaxDecodedSize(EncodedSize(kLongDataSize))> decoded{};
+    size_t decoded_size = 0;
+
+    for (size_t i = 0; i < base64.size(); i += piece_size) {
+      const StatusWithSize result = decoder.Decode(
+          base64.substr(i, piece_size), span(decoded).subspan(decoded_size));
+      ASSERT_EQ(OkStatus(), result.status());
+      decoded_size += result.size();
+    }
+    EXPECT_EQ(OkStatus(), decoder.Finish());
+
+    ASSERT_EQ(input.size(), decoded_size);
+    EXPECT_EQ(0, std::memcmp(input.data(), decoded.data(), decoded_size));
+  }
+}
+
+TEST(Base64Decoder, InvalidCharacter) {
+  Decoder decoder;
+  std::array<std::byte, 6> output;
+  const StatusWithSize result = decoder.Decode("Zm", output);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(0u, result.size());
+  EXPECT_EQ(Status::DataLoss(), decoder.Decode("9*", output).status());
+}
+
+TEST(Base64Decoder, DataAfterPadding) {
+  std::array<std::byte, 6> output;
+
+  Decoder decoder;
+  const StatusWithSize result = decoder.Decode("Zg==", output);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(1u, result.size());
+  EXPECT_EQ(Status::DataLoss(), decoder.Decode("Zg==", output).status());
+
+  decoder.clear();
+  EXPECT_EQ(Status::DataLoss(), decoder.Decode("Zg==Zg==", output).status());
+
+  decoder.clear();
+  EXPECT_EQ(Status::DataLoss(), decoder.Decode("Z=g=", output).status());
+}
+
+TEST(Base64Decoder, Finish_PartialGroup) {
+  Decoder decoder;
+  std::array<std::byte, 3> output;
+  StatusWithSize result = decoder.Decode("Zm9vY", output);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(3u, result.size());
+  EXPECT_EQ(Status::DataLoss(), decoder.Finish());
+
+  // Finish resets the decoder.
+  result = decoder.Decode("Zg==", output);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(1u, result.size());
+  EXPECT_EQ(OkStatus(), decoder.Finish());
+}
+
+TEST(Base64Decoder, OutputTooSmall) {
+  Decoder decoder;
+  std::array<std::byte, 6> output;
+  EXPECT_EQ(6u, decoder.MaxDecodedSize(8));
+  EXPECT_EQ(Status::ResourceExhausted(),
+            decoder.Decode("Zm9vYmFy", span(output).first(5)).status());
+
+  const StatusWithSize result = decoder.Decode("Zm9vYmFy", output);
+  EXPECT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(6u, result.size());
+}
+
 }  // namespace
 }  // namespace pw::base64
@@ -66,10 +66,14 @@ bool pw_Base64IsValid(const char* base64_data, size_t base64_size);
 #ifdef __cplusplus
 }  // extern "C"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <string_view>
 #include <type_traits>
 
 #include "pw_span/span.h"
+#include "pw_status/status_with_size.h"
 #include "pw_string/string.h"
 
 namespace pw::base64 {
@@ -202,6 +206,122 @@ inline bool IsValid(std::string_view base64) {
 /// @returns `true` if the provided character is a valid Base64 character.
 inline bool IsValidChar(char base64) { return pw_Base64IsValidChar(base64); }
 
+/// Encodes data to Base64 as it arrives, in pieces of any size. The output is
+/// the same as encoding all of the data at once with `Encode()`.
+///
+/// Each call to `Encode()` writes the complete 4-character groups it can and
+/// holds up to 2 bytes until more data arrives. `Finish()` writes the last,
+/// padded group.
+class Encoder {
+ public:
+  constexpr Encoder() : pending_{}, pending_size_(0) {}
+
+  /// @returns The number of characters that `Encode()` writes for `size_bytes`
+  /// more bytes of data.
+  constexpr size_t EncodedSize(size_t size_bytes) const {
+    return (pending_size_ + size_bytes) / 3 * 4;
+  }
+
+  /// Encodes the next piece of data.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The data was encoded. Returns the number of characters written.
+  ///
+  ///    RESOURCE_EXHAUSTED: The output is smaller than ``EncodedSize()``.
+  ///    Nothing was written or consumed.
+  ///
+  /// @endrst
+  StatusWithSize Encode(span<const std::byte> data, span<char> output);
+
+  /// Writes the last group, padded with `=`, if any data is held, and resets
+  /// the encoder.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: Returns the number of characters written, which is 0 or 4.
+  ///
+  ///    RESOURCE_EXHAUSTED: A group is held and the output has room for fewer
+  ///    than 4 characters.
+  ///
+  /// @endrst
+  StatusWithSize Finish(span<char> output);
+
+  /// Discards any held data.
+  void clear() { pending_size_ = 0; }
+
+ private:
+  std::array<std::byte, 2> pending_;
+  uint8_t pending_size_;
+};
+
+/// Decodes Base64 as it arrives, in pieces of any size. The input is checked
+/// as it is decoded, so no separate `IsValid()` pass is needed.
+///
+/// Each call to `Decode()` decodes the complete 4-character groups it can and
+/// holds up to 3 characters until more arrive. Padding may only appear in the
+/// last group, after which no more input is accepted until `Finish()`.
+class Decoder {
+ public:
+  constexpr Decoder() : pending_{}, pending_size_(0), padded_(false) {}
+
+  /// @returns The most bytes that `Decode()` writes for `size_bytes` more
+  /// characters.
+  constexpr size_t MaxDecodedSize(size_t size_bytes) const {
+    return (pending_size_ + size_bytes) / 4 * 3;
+  }
+
+  /// Decodes the next piece of Base64. Accepts the standard (`+/`) and
+  /// URL-safe (`-_`) alphabets.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The data was decoded. Returns the number of bytes written.
+  ///
+  ///    RESOURCE_EXHAUSTED: The output is smaller than ``MaxDecodedSize()``.
+  ///    Nothing was written or consumed.
+  ///
+  ///    DATA_LOSS: The input is not valid Base64. Some of it may have been
+  ///    decoded; call ``clear()`` before reusing the decoder.
+  ///
+  /// @endrst
+  StatusWithSize Decode(std::string_view base64, span<std::byte> output);
+
+  /// Checks that the input ended on a group boundary and resets the decoder.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: All of the input was decoded.
+  ///
+  ///    DATA_LOSS: The input ended partway through a group.
+  ///
+  /// @endrst
+  Status Finish();
+
+  /// Discards any held input and resets the decoder.
+  void clear() {
+    pending_size_ = 0;
+    padded_ = false;
+  }
+
+ private:
+  StatusWithSize DecodeGroups(std::string_view base64,
+                              bool more_input,
+                              std::byte* output);
+
+  std::array<char, 4> pending_;
+  uint8_t pending_size_;
+  bool padded_;  // True once a padded group has been decoded.
+};
+
 }  // namespace pw::base64
 
 #endif  // __cplusplus
@@ -0,0 +1,21 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+// PW_BASE64_CONFIG_ENABLE_NEON controls whether AArch64 targets with NEON
+// encode and decode blocks of input with NEON instructions. This is disabled by
+// default, and has no effect on other targets.
+#ifndef PW_BASE64_CONFIG_ENABLE_NEON
+#define PW_BASE64_CONFIG_ENABLE_NEON 0
+#endif  // PW_BASE64_CONFIG_ENABLE_NEON
@@ -15,6 +15,26 @@
 #include "pw_checksum/crc32.h"
 
 #include <array>
+#include <cstddef>
+
+// The carry-less multiply CRC32 is available on x86-64 GCC and Clang builds,
+// and is used only if the CPU supports it. The ARMv8 CRC32 instructions are
+// used only when the compiler targets them.
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define _PW_CHECKSUM_CRC32_PCLMUL 1
+#include <immintrin.h>
+#else
+#define _PW_CHECKSUM_CRC32_PCLMUL 0
+#endif  // defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+
+#if defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#define _PW_CHECKSUM_CRC32_ARM 1
+#include <arm_acle.h>
+
+#include <cstring>
+#else
+#define _PW_CHECKSUM_CRC32_ARM 0
+#endif  // defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
 
 namespace pw::checksum {
 namespace {
@@ -53,8 +73,179 @@ constexpr std::array<uint32_t, (1 << kBits)> GenerateCrc32Table() {
 // https://en.wikipedia.org/wiki/Cyclic_redundancy_check#Polynomial_representations_of_cyclic_redundancy_checks
 constexpr uint32_t kCrc32Polynomial = 0xEDB88320;
 
+// Generates the lookup tables for a slice-by-kSlices CRC32 implementation.
+// tables[0] is the 8-bit table. tables[n][i] is the CRC of byte i followed by
+// n zero bytes, so each of kSlices bytes can be looked up independently.
+template <size_t kSlices>
+constexpr std::array<std::array<uint32_t, 256>, kSlices>
+GenerateSlicedCrc32Tables() {
+  std::array<std::array<uint32_t, 256>, kSlices> tables{};
+  tables[0] = GenerateCrc32Table<8, kCrc32Polynomial>();
+  for (size_t slice = 1; slice < kSlices; slice++) {
+    for (size_t i = 0; i < 256; i++) {
+      const uint32_t previous = tables[slice - 1][i];
+      tables[slice][i] = (previous >> 8) ^ tables[0][previous & 0xFFu];
+    }
+  }
+  return tables;
+}
+
+// Calculates the CRC32 kSlices bytes at a time, which breaks the dependency
+// of each table lookup on the previous one. Uses kSlices KiB of tables.
+template <size_t kSlices>
+uint32_t Crc32SliceBy(const void* data, size_t size_bytes, uint32_t state) {
+  static_assert(kSlices >= 4);
+  static constexpr std::array<std::array<uint32_t, 256>, kSlices> kTables =
+      GenerateSlicedCrc32Tables<kSlices>();
+  const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
+
+  for (; size_bytes >= kSlices; size_bytes -= kSlices) {
+    uint32_t next_state = 0;
+    for (size_t i = 0; i < kSlices; i++) {
+      uint32_t index = data_bytes[i];
+      if (i < sizeof(state)) {
+        index ^= (state >> (8 * i)) & 0xFFu;
+      }
+      next_state ^= kTables[kSlices - 1 - i][index];
+    }
+    state = next_state;
+    data_bytes += kSlices;
+  }
+
+  for (size_t i = 0; i < size_bytes; ++i) {
+    state = kTables[0][(state ^ data_bytes[i]) & 0xFFu] ^ (state >> 8);
+  }
+
+  return state;
+}
+
+#if _PW_CHECKSUM_CRC32_PCLMUL
+
+inline __m128i Load128(const uint8_t* data) {
+  return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+}
+
+// Folds a 128-bit value forward by the distance the constants were computed
+// for and adds it to next.
+__attribute__((target("pclmul,sse4.1"))) inline __m128i Fold128(
+    __m128i value, __m128i constants, __m128i next) {
+  const __m128i low = _mm_clmulepi64_si128(value, constants, 0x00);
+  const __m128i high = _mm_clmulepi64_si128(value, constants, 0x11);
+  return _mm_xor_si128(_mm_xor_si128(high, low), next);
+}
+
+// Calculates the CRC32 by folding 64-byte blocks with carry-less
+// multiplication, then reducing to 32 bits with a Barrett reduction. size_bytes
+// must be a multiple of 16 and at least 64. See "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction", Intel, 2009. The constants
+// are from that paper for the bit-reflected CRC32 polynomial.
+__attribute__((target("pclmul,sse4.1"))) uint32_t Crc32Pclmul(
+    const uint8_t* data, size_t size_bytes, uint32_t state) {
+  const __m128i k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+  const __m128i k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+  const __m128i k5k0 = _mm_set_epi64x(0x0000000000, 0x0163cd6124);
+  const __m128i poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+  const __m128i low_words = _mm_setr_epi32(~0, 0, ~0, 0);
+
+  __m128i x1 = _mm_xor_si128(Load128(data),
+                             _mm_cvtsi32_si128(static_cast<int>(state)));
+  __m128i x2 = Load128(data + 16);
+  __m128i x3 = Load128(data + 32);
+  __m128i x4 = Load128(data + 48);
+  data += 64;
+  size_bytes -= 64;
+
+  // Fold four 128-bit lanes in parallel.
+  for (; size_bytes >= 64; size_bytes -= 64) {
+    x1 = Fold128(x1, k1k2, Load128(data));
+    x2 = Fold128(x2, k1k2, Load128(data + 16));
+    x3 = Fold128(x3, k1k2, Load128(data + 32));
+    x4 = Fold128(x4, k1k2, Load128(data + 48));
+    data += 64;
+  }
+
+  // Fold the lanes into one, then fold in any remaining 16-byte blocks.
+  x1 = Fold128(x1, k3k4, x2);
+  x1 = Fold128(x1, k3k4, x3);
+  x1 = Fold128(x1, k3k4, x4);
+
+  for (; size_bytes >= 16; size_bytes -= 16) {
+    x1 = Fold128(x1, k3k4, Load128(data));
+    data += 16;
+  }
+
+  // Fold 128 bits to 64 bits.
+  x2 = _mm_clmulepi64_si128(x1, k3k4, 0x10);
+  x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+  x2 = _mm_srli_si128(x1, 4);
+  x1 = _mm_and_si128(x1, low_words);
+  x1 = _mm_clmulepi64_si128(x1, k5k0, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  // Barrett reduce to 32 bits.
+  x2 = _mm_and_si128(x1, low_words);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x10);
+  x2 = _mm_and_si128(x2, low_words);
+  x2 = _mm_clmulepi64_si128(x2, poly, 0x00);
+  x1 = _mm_xor_si128(x1, x2);
+
+  return static_cast<uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+bool CpuSupportsPclmul() {
+  return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+}
+
+#endif  // _PW_CHECKSUM_CRC32_PCLMUL
+
 }  // namespace
 
+extern "C" uint32_t _pw_checksum_InternalCrc32Hardware(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  const uint8_t* data_bytes = static_cast<const uint8_t*>(data);
+
+#if _PW_CHECKSUM_CRC32_PCLMUL
+  // Folding has a fixed setup cost, so leave short buffers to the tables.
+  if (size_bytes >= 64 && CpuSupportsPclmul()) {
+    const size_t folded_bytes = size_bytes & ~size_t{15};
+    state = Crc32Pclmul(data_bytes, folded_bytes, state);
+    data_bytes += folded_bytes;
+    size_bytes -= folded_bytes;
+  }
+#elif _PW_CHECKSUM_CRC32_ARM
+  for (; size_bytes >= sizeof(uint64_t); size_bytes -= sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, data_bytes, sizeof(word));
+    state = __crc32d(state, word);
+    data_bytes += sizeof(word);
+  }
+  for (; size_bytes > 0; --size_bytes) {
+    state = __crc32b(state, *data_bytes++);
+  }
+#endif  // _PW_CHECKSUM_CRC32_PCLMUL
+
+  return Crc32SliceBy<8>(data_bytes, size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SliceBy16(const void* data,
+                                                        size_t size_bytes,
+                                                        uint32_t state) {
+  return Crc32SliceBy<16>(data, size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SliceBy8(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  return Crc32SliceBy<8>(data, size_bytes, state);
+}
+
+extern "C" uint32_t _pw_checksum_InternalCrc32SliceBy4(const void* data,
+                                                       size_t size_bytes,
+                                                       uint32_t state) {
+  return Crc32SliceBy<4>(data, size_bytes, state);
+}
+
 extern "C" uint32_t _pw_checksum_InternalCrc32EightBit(const void* data,
                                                        size_t size_bytes,
                                                        uint32_t state) {
@@ -12,6 +12,8 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <string_view>
 
@@ -28,31 +30,91 @@ constexpr std::string_view kString =
     "people very angry and been widely regarded as a bad move.";
 constexpr auto kBytes = bytes::Array<1, 2, 3, 4, 5, 6, 7, 8, 9>();
 
-void Crc32OneBitTest(perf_test::State& state, span<const std::byte> data) {
+constexpr std::array<std::byte, 4096> kBuffer = [] {
+  std::array<std::byte, 4096> buffer{};
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    buffer[i] = static_cast<std::byte>(i * 31);
+  }
+  return buffer;
+}();
+
+constexpr span<const std::byte> k256Bytes = span(kBuffer).first(256);
+constexpr span<const std::byte> k4096Bytes = span(kBuffer);
+
+template <typename CrcVariant>
+void Crc32Test(perf_test::State& state, span<const std::byte> data) {
   while (state.KeepRunning()) {
-    Crc32OneBit::Calculate(data);
+    CrcVariant::Calculate(data);
   }
 }
 
+void Crc32OneBitTest(perf_test::State& state, span<const std::byte> data) {
+  Crc32Test<Crc32OneBit>(state, data);
+}
+
 void Crc32FourBitTest(perf_test::State& state, span<const std::byte> data) {
-  while (state.KeepRunning()) {
-    Crc32FourBit::Calculate(data);
-  }
+  Crc32Test<Crc32FourBit>(state, data);
 }
 
 void Crc32EightBitTest(perf_test::State& state, span<const std::byte> data) {
-  while (state.KeepRunning()) {
-    Crc32EightBit::Calculate(data);
-  }
+  Crc32Test<Crc32EightBit>(state, data);
+}
+
+void Crc32SliceBy4Test(perf_test::State& state, span<const std::byte> data) {
+  Crc32Test<Crc32SliceBy4>(state, data);
+}
+
+void Crc32SliceBy8Test(perf_test::State& state, span<const std::byte> data) {
+  Crc32Test<Crc32SliceBy8>(state, data);
+}
+
+void Crc32SliceBy16Test(perf_test::State& state, span<const std::byte> data) {
+  Crc32Test<Crc32SliceBy16>(state, data);
+}
+
+void Crc32HardwareTest(perf_test::State& state, span<const std::byte> data) {
+  Crc32Test<Crc32Hardware>(state, data);
 }
 
 PW_PERF_TEST(CrcOneBitStringTest, Crc32OneBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcFourBitStringTest, Crc32FourBitTest, as_bytes(span(kString)));
 PW_PERF_TEST(CrcEightBitStringTest, Crc32EightBitTest, as_bytes(span(kString)));
+PW_PERF_TEST(CrcSliceBy4StringTest,
+             Crc32SliceBy4Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcSliceBy8StringTest,
+             Crc32SliceBy8Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcSliceBy16StringTest,
+             Crc32SliceBy16Test,
+             as_bytes(span(kString)));
+PW_PERF_TEST(CrcHardwareStringTest,
+             Crc32HardwareTest,
+             as_bytes(span(kString)));
 
 PW_PERF_TEST(CrcOneBitBytesTest, Crc32OneBitTest, kBytes);
 PW_PERF_TEST(CrcFourBitBytesTest, Crc32FourBitTest, kBytes);
 PW_PERF_TEST(CrcEightBitBytesTest, Crc32EightBitTest, kBytes);
+PW_PERF_TEST(CrcSliceBy4BytesTest, Crc32SliceBy4Test, kBytes);
+PW_PERF_TEST(CrcSliceBy8BytesTest, Crc32SliceBy8Test, kBytes);
+PW_PERF_TEST(CrcSliceBy16BytesTest, Crc32SliceBy16Test, kBytes);
+PW_PERF_TEST(CrcHardwareBytesTest, Crc32HardwareTest, kBytes);
+
+PW_PERF_TEST(CrcOneBit256BytesTest, Crc32OneBitTest, k256Bytes);
+PW_PERF_TEST(CrcFourBit256BytesTest, Crc32FourBitTest, k256Bytes);
+PW_PERF_TEST(CrcEightBit256BytesTest, Crc32EightBitTest, k256Bytes);
+PW_PERF_TEST(CrcSliceBy4256BytesTest, Crc32SliceBy4Test, k256Bytes);
+PW_PERF_TEST(CrcSliceBy8256BytesTest, Crc32SliceBy8Test, k256Bytes);
+PW_PERF_TEST(CrcSliceBy16256BytesTest, Crc32SliceBy16Test, k256Bytes);
+PW_PERF_TEST(CrcHardware256BytesTest, Crc32HardwareTest, k256Bytes);
+
+PW_PERF_TEST(CrcOneBit4096BytesTest, Crc32OneBitTest, k4096Bytes);
+PW_PERF_TEST(CrcFourBit4096BytesTest, Crc32FourBitTest, k4096Bytes);
+PW_PERF_TEST(CrcEightBit4096BytesTest, Crc32EightBitTest, k4096Bytes);
+PW_PERF_TEST(CrcSliceBy44096BytesTest, Crc32SliceBy4Test, k4096Bytes);
+PW_PERF_TEST(CrcSliceBy84096BytesTest, Crc32SliceBy8Test, k4096Bytes);
+PW_PERF_TEST(CrcSliceBy164096BytesTest, Crc32SliceBy16Test, k4096Bytes);
+PW_PERF_TEST(CrcHardware4096BytesTest, Crc32HardwareTest, k4096Bytes);
 
 }  // namespace
 }  // namespace pw::checksum
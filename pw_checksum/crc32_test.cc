@@ -13,6 +13,7 @@
 // the License.
 #include "pw_checksum/crc32.h"
 
+#include <array>
 #include <string_view>
 
 #include "public/pw_checksum/crc32.h"
@@ -46,6 +47,14 @@ TEST(Crc32, Empty) {
   EXPECT_EQ(Crc32FourBit::Calculate(span<std::byte>()),
             PW_CHECKSUM_EMPTY_CRC32);
   EXPECT_EQ(Crc32OneBit::Calculate(span<std::byte>()), PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SliceBy4::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SliceBy8::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32SliceBy16::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
+  EXPECT_EQ(Crc32Hardware::Calculate(span<std::byte>()),
+            PW_CHECKSUM_EMPTY_CRC32);
 }
 
 TEST(Crc32, Buffer) {
@@ -53,6 +62,10 @@ TEST(Crc32, Buffer) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SliceBy4::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SliceBy8::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32SliceBy16::Calculate(as_bytes(span(kBytes))), kBufferCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kBytes))), kBufferCrc);
 }
 
 TEST(Crc32, String) {
@@ -60,6 +73,10 @@ TEST(Crc32, String) {
   EXPECT_EQ(Crc32EightBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32FourBit::Calculate(as_bytes(span(kString))), kStringCrc);
   EXPECT_EQ(Crc32OneBit::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SliceBy4::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SliceBy8::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32SliceBy16::Calculate(as_bytes(span(kString))), kStringCrc);
+  EXPECT_EQ(Crc32Hardware::Calculate(as_bytes(span(kString))), kStringCrc);
 }
 
 template <typename CrcVariant>
@@ -76,6 +93,10 @@ TEST(Crc32Class, ByteByByte) {
   TestByByte<Crc32EightBit>();
   TestByByte<Crc32FourBit>();
   TestByByte<Crc32OneBit>();
+  TestByByte<Crc32SliceBy4>();
+  TestByByte<Crc32SliceBy8>();
+  TestByByte<Crc32SliceBy16>();
+  TestByByte<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -90,6 +111,10 @@ TEST(Crc32Class, Buffer) {
   TestBuffer<Crc32EightBit>();
   TestBuffer<Crc32FourBit>();
   TestBuffer<Crc32OneBit>();
+  TestBuffer<Crc32SliceBy4>();
+  TestBuffer<Crc32SliceBy8>();
+  TestBuffer<Crc32SliceBy16>();
+  TestBuffer<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -105,6 +130,10 @@ TEST(Crc32Class, BufferAppend) {
   TestBufferAppend<Crc32EightBit>();
   TestBufferAppend<Crc32FourBit>();
   TestBufferAppend<Crc32OneBit>();
+  TestBufferAppend<Crc32SliceBy4>();
+  TestBufferAppend<Crc32SliceBy8>();
+  TestBufferAppend<Crc32SliceBy16>();
+  TestBufferAppend<Crc32Hardware>();
 }
 
 template <typename CrcVariant>
@@ -119,6 +148,45 @@ TEST(Crc32Class, String) {
   TestString<Crc32EightBit>();
   TestString<Crc32FourBit>();
   TestString<Crc32OneBit>();
+  TestString<Crc32SliceBy4>();
+  TestString<Crc32SliceBy8>();
+  TestString<Crc32SliceBy16>();
+  TestString<Crc32Hardware>();
+}
+
+// Checks a variant against the 1-bit implementation for every length and
+// alignment of a buffer, split into two updates at every position. This covers
+// the byte-at-a-time tails of the sliced and folded implementations.
+template <typename CrcVariant>
+void TestMatchesOneBit() {
+  std::array<std::byte, 300> buffer;
+  uint32_t value = 1;
+  for (std::byte& b : buffer) {
+    value = value * 1103515245u + 12345u;
+    b = static_cast<std::byte>(value >> 24);
+  }
+
+  for (size_t offset = 0; offset < 16; ++offset) {
+    for (size_t size = 0; size + offset <= buffer.size(); size += 7) {
+      const span<const std::byte> data = span(buffer).subspan(offset, size);
+      const uint32_t expected = Crc32OneBit::Calculate(data);
+      ASSERT_EQ(CrcVariant::Calculate(data), expected);
+
+      CrcVariant crc;
+      crc.Update(data.first(size / 3));
+      crc.Update(data.subspan(size / 3));
+      ASSERT_EQ(crc.value(), expected);
+    }
+  }
+}
+
+TEST(Crc32Class, MatchesOneBit) {
+  TestMatchesOneBit<Crc32EightBit>();
+  TestMatchesOneBit<Crc32FourBit>();
+  TestMatchesOneBit<Crc32SliceBy4>();
+  TestMatchesOneBit<Crc32SliceBy8>();
+  TestMatchesOneBit<Crc32SliceBy16>();
+  TestMatchesOneBit<Crc32Hardware>();
 }
 
 extern "C" uint32_t CallChecksumCrc32(const void* data, size_t size_bytes);
@@ -34,7 +34,19 @@ extern "C" {
 // directly.
 #define _PW_CHECKSUM_CRC32_INITIAL_STATE 0xFFFFFFFFu
 
-// Internal implementation function for CRC32. Do not call it directly.
+// Internal implementation functions for CRC32. Do not call them directly.
+uint32_t _pw_checksum_InternalCrc32Hardware(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
+uint32_t _pw_checksum_InternalCrc32SliceBy16(const void* data,
+                                             size_t size_bytes,
+                                             uint32_t state);
+uint32_t _pw_checksum_InternalCrc32SliceBy8(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
+uint32_t _pw_checksum_InternalCrc32SliceBy4(const void* data,
+                                            size_t size_bytes,
+                                            uint32_t state);
 uint32_t _pw_checksum_InternalCrc32EightBit(const void* data,
                                             size_t size_bytes,
                                             uint32_t state);
@@ -46,7 +58,15 @@ uint32_t _pw_checksum_InternalCrc32OneBit(const void* data,
                                           size_t size_bytes,
                                           uint32_t state);
 
-#if PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS
+#if PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_HARDWARE
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32Hardware
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICE_BY_16
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32SliceBy16
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICE_BY_8
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32SliceBy8
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICE_BY_4
+#define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32SliceBy4
+#elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32EightBit
 #elif PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_4BITS
 #define _pw_checksum_InternalCrc32 _pw_checksum_InternalCrc32FourBit
@@ -113,6 +133,10 @@ class Crc32Impl {
 };
 
 using Crc32 = Crc32Impl<_pw_checksum_InternalCrc32>;
+using Crc32Hardware = Crc32Impl<_pw_checksum_InternalCrc32Hardware>;
+using Crc32SliceBy16 = Crc32Impl<_pw_checksum_InternalCrc32SliceBy16>;
+using Crc32SliceBy8 = Crc32Impl<_pw_checksum_InternalCrc32SliceBy8>;
+using Crc32SliceBy4 = Crc32Impl<_pw_checksum_InternalCrc32SliceBy4>;
 using Crc32EightBit = Crc32Impl<_pw_checksum_InternalCrc32EightBit>;
 using Crc32FourBit = Crc32Impl<_pw_checksum_InternalCrc32FourBit>;
 using Crc32OneBit = Crc32Impl<_pw_checksum_InternalCrc32OneBit>;
@@ -14,6 +14,10 @@
 
 #pragma once
 
+#define PW_CHECKSUM_CRC32_HARDWARE 512
+#define PW_CHECKSUM_CRC32_SLICE_BY_16 128
+#define PW_CHECKSUM_CRC32_SLICE_BY_8 64
+#define PW_CHECKSUM_CRC32_SLICE_BY_4 32
 #define PW_CHECKSUM_CRC32_8BITS 8
 #define PW_CHECKSUM_CRC32_4BITS 4
 #define PW_CHECKSUM_CRC32_1BITS 1
@@ -23,7 +27,11 @@
 #endif  // PW_CHECKSUM_CRC32_DEFAULT_IMPL
 
 #ifdef __cplusplus
-static_assert(PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS ||
+static_assert(PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_HARDWARE ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICE_BY_16 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICE_BY_8 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_SLICE_BY_4 ||
+              PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_8BITS ||
               PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_4BITS ||
               PW_CHECKSUM_CRC32_DEFAULT_IMPL == PW_CHECKSUM_CRC32_1BITS);
 #endif  // __cplusplus
@@ -39,6 +39,11 @@ using TheChecksum = pw::checksum::Crc32FourBit;
 using TheChecksum = pw::checksum::Crc32OneBit;
 #endif
 
+#ifdef USE_CRC32_SLICE_BY_8_CHECKSUM
+#include "pw_checksum/crc32.h"
+using TheChecksum = pw::checksum::Crc32SliceBy8;
+#endif
+
 namespace pw::checksum {
 
 #ifdef USE_NOOP_CHECKSUM
@@ -14,8 +14,12 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/endian.h"
+#include "pw_hdlc/internal/escape.h"
 #include "pw_hdlc/internal/protocol.h"
 #include "pw_log/log.h"
 #include "pw_varint/varint.h"
@@ -100,6 +104,41 @@ Result<Frame> Decoder::Process(const byte new_byte) {
   PW_CRASH("Bad decoder state");
 }
 
+Result<Frame> Decoder::ProcessUntilResult(ConstByteSpan& data) {
+  while (!data.empty()) {
+    size_t run_size = 0;
+
+    if (state_ == State::kFrame) {
+      run_size = internal::FindByteToEscape(data);
+      AppendBytes(data.first(run_size));
+    } else if (state_ == State::kInterFrame) {
+      const void* flag = std::memchr(
+          data.data(), static_cast<int>(kFlag), data.size());
+      run_size = flag == nullptr
+                     ? data.size()
+                     : static_cast<size_t>(static_cast<const byte*>(flag) -
+                                           data.data());
+      // Count bytes to track how many are discarded.
+      current_frame_size_ += run_size;
+    }
+
+    if (run_size == data.size()) {
+      data = ConstByteSpan();
+      break;
+    }
+
+    // Flag and escape bytes, and the byte after an escape, change the state.
+    const byte new_byte = data[run_size];
+    data = data.subspan(run_size + 1);
+
+    Result<Frame> result = Process(new_byte);
+    if (result.status() != Status::Unavailable()) {
+      return result;
+    }
+  }
+  return Status::Unavailable();
+}
+
 void Decoder::AppendByte(byte new_byte) {
   if (current_frame_size_ < max_size()) {
     buffer_[current_frame_size_] = new_byte;
@@ -118,6 +157,40 @@ void Decoder::AppendByte(byte new_byte) {
   current_frame_size_ += 1;
 }
 
+void Decoder::AppendBytes(ConstByteSpan data) {
+  if (data.size() < last_read_bytes_.size()) {
+    for (byte b : data) {
+      AppendByte(b);
+    }
+    return;
+  }
+
+  if (current_frame_size_ < max_size()) {
+    const size_t copy_size =
+        std::min(data.size(), max_size() - current_frame_size_);
+    std::memcpy(buffer_.data() + current_frame_size_, data.data(), copy_size);
+  }
+
+  // All bytes but the last four read are part of the running checksum. Add
+  // the bytes held in the ring buffer, oldest first, then all but the last
+  // four bytes of the run, which replace them in the ring buffer.
+  const size_t held = std::min(current_frame_size_, last_read_bytes_.size());
+  size_t index = (last_read_bytes_index_ + last_read_bytes_.size() - held) %
+                 last_read_bytes_.size();
+  for (size_t i = 0; i < held; ++i) {
+    fcs_.Update(last_read_bytes_[index]);
+    index = (index + 1) % last_read_bytes_.size();
+  }
+
+  fcs_.Update(data.first(data.size() - last_read_bytes_.size()));
+  std::memcpy(last_read_bytes_.data(),
+              data.last(last_read_bytes_.size()).data(),
+              last_read_bytes_.size());
+  last_read_bytes_index_ = 0;
+
+  current_frame_size_ += data.size();
+}
+
 Status Decoder::CheckFrame() const {
   // Empty frames are not an error; repeated flag characters are okay.
   if (current_frame_size_ == 0u) {
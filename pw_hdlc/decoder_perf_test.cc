@@ -0,0 +1,108 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_hdlc/decoder.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_hdlc/internal/protocol.h"
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+constexpr size_t kFrameCount = 16;
+constexpr size_t kMaxPayloadSize = 256;
+
+// Room for kFrameCount frames with every payload byte escaped.
+stream::MemoryWriterBuffer<kFrameCount * (2 * kMaxPayloadSize + 32)> stream;
+DecoderBuffer<kMaxPayloadSize + 32> decoder;
+
+// Encodes kFrameCount frames with payload_size byte payloads. One in every
+// `escape_interval` payload bytes is a flag or escape byte, or none if it is 0.
+ConstByteSpan EncodeStream(size_t payload_size, size_t escape_interval) {
+  std::array<std::byte, kMaxPayloadSize> payload;
+  for (size_t i = 0; i < payload_size; ++i) {
+    payload[i] = static_cast<std::byte>(i * 37);
+    if (NeedsEscaping(payload[i])) {
+      payload[i] = std::byte{0};
+    }
+    if (escape_interval != 0u && i % escape_interval == 0u) {
+      payload[i] = i % 2 == 0u ? kFlag : kEscape;
+    }
+  }
+
+  stream.clear();
+  for (size_t i = 0; i < kFrameCount; ++i) {
+    PW_CHECK_OK(WriteUIFrame(1, span(payload).first(payload_size), stream));
+  }
+
+  // Divide the stream size by the reported time to get throughput. The size
+  // in bytes divided by the time in microseconds is MB/s.
+  PW_LOG_INFO("Decoding %u bytes per iteration",
+              static_cast<unsigned>(stream.bytes_written()));
+  return stream.WrittenData();
+}
+
+// Measures how long it takes to decode a stream of frames one byte at a time
+// with Process(std::byte).
+void DecodeByteAtATime(perf_test::State& state,
+                       size_t payload_size,
+                       size_t escape_interval) {
+  const ConstByteSpan data = EncodeStream(payload_size, escape_interval);
+  size_t frames = 0;
+
+  while (state.KeepRunning()) {
+    for (std::byte b : data) {
+      if (decoder.Process(b).ok()) {
+        frames += 1;
+      }
+    }
+  }
+  PW_CHECK_UINT_GT(frames, 0);
+}
+
+// Measures how long it takes to decode a stream of frames with
+// Process(ConstByteSpan).
+void DecodeSpan(perf_test::State& state,
+                size_t payload_size,
+                size_t escape_interval) {
+  const ConstByteSpan data = EncodeStream(payload_size, escape_interval);
+  size_t frames = 0;
+
+  while (state.KeepRunning()) {
+    decoder.Process(data, [&frames](const Result<Frame>& result) {
+      if (result.ok()) {
+        frames += 1;
+      }
+    });
+  }
+  PW_CHECK_UINT_GT(frames, 0);
+}
+
+PW_PERF_TEST(DecodeByteAtATime16Bytes, DecodeByteAtATime, 16, 0);
+PW_PERF_TEST(DecodeByteAtATime256Bytes, DecodeByteAtATime, 256, 0);
+PW_PERF_TEST(DecodeByteAtATime256BytesEscaped, DecodeByteAtATime, 256, 16);
+
+PW_PERF_TEST(DecodeSpan16Bytes, DecodeSpan, 16, 0);
+PW_PERF_TEST(DecodeSpan256Bytes, DecodeSpan, 256, 0);
+PW_PERF_TEST(DecodeSpan256BytesEscaped, DecodeSpan, 256, 16);
+
+}  // namespace
+}  // namespace pw::hdlc
@@ -14,12 +14,16 @@
 
 #include "pw_hdlc/decoder.h"
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstring>
 
 #include "pw_bytes/array.h"
 #include "pw_fuzzer/fuzztest.h"
+#include "pw_hdlc/encoder.h"
 #include "pw_hdlc/internal/protocol.h"
+#include "pw_stream/memory_stream.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::hdlc {
@@ -154,6 +158,163 @@ TEST(Decoder, TooLargeForBuffer_DecodesNextFrame) {
   EXPECT_EQ(OkStatus(), decoder.Process(kFlag).status());
 }
 
+// A frame or error reported by a decoder, copied so that it outlives the
+// decoder's buffer.
+struct DecodedResult {
+  Status status;
+  uint64_t address = 0;
+  byte control{};
+  std::array<byte, 64> data{};
+  size_t data_size = 0;
+};
+
+bool operator==(const DecodedResult& lhs, const DecodedResult& rhs) {
+  return lhs.status == rhs.status && lhs.address == rhs.address &&
+         lhs.control == rhs.control && lhs.data_size == rhs.data_size &&
+         std::equal(lhs.data.begin(),
+                    lhs.data.begin() + lhs.data_size,
+                    rhs.data.begin());
+}
+
+class DecodedResults {
+ public:
+  void Add(const Result<Frame>& result) {
+    ASSERT_LT(count_, results_.size());
+    DecodedResult& decoded = results_[count_++];
+    decoded.status = result.status();
+    if (result.ok()) {
+      decoded.address = result->address();
+      decoded.control = result->control();
+      decoded.data_size = result->data().size();
+      std::copy(
+          result->data().begin(), result->data().end(), decoded.data.begin());
+    }
+  }
+
+  size_t size() const { return count_; }
+
+  const DecodedResult& operator[](size_t i) const { return results_[i]; }
+
+  size_t frames() const {
+    return static_cast<size_t>(
+        std::count_if(results_.begin(),
+                      results_.begin() + count_,
+                      [](const DecodedResult& r) { return r.status.ok(); }));
+  }
+
+ private:
+  std::array<DecodedResult, 32> results_;
+  size_t count_ = 0;
+};
+
+// Decodes data one byte at a time with Process(std::byte).
+template <size_t kBufferSize>
+void DecodeByteAtATime(ConstByteSpan data, DecodedResults& results) {
+  DecoderBuffer<kBufferSize> decoder;
+  for (byte b : data) {
+    Result<Frame> result = decoder.Process(b);
+    if (result.status() != Status::Unavailable()) {
+      results.Add(result);
+    }
+  }
+}
+
+// Decodes data with Process(ConstByteSpan), passing it chunk_size bytes at a
+// time.
+template <size_t kBufferSize>
+void DecodeInChunks(ConstByteSpan data,
+                    size_t chunk_size,
+                    DecodedResults& results) {
+  DecoderBuffer<kBufferSize> decoder;
+  while (!data.empty()) {
+    const size_t size = std::min(chunk_size, data.size());
+    decoder.Process(data.first(size), [&results](const Result<Frame>& result) {
+      results.Add(result);
+    });
+    data = data.subspan(size);
+  }
+}
+
+template <size_t kBufferSize>
+void ExpectSpanMatchesByteAtATime(ConstByteSpan data, size_t chunk_size) {
+  DecodedResults expected;
+  DecodeByteAtATime<kBufferSize>(data, expected);
+
+  DecodedResults actual;
+  DecodeInChunks<kBufferSize>(data, chunk_size, actual);
+
+  ASSERT_EQ(expected.size(), actual.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_TRUE(expected[i] == actual[i]) << "result " << i;
+  }
+}
+
+// Writes a stream with valid frames, frames with escaped bytes, and each kind
+// of invalid frame.
+ConstByteSpan WriteMixedStream(stream::MemoryWriter& writer) {
+  std::array<byte, 80> payload;
+  for (size_t i = 0; i < payload.size(); ++i) {
+    // Include plenty of flag and escape bytes.
+    payload[i] = i % 5 == 0 ? kFlag
+                 : i % 7 == 0 ? kEscape
+                              : static_cast<byte>(i * 37);
+  }
+
+  // Garbage before the first frame.
+  EXPECT_EQ(OkStatus(), writer.Write(bytes::String("junk")));
+
+  EXPECT_EQ(OkStatus(),
+            WriteUIFrame(1, bytes::String("hello, HDLC!"), writer));
+  EXPECT_EQ(OkStatus(), WriteUIFrame(0x7e, span(payload).first(3), writer));
+  EXPECT_EQ(OkStatus(), WriteUIFrame(1234, span(payload).first(40), writer));
+
+  // Too large for a 64-byte buffer.
+  EXPECT_EQ(OkStatus(), WriteUIFrame(5, payload, writer));
+
+  // Two escapes in a row, an escaped flag, and a frame that is too short.
+  EXPECT_EQ(OkStatus(), writer.Write(bytes::String("~12}}" "34~")));
+  EXPECT_EQ(OkStatus(), writer.Write(bytes::String("~12}~")));
+  EXPECT_EQ(OkStatus(), writer.Write(bytes::String("~12~~~")));
+
+  // A frame with a corrupted payload byte.
+  const size_t corrupt_frame_start = writer.bytes_written();
+  EXPECT_EQ(OkStatus(),
+            WriteUIFrame(3, bytes::String("corrupt this frame"), writer));
+  writer.data()[corrupt_frame_start + 5] = byte{'!'};
+
+  EXPECT_EQ(OkStatus(), WriteUIFrame(99, span(payload).first(50), writer));
+
+  // A frame that is not finished.
+  EXPECT_EQ(OkStatus(), writer.Write(bytes::String("~unfinished")));
+
+  return writer.WrittenData();
+}
+
+TEST(Decoder, ProcessSpan_MatchesProcessByte) {
+  stream::MemoryWriterBuffer<512> writer;
+  const ConstByteSpan data = WriteMixedStream(writer);
+
+  DecodedResults results;
+  DecodeByteAtATime<64>(data, results);
+  ASSERT_EQ(results.frames(), 4u);
+  ASSERT_EQ(results.size(), 10u);
+
+  for (size_t chunk_size : {1, 2, 3, 4, 5, 7, 8, 13, 16, 17, 64, 512}) {
+    ExpectSpanMatchesByteAtATime<64>(data, chunk_size);
+  }
+}
+
+TEST(Decoder, ProcessSpan_MatchesProcessByte_SmallBuffer) {
+  stream::MemoryWriterBuffer<512> writer;
+  const ConstByteSpan data = WriteMixedStream(writer);
+
+  for (size_t chunk_size : {1, 3, 8, 17, 512}) {
+    ExpectSpanMatchesByteAtATime<Frame::kMinContentSizeBytes>(data,
+                                                              chunk_size);
+    ExpectSpanMatchesByteAtATime<13>(data, chunk_size);
+  }
+}
+
 void ProcessNeverCrashes(ConstByteSpan data) {
   DecoderBuffer<1024> decoder;
   for (byte b : data) {
@@ -166,5 +327,14 @@ void ProcessNeverCrashes(ConstByteSpan data) {
 FUZZ_TEST(Decoder, ProcessNeverCrashes)
     .WithDomains(VectorOf<1024>(Arbitrary<byte>()));
 
+void ProcessSpanMatchesProcessByte(ConstByteSpan data) {
+  ExpectSpanMatchesByteAtATime<64>(data, 7);
+  ExpectSpanMatchesByteAtATime<64>(data, data.size());
+}
+
+FUZZ_TEST(Decoder, ProcessSpanMatchesProcessByte)
+    .WithDomains(VectorOf<1024>(ElementOf<byte>(
+        {kFlag, kEscape, byte{0x5e}, byte{0x5d}, byte{0x01}, byte{0xff}})));
+
 }  // namespace
 }  // namespace pw::hdlc
@@ -14,13 +14,13 @@
 
 #include "pw_hdlc/encoder.h"
 
-#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstring>
 
 #include "pw_bytes/endian.h"
 #include "pw_hdlc/encoded_size.h"
+#include "pw_hdlc/internal/escape.h"
 #include "pw_span/span.h"
 #include "pw_varint/varint.h"
 
@@ -41,7 +41,7 @@ Status EscapeAndWrite(const byte b, stream::Writer& writer) {
 Status Encoder::WriteData(ConstByteSpan data) {
   auto begin = data.begin();
   while (true) {
-    auto end = std::find_if(begin, data.end(), NeedsEscaping);
+    auto end = begin + internal::FindByteToEscape(span(begin, data.end()));
 
     if (Status status = writer_.Write(span(begin, end)); !status.ok()) {
       return status;
@@ -101,4 +101,76 @@ Status WriteUIFrame(uint64_t address,
   return encoder.FinishFrame();
 }
 
+StatusWithSize WriteUIFrame(uint64_t address,
+                            ConstByteSpan payload,
+                            ByteSpan buffer) {
+  MemoryEncoder encoder(buffer);
+
+  if (Status status = encoder.StartUnnumberedFrame(address); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  if (Status status = encoder.WriteData(payload); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  if (Status status = encoder.FinishFrame(); !status.ok()) {
+    return StatusWithSize(status, 0);
+  }
+  return StatusWithSize(encoder.size());
+}
+
+Status MemoryEncoder::WriteData(ConstByteSpan data) {
+  ConstByteSpan remaining = data;
+  while (!remaining.empty()) {
+    const size_t run_size = internal::FindByteToEscape(remaining);
+    const size_t escape_size = run_size < remaining.size() ? 2 : 0;
+
+    if (run_size + escape_size > buffer_.size() - size_) {
+      return Status::ResourceExhausted();
+    }
+    std::memcpy(buffer_.data() + size_, remaining.data(), run_size);
+    size_ += run_size;
+
+    if (escape_size == 0u) {
+      break;
+    }
+    buffer_[size_++] = kEscape;
+    buffer_[size_++] = Escape(remaining[run_size]);
+    remaining = remaining.subspan(run_size + 1);
+  }
+
+  fcs_.Update(data);
+  return OkStatus();
+}
+
+Status MemoryEncoder::FinishFrame() {
+  if (Status status =
+          WriteData(bytes::CopyInOrder(endian::little, fcs_.value()));
+      !status.ok()) {
+    return status;
+  }
+  if (size_ == buffer_.size()) {
+    return Status::ResourceExhausted();
+  }
+  buffer_[size_++] = kFlag;
+  return OkStatus();
+}
+
+Status MemoryEncoder::StartFrame(uint64_t address, std::byte control) {
+  fcs_.clear();
+  if (size_ == buffer_.size()) {
+    return Status::ResourceExhausted();
+  }
+  buffer_[size_++] = kFlag;
+
+  std::array<std::byte, 16> metadata_buffer;
+  size_t metadata_size =
+      varint::Encode(address, metadata_buffer, kAddressFormat);
+  if (metadata_size == 0) {
+    return Status::InvalidArgument();
+  }
+
+  metadata_buffer[metadata_size++] = control;
+  return WriteData(span(metadata_buffer).first(metadata_size));
+}
+
 }  // namespace pw::hdlc
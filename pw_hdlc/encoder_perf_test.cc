@@ -0,0 +1,81 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+#include "pw_hdlc/encoded_size.h"
+#include "pw_hdlc/encoder.h"
+#include "pw_hdlc/internal/protocol.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::hdlc {
+namespace {
+
+constexpr uint64_t kAddress = 1;
+constexpr size_t kMaxPayloadSize = 256;
+
+std::array<std::byte, kMaxPayloadSize> payload;
+std::array<std::byte, MaxEncodedFrameSize(kMaxPayloadSize)> frame_buffer;
+
+// Fills the first payload_size bytes of the payload. One in every
+// `escape_interval` bytes is a flag or escape byte, or none if it is 0.
+ConstByteSpan FillPayload(size_t payload_size, size_t escape_interval) {
+  for (size_t i = 0; i < payload_size; ++i) {
+    payload[i] = static_cast<std::byte>(i * 37);
+    if (NeedsEscaping(payload[i])) {
+      payload[i] = std::byte{0};
+    }
+    if (escape_interval != 0u && i % escape_interval == 0u) {
+      payload[i] = i % 2 == 0u ? kFlag : kEscape;
+    }
+  }
+  return span(payload).first(payload_size);
+}
+
+// Measures how long it takes to encode a frame to a stream::MemoryWriter.
+void EncodeToStream(perf_test::State& state,
+                    size_t payload_size,
+                    size_t escape_interval) {
+  const ConstByteSpan data = FillPayload(payload_size, escape_interval);
+
+  while (state.KeepRunning()) {
+    stream::MemoryWriter writer(frame_buffer);
+    WriteUIFrame(kAddress, data, writer).IgnoreError();
+  }
+}
+
+// Measures how long it takes to encode a frame directly to a buffer.
+void EncodeToBuffer(perf_test::State& state,
+                    size_t payload_size,
+                    size_t escape_interval) {
+  const ConstByteSpan data = FillPayload(payload_size, escape_interval);
+
+  while (state.KeepRunning()) {
+    WriteUIFrame(kAddress, data, frame_buffer).IgnoreError();
+  }
+}
+
+PW_PERF_TEST(EncodeToStream16Bytes, EncodeToStream, 16, 0);
+PW_PERF_TEST(EncodeToStream256Bytes, EncodeToStream, 256, 0);
+PW_PERF_TEST(EncodeToStream256BytesEscaped, EncodeToStream, 256, 16);
+
+PW_PERF_TEST(EncodeToBuffer16Bytes, EncodeToBuffer, 16, 0);
+PW_PERF_TEST(EncodeToBuffer256Bytes, EncodeToBuffer, 256, 0);
+PW_PERF_TEST(EncodeToBuffer256BytesEscaped, EncodeToBuffer, 256, 16);
+
+}  // namespace
+}  // namespace pw::hdlc
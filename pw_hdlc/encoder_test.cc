@@ -194,5 +194,88 @@ TEST(WriteUIFrame, WriterError) {
             WriteUIFrame(kAddress, bytes::Array<0x01>(), writer));
 }
 
+// Fills a payload with a mix of runs that need no escaping and flag and escape
+// bytes.
+template <size_t kSize>
+constexpr std::array<byte, kSize> MixedPayload() {
+  std::array<byte, kSize> payload{};
+  for (size_t i = 0; i < kSize; ++i) {
+    payload[i] = i % 11 == 3 ? kFlag
+                 : i % 13 == 5 ? kEscape
+                               : static_cast<byte>(i * 7);
+  }
+  return payload;
+}
+
+constexpr auto kMixedPayload = MixedPayload<200>();
+
+TEST(WriteUIFrameToBuffer, MatchesStream) {
+  std::array<byte, MaxEncodedFrameSize(kMixedPayload.size())> expected;
+  std::array<byte, MaxEncodedFrameSize(kMixedPayload.size())> actual;
+
+  for (size_t size = 0; size <= kMixedPayload.size(); size += 9) {
+    const ConstByteSpan payload = span(kMixedPayload).first(size);
+
+    stream::MemoryWriter writer(expected);
+    ASSERT_EQ(OkStatus(), WriteUIFrame(kAddress, payload, writer));
+
+    const StatusWithSize result = WriteUIFrame(kAddress, payload, actual);
+    ASSERT_EQ(OkStatus(), result.status());
+    ASSERT_EQ(writer.bytes_written(), result.size());
+    EXPECT_EQ(0, std::memcmp(expected.data(), actual.data(), result.size()));
+  }
+}
+
+TEST(WriteUIFrameToBuffer, BufferTooSmall_StaysWithinBuffer) {
+  constexpr auto kPayload = bytes::Array<0x7E, 0x7B, 0x61, 0x7D, 0x7E>();
+  std::array<byte, MaxEncodedFrameSize(kPayload.size())> buffer;
+
+  const StatusWithSize encoded = WriteUIFrame(kAddress, kPayload, buffer);
+  ASSERT_EQ(OkStatus(), encoded.status());
+
+  for (size_t size = 0; size < encoded.size(); ++size) {
+    buffer.fill(byte{'?'});
+    EXPECT_EQ(Status::ResourceExhausted(),
+              WriteUIFrame(kAddress, kPayload, span(buffer).first(size))
+                  .status());
+    for (size_t i = size; i < buffer.size(); ++i) {
+      ASSERT_EQ(byte{'?'}, buffer[i]);
+    }
+  }
+}
+
+TEST(MemoryEncoder, MatchesEncoder) {
+  std::array<byte, 2 * MaxEncodedFrameSize(kMixedPayload.size())> expected;
+  stream::MemoryWriter writer(expected);
+  Encoder encoder(writer);
+
+  std::array<byte, 2 * MaxEncodedFrameSize(kMixedPayload.size())> actual;
+  MemoryEncoder memory_encoder(actual);
+
+  // Write two frames, with the payload split into pieces of different sizes.
+  for (size_t piece_size : {1u, 17u}) {
+    ASSERT_EQ(OkStatus(), encoder.StartUnnumberedFrame(kAddress));
+    ASSERT_EQ(OkStatus(), memory_encoder.StartUnnumberedFrame(kAddress));
+
+    ConstByteSpan payload = kMixedPayload;
+    while (!payload.empty()) {
+      const ConstByteSpan piece =
+          payload.first(std::min(piece_size, payload.size()));
+      ASSERT_EQ(OkStatus(), encoder.WriteData(piece));
+      ASSERT_EQ(OkStatus(), memory_encoder.WriteData(piece));
+      payload = payload.subspan(piece.size());
+    }
+
+    ASSERT_EQ(OkStatus(), encoder.FinishFrame());
+    ASSERT_EQ(OkStatus(), memory_encoder.FinishFrame());
+  }
+
+  ASSERT_EQ(writer.bytes_written(), memory_encoder.size());
+  EXPECT_EQ(0,
+            std::memcmp(expected.data(),
+                        memory_encoder.data().data(),
+                        memory_encoder.size()));
+}
+
 }  // namespace
 }  // namespace pw::hdlc
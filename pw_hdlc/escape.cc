@@ -0,0 +1,80 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_hdlc/internal/escape.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "lib/stdcompat/bit.h"
+#include "pw_hdlc/internal/protocol.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif  // defined(__SSE2__)
+
+namespace pw::hdlc::internal {
+namespace {
+
+constexpr uint64_t kLowBits = 0x0101010101010101u;
+constexpr uint64_t kHighBits = 0x8080808080808080u;
+
+// True if any of the 8 bytes in word equals the byte repeated in pattern.
+constexpr bool WordContains(uint64_t word, uint64_t pattern) {
+  word ^= pattern;
+  return ((word - kLowBits) & ~word & kHighBits) != 0u;
+}
+
+}  // namespace
+
+size_t FindByteToEscape(ConstByteSpan data) {
+  const std::byte* const bytes = data.data();
+  size_t i = 0;
+
+#if defined(__SSE2__)
+  const __m128i flags = _mm_set1_epi8(static_cast<char>(kFlag));
+  const __m128i escapes = _mm_set1_epi8(static_cast<char>(kEscape));
+
+  for (; i + sizeof(__m128i) <= data.size(); i += sizeof(__m128i)) {
+    const __m128i chunk =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+    const int matches = _mm_movemask_epi8(_mm_or_si128(
+        _mm_cmpeq_epi8(chunk, flags), _mm_cmpeq_epi8(chunk, escapes)));
+    if (matches != 0) {
+      return i + static_cast<size_t>(
+                     cpp20::countr_zero(static_cast<unsigned>(matches)));
+    }
+  }
+#endif  // defined(__SSE2__)
+
+  constexpr uint64_t kFlags = kLowBits * static_cast<uint8_t>(kFlag);
+  constexpr uint64_t kEscapes = kLowBits * static_cast<uint8_t>(kEscape);
+
+  for (; i + sizeof(uint64_t) <= data.size(); i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, bytes + i, sizeof(word));
+    if (WordContains(word, kFlags) || WordContains(word, kEscapes)) {
+      break;  // Find the byte in the loop below.
+    }
+  }
+
+  for (; i < data.size(); ++i) {
+    if (NeedsEscaping(bytes[i])) {
+      return i;
+    }
+  }
+  return data.size();
+}
+
+}  // namespace pw::hdlc::internal
@@ -112,10 +112,15 @@ class Decoder {
 
   /// @brief Processes a span of data and calls the provided callback with each
   /// frame or error.
+  ///
+  /// Produces the same results as passing each byte to ``Process(std::byte)``,
+  /// but handles the data a run at a time: it searches for flag and escape
+  /// bytes, copies the bytes between them to the frame buffer in bulk, and
+  /// updates the frame check sequence once per run.
   template <typename F, typename... Args>
   void Process(ConstByteSpan data, F&& callback, Args&&... args) {
-    for (std::byte b : data) {
-      auto result = Process(b);
+    while (!data.empty()) {
+      auto result = ProcessUntilResult(data);
       if (result.status() != Status::Unavailable()) {
         callback(std::forward<Args>(args)..., result);
       }
@@ -145,8 +150,16 @@ class Decoder {
     fcs_.clear();
   }
 
+  // Processes bytes from the front of data until one of them produces a frame
+  // or an error, which is returned, or data is empty. Consumed bytes are
+  // removed from data.
+  Result<Frame> ProcessUntilResult(ConstByteSpan& data);
+
   void AppendByte(std::byte new_byte);
 
+  // Appends a run of bytes that contains no flag or escape bytes.
+  void AppendBytes(ConstByteSpan data);
+
   Status CheckFrame() const;
 
   bool VerifyFrameCheckSequence() const;
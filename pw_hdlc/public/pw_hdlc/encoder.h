@@ -20,6 +20,7 @@
 #include "pw_checksum/crc32.h"
 #include "pw_hdlc/internal/protocol.h"
 #include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
 #include "pw_stream/stream.h"
 
 namespace pw::hdlc {
@@ -61,6 +62,37 @@ Status WriteUIFrame(uint64_t address,
                     ConstByteSpan payload,
                     stream::Writer& writer);
 
+/// @brief Encodes an HDLC unnumbered information frame (UI frame) directly
+/// into ``buffer``.
+///
+/// This is faster than ``WriteUIFrame`` with a ``pw::stream::MemoryWriter``.
+/// The payload is copied in bulk between the bytes that need escaping, and
+/// there are no virtual calls per run. A buffer of
+/// ``MaxEncodedFrameSize(address, payload)`` bytes always fits the frame.
+///
+/// @param address The frame address.
+///
+/// @param payload The frame data to encode.
+///
+/// @param buffer The buffer to encode the frame to.
+///
+/// @returns @rst
+///
+/// .. pw-status-codes::
+///
+///    OK: The frame was encoded. The size is the number of bytes of
+///    ``buffer`` that hold the frame.
+///
+///    RESOURCE_EXHAUSTED: The frame does not fit in ``buffer``.
+///
+///    INVALID_ARGUMENT: The start of the write failed. Check
+///    for problems in your ``address`` argument's value.
+///
+/// @endrst
+StatusWithSize WriteUIFrame(uint64_t address,
+                            ConstByteSpan payload,
+                            ByteSpan buffer);
+
 /// Encodes and writes HDLC frames.
 class Encoder {
  public:
@@ -90,4 +122,44 @@ class Encoder {
   checksum::Crc32 fcs_;
 };
 
+/// Encodes HDLC frames directly into a buffer, such as a ``pw::multibuf``
+/// chunk sized with ``MaxEncodedFrameSize``. Has the same interface as
+/// ``Encoder``, but copies runs of bytes that don't need escaping straight to
+/// the buffer instead of writing them to a stream.
+///
+/// Frames are encoded one after another. If an operation returns
+/// ``RESOURCE_EXHAUSTED``, the frame did not fit and the buffer holds part of
+/// it.
+class MemoryEncoder {
+ public:
+  /// Construct an encoder which will encode frames to ``buffer``.
+  constexpr MemoryEncoder(ByteSpan buffer) : buffer_(buffer), size_(0) {}
+
+  /// Writes the header for an U-frame. After successfully calling
+  /// StartUnnumberedFrame, WriteData may be called any number of times.
+  Status StartUnnumberedFrame(uint64_t address) {
+    return StartFrame(address, UFrameControl::UnnumberedInformation().data());
+  }
+
+  /// Writes data for an ongoing frame. Must only be called after a successful
+  /// StartUnnumberedFrame call, and prior to a FinishFrame() call.
+  Status WriteData(ConstByteSpan data);
+
+  /// Finishes a frame. Writes the frame check sequence and a terminating flag.
+  Status FinishFrame();
+
+  /// The bytes encoded so far.
+  ConstByteSpan data() const { return buffer_.first(size_); }
+
+  /// The number of bytes encoded so far.
+  size_t size() const { return size_; }
+
+ private:
+  Status StartFrame(uint64_t address, std::byte control);
+
+  ByteSpan buffer_;
+  size_t size_;
+  checksum::Crc32 fcs_;
+};
+
 }  // namespace pw::hdlc
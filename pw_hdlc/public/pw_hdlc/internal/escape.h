@@ -0,0 +1,27 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+
+#include "pw_bytes/span.h"
+
+namespace pw::hdlc::internal {
+
+// Returns the index of the first flag or escape byte in data, or data.size()
+// if there is none. Checks 16 bytes at a time with SSE2 when it is available
+// and 8 bytes at a time otherwise.
+size_t FindByteToEscape(ConstByteSpan data);
+
+}  // namespace pw::hdlc::internal
@@ -18,12 +18,13 @@
 
 #include <algorithm>
 
+#include "pw_hdlc/encoded_size.h"
 #include "pw_hdlc/encoder.h"
 #include "pw_log/log.h"
 #include "pw_multibuf/multibuf.h"
 #include "pw_multibuf/stream.h"
 #include "pw_result/result.h"
-#include "pw_stream/null_stream.h"
+#include "pw_status/try.h"
 
 namespace pw::hdlc {
 
@@ -35,15 +36,15 @@ using ::pw::channel::ByteReaderWriter;
 using ::pw::channel::DatagramReaderWriter;
 using ::pw::multibuf::Chunk;
 using ::pw::multibuf::MultiBuf;
-using ::pw::stream::CountingNullStream;
 
 namespace {
 
-/// HDLC encodes the contents of ``payload`` to ``writer``.
+/// HDLC encodes the contents of ``payload`` with ``encoder``, which is an
+/// ``Encoder`` or a ``MemoryEncoder``.
+template <typename EncoderType>
 Status WriteMultiBufUIFrame(uint64_t address,
                             const MultiBuf& payload,
-                            stream::Writer& writer) {
-  Encoder encoder(writer);
+                            EncoderType& encoder) {
   if (Status status = encoder.StartUnnumberedFrame(address); !status.ok()) {
     return status;
   }
@@ -55,15 +56,33 @@ Status WriteMultiBufUIFrame(uint64_t address,
   return encoder.FinishFrame();
 }
 
-/// Calculates the size of ``payload`` once HDLC-encoded.
-Result<size_t> CalculateSizeOnceEncoded(uint64_t address,
-                                        const MultiBuf& payload) {
-  CountingNullStream null_stream;
-  Status encode_status = WriteMultiBufUIFrame(address, payload, null_stream);
-  if (!encode_status.ok()) {
-    return encode_status;
+/// Calculates the maximum size of ``payload`` once HDLC-encoded. This only
+/// counts the payload bytes that need escaping, so it is much cheaper than
+/// encoding the frame.
+size_t MaxEncodedMultiBufFrameSize(uint64_t address, const MultiBuf& payload) {
+  size_t size = MaxEncodedFrameSize(address, ConstByteSpan());
+  for (const Chunk& chunk : payload.Chunks()) {
+    size += EscapedSize(chunk);
+  }
+  return size;
+}
+
+/// HDLC encodes the contents of ``payload`` to ``buffer``, which must be large
+/// enough to hold the encoded frame. Returns the size of the encoded frame.
+Result<size_t> EncodeMultiBufUIFrame(uint64_t address,
+                                     const MultiBuf& payload,
+                                     MultiBuf& buffer) {
+  // When the buffer is contiguous, encode straight into its memory.
+  if (buffer.Chunks().size() == 1) {
+    MemoryEncoder encoder(buffer.Chunks().front());
+    PW_TRY(WriteMultiBufUIFrame(address, payload, encoder));
+    return encoder.size();
   }
-  return null_stream.bytes_written();
+
+  multibuf::Stream stream(buffer);
+  Encoder encoder(stream);
+  PW_TRY(WriteMultiBufUIFrame(address, payload, encoder));
+  return stream.Tell();
 }
 
 /// Attempts to decode a frame from ``data``, advancing ``data`` forwards by
@@ -264,20 +283,12 @@ void Router::WriteOutgoingMessages(Context& cx) {
       return;
     }
     if (!outgoing_allocation_future_.has_value()) {
-      Result<size_t> encoded_size = CalculateSizeOnceEncoded(
-          address_to_encode_and_send_to_, *buffer_to_encode_and_send_);
-      if (!encoded_size.ok()) {
-        PW_LOG_ERROR(
-            "Unable to compute size of encoded packet for outgoing buffer of "
-            "size %zu destined for outgoing HDLC address %" PRIu64
-            ". Packet will be discarded.",
-            buffer_to_encode_and_send_->size(),
-            address_to_encode_and_send_to_);
-        buffer_to_encode_and_send_ = std::nullopt;
-        continue;
-      }
+      // Allocate the maximum size and truncate the buffer once the frame is
+      // encoded, so that the frame is only encoded once.
       outgoing_allocation_future_ =
-          io_channel_.GetWriteAllocator().AllocateAsync(*encoded_size);
+          io_channel_.GetWriteAllocator().AllocateAsync(
+              MaxEncodedMultiBufFrameSize(address_to_encode_and_send_to_,
+                                          *buffer_to_encode_and_send_));
     }
     Poll<std::optional<MultiBuf>> maybe_write_buffer =
         outgoing_allocation_future_->Pend(cx);
@@ -300,19 +311,20 @@ void Router::WriteOutgoingMessages(Context& cx) {
       continue;
     }
     MultiBuf write_buffer = std::move(**maybe_write_buffer);
-    Status encode_status =
-        WriteMultiBufUIFrame(address_to_encode_and_send_to_,
-                             *buffer_to_encode_and_send_,
-                             pw::multibuf::Stream(write_buffer));
+    Result<size_t> encoded_size =
+        EncodeMultiBufUIFrame(address_to_encode_and_send_to_,
+                              *buffer_to_encode_and_send_,
+                              write_buffer);
     buffer_to_encode_and_send_ = std::nullopt;
-    if (!encode_status.ok()) {
+    if (!encoded_size.ok()) {
       PW_LOG_ERROR(
           "Failed to encode a buffer destined for outgoing HDLC address "
           "%" PRIu64 ". Status: %d",
           address_to_encode_and_send_to_,
-          encode_status.code());
+          encoded_size.status().code());
       continue;
     }
+    write_buffer.Truncate(*encoded_size);
     Status write_status = io_channel_.Write(std::move(write_buffer)).status();
     if (!write_status.ok()) {
       PW_LOG_ERROR(
@@ -0,0 +1,230 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#define PW_LOG_MODULE_NAME "KVS"
+#define PW_LOG_LEVEL PW_KVS_LOG_LEVEL
+
+#include "pw_kvs/internal/checkpoint.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#include "pw_bytes/alignment.h"
+#include "pw_kvs_private/config.h"
+#include "pw_log/log.h"
+#include "pw_status/try.h"
+
+namespace pw::kvs::internal {
+
+StatusWithSize CheckpointLog::RecordOutput::DoWrite(
+    span<const std::byte> data) {
+  PW_TRY_WITH_SIZE(partition_->Write(address_, data));
+  crc_.Update(data);
+  address_ += data.size();
+  bytes_written_ += data.size();
+  return StatusWithSize(data.size());
+}
+
+size_t CheckpointLog::header_size() const {
+  return AlignUp(sizeof(RecordHeader), alignment_bytes());
+}
+
+size_t CheckpointLog::marker_size() const {
+  return AlignUp(sizeof(uint32_t), alignment_bytes());
+}
+
+size_t CheckpointLog::crc_size() const {
+  return AlignUp(sizeof(uint32_t), alignment_bytes());
+}
+
+size_t CheckpointLog::aligned_payload_size(size_t payload_size) const {
+  return AlignUp(payload_size, alignment_bytes());
+}
+
+size_t CheckpointLog::record_size(size_t payload_size) const {
+  return header_size() + marker_size() + aligned_payload_size(payload_size) +
+         crc_size();
+}
+
+Status CheckpointLog::Open() {
+  record_valid_ = false;
+  payload_size_ = 0;
+
+  if (alignment_bytes() > kMaxFlashAlignment) {
+    return Status::InvalidArgument();
+  }
+
+  bool record_found = false;
+  Address address = 0;
+
+  while (address + header_size() <= partition_->size_bytes()) {
+    RecordHeader header;
+    PW_TRY(partition_->Read(address, sizeof(header), &header).status());
+
+    if (header.magic != kMagic) {
+      // Anything but erased flash is left over from an interrupted write. Start
+      // over with an erased log rather than appending after it.
+      if (!partition_->AppearsErased(as_bytes(span(&header, 1)))) {
+        address = partition_->size_bytes();
+      }
+      break;
+    }
+
+    if (header.payload_size > partition_->size_bytes() ||
+        record_size(header.payload_size) > partition_->size_bytes() - address) {
+      address = partition_->size_bytes();
+      break;
+    }
+
+    record_found = true;
+    record_address_ = address;
+    payload_size_ = header.payload_size;
+    address += record_size(header.payload_size);
+  }
+
+  end_address_ = address;
+
+  if (!record_found) {
+    return Status::NotFound();
+  }
+  return Validate();
+}
+
+Status CheckpointLog::Validate() {
+  bool marker_erased;
+  PW_TRY(partition_->IsRegionErased(
+      record_address_ + header_size(), marker_size(), &marker_erased));
+  if (!marker_erased) {
+    PW_LOG_DEBUG("Checkpoint at address %u was invalidated",
+                 unsigned(record_address_));
+    return Status::NotFound();
+  }
+
+  checksum::Crc32 crc;
+  std::array<std::byte, 64> buffer;
+  const size_t aligned_size = aligned_payload_size(payload_size_);
+
+  for (size_t offset = 0; offset < aligned_size; offset += buffer.size()) {
+    const size_t chunk_size = std::min(buffer.size(), aligned_size - offset);
+    PW_TRY(partition_->Read(payload_address() + offset, chunk_size, &buffer)
+               .status());
+    crc.Update(span(buffer.data(), chunk_size));
+  }
+
+  uint32_t stored_crc;
+  PW_TRY(partition_
+             ->Read(payload_address() + aligned_size,
+                    sizeof(stored_crc),
+                    &stored_crc)
+             .status());
+  if (stored_crc != crc.value()) {
+    PW_LOG_DEBUG("Checkpoint at address %u is incomplete or corrupt",
+                 unsigned(record_address_));
+    return Status::NotFound();
+  }
+
+  record_valid_ = true;
+  return OkStatus();
+}
+
+Status CheckpointLog::ReadPayload(size_t offset, span<std::byte> data) const {
+  if (!record_valid_ || offset + data.size() > payload_size_) {
+    return Status::OutOfRange();
+  }
+  return partition_->Read(payload_address() + offset, data).status();
+}
+
+Status CheckpointLog::Invalidate() {
+  if (!record_valid_) {
+    return OkStatus();
+  }
+
+  std::array<std::byte, kMaxFlashAlignment> marker;
+  std::memset(marker.data(),
+              ~static_cast<int>(partition_->erased_memory_content()),
+              marker_size());
+
+  record_valid_ = false;
+  const Address marker_address = record_address_ + header_size();
+  return partition_->Write(marker_address, span(marker.data(), marker_size()))
+      .status();
+}
+
+Status CheckpointLog::BeginRecord(size_t payload_size, RecordOutput& output) {
+  if (alignment_bytes() > kMaxFlashAlignment) {
+    return Status::InvalidArgument();
+  }
+
+  const size_t size = record_size(payload_size);
+  if (size > partition_->size_bytes()) {
+    return Status::ResourceExhausted();
+  }
+
+  record_valid_ = false;
+
+  if (size > partition_->size_bytes() - end_address_) {
+    PW_LOG_DEBUG("Checkpoint log is full; erasing it");
+    PW_TRY(partition_->Erase());
+    end_address_ = 0;
+  }
+
+  record_address_ = end_address_;
+  payload_size_ = payload_size;
+
+  // Skip this record from now on, even if writing it fails partway.
+  end_address_ += size;
+
+  std::array<std::byte, kMaxFlashAlignment> header_buffer{};
+  const RecordHeader header{
+      .magic = kMagic,
+      .payload_size = static_cast<uint32_t>(payload_size),
+  };
+  std::memcpy(header_buffer.data(), &header, sizeof(header));
+
+  const Status status =
+      partition_
+          ->Write(record_address_, span(header_buffer.data(), header_size()))
+          .status();
+  if (!status.ok()) {
+    // The log may hold data that was not written by it. Erase it next time.
+    end_address_ = partition_->size_bytes();
+    return status;
+  }
+
+  output.partition_ = partition_;
+  output.address_ = payload_address();
+  output.bytes_written_ = 0;
+  output.crc_.clear();
+  return OkStatus();
+}
+
+Status CheckpointLog::FinishRecord(const RecordOutput& output) {
+  if (output.bytes_written_ != aligned_payload_size(payload_size_)) {
+    return Status::Internal();
+  }
+
+  std::array<std::byte, kMaxFlashAlignment> crc_buffer{};
+  const uint32_t crc = output.crc_.value();
+  std::memcpy(crc_buffer.data(), &crc, sizeof(crc));
+
+  PW_TRY(partition_
+             ->Write(payload_address() + output.bytes_written_,
+                     span(crc_buffer.data(), crc_size()))
+             .status());
+  record_valid_ = true;
+  return OkStatus();
+}
+
+}  // namespace pw::kvs::internal
@@ -17,6 +17,7 @@
 
 #include "pw_kvs/internal/entry_cache.h"
 
+#include <algorithm>
 #include <cinttypes>
 
 #include "pw_assert/check.h"
@@ -69,53 +70,54 @@ StatusWithSize EntryCache::Find(FlashPartition& partition,
   Entry::KeyBuffer key_buffer;
   bool error_detected = false;
 
-  for (size_t i = 0; i < descriptors_.size(); ++i) {
-    if (descriptors_[i].key_hash == hash) {
-      bool key_found = false;
-      Key read_key;
-
-      for (Address address : addresses(i)) {
-        Status read_result =
-            Entry::ReadKey(partition, address, key.size(), key_buffer.data());
-
-        read_key = Key(key_buffer.data(), key.size());
-
-        if (read_result.ok() && hash == internal::Hash(read_key)) {
-          key_found = true;
-          break;
-        } else {
-          // A hash mismatch can be caused by reading invalid data or a key hash
-          // collision of keys with differing size. To verify the data read from
-          // flash is good, validate the entry.
-          Entry entry;
-          read_result = Entry::Read(partition, address, formats, &entry);
-          if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
-            key_found = true;
-            break;
-          }
-
-          PW_LOG_WARN(
-              "   Found corrupt entry, invalidating this copy of the key");
-          error_detected = true;
-          sectors.FromAddress(address).mark_corrupt();
-        }
-      }
-      size_t error_val = error_detected ? 1 : 0;
-
-      if (!key_found) {
-        PW_LOG_ERROR("No valid entries for key. Data has been lost!");
-        return StatusWithSize::DataLoss(error_val);
-      } else if (key == read_key) {
-        PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
-        *metadata = EntryMetadata(descriptors_[i], addresses(i));
-        return StatusWithSize(error_val);
-      } else {
-        PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
-        return StatusWithSize::AlreadyExists(error_val);
+  const int index = FindIndex(hash);
+  if (index == -1) {
+    return StatusWithSize::NotFound();
+  }
+
+  const size_t i = static_cast<size_t>(index);
+
+  bool key_found = false;
+  Key read_key;
+
+  for (Address address : addresses(i)) {
+    Status read_result =
+        Entry::ReadKey(partition, address, key.size(), key_buffer.data());
+
+    read_key = Key(key_buffer.data(), key.size());
+
+    if (read_result.ok() && hash == internal::Hash(read_key)) {
+      key_found = true;
+      break;
+    } else {
+      // A hash mismatch can be caused by reading invalid data or a key hash
+      // collision of keys with differing size. To verify the data read from
+      // flash is good, validate the entry.
+      Entry entry;
+      read_result = Entry::Read(partition, address, formats, &entry);
+      if (read_result.ok() && entry.VerifyChecksumInFlash().ok()) {
+        key_found = true;
+        break;
       }
+
+      PW_LOG_WARN("   Found corrupt entry, invalidating this copy of the key");
+      error_detected = true;
+      sectors.FromAddress(address).mark_corrupt();
     }
   }
-  return StatusWithSize::NotFound();
+  size_t error_val = error_detected ? 1 : 0;
+
+  if (!key_found) {
+    PW_LOG_ERROR("No valid entries for key. Data has been lost!");
+    return StatusWithSize::DataLoss(error_val);
+  } else if (key == read_key) {
+    PW_LOG_DEBUG("Found match for key hash 0x%08" PRIx32, hash);
+    *metadata = EntryMetadata(descriptors_[i], addresses(i));
+    return StatusWithSize(error_val);
+  } else {
+    PW_LOG_WARN("Found key hash collision for 0x%08" PRIx32, hash);
+    return StatusWithSize::AlreadyExists(error_val);
+  }
 }
 
 EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
@@ -123,6 +125,7 @@ EntryMetadata EntryCache::AddNew(const KeyDescriptor& descriptor,
   // TODO(hepler): DCHECK(!full());
   Address* first_address = ResetAddresses(descriptors_.size(), address);
   descriptors_.push_back(descriptor);
+  AddToKeyIndex();
   return EntryMetadata(descriptors_.back(), span(first_address, 1));
 }
 
@@ -138,6 +141,8 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
   // deleted descriptor's space and then pops the last entry.
   Address* addresses_at_end = first_address(descriptors_.size() - 1);
 
+  RemoveFromKeyIndex(index_to_remove);
+
   if (index_to_remove < descriptors_.size() - 1) {
     Address* addresses_to_remove = first_address(index_to_remove);
     for (unsigned int i = 0; i < redundancy_; i++) {
@@ -152,10 +157,10 @@ EntryCache::iterator EntryCache::RemoveEntry(iterator& entry_it) {
   return {this, descriptors_.data() + index_to_remove};
 }
 
-// TODO(hepler): This method is the trigger of the O(valid_entries *
-// all_entries) time complexity for reading. At some cost to memory, this could
-// be optimized by using a hash table instead of scanning, but in practice this
-// should be fine for a small number of keys
+// This method is called for every entry read from flash. If the cache is
+// indexed, FindIndex is a binary search over the key index. Otherwise, it scans
+// the descriptors, which makes reading O(valid_entries * all_entries); this is
+// fine for a small number of keys.
 Status EntryCache::AddNewOrUpdateExisting(const KeyDescriptor& descriptor,
                                           Address address,
                                           size_t sector_size_bytes) const {
@@ -220,6 +225,15 @@ size_t EntryCache::present_entries() const {
 }
 
 int EntryCache::FindIndex(uint32_t key_hash) const {
+  if (indexed()) {
+    const size_t position = KeyIndexLowerBound(key_hash, descriptors_.size());
+    if (position < descriptors_.size() &&
+        descriptors_[key_index_[position]].key_hash == key_hash) {
+      return key_index_[position];
+    }
+    return -1;
+  }
+
   for (size_t i = 0; i < descriptors_.size(); ++i) {
     if (descriptors_[i].key_hash == key_hash) {
       return i;
@@ -228,6 +242,55 @@ int EntryCache::FindIndex(uint32_t key_hash) const {
   return -1;
 }
 
+size_t EntryCache::KeyIndexLowerBound(uint32_t key_hash,
+                                      size_t entries) const {
+  IndexEntry* const end = key_index_ + entries;
+  return static_cast<size_t>(
+      std::lower_bound(key_index_,
+                       end,
+                       key_hash,
+                       [this](IndexEntry index, uint32_t hash) {
+                         return descriptors_[index].key_hash < hash;
+                       }) -
+      key_index_);
+}
+
+void EntryCache::AddToKeyIndex() const {
+  if (!indexed()) {
+    return;
+  }
+
+  // The new descriptor is the last one, so key_index_ has one open slot at the
+  // end. Shift larger hashes up to make room for it.
+  const size_t new_index = descriptors_.size() - 1;
+  const size_t position =
+      KeyIndexLowerBound(descriptors_[new_index].key_hash, new_index);
+  std::copy_backward(key_index_ + position,
+                     key_index_ + new_index,
+                     key_index_ + new_index + 1);
+  key_index_[position] = static_cast<IndexEntry>(new_index);
+}
+
+void EntryCache::RemoveFromKeyIndex(size_t index_to_remove) const {
+  if (!indexed()) {
+    return;
+  }
+
+  const size_t last_index = descriptors_.size() - 1;
+  const size_t position = KeyIndexLowerBound(
+      descriptors_[index_to_remove].key_hash, descriptors_.size());
+  std::copy(key_index_ + position + 1,
+            key_index_ + descriptors_.size(),
+            key_index_ + position);
+
+  // The last descriptor is about to move into the removed descriptor's slot.
+  if (index_to_remove != last_index) {
+    key_index_[KeyIndexLowerBound(descriptors_[last_index].key_hash,
+                                  last_index)] =
+        static_cast<IndexEntry>(index_to_remove);
+  }
+}
+
 void EntryCache::AddAddressIfRoom(size_t descriptor_index,
                                   Address address) const {
   Address* const existing = first_address(descriptor_index);
@@ -194,6 +194,90 @@ TEST_F(EmptyEntryCache, Iterator_Const_CanBeAssignedFromMutable) {
   EXPECT_EQ(99u, it->first_address());
 }
 
+class IndexedEntryCache : public ::testing::Test {
+ protected:
+  static constexpr size_t kMaxEntries = 32;
+  static constexpr size_t kRedundancy = 2;
+
+  IndexedEntryCache()
+      : entries_(descriptors_, addresses_, kRedundancy, key_index_) {}
+
+  // Spreads out the hashes so they are not added in sorted order.
+  static constexpr uint32_t HashFor(uint32_t i) { return i * 0x9e3779b9u; }
+
+  // Adds entries [first, last) with transaction ID 1.
+  void AddEntries(uint32_t first, uint32_t last) {
+    for (uint32_t i = first; i < last; ++i) {
+      ASSERT_EQ(OkStatus(),
+                entries_.AddNewOrUpdateExisting(
+                    {HashFor(i), 1, EntryState::kValid}, i * 10, 1));
+    }
+  }
+
+  // Returns true if the entry is found, by updating it to a newer transaction.
+  bool UpdateEntry(uint32_t i, uint32_t transaction_id) {
+    const size_t total_entries = entries_.total_entries();
+    EXPECT_EQ(
+        OkStatus(),
+        entries_.AddNewOrUpdateExisting(
+            {HashFor(i), transaction_id, EntryState::kValid}, i * 10 + 1, 1));
+    return entries_.total_entries() == total_entries;
+  }
+
+  Vector<KeyDescriptor, kMaxEntries> descriptors_;
+  EntryCache::AddressList<kMaxEntries, kRedundancy> addresses_;
+  EntryCache::IndexEntry key_index_[kMaxEntries];
+
+  EntryCache entries_;
+};
+
+TEST_F(IndexedEntryCache, AddNewOrUpdateExisting_FindsEveryEntry) {
+  ASSERT_TRUE(entries_.indexed());
+  AddEntries(0, kMaxEntries);
+  ASSERT_TRUE(entries_.full());
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    EXPECT_TRUE(UpdateEntry(i, 2));
+  }
+
+  for (const EntryMetadata& entry : entries_) {
+    EXPECT_EQ(2u, entry.transaction_id());
+    EXPECT_EQ(1u, entry.first_address() % 10);
+  }
+}
+
+TEST_F(IndexedEntryCache, RemoveEntry_KeepsIndexConsistent) {
+  AddEntries(0, kMaxEntries);
+
+  // Remove entries with even hashes, as garbage collection would.
+  for (EntryCache::iterator it = entries_.begin(); it != entries_.end();) {
+    if (it->hash() % 2 == 0) {
+      it = entries_.RemoveEntry(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(kMaxEntries / 2, entries_.total_entries());
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    EXPECT_EQ(HashFor(i) % 2 != 0, UpdateEntry(i, 2));
+  }
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+}
+
+TEST_F(IndexedEntryCache, Reset_ClearsIndex) {
+  AddEntries(0, kMaxEntries / 2);
+  entries_.Reset();
+
+  AddEntries(kMaxEntries / 2, kMaxEntries);
+  EXPECT_EQ(kMaxEntries / 2, entries_.total_entries());
+
+  for (uint32_t i = 0; i < kMaxEntries; ++i) {
+    EXPECT_EQ(i >= kMaxEntries / 2, UpdateEntry(i, 2));
+  }
+  EXPECT_EQ(kMaxEntries, entries_.total_entries());
+}
+
 constexpr size_t kSectorSize = 64;
 constexpr uint32_t kMagic = 0xa14ae726;
 // For KVS entry magic value always use a random 32 bit integer rather than a
@@ -23,6 +23,7 @@
 #include <type_traits>
 
 #include "pw_assert/check.h"
+#include "pw_kvs/alignment.h"
 #include "pw_kvs_private/config.h"
 #include "pw_log/log.h"
 #include "pw_status/try.h"
@@ -36,6 +37,31 @@ constexpr bool InvalidKey(Key key) {
   return key.empty() || (key.size() > internal::Entry::kMaxKeyLength);
 }
 
+// Checkpoint payload layout: a CheckpointHeader, a CheckpointSector for each
+// sector, then a CheckpointKey for each key descriptor. Like entry headers,
+// fields are stored in the native byte order.
+struct CheckpointHeader {
+  uint32_t sector_size_bytes;
+  uint32_t sector_count;
+  uint32_t redundancy;
+  uint32_t entry_count;
+};
+
+struct CheckpointSector {
+  uint32_t writable_bytes;
+
+  // Transaction ID of the first entry in the sector, if there is one. Detects
+  // sectors that were erased and rewritten by something other than the KVS.
+  uint32_t first_transaction_id;
+};
+
+// Each CheckpointKey is followed by one address per redundant copy.
+struct CheckpointKey {
+  uint32_t key_hash;
+  uint32_t transaction_id;
+  uint32_t deleted;
+};
+
 }  // namespace
 
 KeyValueStore::KeyValueStore(FlashPartition* partition,
@@ -45,16 +71,19 @@ KeyValueStore::KeyValueStore(FlashPartition* partition,
                              Vector<SectorDescriptor>& sector_descriptor_list,
                              const SectorDescriptor** temp_sectors_to_skip,
                              Vector<KeyDescriptor>& key_descriptor_list,
-                             Address* addresses)
+                             Address* addresses,
+                             internal::EntryCache::IndexEntry* key_index)
     : partition_(*partition),
       formats_(formats),
       sectors_(sector_descriptor_list, *partition, temp_sectors_to_skip),
-      entry_cache_(key_descriptor_list, addresses, redundancy),
+      entry_cache_(key_descriptor_list, addresses, redundancy, key_index),
       options_(options),
+      checkpoint_log_(options.checkpoint_partition),
       initialized_(InitializationState::kNotInitialized),
       error_detected_(false),
       internal_stats_({}),
-      last_transaction_id_(0) {}
+      last_transaction_id_(0),
+      incremental_gc_sector_(nullptr) {}
 
 Status KeyValueStore::Init() {
   initialized_ = InitializationState::kNotInitialized;
@@ -132,6 +161,12 @@ Status KeyValueStore::Init() {
       unsigned(sectors_.size()),
       unsigned(partition_.sector_size_bytes()));
 
+  // Save the state that was just read so that the next Init() can use it.
+  if (initialized_ == InitializationState::kReady &&
+      !checkpoint_log_.has_valid_record()) {
+    UpdateCheckpoint();
+  }
+
   // Report any corruption was not repaired.
   if (error_detected_) {
     PW_LOG_WARN(
@@ -148,6 +183,25 @@ Status KeyValueStore::InitializeMetadata() {
 
   sectors_.Reset();
   entry_cache_.Reset();
+  incremental_gc_sector_ = nullptr;
+
+  bool checkpoint_loaded = false;
+  if (checkpoint_log_.enabled()) {
+    const Status checkpoint_status = LoadCheckpoint();
+    if (checkpoint_status.ok()) {
+      PW_LOG_INFO("Loaded checkpoint with %u keys",
+                  unsigned(entry_cache_.total_entries()));
+      checkpoint_loaded = true;
+    } else {
+      PW_LOG_INFO("Checkpoint not usable (%s); reading all entries",
+                  checkpoint_status.str());
+
+      // Don't use the checkpoint again. Init() writes a new one.
+      checkpoint_log_.Invalidate().IgnoreError();
+      sectors_.Reset();
+      entry_cache_.Reset();
+    }
+  }
 
   PW_LOG_DEBUG("First pass: Read all entries from all sectors");
   Address sector_address = 0;
@@ -160,56 +214,14 @@ Status KeyValueStore::InitializeMetadata() {
   for (SectorDescriptor& sector : sectors_) {
     Address entry_address = sector_address;
 
-    size_t sector_corrupt_bytes = 0;
-
-    for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
-      PW_LOG_DEBUG("Load entry: sector=%u, entry#=%d, address=%u",
-                   unsigned(sector_address),
-                   num_entries_in_sector,
-                   unsigned(entry_address));
-
-      if (!sectors_.AddressInSector(sector, entry_address)) {
-        PW_LOG_DEBUG("Fell off end of sector; moving to the next sector");
-        break;
-      }
-
-      Address next_entry_address;
-      Status status = LoadEntry(entry_address, &next_entry_address);
-      if (status.IsNotFound()) {
-        PW_LOG_DEBUG(
-            "Hit un-written data in sector; moving to the next sector");
-        break;
-      } else if (!status.ok()) {
-        // The entry could not be read, indicating likely data corruption within
-        // the sector. Try to scan the remainder of the sector for other
-        // entries.
-
-        error_detected_ = true;
-        corrupt_entries++;
-
-        status = ScanForEntry(sector,
-                              entry_address + Entry::kMinAlignmentBytes,
-                              &next_entry_address);
-        if (!status.ok()) {
-          // No further entries in this sector. Mark the remaining bytes in the
-          // sector as corrupt (since we can't reliably know the size of the
-          // corrupt entry).
-          sector_corrupt_bytes +=
-              sector_size_bytes - (entry_address - sector_address);
-          break;
-        }
-
-        sector_corrupt_bytes += next_entry_address - entry_address;
-      }
-
-      // Entry loaded successfully; so get ready to load the next one.
-      entry_address = next_entry_address;
-
-      // Update of the number of writable bytes in this sector.
-      sector.set_writable_bytes(sector_size_bytes -
-                                (entry_address - sector_address));
+    // Only entries written after the checkpoint need to be read.
+    if (checkpoint_loaded) {
+      entry_address += sector_size_bytes - sector.writable_bytes();
     }
 
+    const size_t sector_corrupt_bytes =
+        LoadSector(sector, entry_address, corrupt_entries);
+
     if (sector_corrupt_bytes > 0) {
       // If the sector contains corrupt data, prevent any further entries from
       // being written to it by indicating that it has no space. This should
@@ -307,6 +319,213 @@ Status KeyValueStore::InitializeMetadata() {
   return OkStatus();
 }
 
+size_t KeyValueStore::LoadSector(SectorDescriptor& sector,
+                                 Address entry_address,
+                                 size_t& corrupt_entries) {
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  const Address sector_address = sectors_.BaseAddress(sector);
+  size_t sector_corrupt_bytes = 0;
+
+  for (int num_entries_in_sector = 0; true; num_entries_in_sector++) {
+    PW_LOG_DEBUG("Load entry: sector=%u, entry#=%d, address=%u",
+                 unsigned(sector_address),
+                 num_entries_in_sector,
+                 unsigned(entry_address));
+
+    if (!sectors_.AddressInSector(sector, entry_address)) {
+      PW_LOG_DEBUG("Fell off end of sector; moving to the next sector");
+      break;
+    }
+
+    Address next_entry_address;
+    Status status = LoadEntry(entry_address, &next_entry_address);
+    if (status.IsNotFound()) {
+      PW_LOG_DEBUG("Hit un-written data in sector; moving to the next sector");
+      break;
+    } else if (!status.ok()) {
+      // The entry could not be read, indicating likely data corruption within
+      // the sector. Try to scan the remainder of the sector for other entries.
+
+      error_detected_ = true;
+      corrupt_entries++;
+
+      status = ScanForEntry(sector,
+                            entry_address + Entry::kMinAlignmentBytes,
+                            &next_entry_address);
+      if (!status.ok()) {
+        // No further entries in this sector. Mark the remaining bytes in the
+        // sector as corrupt (since we can't reliably know the size of the
+        // corrupt entry).
+        sector_corrupt_bytes +=
+            sector_size_bytes - (entry_address - sector_address);
+        break;
+      }
+
+      sector_corrupt_bytes += next_entry_address - entry_address;
+    }
+
+    // Entry loaded successfully; so get ready to load the next one.
+    entry_address = next_entry_address;
+
+    // Update of the number of writable bytes in this sector.
+    sector.set_writable_bytes(sector_size_bytes -
+                              (entry_address - sector_address));
+  }
+
+  return sector_corrupt_bytes;
+}
+
+Status KeyValueStore::LoadCheckpoint() {
+  PW_TRY(checkpoint_log_.Open());
+
+  size_t offset = 0;
+  auto read = [&](auto& value) {
+    const Status status = checkpoint_log_.ReadPayload(
+        offset, as_writable_bytes(span(&value, 1)));
+    offset += sizeof(value);
+    return status;
+  };
+
+  CheckpointHeader header;
+  PW_TRY(read(header));
+
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+  if (header.sector_size_bytes != sector_size_bytes ||
+      header.sector_count != sectors_.size() ||
+      header.redundancy != redundancy() ||
+      header.entry_count > entry_cache_.max_entries()) {
+    return Status::FailedPrecondition();
+  }
+
+  for (SectorDescriptor& sector : sectors_) {
+    CheckpointSector checkpoint_sector;
+    PW_TRY(read(checkpoint_sector));
+
+    if (checkpoint_sector.writable_bytes > sector_size_bytes) {
+      return Status::DataLoss();
+    }
+
+    // Make sure the sector still holds what it held at the checkpoint.
+    if (checkpoint_sector.writable_bytes < sector_size_bytes) {
+      Entry entry;
+      PW_TRY(Entry::Read(
+          partition_, sectors_.BaseAddress(sector), formats_, &entry));
+      if (entry.transaction_id() != checkpoint_sector.first_transaction_id) {
+        return Status::DataLoss();
+      }
+    }
+
+    sector.set_writable_bytes(checkpoint_sector.writable_bytes);
+  }
+
+  for (size_t i = 0; i < header.entry_count; ++i) {
+    CheckpointKey key;
+    PW_TRY(read(key));
+
+    EntryMetadata metadata;
+    for (size_t copy = 0; copy < redundancy(); ++copy) {
+      uint32_t address;
+      PW_TRY(read(address));
+      if (address >= partition_.size_bytes()) {
+        return Status::DataLoss();
+      }
+
+      if (copy == 0) {
+        metadata = entry_cache_.AddNew(
+            {
+                .key_hash = key.key_hash,
+                .transaction_id = key.transaction_id,
+                .state = key.deleted != 0u ? EntryState::kDeleted
+                                           : EntryState::kValid,
+            },
+            address);
+      } else {
+        metadata.AddNewAddress(address);
+      }
+    }
+  }
+
+  return offset == checkpoint_log_.payload_size() ? OkStatus()
+                                                  : Status::DataLoss();
+}
+
+Status KeyValueStore::WriteCheckpoint() {
+  if (!checkpoint_log_.enabled() ||
+      initialized_ != InitializationState::kReady || CheckForErrors()) {
+    return Status::FailedPrecondition();
+  }
+
+  const size_t payload_size =
+      sizeof(CheckpointHeader) +
+      sectors_.size() * sizeof(CheckpointSector) +
+      entry_cache_.total_entries() *
+          (sizeof(CheckpointKey) + redundancy() * sizeof(uint32_t));
+
+  internal::CheckpointLog::RecordOutput output;
+  PW_TRY(checkpoint_log_.BeginRecord(payload_size, output));
+
+  {
+    AlignedWriterBuffer<kMaxFlashAlignment> writer(
+        checkpoint_log_.alignment_bytes(), output);
+
+    const CheckpointHeader header{
+        .sector_size_bytes =
+            static_cast<uint32_t>(partition_.sector_size_bytes()),
+        .sector_count = static_cast<uint32_t>(sectors_.size()),
+        .redundancy = static_cast<uint32_t>(redundancy()),
+        .entry_count = static_cast<uint32_t>(entry_cache_.total_entries()),
+    };
+    PW_TRY(writer.Write(&header, sizeof(header)).status());
+
+    for (const SectorDescriptor& sector : sectors_) {
+      CheckpointSector checkpoint_sector{
+          .writable_bytes = static_cast<uint32_t>(sector.writable_bytes()),
+          .first_transaction_id = 0,
+      };
+      if (!sector.Empty(partition_.sector_size_bytes())) {
+        Entry entry;
+        PW_TRY(Entry::Read(
+            partition_, sectors_.BaseAddress(sector), formats_, &entry));
+        checkpoint_sector.first_transaction_id = entry.transaction_id();
+      }
+      PW_TRY(writer.Write(&checkpoint_sector, sizeof(checkpoint_sector))
+                 .status());
+    }
+
+    for (const EntryMetadata& metadata : entry_cache_) {
+      const CheckpointKey key{
+          .key_hash = metadata.hash(),
+          .transaction_id = metadata.transaction_id(),
+          .deleted = metadata.state() == EntryState::kDeleted ? 1u : 0u,
+      };
+      PW_TRY(writer.Write(&key, sizeof(key)).status());
+
+      for (const Address address : metadata.addresses()) {
+        const uint32_t address_value = address;
+        PW_TRY(
+            writer.Write(&address_value, sizeof(address_value)).status());
+      }
+    }
+
+    PW_TRY(writer.Flush().status());
+  }
+
+  PW_TRY(checkpoint_log_.FinishRecord(output));
+  PW_LOG_DEBUG("Wrote checkpoint with %u keys",
+               unsigned(entry_cache_.total_entries()));
+  return OkStatus();
+}
+
+void KeyValueStore::UpdateCheckpoint() {
+  if (!checkpoint_log_.enabled()) {
+    return;
+  }
+  const Status status = WriteCheckpoint();
+  if (!status.ok()) {
+    PW_LOG_WARN("Failed to write checkpoint: %s", status.str());
+  }
+}
+
 KeyValueStore::StorageStats KeyValueStore::GetStorageStats() const {
   StorageStats stats{};
   const size_t sector_size = partition_.sector_size_bytes();
@@ -805,6 +1024,8 @@ Status KeyValueStore::GetSectorForWrite(
 
   size_t gc_sector_count = 0;
   bool do_auto_gc = options_.gc_on_write != GargbageCollectOnWrite::kDisabled;
+  const bool limit_relocation = options_.gc_on_write_max_relocate_bytes != 0;
+  size_t relocate_bytes_remaining = options_.gc_on_write_max_relocate_bytes;
 
   // Do garbage collection as needed, so long as policy allows.
   while (result.IsResourceExhausted() && do_auto_gc) {
@@ -813,8 +1034,26 @@ Status KeyValueStore::GetSectorForWrite(
       // GC after this try.
       do_auto_gc = false;
     }
-    // Garbage collect and then try again to find the best sector.
-    Status gc_status = GarbageCollect(reserved_addresses);
+    // Garbage collect and then try again to find the best sector. If the
+    // amount of relocation is limited, collect a step at a time until the
+    // limit is reached.
+    Status gc_status;
+    bool sector_collected = true;
+    if (limit_relocation) {
+      const StatusWithSize step = GarbageCollectStep(
+          relocate_bytes_remaining, reserved_addresses, /*on_write=*/true);
+      relocate_bytes_remaining -= step.size();
+      gc_status = step.status();
+      if (gc_status.IsResourceExhausted()) {
+        PW_LOG_DEBUG("Reached limit of %u relocated bytes for this write",
+                     unsigned(options_.gc_on_write_max_relocate_bytes));
+      }
+      // A step may only move some of a sector's entries. The sector is done
+      // once it has been erased, which clears the sector in progress.
+      sector_collected = incremental_gc_sector_ == nullptr;
+    } else {
+      gc_status = GarbageCollect(reserved_addresses);
+    }
     if (!gc_status.ok()) {
       if (gc_status.IsNotFound()) {
         // Not enough space, and no reclaimable bytes, this KVS is full!
@@ -825,7 +1064,9 @@ Status KeyValueStore::GetSectorForWrite(
 
     result = sectors_.FindSpace(sector, entry_size, reserved_addresses);
 
-    gc_sector_count++;
+    if (sector_collected) {
+      gc_sector_count++;
+    }
     // Allow total sectors + 2 number of GC cycles so that once reclaimable
     // bytes in all the sectors have been reclaimed can try and free up space by
     // moving entries for keys other than the one being worked on in to sectors
@@ -906,7 +1147,13 @@ Status KeyValueStore::RelocateEntry(const EntryMetadata& metadata,
                                     span<const Address> reserved_addresses) {
   Entry entry;
   PW_TRY(ReadEntry(metadata, entry));
+  return RelocateEntry(entry, metadata, address, reserved_addresses);
+}
 
+Status KeyValueStore::RelocateEntry(Entry& entry,
+                                    const EntryMetadata& metadata,
+                                    KeyValueStore::Address& address,
+                                    span<const Address> reserved_addresses) {
   // Find a new sector for the entry and write it to the new location. For
   // relocation the find should not not be a sector already containing the key
   // but can be the always empty sector, since this is part of the GC process
@@ -1010,6 +1257,7 @@ Status KeyValueStore::FullMaintenanceHelper(MaintenanceType maintenance_type) {
 #endif  // PW_KVS_REMOVE_DELETED_KEYS_IN_HEAVY_MAINTENANCE
 
   if (overall_status.ok()) {
+    UpdateCheckpoint();
     PW_LOG_INFO("Full maintenance complete");
   } else {
     PW_LOG_ERROR("Full maintenance finished with some errors");
@@ -1027,7 +1275,12 @@ Status KeyValueStore::PartialMaintenance() {
   if (error_detected_ && options_.recovery != ErrorRecovery::kManual) {
     PW_TRY(Repair());
   }
-  return GarbageCollect(span<const Address>());
+
+  const Status status = GarbageCollect(span<const Address>());
+  if (status.ok()) {
+    UpdateCheckpoint();
+  }
+  return status;
 }
 
 Status KeyValueStore::GarbageCollect(span<const Address> reserved_addresses) {
@@ -1086,7 +1339,16 @@ Status KeyValueStore::GarbageCollectSector(
   }
 
   // Step 2: Reinitialize the sector
+  return EraseGarbageCollectedSector(sector_to_gc);
+}
+
+Status KeyValueStore::EraseGarbageCollectedSector(
+    SectorDescriptor& sector_to_gc) {
   if (!sector_to_gc.Empty(partition_.sector_size_bytes())) {
+    // The checkpoint records the sector's contents, so it must not be used
+    // once the sector is erased.
+    PW_TRY(checkpoint_log_.Invalidate());
+
     sector_to_gc.mark_corrupt();
     internal_stats_.sector_erase_count++;
     PW_TRY(partition_.Erase(sectors_.BaseAddress(sector_to_gc), 1));
@@ -1098,6 +1360,104 @@ Status KeyValueStore::GarbageCollectSector(
   return OkStatus();
 }
 
+StatusWithSize KeyValueStore::IncrementalGarbageCollect(
+    size_t max_relocate_bytes) {
+  if (!initialized()) {
+    return StatusWithSize::FailedPrecondition();
+  }
+  const StatusWithSize result =
+      GarbageCollectStep(max_relocate_bytes, {}, /*on_write=*/false);
+
+  // Replace the checkpoint if the step erased a sector.
+  if (result.ok() && !checkpoint_log_.has_valid_record()) {
+    UpdateCheckpoint();
+  }
+  return result;
+}
+
+StatusWithSize KeyValueStore::GarbageCollectStep(
+    size_t max_relocate_bytes,
+    span<const Address> reserved_addresses,
+    bool on_write) {
+  const size_t sector_size_bytes = partition_.sector_size_bytes();
+
+  // Step 1: Continue with the sector from the previous step, unless it was
+  // collected some other way or holds an address that must be avoided.
+  SectorDescriptor* sector_to_gc = incremental_gc_sector_;
+  if (sector_to_gc != nullptr &&
+      (sector_to_gc->RecoverableBytes(sector_size_bytes) == 0 ||
+       std::any_of(reserved_addresses.begin(),
+                   reserved_addresses.end(),
+                   [&](Address address) {
+                     return sectors_.AddressInSector(*sector_to_gc, address);
+                   }))) {
+    sector_to_gc = nullptr;
+  }
+
+  if (sector_to_gc == nullptr) {
+    sector_to_gc = sectors_.FindSectorToGarbageCollect(reserved_addresses);
+    if (sector_to_gc == nullptr ||
+        (!on_write && sector_to_gc->RecoverableBytes(sector_size_bytes) == 0)) {
+      incremental_gc_sector_ = nullptr;
+      return StatusWithSize::NotFound();
+    }
+  }
+  incremental_gc_sector_ = sector_to_gc;
+
+  PW_LOG_DEBUG("  Garbage Collect step for sector %u, %u valid bytes",
+               sectors_.Index(sector_to_gc),
+               unsigned(sector_to_gc->valid_bytes()));
+
+  // Step 2: Move valid entries out of the sector until the budget is used up.
+  size_t relocated_bytes = 0;
+  bool budget_used = false;
+  for (EntryMetadata& metadata : entry_cache_) {
+    if (sector_to_gc->valid_bytes() == 0 || budget_used) {
+      break;
+    }
+
+    for (Address& address : metadata.addresses()) {
+      if (!sectors_.AddressInSector(*sector_to_gc, address)) {
+        continue;
+      }
+
+      Entry entry;
+      PW_TRY_WITH_SIZE(ReadEntry(metadata, entry));
+
+      // Every step but those for writes relocates at least one entry.
+      const bool required = !on_write && relocated_bytes == 0;
+      if (relocated_bytes + entry.size() > max_relocate_bytes && !required) {
+        budget_used = true;
+        break;
+      }
+
+      PW_LOG_DEBUG("  Relocate entry for Key 0x%08" PRIx32 ", sector %u",
+                   metadata.hash(),
+                   sectors_.Index(sectors_.FromAddress(address)));
+      PW_TRY_WITH_SIZE(
+          RelocateEntry(entry, metadata, address, reserved_addresses));
+      relocated_bytes += entry.size();
+    }
+  }
+
+  if (sector_to_gc->valid_bytes() != 0) {
+    if (budget_used) {
+      return relocated_bytes == 0 ? StatusWithSize::ResourceExhausted()
+                                  : StatusWithSize(relocated_bytes);
+    }
+    PW_LOG_ERROR(
+        "  Failed to relocate valid entries from sector being garbage "
+        "collected, %u valid bytes remain",
+        unsigned(sector_to_gc->valid_bytes()));
+    return StatusWithSize::Internal(relocated_bytes);
+  }
+
+  // Step 3: Reinitialize the sector once it holds no valid entries.
+  incremental_gc_sector_ = nullptr;
+  PW_TRY_WITH_SIZE(EraseGarbageCollectedSector(*sector_to_gc));
+  return StatusWithSize(relocated_bytes);
+}
+
 StatusWithSize KeyValueStore::UpdateEntriesToPrimaryFormat() {
   size_t entries_updated = 0;
   for (EntryMetadata& prior_metadata : entry_cache_) {
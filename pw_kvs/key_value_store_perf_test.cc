@@ -0,0 +1,148 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "pw_assert/check.h"
+#include "pw_kvs/crc16_checksum.h"
+#include "pw_kvs/fake_flash_memory.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/key_value_store.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_string/string_builder.h"
+
+namespace pw::kvs {
+namespace {
+
+constexpr size_t kMaxEntries = 256;
+constexpr size_t kSectorSize = 4096;
+constexpr size_t kSectorCount = 16;
+
+// For KVS magic value always use a random 32 bit integer rather than a
+// human readable 4 bytes. See pw_kvs/format.h for more information.
+constexpr EntryFormat kFormat{.magic = 0x5b9a341e, .checksum = nullptr};
+
+FakeFlashMemoryBuffer<kSectorSize, kSectorCount> flash;
+FlashPartition partition(&flash);
+
+KeyValueStoreBuffer<kMaxEntries, kSectorCount> linear_kvs(&partition, kFormat);
+IndexedKeyValueStoreBuffer<kMaxEntries, kSectorCount> indexed_kvs(&partition,
+                                                                  kFormat);
+
+std::array<StringBuffer<8>, kMaxEntries> keys;
+
+// Erases the partition and fills the KVS with `entries` keys. Returns the key
+// that was added last, which is the last one a linear scan reaches.
+std::string_view Fill(KeyValueStore& kvs, size_t entries) {
+  PW_CHECK_OK(partition.Erase());
+  PW_CHECK_OK(kvs.Init());
+
+  for (size_t i = 0; i < entries; ++i) {
+    keys[i].clear();
+    keys[i].Format("key%u", static_cast<unsigned>(i));
+    PW_CHECK_OK(kvs.Put(keys[i].view(), static_cast<uint32_t>(i)));
+  }
+  return keys[entries - 1].view();
+}
+
+// Measures how long Get takes to read a value from a KVS with `entries` keys.
+void GetLatency(perf_test::State& state, KeyValueStore& kvs, size_t entries) {
+  const std::string_view key = Fill(kvs, entries);
+
+  uint32_t value;
+  while (state.KeepRunning()) {
+    kvs.Get(key, &value).IgnoreError();
+  }
+}
+
+// Measures how long Put takes to update a value in a KVS with `entries` keys.
+// This includes writing the entry to flash and any garbage collection that it
+// triggers.
+void PutLatency(perf_test::State& state, KeyValueStore& kvs, size_t entries) {
+  const std::string_view key = Fill(kvs, entries);
+
+  uint32_t value = 0;
+  while (state.KeepRunning()) {
+    kvs.Put(key, value++).IgnoreError();
+  }
+}
+
+// A larger flash for measuring mount time. Entries are checksummed, as they
+// usually are in practice, so a full scan reads every byte of every entry.
+constexpr size_t kMountSectorCount = 32;
+
+FakeFlashMemoryBuffer<kSectorSize, kMountSectorCount> mount_flash;
+FlashPartition mount_partition(&mount_flash);
+FakeFlashMemoryBuffer<kSectorSize, 4> checkpoint_flash;
+FlashPartition checkpoint_partition(&checkpoint_flash);
+
+ChecksumCrc16 checksum;
+constexpr EntryFormat kChecksummedFormat{.magic = 0x7cb0a412,
+                                         .checksum = &checksum};
+
+// Measures how long Init takes for a KVS with `entries` keys that have each
+// been written 4 times, with or without a checkpoint written after the last
+// write.
+void MountLatency(perf_test::State& state, size_t entries, bool checkpoint) {
+  PW_CHECK_OK(mount_partition.Erase());
+  PW_CHECK_OK(checkpoint_partition.Erase());
+
+  Options options;
+  options.checkpoint_partition = checkpoint ? &checkpoint_partition : nullptr;
+  KeyValueStoreBuffer<kMaxEntries, kMountSectorCount> kvs(
+      &mount_partition, kChecksummedFormat, options);
+  PW_CHECK_OK(kvs.Init());
+
+  std::array<std::byte, 64> value{};
+  for (size_t round = 0; round < 4; ++round) {
+    for (size_t i = 0; i < entries; ++i) {
+      keys[i].clear();
+      keys[i].Format("key%u", static_cast<unsigned>(i));
+      value.fill(static_cast<std::byte>(round + i));
+      PW_CHECK_OK(kvs.Put(keys[i].view(), value));
+    }
+  }
+  if (checkpoint) {
+    PW_CHECK_OK(kvs.WriteCheckpoint());
+  }
+
+  while (state.KeepRunning()) {
+    kvs.Init().IgnoreError();
+  }
+}
+
+PW_PERF_TEST(Get16EntriesLinear, GetLatency, linear_kvs, 16);
+PW_PERF_TEST(Get64EntriesLinear, GetLatency, linear_kvs, 64);
+PW_PERF_TEST(Get256EntriesLinear, GetLatency, linear_kvs, 256);
+PW_PERF_TEST(Get16EntriesIndexed, GetLatency, indexed_kvs, 16);
+PW_PERF_TEST(Get64EntriesIndexed, GetLatency, indexed_kvs, 64);
+PW_PERF_TEST(Get256EntriesIndexed, GetLatency, indexed_kvs, 256);
+
+PW_PERF_TEST(Put16EntriesLinear, PutLatency, linear_kvs, 16);
+PW_PERF_TEST(Put64EntriesLinear, PutLatency, linear_kvs, 64);
+PW_PERF_TEST(Put256EntriesLinear, PutLatency, linear_kvs, 256);
+PW_PERF_TEST(Put16EntriesIndexed, PutLatency, indexed_kvs, 16);
+PW_PERF_TEST(Put64EntriesIndexed, PutLatency, indexed_kvs, 64);
+PW_PERF_TEST(Put256EntriesIndexed, PutLatency, indexed_kvs, 256);
+
+PW_PERF_TEST(Mount64EntriesFullScan, MountLatency, 64, false);
+PW_PERF_TEST(Mount256EntriesFullScan, MountLatency, 256, false);
+PW_PERF_TEST(Mount64EntriesCheckpoint, MountLatency, 64, true);
+PW_PERF_TEST(Mount256EntriesCheckpoint, MountLatency, 256, true);
+
+}  // namespace
+}  // namespace pw::kvs
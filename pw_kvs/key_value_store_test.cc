@@ -475,6 +475,41 @@ TEST_F(LargeEmptyInitializedKvs, KeyDeletionMaintenance) {
   ASSERT_EQ(val, kValue2);
 }
 
+TEST(IndexedKvs, PutGetDelete_SurviveMaintenanceAndInit) {
+  Flash flash;
+  ASSERT_EQ(OkStatus(), flash.partition.Erase());
+
+  IndexedKeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash.partition, default_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  constexpr size_t kKeys = 20;
+  std::array<StringBuffer<8>, kKeys> key_names;
+  for (size_t i = 0; i < kKeys; ++i) {
+    key_names[i].Format("key%u", static_cast<unsigned>(i));
+    ASSERT_EQ(OkStatus(), kvs.Put(key_names[i].view(), uint32_t(i)));
+  }
+  for (size_t i = 0; i < kKeys; i += 2) {
+    ASSERT_EQ(OkStatus(), kvs.Delete(key_names[i].view()));
+  }
+  ASSERT_EQ(OkStatus(), kvs.HeavyMaintenance());
+
+  IndexedKeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> reloaded(
+      &flash.partition, default_format);
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  EXPECT_EQ(kKeys / 2, reloaded.size());
+
+  for (size_t i = 0; i < kKeys; ++i) {
+    uint32_t value = 0;
+    if (i % 2 == 0) {
+      EXPECT_EQ(Status::NotFound(), reloaded.Get(key_names[i].view(), &value));
+    } else {
+      ASSERT_EQ(OkStatus(), reloaded.Get(key_names[i].view(), &value));
+      EXPECT_EQ(i, value);
+    }
+  }
+}
+
 TEST(InMemoryKvs, Put_MaxValueSize) {
   // Create and erase the fake flash.
   Flash flash;
@@ -506,4 +541,370 @@ TEST(InMemoryKvs, Put_MaxValueSize) {
   EXPECT_EQ(Status::InvalidArgument(), kvs.Put("K", big_data));
 }
 
+class IncrementalGarbageCollection : public ::testing::Test {
+ protected:
+  // With a 4-byte key, each entry fills a quarter of a sector.
+  using Value = std::array<std::byte, 108>;
+  static constexpr size_t kEntrySize = 128;
+
+  IncrementalGarbageCollection() { PW_CHECK_OK(flash_.partition.Erase()); }
+
+  static Value ValueFor(size_t i) {
+    Value value;
+    value.fill(static_cast<std::byte>(i));
+    return value;
+  }
+
+  // Fills `sectors` sectors with 4 keys each, then updates the first key in
+  // each sector so that every sector has reclaimable space and valid entries.
+  static void FillWithStaleEntries(KeyValueStore& kvs, size_t sectors) {
+    for (size_t i = 0; i < 4 * sectors; ++i) {
+      ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i)));
+    }
+    for (size_t i = 0; i < 4 * sectors; i += 4) {
+      ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i + 100)));
+    }
+  }
+
+  static const char* Key(size_t i) {
+    static constexpr const char* kKeys[] = {
+        "k_00", "k_01", "k_02", "k_03", "k_04", "k_05", "k_06", "k_07",
+        "k_08", "k_09", "k_10", "k_11", "k_12", "k_13", "k_14", "k_15"};
+    return kKeys[i];
+  }
+
+  static void CheckValues(KeyValueStore& kvs, size_t keys) {
+    for (size_t i = 0; i < keys; ++i) {
+      Value value;
+      ASSERT_EQ(OkStatus(), kvs.Get(Key(i), &value));
+      EXPECT_EQ(ValueFor(i % 4 == 0 ? i + 100 : i), value);
+    }
+  }
+
+  Flash flash_;
+};
+
+TEST_F(IncrementalGarbageCollection, RelocatesInBoundedSteps) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash_.partition,
+      default_format,
+      {.gc_on_write = GargbageCollectOnWrite::kDisabled});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  FillWithStaleEntries(kvs, 3);
+  ASSERT_GT(kvs.GetStorageStats().reclaimable_bytes, 0u);
+
+  size_t steps = 0;
+  StatusWithSize result;
+  while ((result = kvs.IncrementalGarbageCollect(kEntrySize)).ok()) {
+    EXPECT_LE(result.size(), kEntrySize);
+    ASSERT_LT(++steps, 100u);
+  }
+  EXPECT_EQ(Status::NotFound(), result.status());
+
+  // Each sector took more than one step to collect.
+  EXPECT_GT(steps, 3u);
+  EXPECT_EQ(0u, kvs.GetStorageStats().reclaimable_bytes);
+  EXPECT_EQ(3u, kvs.GetStorageStats().sector_erase_count);
+  CheckValues(kvs, 12);
+
+  // Collected entries are found after reloading from flash.
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> reloaded(
+      &flash_.partition, default_format);
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  CheckValues(reloaded, 12);
+}
+
+TEST_F(IncrementalGarbageCollection, AlwaysRelocatesAnEntry) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash_.partition,
+      default_format,
+      {.gc_on_write = GargbageCollectOnWrite::kDisabled});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  FillWithStaleEntries(kvs, 1);
+
+  StatusWithSize result = kvs.IncrementalGarbageCollect(1);
+  ASSERT_EQ(OkStatus(), result.status());
+  EXPECT_EQ(kEntrySize, result.size());
+}
+
+TEST_F(IncrementalGarbageCollection, NotInitialized) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(&flash_.partition,
+                                                          default_format);
+  EXPECT_EQ(Status::FailedPrecondition(),
+            kvs.IncrementalGarbageCollect(1024).status());
+}
+
+TEST_F(IncrementalGarbageCollection, PutRelocatesAtMostTheLimit) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash_.partition,
+      default_format,
+      {.gc_on_write_max_relocate_bytes = kEntrySize - 1});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  FillWithStaleEntries(kvs, 4);
+
+  // Making room requires relocating an entry, which exceeds the limit.
+  EXPECT_EQ(Status::ResourceExhausted(), kvs.Put(Key(1), ValueFor(200)));
+  CheckValues(kvs, 16);
+
+  while (kvs.IncrementalGarbageCollect(kEntrySize).ok()) {
+  }
+  EXPECT_EQ(OkStatus(), kvs.Put(Key(1), ValueFor(200)));
+
+  Value value;
+  ASSERT_EQ(OkStatus(), kvs.Get(Key(1), &value));
+  EXPECT_EQ(ValueFor(200), value);
+}
+
+TEST_F(IncrementalGarbageCollection, PutRelocatesWithinTheLimit) {
+  KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors> kvs(
+      &flash_.partition,
+      default_format,
+      {.gc_on_write_max_relocate_bytes = kEntrySize});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  FillWithStaleEntries(kvs, 4);
+
+  EXPECT_EQ(OkStatus(), kvs.Put(Key(1), ValueFor(200)));
+
+  Value value;
+  ASSERT_EQ(OkStatus(), kvs.Get(Key(1), &value));
+  EXPECT_EQ(ValueFor(200), value);
+}
+
+// Counts the bytes read from the partition, to tell whether Init() read every
+// entry or loaded a checkpoint.
+class ReadCountingPartition : public FlashPartition {
+ public:
+  ReadCountingPartition(FlashMemory* flash) : FlashPartition(flash) {}
+
+  using FlashPartition::Read;
+
+  StatusWithSize Read(Address address, span<std::byte> output) override {
+    bytes_read += output.size();
+    return FlashPartition::Read(address, output);
+  }
+
+  size_t bytes_read = 0;
+};
+
+class Checkpoint : public ::testing::Test {
+ protected:
+  using Kvs = KeyValueStoreBuffer<kMaxEntries, kMaxUsableSectors>;
+  using Value = std::array<std::byte, 48>;
+
+  Checkpoint()
+      : flash_(16),
+        partition_(&flash_),
+        checkpoint_flash_(16),
+        checkpoint_partition_(&checkpoint_flash_) {
+    PW_CHECK_OK(partition_.Erase());
+    PW_CHECK_OK(checkpoint_partition_.Erase());
+  }
+
+  Options options() { return {.checkpoint_partition = &checkpoint_partition_}; }
+
+  static Value ValueFor(size_t i) {
+    Value value;
+    value.fill(static_cast<std::byte>(i));
+    return value;
+  }
+
+  static const char* Key(size_t i) {
+    static constexpr const char* kKeys[] = {
+        "k_00", "k_01", "k_02", "k_03", "k_04", "k_05", "k_06", "k_07",
+        "k_08", "k_09", "k_10", "k_11", "k_12", "k_13", "k_14", "k_15"};
+    return kKeys[i];
+  }
+
+  // Initializes a KVS and returns the number of bytes it read from the KVS
+  // partition.
+  size_t InitAndCountReads(KeyValueStore& kvs) {
+    partition_.bytes_read = 0;
+    EXPECT_EQ(OkStatus(), kvs.Init());
+    return partition_.bytes_read;
+  }
+
+  // Checks that a KVS that loaded a checkpoint matches one that read all of
+  // its entries.
+  static void ExpectSameContents(KeyValueStore& expected, KeyValueStore& kvs) {
+    ASSERT_EQ(expected.size(), kvs.size());
+    EXPECT_EQ(expected.transaction_count(), kvs.transaction_count());
+    EXPECT_EQ(expected.GetStorageStats().in_use_bytes,
+              kvs.GetStorageStats().in_use_bytes);
+    EXPECT_EQ(expected.GetStorageStats().reclaimable_bytes,
+              kvs.GetStorageStats().reclaimable_bytes);
+    EXPECT_EQ(expected.GetStorageStats().writable_bytes,
+              kvs.GetStorageStats().writable_bytes);
+
+    for (const auto& item : expected) {
+      Value expected_value;
+      Value value;
+      ASSERT_EQ(OkStatus(), item.Get(&expected_value));
+      ASSERT_EQ(OkStatus(), kvs.Get(item.key(), &value));
+      EXPECT_EQ(expected_value, value);
+    }
+  }
+
+  FakeFlashMemoryBuffer<512, 6> flash_;
+  ReadCountingPartition partition_;
+  FakeFlashMemoryBuffer<512, 2> checkpoint_flash_;
+  FlashPartition checkpoint_partition_;
+};
+
+TEST_F(Checkpoint, InitReadsOnlyEntriesWrittenAfterCheckpoint) {
+  Kvs kvs(&partition_, default_format, options());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < 12; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs.WriteCheckpoint());
+
+  // Entries written after the checkpoint are found when reloading.
+  ASSERT_EQ(OkStatus(), kvs.Put(Key(0), ValueFor(100)));
+  ASSERT_EQ(OkStatus(), kvs.Put(Key(12), ValueFor(12)));
+  ASSERT_EQ(OkStatus(), kvs.Delete(Key(1)));
+
+  Kvs full_scan(&partition_, default_format);
+  const size_t full_scan_bytes_read = InitAndCountReads(full_scan);
+
+  Kvs reloaded(&partition_, default_format, options());
+  EXPECT_LT(InitAndCountReads(reloaded), full_scan_bytes_read / 2);
+
+  ExpectSameContents(full_scan, reloaded);
+  Value value;
+  EXPECT_EQ(Status::NotFound(), reloaded.Get(Key(1), &value));
+  ASSERT_EQ(OkStatus(), reloaded.Get(Key(0), &value));
+  EXPECT_EQ(ValueFor(100), value);
+}
+
+TEST_F(Checkpoint, InitWritesCheckpoint) {
+  Kvs kvs(&partition_, default_format);
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < 12; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i)));
+  }
+
+  // There is no checkpoint yet, so the first Init() reads all entries.
+  Kvs first(&partition_, default_format, options());
+  const size_t full_scan_bytes_read = InitAndCountReads(first);
+
+  Kvs second(&partition_, default_format, options());
+  EXPECT_LT(InitAndCountReads(second), full_scan_bytes_read / 2);
+  ExpectSameContents(first, second);
+}
+
+TEST_F(Checkpoint, EraseInvalidatesCheckpoint) {
+  Kvs kvs(&partition_, default_format, options());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < 12; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs.WriteCheckpoint());
+
+  // Update keys until garbage collection on write erases sectors.
+  for (size_t i = 0; kvs.GetStorageStats().sector_erase_count < 2; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i % 12), ValueFor(i + 100)));
+    ASSERT_LT(i, 200u);
+  }
+
+  Kvs full_scan(&partition_, default_format);
+  const size_t full_scan_bytes_read = InitAndCountReads(full_scan);
+
+  // The checkpoint was invalidated, so Init() reads all entries.
+  Kvs reloaded(&partition_, default_format, options());
+  EXPECT_GE(InitAndCountReads(reloaded), full_scan_bytes_read);
+  ExpectSameContents(full_scan, reloaded);
+
+  // That Init() wrote a new checkpoint.
+  Kvs reloaded_again(&partition_, default_format, options());
+  EXPECT_LT(InitAndCountReads(reloaded_again), full_scan_bytes_read / 2);
+  ExpectSameContents(full_scan, reloaded_again);
+}
+
+TEST_F(Checkpoint, IncrementalGarbageCollectWritesCheckpoint) {
+  Kvs kvs(&partition_,
+          default_format,
+          {.gc_on_write = GargbageCollectOnWrite::kDisabled,
+           .checkpoint_partition = &checkpoint_partition_});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < 24; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i % 12), ValueFor(i)));
+  }
+
+  StatusWithSize result;
+  while ((result = kvs.IncrementalGarbageCollect(64)).ok()) {
+  }
+  ASSERT_EQ(Status::NotFound(), result.status());
+  ASSERT_GT(kvs.GetStorageStats().sector_erase_count, 0u);
+
+  Kvs full_scan(&partition_, default_format);
+  const size_t full_scan_bytes_read = InitAndCountReads(full_scan);
+
+  Kvs reloaded(&partition_, default_format, options());
+  EXPECT_LT(InitAndCountReads(reloaded), full_scan_bytes_read / 2);
+  ExpectSameContents(full_scan, reloaded);
+}
+
+TEST_F(Checkpoint, MaintenanceWritesCheckpoint) {
+  Kvs kvs(&partition_, default_format, options());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < 24; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i % 12), ValueFor(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs.HeavyMaintenance());
+  ASSERT_GT(kvs.GetStorageStats().sector_erase_count, 0u);
+
+  Kvs full_scan(&partition_, default_format);
+  const size_t full_scan_bytes_read = InitAndCountReads(full_scan);
+
+  Kvs reloaded(&partition_, default_format, options());
+  EXPECT_LT(InitAndCountReads(reloaded), full_scan_bytes_read / 2);
+  ExpectSameContents(full_scan, reloaded);
+}
+
+TEST_F(Checkpoint, ExternalEraseIsDetected) {
+  Kvs kvs(&partition_, default_format, options());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < 12; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i)));
+  }
+  ASSERT_EQ(OkStatus(), kvs.WriteCheckpoint());
+
+  ASSERT_EQ(OkStatus(), partition_.Erase());
+
+  Kvs reloaded(&partition_, default_format, options());
+  ASSERT_EQ(OkStatus(), reloaded.Init());
+  EXPECT_EQ(0u, reloaded.size());
+}
+
+TEST_F(Checkpoint, LogIsErasedWhenFull) {
+  Kvs kvs(&partition_, default_format, options());
+  ASSERT_EQ(OkStatus(), kvs.Init());
+  for (size_t i = 0; i < 12; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i)));
+  }
+
+  // Each checkpoint takes several hundred bytes of the 1 KiB partition.
+  for (size_t i = 0; i < 10; ++i) {
+    ASSERT_EQ(OkStatus(), kvs.Put(Key(i), ValueFor(i + 100)));
+    ASSERT_EQ(OkStatus(), kvs.WriteCheckpoint());
+  }
+
+  Kvs full_scan(&partition_, default_format);
+  const size_t full_scan_bytes_read = InitAndCountReads(full_scan);
+
+  Kvs reloaded(&partition_, default_format, options());
+  EXPECT_LT(InitAndCountReads(reloaded), full_scan_bytes_read / 2);
+  ExpectSameContents(full_scan, reloaded);
+}
+
+TEST_F(Checkpoint, WriteCheckpoint_FailedPrecondition) {
+  Kvs no_checkpoint_partition(&partition_, default_format);
+  ASSERT_EQ(OkStatus(), no_checkpoint_partition.Init());
+  EXPECT_EQ(Status::FailedPrecondition(),
+            no_checkpoint_partition.WriteCheckpoint());
+
+  Kvs not_initialized(&partition_, default_format, options());
+  EXPECT_EQ(Status::FailedPrecondition(), not_initialized.WriteCheckpoint());
+}
+
 }  // namespace pw::kvs
@@ -115,5 +115,31 @@ TEST_F(WearTest, TwoPassFillWithLargeAndLarger) {
             2u * partition_.average_erase_count());
 }
 
+// Update several keys with garbage collection done incrementally between
+// writes, as a background thread would, and with writes limited to erasing
+// sectors that need no relocation. Ensure writes never fail and wear is still
+// spread across the sectors.
+TEST_F(WearTest, IncrementalGarbageCollection) {
+  partition_.ResetCounters();
+
+  KeyValueStoreBuffer<kMaxEntries, kSectors> kvs(
+      &partition_, format, {.gc_on_write_max_relocate_bytes = 1});
+  ASSERT_EQ(OkStatus(), kvs.Init());
+
+  constexpr const char* kKeys[] = {"key_a", "key_b", "key_c", "key_d"};
+  for (size_t i = 0; i < kSectors * 50; ++i) {
+    test_data[0]++;
+
+    ASSERT_EQ(OkStatus(),
+              kvs.Put(kKeys[i % 4], as_bytes(span(test_data, 100))));
+    kvs.IncrementalGarbageCollect(128).IgnoreError();
+  }
+
+  EXPECT_EQ(4u, kvs.size());
+  EXPECT_GE(partition_.min_erase_count(), 1u);
+  EXPECT_LT(partition_.max_erase_count(),
+            2u * partition_.average_erase_count());
+}
+
 }  // namespace
 }  // namespace pw::kvs
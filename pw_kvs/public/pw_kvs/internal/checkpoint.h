@@ -0,0 +1,138 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_checksum/crc32.h"
+#include "pw_kvs/flash_memory.h"
+#include "pw_kvs/io.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/status_with_size.h"
+
+namespace pw {
+namespace kvs {
+namespace internal {
+
+// A log of KVS checkpoint records, stored in a flash partition of its own.
+// Records are appended one after another; the log is erased when the next
+// record does not fit. Only the last record in the log is ever used.
+//
+// Each record is laid out as follows, with every part aligned to the
+// partition's alignment:
+//
+//   [header: magic, payload size][invalidation marker][payload][payload CRC]
+//
+// The invalidation marker is left erased when the record is written. Writing
+// to it marks the record as out of date without an erase. A record is valid
+// if it is complete, its payload CRC matches, and its marker is erased.
+//
+// The log knows nothing about the contents of the payload.
+class CheckpointLog {
+ public:
+  using Address = FlashPartition::Address;
+
+  // Receives the payload of a record. Created by the caller and passed to
+  // BeginRecord, which points it at the record's payload.
+  class RecordOutput final : public Output {
+   public:
+    constexpr RecordOutput()
+        : partition_(nullptr), address_(0), bytes_written_(0) {}
+
+   private:
+    friend class CheckpointLog;
+
+    StatusWithSize DoWrite(span<const std::byte> data) override;
+
+    FlashPartition* partition_;
+    Address address_;
+    size_t bytes_written_;
+    checksum::Crc32 crc_;
+  };
+
+  explicit constexpr CheckpointLog(FlashPartition* partition)
+      : partition_(partition),
+        record_address_(0),
+        payload_size_(0),
+        end_address_(0),
+        record_valid_(false) {}
+
+  // True if the log has a partition to store records in.
+  bool enabled() const { return partition_ != nullptr; }
+
+  size_t alignment_bytes() const { return partition_->alignment_bytes(); }
+
+  // Scans the log for its last record and checks whether it is valid. Returns
+  // OK if it is, NOT_FOUND if there is no valid record, or an error if the
+  // partition could not be read.
+  Status Open();
+
+  // True if Open found a valid record, or a record was written since, and the
+  // record has not been invalidated.
+  bool has_valid_record() const { return record_valid_; }
+
+  // Size of the valid record's payload.
+  size_t payload_size() const { return payload_size_; }
+
+  // Reads part of the valid record's payload, starting at offset.
+  Status ReadPayload(size_t offset, span<std::byte> data) const;
+
+  // Marks the valid record as out of date so it is never used again. Does
+  // nothing if there is no valid record.
+  Status Invalidate();
+
+  // Starts a record with a payload of payload_size bytes, erasing the log
+  // first if the record does not fit. Write the payload to output, which must
+  // receive exactly payload_size bytes padded to alignment_bytes(), then call
+  // FinishRecord. The previous record is no longer used after this call.
+  Status BeginRecord(size_t payload_size, RecordOutput& output);
+
+  // Completes the record started with BeginRecord by writing its payload CRC.
+  // The record is valid once this returns OK.
+  Status FinishRecord(const RecordOutput& output);
+
+ private:
+  struct RecordHeader {
+    uint32_t magic;
+    uint32_t payload_size;
+  };
+
+  // Randomly generated, like the KVS entry magic values.
+  static constexpr uint32_t kMagic = 0x3e8f71c5;
+
+  size_t header_size() const;
+  size_t marker_size() const;
+  size_t crc_size() const;
+  size_t aligned_payload_size(size_t payload_size) const;
+  size_t record_size(size_t payload_size) const;
+
+  Address payload_address() const {
+    return record_address_ + header_size() + marker_size();
+  }
+
+  Status Validate();
+
+  FlashPartition* const partition_;
+
+  Address record_address_;  // Start of the last record in the log.
+  size_t payload_size_;     // Payload size of the last record in the log.
+  Address end_address_;     // Where the next record is written.
+  bool record_valid_;
+};
+
+}  // namespace internal
+}  // namespace kvs
+}  // namespace pw
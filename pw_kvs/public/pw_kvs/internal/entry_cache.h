@@ -15,6 +15,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <limits>
 #include <type_traits>
 
 #include "pw_containers/vector.h"
@@ -71,6 +72,7 @@ class EntryMetadata {
 
   // Resets the KeyDescrtiptor and addresses to refer to the provided
   // KeyDescriptor and address.
+  // The key hash must not change if the EntryCache has a key index.
   void Reset(const KeyDescriptor& descriptor, Address address);
 
  private:
@@ -152,14 +154,27 @@ class EntryCache {
   template <size_t kMaxEntries, size_t kRedundancy>
   using AddressList = Address[kMaxEntries * kRedundancy + kRedundancy];
 
+  // The type used for entries in the optional key hash index.
+  using IndexEntry = uint16_t;
+
+  // The maximum number of entries in an EntryCache with a key hash index.
+  static constexpr size_t kMaxIndexedEntries =
+      std::numeric_limits<IndexEntry>::max();
+
+  // If key_index is provided, it must have room for descriptors.max_size()
+  // entries. It is kept sorted by key hash so that lookups use a binary search
+  // instead of scanning every descriptor.
   constexpr EntryCache(Vector<KeyDescriptor>& descriptors,
                        Address* addresses,
-                       size_t redundancy)
+                       size_t redundancy,
+                       IndexEntry* key_index = nullptr)
       : descriptors_(descriptors),
         addresses_(addresses),
-        redundancy_(redundancy) {}
+        redundancy_(redundancy),
+        key_index_(key_index) {}
 
-  // Clears all KeyDescriptors.
+  // Clears all KeyDescriptors. The key index, if any, is sized by the number of
+  // descriptors, so it is cleared too.
   void Reset() const { descriptors_.clear(); }
 
   // Finds the metadata for an entry matching a particular key. Searches for a
@@ -217,6 +232,9 @@ class EntryCache {
   // The maximum number of entries supported by this EntryCache.
   size_t max_entries() const { return descriptors_.max_size(); }
 
+  // True if lookups use the sorted key hash index.
+  bool indexed() const { return key_index_ != nullptr; }
+
   iterator begin() const { return {this, descriptors_.begin()}; }
   const_iterator cbegin() const { return {this, descriptors_.begin()}; }
 
@@ -224,8 +242,21 @@ class EntryCache {
   const_iterator cend() const { return {this, descriptors_.end()}; }
 
  private:
+  // Returns the index of the descriptor with the given key hash, or -1.
   int FindIndex(uint32_t key_hash) const;
 
+  // Searches the first `entries` entries of key_index_. Returns the position
+  // of the first entry whose key hash is not less than key_hash.
+  size_t KeyIndexLowerBound(uint32_t key_hash, size_t entries) const;
+
+  // Updates key_index_ for a descriptor that was just added at the end of
+  // descriptors_.
+  void AddToKeyIndex() const;
+
+  // Updates key_index_ before the descriptor at index_to_remove is replaced by
+  // the last descriptor, which is then popped.
+  void RemoveFromKeyIndex(size_t index_to_remove) const;
+
   // Adds the address to the descriptor at the specified index if there is an
   // address slot available.
   void AddAddressIfRoom(size_t descriptor_index, Address address) const;
@@ -242,6 +273,10 @@ class EntryCache {
   Vector<KeyDescriptor>& descriptors_;
   FlashPartition::Address* const addresses_;
   const size_t redundancy_;
+
+  // Optional list of descriptor indices, sorted by key hash. Its length always
+  // matches descriptors_.size().
+  IndexEntry* const key_index_;
 };
 
 }  // namespace internal
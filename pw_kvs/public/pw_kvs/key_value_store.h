@@ -22,6 +22,7 @@
 #include "pw_kvs/checksum.h"
 #include "pw_kvs/flash_memory.h"
 #include "pw_kvs/format.h"
+#include "pw_kvs/internal/checkpoint.h"
 #include "pw_kvs/internal/entry.h"
 #include "pw_kvs/internal/entry_cache.h"
 #include "pw_kvs/internal/key_descriptor.h"
@@ -78,6 +79,21 @@ struct Options {
 
   // Verify an in-flash entry's checksum after writing it.
   bool verify_on_write = true;
+
+  // Maximum number of bytes of valid entries that garbage collection may
+  // relocate during a single write, or 0 for no limit. With a limit, writes
+  // still erase sectors that hold only stale entries, but collect sectors with
+  // valid entries only as far as the limit allows. A write that cannot free
+  // enough space within the limit fails with RESOURCE_EXHAUSTED. Call
+  // IncrementalGarbageCollect() from a background thread or work queue to keep
+  // space available.
+  size_t gc_on_write_max_relocate_bytes = 0;
+
+  // Optional partition for checkpoints, which let Init() skip reading every
+  // entry in the KVS. Must not overlap the KVS partition and must only be used
+  // by one KVS. If null, Init() always reads all entries. See
+  // KeyValueStore::WriteCheckpoint().
+  FlashPartition* checkpoint_partition = nullptr;
 };
 
 /// Flash-backed persistent key-value store (KVS) with integrated
@@ -289,12 +305,63 @@ class KeyValueStore {
     return FullMaintenanceHelper(MaintenanceType::kRegular);
   }
 
+  /// Performs a bounded step of garbage collection, for use from a background
+  /// thread or work queue. Each step relocates at most `max_relocate_bytes` of
+  /// valid entries out of the sector being collected, and erases the sector
+  /// once no valid entries remain in it. Large sectors may take several steps
+  /// to collect. A step always relocates at least one entry, so repeated calls
+  /// make progress even if an entry is larger than `max_relocate_bytes`.
+  ///
+  /// Unlike `PartialMaintenance()`, this never repairs errors and only
+  /// collects sectors that have reclaimable space.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: A step was performed. Returns the number of bytes relocated, which
+  ///    is 0 if the step only erased a sector. Call again to continue.
+  ///
+  ///    NOT_FOUND: There is no reclaimable space to collect.
+  ///
+  ///    FAILED_PRECONDITION: The KVS is not initialized. Call ``Init()``
+  ///    before calling this method.
+  ///
+  /// @endrst
+  StatusWithSize IncrementalGarbageCollect(size_t max_relocate_bytes);
+
   /// Performs a portion of KVS maintenance. If configured for at least lazy
   /// recovery, will do any needed repairing of corruption. Does garbage
   /// collection of part of the KVS, typically a single sector or similar unit
   /// that makes sense for the KVS implementation.
   Status PartialMaintenance();
 
+  /// Writes a checkpoint to `Options::checkpoint_partition`: a snapshot of the
+  /// key descriptors and the writable space in each sector. `Init()` loads
+  /// the last checkpoint and only reads entries written after it, instead of
+  /// reading every entry in the KVS. Checkpoints are also written by
+  /// `Init()` when it could not use one, by maintenance, and by
+  /// `IncrementalGarbageCollect()` when it erases a sector.
+  ///
+  /// Erasing a sector makes the checkpoint out of date, so garbage collection
+  /// invalidates it first. `Init()` falls back to reading all entries if the
+  /// checkpoint was invalidated or does not match the KVS flash.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The checkpoint was written.
+  ///
+  ///    FAILED_PRECONDITION: The KVS is not initialized, needs maintenance,
+  ///    or has no checkpoint partition.
+  ///
+  ///    RESOURCE_EXHAUSTED: The checkpoint does not fit in the checkpoint
+  ///    partition.
+  ///
+  /// @endrst
+  Status WriteCheckpoint();
+
   void LogDebugInfo() const;
 
   // Classes and functions to support STL-style iteration.
@@ -475,7 +542,8 @@ class KeyValueStore {
                 Vector<SectorDescriptor>& sector_descriptor_list,
                 const SectorDescriptor** temp_sectors_to_skip,
                 Vector<KeyDescriptor>& key_descriptor_list,
-                Address* addresses);
+                Address* addresses,
+                internal::EntryCache::IndexEntry* key_index = nullptr);
 
  private:
   using EntryMetadata = internal::EntryMetadata;
@@ -492,6 +560,22 @@ class KeyValueStore {
   }
 
   Status InitializeMetadata();
+
+  // Loads entries from a sector, starting at entry_address, and updates its
+  // writable bytes. Returns the number of corrupt bytes found in the sector.
+  size_t LoadSector(SectorDescriptor& sector,
+                    Address entry_address,
+                    size_t& corrupt_entries);
+
+  // Loads the key descriptors and sector writable bytes from the last
+  // checkpoint. Fails if there is no valid checkpoint or it does not match the
+  // KVS flash, in which case the metadata must be reset.
+  Status LoadCheckpoint();
+
+  // Writes a checkpoint if there is a checkpoint partition. Failures are only
+  // logged; they never affect the KVS.
+  void UpdateCheckpoint();
+
   Status LoadEntry(Address entry_address, Address* next_entry_address);
   Status ScanForEntry(const SectorDescriptor& sector,
                       Address start_address,
@@ -589,6 +673,12 @@ class KeyValueStore {
                        KeyValueStore::Address& address,
                        span<const Address> reserved_addresses);
 
+  // Relocates an entry that was already read from flash.
+  Status RelocateEntry(Entry& entry,
+                       const EntryMetadata& metadata,
+                       KeyValueStore::Address& address,
+                       span<const Address> reserved_addresses);
+
   // Perform all maintenance possible, including all neeeded repairing of
   // corruption and garbage collection of reclaimable space in the KVS. When
   // configured for manual recovery, this is the only way KVS repair is
@@ -615,6 +705,25 @@ class KeyValueStore {
   Status GarbageCollectSector(SectorDescriptor& sector_to_gc,
                               span<const Address> reserved_addresses);
 
+  // Erases a sector that garbage collection has emptied of valid entries.
+  Status EraseGarbageCollectedSector(SectorDescriptor& sector_to_gc);
+
+  // Relocates up to max_relocate_bytes of valid entries out of the sector
+  // being collected incrementally, selecting a new sector if needed, and
+  // erases the sector once it is empty. Progress is kept across calls.
+  //
+  // For writes (on_write is true), the sector may have no reclaimable bytes,
+  // and RESOURCE_EXHAUSTED is returned if the next entry does not fit in the
+  // budget. Otherwise, only sectors with reclaimable bytes are collected and
+  // at least one entry is always relocated.
+  //
+  //                 OK: Progress was made; size is the bytes relocated.
+  //          NOT_FOUND: There is no sector to garbage collect.
+  // RESOURCE_EXHAUSTED: The budget is too small to make progress.
+  StatusWithSize GarbageCollectStep(size_t max_relocate_bytes,
+                                    span<const Address> reserved_addresses,
+                                    bool on_write);
+
   // Ensure that all entries are on the primary (first) format. Entries that are
   // not on the primary format are rewritten.
   //
@@ -647,12 +756,16 @@ class KeyValueStore {
   // List of sectors used by this KVS.
   internal::Sectors sectors_;
 
-  // Unordered list of KeyDescriptors. Finding a key requires scanning and
-  // verifying a match by reading the actual entry.
+  // Unordered list of KeyDescriptors. Finding a key requires scanning (or
+  // searching the optional key hash index) and verifying a match by reading
+  // the actual entry.
   internal::EntryCache entry_cache_;
 
   Options options_;
 
+  // Records written by WriteCheckpoint(), if there is a checkpoint partition.
+  internal::CheckpointLog checkpoint_log_;
+
   // Threshold value for when to garbage collect all stale data. Above the
   // threshold, GC all reclaimable bytes regardless of if valid data is in
   // sector. Below the threshold, only GC sectors with reclaimable bytes and no
@@ -685,6 +798,11 @@ class KeyValueStore {
   InternalStats internal_stats_;
 
   uint32_t last_transaction_id_;
+
+  // Sector that IncrementalGarbageCollect() or a write with a relocation limit
+  // is partway through collecting, if any. This is only a hint; if the sector
+  // is no longer worth collecting, another one is selected.
+  SectorDescriptor* incremental_gc_sector_;
 };
 
 template <size_t kMaxEntries,
@@ -726,6 +844,28 @@ class KeyValueStoreBuffer : public KeyValueStore {
     std::copy(formats.begin(), formats.end(), formats_.begin());
   }
 
+ protected:
+  // Constructs a KeyValueStore that finds keys with a sorted key hash index.
+  // key_index must have room for kMaxEntries entries.
+  KeyValueStoreBuffer(FlashPartition* partition,
+                      span<const EntryFormat, kEntryFormats> formats,
+                      const Options& options,
+                      internal::EntryCache::IndexEntry* key_index)
+      : KeyValueStore(partition,
+                      formats_,
+                      options,
+                      kRedundancy,
+                      sectors_,
+                      temp_sectors_to_skip_,
+                      key_descriptors_,
+                      addresses_,
+                      key_index),
+        sectors_(),
+        key_descriptors_(),
+        formats_() {
+    std::copy(formats.begin(), formats.end(), formats_.begin());
+  }
+
  private:
   static_assert(kMaxEntries > 0u);
   static_assert(kMaxUsableSectors > 0u);
@@ -755,5 +895,55 @@ class KeyValueStoreBuffer : public KeyValueStore {
   std::array<EntryFormat, kEntryFormats> formats_;
 };
 
+/// A `KeyValueStoreBuffer` that also keeps an index of its entries sorted by
+/// key hash. `Get`, `Put`, and `Delete` find keys with a binary search instead
+/// of a linear scan of every entry, at a cost of two bytes of RAM per entry
+/// and slightly slower insertion and removal of keys. Consider it for stores
+/// with more than a few dozen entries.
+template <size_t kMaxEntries,
+          size_t kMaxUsableSectors,
+          size_t kRedundancy = 1,
+          size_t kEntryFormats = 1>
+class IndexedKeyValueStoreBuffer
+    : public KeyValueStoreBuffer<kMaxEntries,
+                                 kMaxUsableSectors,
+                                 kRedundancy,
+                                 kEntryFormats> {
+ private:
+  using Base = KeyValueStoreBuffer<kMaxEntries,
+                                   kMaxUsableSectors,
+                                   kRedundancy,
+                                   kEntryFormats>;
+
+ public:
+  // Constructs a KeyValueStore on the partition, with support for one
+  // EntryFormat (kEntryFormats must be 1).
+  IndexedKeyValueStoreBuffer(FlashPartition* partition,
+                             const EntryFormat& format,
+                             const Options& options = {})
+      : IndexedKeyValueStoreBuffer(
+            partition,
+            span<const EntryFormat, kEntryFormats>(
+                reinterpret_cast<const EntryFormat (&)[1]>(format)),
+            options) {
+    static_assert(kEntryFormats == 1,
+                  "kEntryFormats EntryFormats must be specified");
+  }
+
+  // Constructs a KeyValueStore on the partition. Supports multiple entry
+  // formats. The first EntryFormat is used for new entries.
+  IndexedKeyValueStoreBuffer(FlashPartition* partition,
+                             span<const EntryFormat, kEntryFormats> formats,
+                             const Options& options = {})
+      : Base(partition, formats, options, key_index_) {}
+
+ private:
+  static_assert(kMaxEntries <= internal::EntryCache::kMaxIndexedEntries,
+                "Too many entries for the key hash index");
+
+  // Descriptor indices sorted by key hash, for use by the KVS's EntryCache.
+  internal::EntryCache::IndexEntry key_index_[kMaxEntries];
+};
+
 }  // namespace kvs
 }  // namespace pw
@@ -13,6 +13,7 @@
 // the License.
 #include "pw_multisink/multisink.h"
 
+#include <atomic>
 #include <cstring>
 
 #include "pw_assert/check.h"
@@ -28,14 +29,24 @@ namespace pw {
 namespace multisink {
 
 void MultiSink::HandleEntry(ConstByteSpan entry) {
-  std::lock_guard lock(lock_);
+  if (staging_ != nullptr && staging_->TryPush(entry)) {
+    // Order the push before checking the lock. If the lock is held, its holder
+    // is guaranteed to see the entry after it unlocks (see FlushAndUnlock()).
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (lock_.try_lock()) {
+      FlushAndUnlock();
+    }
+    return;
+  }
+
+  Guard guard(*this);
   const Status push_back_status = ring_buffer_.PushBack(entry, sequence_id_++);
   PW_DCHECK_OK(push_back_status);
   NotifyListeners();
 }
 
 void MultiSink::HandleDropped(uint32_t drop_count) {
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   // Updating the sequence ID helps identify where the ingress drop happend when
   // a drain peeks or pops.
   sequence_id_ += drop_count;
@@ -44,7 +55,7 @@ void MultiSink::HandleDropped(uint32_t drop_count) {
 }
 
 Status MultiSink::PopEntry(Drain& drain, const Drain::PeekedEntry& entry) {
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   PW_DCHECK_PTR_EQ(drain.multisink_, this);
 
   // Ignore the call if the entry has been handled already.
@@ -87,7 +98,7 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
   drain_drop_count_out = 0;
   ingress_drop_count_out = 0;
 
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   PW_DCHECK_PTR_EQ(drain.multisink_, this);
 
   const Status peek_status = drain.reader_.PeekFrontWithPreamble(
@@ -147,7 +158,7 @@ Result<ConstByteSpan> MultiSink::PeekOrPopEntry(
 }
 
 void MultiSink::AttachDrain(Drain& drain) {
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   PW_DCHECK_PTR_EQ(drain.multisink_, nullptr);
   drain.multisink_ = this;
 
@@ -163,7 +174,7 @@ void MultiSink::AttachDrain(Drain& drain) {
 }
 
 void MultiSink::DetachDrain(Drain& drain) {
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   PW_DCHECK_PTR_EQ(drain.multisink_, this);
   drain.multisink_ = nullptr;
   PW_CHECK_OK(ring_buffer_.DetachReader(drain.reader_),
@@ -171,23 +182,57 @@ void MultiSink::DetachDrain(Drain& drain) {
 }
 
 void MultiSink::AttachListener(Listener& listener) {
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   listeners_.push_back(listener);
   // Notify the newly added entry, in case there are items in the sink.
   listener.OnNewEntryAvailable();
 }
 
 void MultiSink::DetachListener(Listener& listener) {
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   [[maybe_unused]] bool was_detached = listeners_.remove(listener);
   PW_DCHECK(was_detached, "The listener was already attached.");
 }
 
 void MultiSink::Clear() {
-  std::lock_guard lock(lock_);
+  Guard guard(*this);
   ring_buffer_.Clear();
 }
 
+void MultiSink::FlushStagedEntries() {
+  if (staging_ == nullptr || !staging_->HasEntry()) {
+    return;
+  }
+
+  do {
+    const Status push_back_status =
+        ring_buffer_.PushBack(staging_->Front(), sequence_id_++);
+    PW_DCHECK_OK(push_back_status);
+    staging_->Pop();
+  } while (staging_->HasEntry());
+
+  NotifyListeners();
+}
+
+void MultiSink::FlushAndUnlock() {
+  FlushStagedEntries();
+  lock_.unlock();
+
+  if (staging_ == nullptr) {
+    return;
+  }
+
+  // A writer may have staged an entry after the flush above, and then failed
+  // to take the lock because it was still held. The fences on both sides
+  // ensure that either the writer's try_lock() succeeds or this sees its entry.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  while (staging_->HasEntry() && lock_.try_lock()) {
+    FlushStagedEntries();
+    lock_.unlock();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
 void MultiSink::NotifyListeners() {
   for (auto& listener : listeners_) {
     listener.OnNewEntryAvailable();
@@ -198,16 +243,21 @@ Status MultiSink::UnsafeForEachEntry(
     const Function<void(ConstByteSpan)>& callback, size_t max_num_entries) {
   MultiSink::UnsafeIterationWrapper multisink_iteration = UnsafeIteration();
 
-  // First count the number of entries.
+  // First count the number of entries, including entries that were staged but
+  // not yet moved into the ring buffer. Staged entries are read in place, since
+  // moving them requires the lock and would notify listeners.
   size_t num_entries = 0;
   for ([[maybe_unused]] ConstByteSpan entry : multisink_iteration) {
     num_entries++;
   }
+  const size_t num_staged_entries =
+      staging_ == nullptr ? 0 : staging_->UnsafeSize();
 
   // Log up to the max number of logs to avoid overflowing the crash log
   // writer.
+  const size_t total_entries = num_entries + num_staged_entries;
   const size_t first_logged_offset =
-      max_num_entries > num_entries ? 0 : num_entries - max_num_entries;
+      max_num_entries > total_entries ? 0 : total_entries - max_num_entries;
   pw::multisink::MultiSink::iterator it = multisink_iteration.begin();
   for (size_t offset = 0; it != multisink_iteration.end(); ++it, ++offset) {
     if (offset < first_logged_offset) {
@@ -220,6 +270,13 @@ Status MultiSink::UnsafeForEachEntry(
     return Status::DataLoss();
   }
 
+  // Staged entries follow the ring buffer's entries, as they would once moved.
+  for (size_t i = 0; i < num_staged_entries; ++i) {
+    if (num_entries + i >= first_logged_offset) {
+      callback(staging_->UnsafeAt(i));
+    }
+  }
+
   return OkStatus();
 }
 
@@ -0,0 +1,139 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_bytes/span.h"
+#include "pw_log/log.h"
+#include "pw_multisink/multisink.h"
+#include "pw_multisink/staging_buffer.h"
+#include "pw_multisink/test_thread.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_thread/thread.h"
+#include "pw_thread/yield.h"
+
+namespace pw::multisink {
+namespace {
+
+// Measures how long several threads take to write entries to a multisink while
+// a drain reads them, as in multisink_threaded_test.cc.
+
+constexpr size_t kMaxWriters = 4;
+constexpr size_t kEntriesPerWriter = 1000;
+constexpr size_t kEntrySize = 24;
+constexpr size_t kBufferSize = 64 * (kEntrySize + 8);
+
+constexpr std::array<std::byte, kEntrySize> kEntry{};
+
+// Writes kEntriesPerWriter entries to a multisink.
+class WriterThread : public thread::ThreadCore {
+ public:
+  constexpr WriterThread() : multisink_(nullptr) {}
+
+  void set_multisink(MultiSink& multisink) { multisink_ = &multisink; }
+
+ private:
+  void Run() override {
+    for (size_t i = 0; i < kEntriesPerWriter; ++i) {
+      multisink_->HandleEntry(kEntry);
+    }
+  }
+
+  MultiSink* multisink_;
+};
+
+// Pops entries from a multisink until every entry written has been read or
+// dropped.
+class ReaderThread : public thread::ThreadCore {
+ public:
+  constexpr ReaderThread() : multisink_(nullptr), expected_count_(0) {}
+
+  void Reset(MultiSink& multisink, uint32_t expected_count) {
+    multisink_ = &multisink;
+    expected_count_ = expected_count;
+  }
+
+ private:
+  void Run() override {
+    MultiSink::Drain drain;
+    multisink_->AttachDrain(drain);
+
+    std::array<std::byte, kEntrySize> buffer;
+    uint32_t count = 0;
+    while (count < expected_count_) {
+      uint32_t drop_count = 0;
+      uint32_t ingress_drop_count = 0;
+      const Result<ConstByteSpan> entry =
+          drain.PopEntry(buffer, drop_count, ingress_drop_count);
+      count += drop_count + ingress_drop_count;
+      if (entry.ok()) {
+        count += 1;
+      } else {
+        this_thread::yield();
+      }
+    }
+    multisink_->DetachDrain(drain);
+  }
+
+  MultiSink* multisink_;
+  uint32_t expected_count_;
+};
+
+std::array<std::byte, kBufferSize> buffer;
+StagingBuffer<16, kEntrySize> staging_buffer;
+ReaderThread reader;
+std::array<WriterThread, kMaxWriters> writers;
+
+void WriteWithContention(perf_test::State& state,
+                         size_t writer_count,
+                         bool staged) {
+  PW_LOG_INFO("%u writers each write %u entries per iteration",
+              static_cast<unsigned>(writer_count),
+              static_cast<unsigned>(kEntriesPerWriter));
+
+  while (state.KeepRunning()) {
+    std::optional<MultiSink> multisink;
+    if (staged) {
+      multisink.emplace(buffer, staging_buffer);
+    } else {
+      multisink.emplace(buffer);
+    }
+
+    reader.Reset(*multisink, writer_count * kEntriesPerWriter);
+    thread::Thread reader_thread(test::MultiSinkTestThreadOptions(), reader);
+
+    std::array<thread::Thread, kMaxWriters> writer_threads;
+    for (size_t i = 0; i < writer_count; ++i) {
+      writers[i].set_multisink(*multisink);
+      writer_threads[i] =
+          thread::Thread(test::MultiSinkTestThreadOptions(), writers[i]);
+    }
+    for (size_t i = 0; i < writer_count; ++i) {
+      writer_threads[i].join();
+    }
+    reader_thread.join();
+  }
+}
+
+PW_PERF_TEST(LockedOneWriter, WriteWithContention, 1, false);
+PW_PERF_TEST(StagedOneWriter, WriteWithContention, 1, true);
+
+PW_PERF_TEST(LockedFourWriters, WriteWithContention, 4, false);
+PW_PERF_TEST(StagedFourWriters, WriteWithContention, 4, true);
+
+}  // namespace
+}  // namespace pw::multisink
@@ -21,6 +21,7 @@
 #include <string_view>
 
 #include "pw_function/function.h"
+#include "pw_multisink/staging_buffer.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_unit_test/framework.h"
@@ -532,6 +533,170 @@ TEST_F(MultiSinkTest, DetachedDrainReportsDropCount) {
   VerifyPopEntry(drains_[0], kMessage, 0, ingress_drops);
 }
 
+class StagedMultiSinkTest : public MultiSinkTest {
+ protected:
+  static constexpr std::byte kLargeMessage[] = {(std::byte)0x01,
+                                                (std::byte)0x02,
+                                                (std::byte)0x03,
+                                                (std::byte)0x04,
+                                                (std::byte)0x05};
+
+  StagedMultiSinkTest()
+      : staged_buffer_{}, staged_multisink_(staged_buffer_, staging_) {}
+
+  StagingBuffer<4, sizeof(kMessage)> staging_;
+  std::byte staged_buffer_[kBufferSize];
+  MultiSink staged_multisink_;
+};
+
+TEST_F(StagedMultiSinkTest, SingleDrain) {
+  staged_multisink_.AttachDrain(drains_[0]);
+  staged_multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+  staged_multisink_.HandleEntry(kMessage);
+
+  // Single entry push and pop.
+  ExpectNotificationCount(listeners_[0], 1u);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+
+  // Multiple entries with intermittent drops.
+  staged_multisink_.HandleEntry(kMessage);
+  staged_multisink_.HandleDropped();
+  staged_multisink_.HandleEntry(kMessageOther);
+  ExpectNotificationCount(listeners_[0], 3u);
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], kMessageOther, 0u, 1u);
+
+  // Confirm out-of-range if no entries are expected.
+  ExpectNotificationCount(listeners_[0], 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+}
+
+TEST_F(StagedMultiSinkTest, MoreEntriesThanStagingSlots) {
+  staged_multisink_.AttachDrain(drains_[0]);
+  for (size_t i = 0; i < 3 * staging_.capacity(); ++i) {
+    staged_multisink_.HandleEntry(i % 2 == 0 ? kMessage : kMessageOther);
+  }
+  for (size_t i = 0; i < 3 * staging_.capacity(); ++i) {
+    VerifyPopEntry(drains_[0], i % 2 == 0 ? kMessage : kMessageOther, 0u, 0u);
+  }
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+}
+
+TEST_F(StagedMultiSinkTest, EntryTooLargeToStage_KeepsOrder) {
+  staged_multisink_.AttachDrain(drains_[0]);
+  staged_multisink_.HandleEntry(kMessage);
+  staged_multisink_.HandleEntry(kLargeMessage);
+  staged_multisink_.HandleEntry(kMessageOther);
+
+  VerifyPopEntry(drains_[0], kMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], kLargeMessage, 0u, 0u);
+  VerifyPopEntry(drains_[0], kMessageOther, 0u, 0u);
+  VerifyPopEntry(drains_[0], std::nullopt, 0u, 0u);
+}
+
+TEST_F(StagedMultiSinkTest, SlowDrainReportsDropCount) {
+  // Fill the ring buffer several times over, so the drain falls behind.
+  std::array<std::byte, kEntryBufferSize - 16> large_entry{};
+  staged_multisink_.AttachDrain(drains_[0]);
+  staged_multisink_.HandleEntry(kMessage);
+  for (size_t i = 0; i < 10; ++i) {
+    staged_multisink_.HandleEntry(large_entry);
+  }
+  staged_multisink_.HandleEntry(kMessageOther);
+
+  uint32_t drop_count = 0;
+  uint32_t ingress_drop_count = 0;
+  Result<ConstByteSpan> result =
+      drains_[0].PopEntry(entry_buffer_, drop_count, ingress_drop_count);
+  ASSERT_EQ(result.status(), OkStatus());
+  EXPECT_GT(drop_count, 0u);
+  EXPECT_EQ(ingress_drop_count, 0u);
+}
+
+TEST_F(StagedMultiSinkTest, UnsafeForEachEntry_IncludesStagedEntries) {
+  staged_multisink_.AttachListener(listeners_[0]);
+  ExpectNotificationCount(listeners_[0], 1u);
+  staged_multisink_.HandleEntry(kMessage);
+  ExpectNotificationCount(listeners_[0], 1u);
+
+  // Stage entries as if a writer could not take the lock.
+  ASSERT_TRUE(staging_.TryPush(kMessageOther));
+  ASSERT_TRUE(staging_.TryPush(kMessage));
+
+  const std::array<ConstByteSpan, 2> expected_entries = {kMessageOther,
+                                                         kMessage};
+  size_t entry_count = 0;
+  struct {
+    size_t& entry_count;
+    span<const ConstByteSpan> expected_results;
+  } ctx{entry_count, expected_entries};
+  auto cb = [&ctx](ConstByteSpan data) {
+    ASSERT_LT(ctx.entry_count, ctx.expected_results.size());
+    ConstByteSpan expected_entry = ctx.expected_results[ctx.entry_count];
+    EXPECT_EQ(data.size(), expected_entry.size());
+    const int result =
+        memcmp(data.data(), expected_entry.data(), expected_entry.size());
+    EXPECT_EQ(0, result);
+    ctx.entry_count++;
+  };
+
+  // Limit the dump so that it skips the ring buffer's only entry.
+  EXPECT_EQ(OkStatus(),
+            staged_multisink_.UnsafeForEachEntry(cb, expected_entries.size()));
+  EXPECT_EQ(expected_entries.size(), entry_count);
+
+  // The staged entries were not moved, and listeners were not notified.
+  EXPECT_EQ(staging_.UnsafeSize(), 2u);
+  ExpectNotificationCount(listeners_[0], 0u);
+}
+
+TEST(StagingQueue, PushAndPop) {
+  StagingBuffer<4, 8> staging;
+  EXPECT_EQ(staging.capacity(), 4u);
+  EXPECT_EQ(staging.max_entry_size(), 8u);
+  EXPECT_FALSE(staging.HasEntry());
+
+  constexpr std::string_view kEntry = "hello";
+  ASSERT_TRUE(staging.TryPush(as_bytes(span(kEntry))));
+  ASSERT_TRUE(staging.HasEntry());
+
+  const ConstByteSpan front = staging.Front();
+  EXPECT_EQ(std::string_view(reinterpret_cast<const char*>(front.data()),
+                             front.size()),
+            kEntry);
+  staging.Pop();
+  EXPECT_FALSE(staging.HasEntry());
+}
+
+TEST(StagingQueue, TooLarge) {
+  StagingBuffer<4, 4> staging;
+  EXPECT_FALSE(staging.TryPush(as_bytes(span("12345", 5))));
+  EXPECT_TRUE(staging.TryPush(as_bytes(span("1234", 4))));
+}
+
+TEST(StagingQueue, Full) {
+  StagingBuffer<2, 4> staging;
+  EXPECT_TRUE(staging.TryPush(as_bytes(span("1", 1))));
+  EXPECT_TRUE(staging.TryPush(as_bytes(span("2", 1))));
+  EXPECT_FALSE(staging.TryPush(as_bytes(span("3", 1))));
+
+  staging.Pop();
+  EXPECT_TRUE(staging.TryPush(as_bytes(span("3", 1))));
+}
+
+TEST(StagingQueue, WrapsAround) {
+  StagingBuffer<2, 4> staging;
+  for (char value = 'a'; value <= 'z'; ++value) {
+    ASSERT_TRUE(staging.TryPush(as_bytes(span(&value, 1))));
+    ASSERT_TRUE(staging.HasEntry());
+    ASSERT_EQ(staging.Front().size(), 1u);
+    EXPECT_EQ(static_cast<char>(staging.Front()[0]), value);
+    staging.Pop();
+  }
+  EXPECT_FALSE(staging.HasEntry());
+}
+
 TEST(UnsafeIteration, NoLimit) {
   constexpr std::array<std::string_view, 5> kExpectedEntries{
       "one", "two", "three", "four", "five"};
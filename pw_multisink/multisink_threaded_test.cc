@@ -371,6 +371,80 @@ TEST_F(MultiSinkTest, OverflowMultisink) {
   // can't control the order threads will operate.
 }
 
+// A multisink whose writers stage entries rather than taking the lock.
+class StagedMultiSinkTest : public ::testing::Test {
+ protected:
+  StagedMultiSinkTest() : buffer_{}, multisink_(buffer_, staging_) {}
+
+  StagingBuffer<8, kEntryBufferSize> staging_;
+  std::byte buffer_[kBufferSize];
+  MultiSink multisink_;
+};
+
+TEST_F(StagedMultiSinkTest, SingleWriterSingleReader) {
+  const uint32_t log_count = 100;
+  const uint32_t drop_count = 5;
+  const uint32_t expected_message_and_drop_count = log_count + drop_count;
+  const auto message_stack = MessagePool::Instance().GetMessages(log_count);
+
+  // Start reader thread.
+  LogPopReaderThread reader_thread_core(multisink_,
+                                        expected_message_and_drop_count);
+  thread::Thread reader_thread(test::MultiSinkTestThreadOptions(),
+                               reader_thread_core);
+  // Start writer thread.
+  LogWriterThread writer_thread_core(multisink_, message_stack);
+  thread::Thread writer_thread(test::MultiSinkTestThreadOptions(),
+                               writer_thread_core);
+
+  // Wait for writer thread to end.
+  writer_thread.join();
+  multisink_.HandleDropped(drop_count);
+  reader_thread.join();
+
+  EXPECT_EQ(reader_thread_core.drop_count(), drop_count);
+  CompareSentAndReceivedMessages(message_stack,
+                                 reader_thread_core.received_messages());
+}
+
+TEST_F(StagedMultiSinkTest, MultipleWritersMultipleReaders) {
+  const uint32_t log_count = 100;
+  const uint32_t drop_count = 7;
+  const uint32_t expected_message_and_drop_count = 2 * log_count + drop_count;
+  const auto message_stack = MessagePool::Instance().GetMessages(log_count);
+
+  // Start reader threads.
+  LogPopReaderThread reader_thread_core1(multisink_,
+                                         expected_message_and_drop_count);
+  thread::Thread reader_thread1(test::MultiSinkTestThreadOptions(),
+                                reader_thread_core1);
+  LogPeekAndCommitReaderThread reader_thread_core2(
+      multisink_, expected_message_and_drop_count);
+  thread::Thread reader_thread2(test::MultiSinkTestThreadOptions(),
+                                reader_thread_core2);
+  // Start writer threads.
+  LogWriterThread writer_thread_core1(multisink_, message_stack);
+  thread::Thread writer_thread1(test::MultiSinkTestThreadOptions(),
+                                writer_thread_core1);
+  LogWriterThread writer_thread_core2(multisink_, message_stack);
+  thread::Thread writer_thread2(test::MultiSinkTestThreadOptions(),
+                                writer_thread_core2);
+
+  // Wait for writer thread to end.
+  writer_thread1.join();
+  writer_thread2.join();
+  multisink_.HandleDropped(drop_count);
+  reader_thread1.join();
+  reader_thread2.join();
+
+  EXPECT_EQ(reader_thread_core1.drop_count(), drop_count);
+  EXPECT_EQ(reader_thread_core2.drop_count(), drop_count);
+  EXPECT_EQ(reader_thread_core1.received_messages().size(),
+            expected_message_and_drop_count - drop_count);
+  EXPECT_EQ(reader_thread_core2.received_messages().size(),
+            expected_message_and_drop_count - drop_count);
+}
+
 #endif  // PW_THREAD_JOINING_ENABLED
 
 }  // namespace pw::multisink
@@ -19,6 +19,7 @@
 #include "pw_bytes/span.h"
 #include "pw_function/function.h"
 #include "pw_multisink/config.h"
+#include "pw_multisink/staging_buffer.h"
 #include "pw_result/result.h"
 #include "pw_ring_buffer/prefixed_entry_ring_buffer.h"
 #include "pw_status/status.h"
@@ -33,6 +34,12 @@ namespace multisink {
 //
 // This class is thread-safe but NOT IRQ-safe when
 // PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled.
+//
+// By default, writers and drains all take the same lock. A MultiSink may
+// instead be given a StagingBuffer, which writers copy entries into without
+// waiting for the lock. Whichever thread holds the lock moves staged entries
+// into the ring buffer, so writers do not contend with each other or with
+// drains. See the HandleEntry() documentation for details.
 class MultiSink {
  public:
   // An asynchronous reader which is attached to a MultiSink via AttachDrain.
@@ -235,6 +242,10 @@ class MultiSink {
     // Invoked by the attached multisink when a new entry or drop count is
     // available. The multisink lock is held during this call, so neither the
     // multisink nor it's drains can be used during this callback.
+    //
+    // If the multisink has a staging buffer, this is called from the thread
+    // that moves staged entries into the multisink, which may be a drain or a
+    // different writer. Entries moved together are reported with one call.
     virtual void OnNewEntryAvailable() = 0;
   };
 
@@ -311,18 +322,39 @@ class MultiSink {
 
   // Constructs a multisink using a ring buffer backed by the provided buffer.
   MultiSink(ByteSpan buffer)
-      : ring_buffer_(true), sequence_id_(0), total_ingress_drops_(0) {
+      : ring_buffer_(true),
+        sequence_id_(0),
+        total_ingress_drops_(0),
+        staging_(nullptr) {
     ring_buffer_.SetBuffer(buffer)
         .IgnoreError();  // TODO: b/242598609 - Handle Status properly
     AttachDrain(oldest_entry_drain_);
   }
 
+  // Constructs a multisink whose writers stage entries in the provided
+  // StagingBuffer rather than waiting for the lock. The staging buffer must
+  // not be shared with other multisinks, and must outlive this one.
+  MultiSink(ByteSpan buffer, StagingQueue& staging_buffer)
+      : MultiSink(buffer) {
+    staging_ = &staging_buffer;
+  }
+
   // Write an entry to the multisink. If available space is less than the
   // size of the entry, the internal ring buffer will push the oldest entries
   // out to make space, so long as the entry is not larger than the buffer.
   // The sequence ID of the multisink will always increment as a result of
   // calling HandleEntry, regardless of whether pushing the entry succeeds.
   //
+  // If the multisink has a staging buffer, the entry is copied into it without
+  // taking the lock. The writer then moves staged entries into the ring buffer
+  // if the lock is free; otherwise, the thread holding the lock moves them
+  // before releasing it. Either way, the entry is assigned its sequence ID, and
+  // listeners are notified, when it is moved. Entries that are too large to
+  // stage, or that arrive while the staging buffer is full, take the lock as
+  // usual. Entries are moved in the order they were staged, but an entry that
+  // takes the lock may be added ahead of staged entries from other writers
+  // that have not finished copying theirs.
+  //
   // Precondition: If PW_MULTISINK_LOCK_INTERRUPT_SAFE is disabled, this
   // function must not be called from an interrupt context.
   // Precondition: entry.size() <= `ring_buffer_` size
@@ -370,14 +402,16 @@ class MultiSink {
 
   // Uses MultiSink's unsafe iteration to dump the contents to a user-provided
   // callback. max_num_entries can be used to limit the dump to the N most
-  // recent entries.
+  // recent entries. Entries that are still staged are passed to the callback
+  // after the ring buffer's entries, without moving them into the ring buffer.
   //
   // Returns:
   //   OK - Successfully dumped entire multisink.
   //   DATA_LOSS - Corruption detected, some entries may have been lost.
   Status UnsafeForEachEntry(
       const Function<void(ConstByteSpan)>& callback,
-      size_t max_num_entries = std::numeric_limits<size_t>::max());
+      size_t max_num_entries = std::numeric_limits<size_t>::max())
+      PW_NO_LOCK_SAFETY_ANALYSIS;
 
  protected:
   friend Drain;
@@ -412,6 +446,36 @@ class MultiSink {
       PW_LOCKS_EXCLUDED(lock_);
 
  private:
+  // Holds the lock for its lifetime. Staged entries are moved into the ring
+  // buffer when the lock is acquired, so that drains see them, and again
+  // before it is released, so that entries staged by writers that could not
+  // take the lock are not left behind.
+  class PW_SCOPED_LOCKABLE Guard {
+   public:
+    explicit Guard(MultiSink& multisink)
+        PW_EXCLUSIVE_LOCK_FUNCTION(multisink.lock_)
+        : multisink_(multisink) {
+      multisink_.lock_.lock();
+      multisink_.FlushStagedEntries();
+    }
+
+    ~Guard() PW_UNLOCK_FUNCTION() { multisink_.FlushAndUnlock(); }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+   private:
+    MultiSink& multisink_;
+  };
+
+  // Moves published entries from the staging buffer into the ring buffer and
+  // notifies listeners if there were any.
+  void FlushStagedEntries() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Flushes staged entries and releases the lock. Then, if a writer staged an
+  // entry in the meantime and the lock is free, flushes again on its behalf.
+  void FlushAndUnlock() PW_UNLOCK_FUNCTION(lock_) PW_NO_LOCK_SAFETY_ANALYSIS;
+
   // Notifies attached listeners of new entries or an updated drop count.
   void NotifyListeners() PW_EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
@@ -420,6 +484,7 @@ class MultiSink {
   Drain oldest_entry_drain_ PW_GUARDED_BY(lock_);
   uint32_t sequence_id_ PW_GUARDED_BY(lock_);
   uint32_t total_ingress_drops_ PW_GUARDED_BY(lock_);
+  StagingQueue* staging_;
   LockType lock_;
 };
 
@@ -0,0 +1,140 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+#include "pw_bytes/span.h"
+#include "pw_span/span.h"
+
+namespace pw {
+namespace multisink {
+
+// A bounded, lock-free queue of entries that many producers write to and one
+// consumer reads from. A MultiSink constructed with a staging queue copies
+// entries into it without taking the MultiSink's lock, and whichever thread
+// holds the lock moves them into the ring buffer. See StagingBuffer for the
+// storage.
+//
+// Producers claim a slot with a compare-and-swap on the write position, copy
+// the entry into the slot, and then publish it by advancing the slot's
+// sequence number. The consumer only reads slots that have been published, in
+// order. This is Dmitry Vyukov's bounded queue, with a single consumer.
+class StagingQueue {
+ public:
+  StagingQueue(const StagingQueue&) = delete;
+  StagingQueue& operator=(const StagingQueue&) = delete;
+
+  // The largest entry that fits in a slot.
+  size_t max_entry_size() const { return max_entry_size_; }
+
+  // The number of entries the queue holds.
+  size_t capacity() const { return sequences_.size(); }
+
+  // Copies an entry into the queue. Returns false if the entry is larger than
+  // max_entry_size() or the queue is full. Never blocks, so it may be called
+  // from any thread or interrupt.
+  bool TryPush(ConstByteSpan entry);
+
+  // True if the next entry has been published. May be called from any
+  // context, but only the consumer may act on the result.
+  bool HasEntry() const;
+
+  // Returns the next entry, which remains valid until Pop() is called.
+  //
+  // Precondition: Only the consumer may call this, and HasEntry() is true.
+  ConstByteSpan Front() const;
+
+  // Frees the next entry's slot for producers.
+  //
+  // Precondition: Only the consumer may call this, and HasEntry() is true.
+  void Pop();
+
+  // Returns the number of consecutive published entries, starting with the
+  // next one, without consuming them.
+  //
+  // This is not synchronized with the consumer, and is only meant for dumping
+  // entries when the consumer cannot run, such as from a crash handler.
+  size_t UnsafeSize() const;
+
+  // Returns the entry index entries after the next one, without consuming it.
+  //
+  // Precondition: index < UnsafeSize(), and the consumer is not running.
+  ConstByteSpan UnsafeAt(size_t index) const;
+
+ protected:
+  StagingQueue(span<std::atomic<uint32_t>> sequences,
+               span<uint16_t> sizes,
+               ByteSpan data,
+               size_t max_entry_size)
+      : sequences_(sequences),
+        sizes_(sizes),
+        data_(data),
+        max_entry_size_(max_entry_size),
+        write_position_(0),
+        read_position_(0) {}
+
+  // Marks every slot as free. Called once the storage has been constructed.
+  void Initialize();
+
+ private:
+  size_t Slot(uint32_t position) const {
+    return position & (sequences_.size() - 1);
+  }
+
+  // For each slot, the position a producer may claim it at, or one past the
+  // position it was published at if it holds an entry.
+  span<std::atomic<uint32_t>> sequences_;
+  span<uint16_t> sizes_;
+  ByteSpan data_;
+  size_t max_entry_size_;
+
+  std::atomic<uint32_t> write_position_;
+
+  // Only the consumer modifies the read position. It is atomic so that
+  // HasEntry() can be called without the MultiSink's lock.
+  std::atomic<uint32_t> read_position_;
+};
+
+// Storage for a StagingQueue with kEntries slots of up to kMaxEntrySizeBytes
+// each. kEntries must be a power of two.
+template <size_t kEntries, size_t kMaxEntrySizeBytes>
+class StagingBuffer : public StagingQueue {
+ public:
+  static_assert(kEntries > 0u && (kEntries & (kEntries - 1)) == 0u,
+                "The number of entries must be a power of two");
+  static_assert(kEntries <= std::numeric_limits<int32_t>::max());
+  static_assert(kMaxEntrySizeBytes <= std::numeric_limits<uint16_t>::max(),
+                "Entries must be smaller than 64 KiB");
+
+  StagingBuffer()
+      : StagingQueue(sequences_,
+                     sizes_,
+                     as_writable_bytes(span(data_)),
+                     kMaxEntrySizeBytes) {
+    Initialize();
+  }
+
+ private:
+  std::array<std::atomic<uint32_t>, kEntries> sequences_;
+  std::array<uint16_t, kEntries> sizes_;
+  std::array<std::array<std::byte, kMaxEntrySizeBytes>, kEntries> data_;
+};
+
+}  // namespace multisink
+}  // namespace pw
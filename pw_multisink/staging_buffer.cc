@@ -0,0 +1,101 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "pw_multisink/staging_buffer.h"
+
+#include <cstring>
+
+#include "pw_assert/check.h"
+
+namespace pw {
+namespace multisink {
+
+void StagingQueue::Initialize() {
+  for (size_t i = 0; i < sequences_.size(); ++i) {
+    sequences_[i].store(static_cast<uint32_t>(i), std::memory_order_relaxed);
+  }
+}
+
+bool StagingQueue::TryPush(ConstByteSpan entry) {
+  if (entry.size() > max_entry_size_) {
+    return false;
+  }
+
+  uint32_t position = write_position_.load(std::memory_order_relaxed);
+  while (true) {
+    const size_t slot = Slot(position);
+    const uint32_t sequence = sequences_[slot].load(std::memory_order_acquire);
+    const int32_t difference = static_cast<int32_t>(sequence - position);
+
+    if (difference == 0) {
+      // The slot is free. Claim it, unless another producer got there first,
+      // in which case position is updated and the loop tries again.
+      if (write_position_.compare_exchange_weak(
+              position, position + 1, std::memory_order_relaxed)) {
+        std::memcpy(
+            data_.data() + slot * max_entry_size_, entry.data(), entry.size());
+        sizes_[slot] = static_cast<uint16_t>(entry.size());
+        sequences_[slot].store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      // The slot still holds an entry from the previous lap: the queue is full.
+      return false;
+    } else {
+      // Another producer claimed the slot; catch up with it.
+      position = write_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+bool StagingQueue::HasEntry() const {
+  const uint32_t position = read_position_.load(std::memory_order_relaxed);
+  return sequences_[Slot(position)].load(std::memory_order_acquire) ==
+         position + 1;
+}
+
+ConstByteSpan StagingQueue::Front() const {
+  PW_DCHECK(HasEntry());
+  const size_t slot = Slot(read_position_.load(std::memory_order_relaxed));
+  return data_.subspan(slot * max_entry_size_, sizes_[slot]);
+}
+
+void StagingQueue::Pop() {
+  PW_DCHECK(HasEntry());
+  const uint32_t position = read_position_.load(std::memory_order_relaxed);
+  sequences_[Slot(position)].store(
+      position + static_cast<uint32_t>(sequences_.size()),
+      std::memory_order_release);
+  read_position_.store(position + 1, std::memory_order_relaxed);
+}
+
+size_t StagingQueue::UnsafeSize() const {
+  const uint32_t position = read_position_.load(std::memory_order_relaxed);
+  size_t size = 0;
+  while (size < sequences_.size() &&
+         sequences_[Slot(position + size)].load(std::memory_order_acquire) ==
+             position + size + 1) {
+    ++size;
+  }
+  return size;
+}
+
+ConstByteSpan StagingQueue::UnsafeAt(size_t index) const {
+  PW_DCHECK_UINT_LT(index, UnsafeSize());
+  const size_t slot =
+      Slot(read_position_.load(std::memory_order_relaxed) + index);
+  return data_.subspan(slot * max_entry_size_, sizes_[slot]);
+}
+
+}  // namespace multisink
+}  // namespace pw
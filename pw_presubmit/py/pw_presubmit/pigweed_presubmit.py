@@ -196,6 +196,7 @@ def _gn_combined_build_check_targets() -> Sequence[str]:
     # TODO: b/269354373 - clang is not supported on windows yet
     if sys.platform != 'win32':
         build_targets.append('host_clang_debug_dynamic_allocation')
+        build_targets.append('host_clang_debug_call_index_buckets')
 
     return build_targets
 
@@ -770,6 +771,14 @@ def bazel_test(ctx: PresubmitContext) -> None:
         '--',
         '//pw_rpc/...',
     )
+    build_bazel(
+        ctx,
+        'test',
+        '--//pw_rpc:config_override='
+        '//pw_rpc:call_index_buckets_config_enabled',
+        '--',
+        '//pw_rpc/...',
+    )
 
     # pw_grpc
     build_bazel(
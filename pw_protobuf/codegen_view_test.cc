@@ -0,0 +1,281 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+#include "pw_bytes/span.h"
+#include "pw_containers/vector.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_unit_test/framework.h"
+
+// These header files contain the code generated by the pw_protobuf plugin.
+// They are re-generated every time the tests are built and are used by the
+// tests to ensure that the interface remains consistent.
+//
+// The purpose of the tests in this file is primarily to verify that the
+// generated C++ interface is valid rather than the correctness of the
+// low-level decoder.
+#include "pw_protobuf_test_protos/full_test.pwpb.h"
+
+namespace pw::protobuf {
+namespace {
+
+using namespace ::pw::protobuf::test::pwpb;
+
+// Encodes a Pigweed message with most of its fields set.
+ConstByteSpan EncodePigweed(ByteSpan buffer) {
+  Pigweed::MemoryEncoder pigweed(buffer);
+  pigweed.WriteMagicNumber(73).IgnoreError();
+  pigweed.WriteZiggy(-111).IgnoreError();
+  pigweed.WriteErrorMessage("not a typewriter").IgnoreError();
+  pigweed.WriteBin(Pigweed::Protobuf::Binary::ZERO).IgnoreError();
+  {
+    DeviceInfo::StreamEncoder device_info = pigweed.GetDeviceInfoEncoder();
+    device_info.WriteDeviceName("pixel").IgnoreError();
+    {
+      KeyValuePair::StreamEncoder attributes =
+          device_info.GetAttributesEncoder();
+      attributes.WriteKey("version").IgnoreError();
+      attributes.WriteValue("5.3.1").IgnoreError();
+    }
+    {
+      KeyValuePair::StreamEncoder attributes =
+          device_info.GetAttributesEncoder();
+      attributes.WriteKey("chip").IgnoreError();
+      attributes.WriteValue("left-soc").IgnoreError();
+    }
+    device_info.WriteStatus(DeviceInfo::DeviceStatus::PANIC).IgnoreError();
+  }
+  {
+    Pigweed::Pigweed::StreamEncoder pigweed_pigweed =
+        pigweed.GetPigweedEncoder();
+    pigweed_pigweed.WriteStatus(Bool::FILE_NOT_FOUND).IgnoreError();
+  }
+  constexpr std::array<std::byte, 8> kData = {
+      std::byte{0x10},
+      std::byte{0x20},
+      std::byte{0x30},
+      std::byte{0x40},
+      std::byte{0x50},
+      std::byte{0x60},
+      std::byte{0x70},
+      std::byte{0x80},
+  };
+  pigweed.WriteData(kData).IgnoreError();
+  EXPECT_EQ(pigweed.status(), OkStatus());
+  return ConstByteSpan(pigweed);
+}
+
+// Checks that every accessor of a Pigweed::View reads the message from
+// EncodePigweed().
+void ExpectPigweed(const Pigweed::View& pigweed) {
+  Result<uint32_t> magic_number = pigweed.GetMagicNumber();
+  ASSERT_EQ(magic_number.status(), OkStatus());
+  EXPECT_EQ(magic_number.value(), 73u);
+
+  Result<int32_t> ziggy = pigweed.GetZiggy();
+  ASSERT_EQ(ziggy.status(), OkStatus());
+  EXPECT_EQ(ziggy.value(), -111);
+
+  Result<std::string_view> error_message = pigweed.GetErrorMessage();
+  ASSERT_EQ(error_message.status(), OkStatus());
+  EXPECT_EQ(error_message.value(), "not a typewriter");
+
+  Result<Pigweed::Protobuf::Binary> bin = pigweed.GetBin();
+  ASSERT_EQ(bin.status(), OkStatus());
+  EXPECT_EQ(bin.value(), Pigweed::Protobuf::Binary::ZERO);
+
+  Result<ConstByteSpan> data = pigweed.GetData();
+  ASSERT_EQ(data.status(), OkStatus());
+  ASSERT_EQ(data.value().size(), 8u);
+  EXPECT_EQ(data.value()[0], std::byte{0x10});
+  EXPECT_EQ(data.value()[7], std::byte{0x80});
+
+  Result<Pigweed::Pigweed::View> pigweed_pigweed = pigweed.GetPigweed();
+  ASSERT_EQ(pigweed_pigweed.status(), OkStatus());
+  Result<Bool> status = pigweed_pigweed.value().GetStatus();
+  ASSERT_EQ(status.status(), OkStatus());
+  EXPECT_EQ(status.value(), Bool::FILE_NOT_FOUND);
+
+  Result<DeviceInfo::View> device_info = pigweed.GetDeviceInfo();
+  ASSERT_EQ(device_info.status(), OkStatus());
+  Result<std::string_view> device_name = device_info.value().GetDeviceName();
+  ASSERT_EQ(device_name.status(), OkStatus());
+  EXPECT_EQ(device_name.value(), "pixel");
+  Result<DeviceInfo::DeviceStatus> device_status =
+      device_info.value().GetStatus();
+  ASSERT_EQ(device_status.status(), OkStatus());
+  EXPECT_EQ(device_status.value(), DeviceInfo::DeviceStatus::PANIC);
+
+  EXPECT_EQ(pigweed.GetCycles().status(), Status::NotFound());
+  EXPECT_EQ(pigweed.GetRatio().status(), Status::NotFound());
+  EXPECT_EQ(pigweed.GetDescription().status(), Status::NotFound());
+  EXPECT_EQ(pigweed.GetBungle().status(), Status::NotFound());
+  EXPECT_EQ(device_info.value().GetDeviceId().status(), Status::NotFound());
+}
+
+TEST(CodegenView, Scan) {
+  std::array<std::byte, 256> buffer;
+  const ConstByteSpan proto = EncodePigweed(buffer);
+
+  Pigweed::View pigweed(proto);
+  EXPECT_FALSE(pigweed.indexed());
+  ExpectPigweed(pigweed);
+}
+
+TEST(CodegenView, Indexed) {
+  std::array<std::byte, 256> buffer;
+  const ConstByteSpan proto = EncodePigweed(buffer);
+
+  Pigweed::View pigweed(proto);
+  Pigweed::View::Index index;
+  ASSERT_EQ(pigweed.BuildIndex(index), OkStatus());
+  EXPECT_TRUE(pigweed.indexed());
+  ExpectPigweed(pigweed);
+}
+
+TEST(CodegenView, StringPointsIntoBuffer) {
+  std::array<std::byte, 256> buffer;
+  const ConstByteSpan proto = EncodePigweed(buffer);
+
+  Pigweed::View pigweed(proto);
+  Result<std::string_view> error_message = pigweed.GetErrorMessage();
+  ASSERT_EQ(error_message.status(), OkStatus());
+
+  const auto* data = reinterpret_cast<const std::byte*>(error_message->data());
+  EXPECT_GE(data, proto.data());
+  EXPECT_LE(data + error_message->size(), proto.data() + proto.size());
+}
+
+TEST(CodegenView, FirstOccurrence) {
+  std::array<std::byte, 16> buffer;
+  CornerCases::MemoryEncoder corner_cases(buffer);
+  ASSERT_EQ(corner_cases.WriteUint32(1), OkStatus());
+  ASSERT_EQ(corner_cases.WriteUint32(2), OkStatus());
+
+  CornerCases::View view(corner_cases);
+  Result<uint32_t> value = view.GetUint32();
+  ASSERT_EQ(value.status(), OkStatus());
+  EXPECT_EQ(value.value(), 1u);
+
+  CornerCases::View::Index index;
+  ASSERT_EQ(view.BuildIndex(index), OkStatus());
+  value = view.GetUint32();
+  ASSERT_EQ(value.status(), OkStatus());
+  EXPECT_EQ(value.value(), 1u);
+}
+
+TEST(CodegenView, ForEachRepeatedMessage) {
+  std::array<std::byte, 256> buffer;
+  const ConstByteSpan proto = EncodePigweed(buffer);
+
+  Result<DeviceInfo::View> device_info = Pigweed::View(proto).GetDeviceInfo();
+  ASSERT_EQ(device_info.status(), OkStatus());
+
+  Vector<std::string_view, 4> keys;
+  Vector<std::string_view, 4> values;
+  EXPECT_EQ(device_info->ForEachAttributes([&](KeyValuePair::View attribute) {
+    PW_TRY_ASSIGN(std::string_view key, attribute.GetKey());
+    PW_TRY_ASSIGN(std::string_view value, attribute.GetValue());
+    keys.push_back(key);
+    values.push_back(value);
+    return OkStatus();
+  }),
+            OkStatus());
+
+  ASSERT_EQ(keys.size(), 2u);
+  EXPECT_EQ(keys[0], "version");
+  EXPECT_EQ(values[0], "5.3.1");
+  EXPECT_EQ(keys[1], "chip");
+  EXPECT_EQ(values[1], "left-soc");
+}
+
+TEST(CodegenView, ForEachStopsOnError) {
+  std::array<std::byte, 256> buffer;
+  const ConstByteSpan proto = EncodePigweed(buffer);
+
+  Result<DeviceInfo::View> device_info = Pigweed::View(proto).GetDeviceInfo();
+  ASSERT_EQ(device_info.status(), OkStatus());
+
+  int calls = 0;
+  EXPECT_EQ(device_info->ForEachAttributes([&calls](KeyValuePair::View) {
+    ++calls;
+    return Status::Cancelled();
+  }),
+            Status::Cancelled());
+  EXPECT_EQ(calls, 1);
+}
+
+TEST(CodegenView, ForEachMissingField) {
+  DeviceInfo::View device_info;
+  int calls = 0;
+  EXPECT_EQ(device_info.ForEachAttributes([&calls](KeyValuePair::View) {
+    ++calls;
+    return OkStatus();
+  }),
+            OkStatus());
+  EXPECT_EQ(calls, 0);
+}
+
+// Counts the crates in a tree of crates.
+Status CountCrates(Crate::View crate, int& count) {
+  count += 1;
+  return crate.ForEachSmallerCrates(
+      [&count](Crate::View smaller) { return CountCrates(smaller, count); });
+}
+
+TEST(CodegenView, RecursiveMessage) {
+  std::array<std::byte, 128> buffer;
+  Crate::MemoryEncoder biggest(buffer);
+  ASSERT_EQ(biggest.WriteName("Huge crate"), OkStatus());
+  {
+    Crate::StreamEncoder medium = biggest.GetSmallerCratesEncoder();
+    ASSERT_EQ(medium.WriteName("Medium crate"), OkStatus());
+    {
+      Crate::StreamEncoder small = medium.GetSmallerCratesEncoder();
+      ASSERT_EQ(small.WriteName("Small crate"), OkStatus());
+    }
+  }
+  {
+    Crate::StreamEncoder other = biggest.GetSmallerCratesEncoder();
+    ASSERT_EQ(other.WriteName("Other crate"), OkStatus());
+  }
+  ASSERT_EQ(biggest.status(), OkStatus());
+
+  Crate::View crate(biggest);
+  Result<std::string_view> name = crate.GetName();
+  ASSERT_EQ(name.status(), OkStatus());
+  EXPECT_EQ(name.value(), "Huge crate");
+
+  int count = 0;
+  EXPECT_EQ(CountCrates(crate, count), OkStatus());
+  EXPECT_EQ(count, 4);
+}
+
+TEST(CodegenView, InvalidMessage) {
+  // Field 1 claims to be 16 bytes long, but there are only 2.
+  constexpr std::array<std::byte, 4> kProto = {
+      std::byte{0x0a}, std::byte{0x10}, std::byte{'h'}, std::byte{'i'}};
+
+  KeyValuePair::View key_value_pair(kProto);
+  KeyValuePair::View::Index index;
+  EXPECT_EQ(key_value_pair.BuildIndex(index), Status::DataLoss());
+  EXPECT_FALSE(key_value_pair.indexed());
+  EXPECT_EQ(key_value_pair.GetKey().status(), Status::DataLoss());
+}
+
+}  // namespace
+}  // namespace pw::protobuf
@@ -14,12 +14,481 @@
 
 #include "pw_protobuf/decoder.h"
 
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <optional>
 
 #include "pw_assert/check.h"
+#include "pw_bytes/bit.h"
+#include "pw_containers/vector.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_status/status_with_size.h"
+#include "pw_status/try.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_string/string.h"
 #include "pw_varint/varint.h"
 
 namespace pw::protobuf {
+namespace {
+
+using internal::MessageField;
+using internal::VarintType;
+
+// Decodes a varint from the start of the data and advances past it. Returns
+// false if the data does not start with a valid varint.
+bool ConsumeVarint(ConstByteSpan& data, uint64_t& value) {
+  // Nearly all keys and lengths, and many values, are a single byte.
+  if (!data.empty() && data[0] < std::byte{0x80}) {
+    value = static_cast<uint64_t>(data[0]);
+    data = data.subspan(1);
+    return true;
+  }
+  const size_t size = varint::Decode(data, &value);
+  data = data.subspan(size);
+  return size != 0u;
+}
+
+// Stores a decoded varint to a struct member of the given size. Returns
+// FAILED_PRECONDITION if the value doesn't fit, as StreamDecoder does.
+Status StoreVarint(uint64_t value,
+                   VarintType type,
+                   std::byte* out,
+                   size_t size) {
+  if (size == sizeof(bool)) {
+    const bool boolean = value != 0u;
+    std::memcpy(out, &boolean, sizeof(boolean));
+    return OkStatus();
+  }
+
+  if (type == VarintType::kUnsigned) {
+    if (size == sizeof(uint64_t)) {
+      std::memcpy(out, &value, sizeof(value));
+      return OkStatus();
+    }
+    if (value > std::numeric_limits<uint32_t>::max()) {
+      return Status::FailedPrecondition();
+    }
+    const uint32_t value32 = static_cast<uint32_t>(value);
+    std::memcpy(out, &value32, sizeof(value32));
+    return OkStatus();
+  }
+
+  const int64_t signed_value = type == VarintType::kZigZag
+                                   ? varint::ZigZagDecode(value)
+                                   : static_cast<int64_t>(value);
+  if (size == sizeof(int64_t)) {
+    std::memcpy(out, &signed_value, sizeof(signed_value));
+    return OkStatus();
+  }
+  if (signed_value > std::numeric_limits<int32_t>::max() ||
+      signed_value < std::numeric_limits<int32_t>::min()) {
+    return Status::FailedPrecondition();
+  }
+  const int32_t value32 = static_cast<int32_t>(signed_value);
+  std::memcpy(out, &value32, sizeof(value32));
+  return OkStatus();
+}
+
+// Decodes packed varints into an array of elements of the given size. Returns
+// the number of elements decoded, and RESOURCE_EXHAUSTED if they didn't all
+// fit.
+StatusWithSize DecodePackedVarints(ConstByteSpan data,
+                                   VarintType type,
+                                   span<std::byte> out,
+                                   size_t elem_size) {
+  size_t count = 0;
+  while (!data.empty()) {
+    if (out.size() < elem_size) {
+      return StatusWithSize::ResourceExhausted(count);
+    }
+    uint64_t value;
+    if (!ConsumeVarint(data, value)) {
+      return StatusWithSize::DataLoss(count);
+    }
+    if (Status status = StoreVarint(value, type, out.data(), elem_size);
+        !status.ok()) {
+      return StatusWithSize(status, count);
+    }
+    out = out.subspan(elem_size);
+    count += 1;
+  }
+  return StatusWithSize(count);
+}
+
+// Copies little-endian fixed-size values to an array of elements of the given
+// size. Returns the number of elements copied.
+size_t CopyFixed(ConstByteSpan data, std::byte* out, size_t elem_size) {
+  const size_t count = data.size() / elem_size;
+  std::memcpy(out, data.data(), count * elem_size);
+  if constexpr (endian::native != endian::little) {
+    for (size_t i = 0; i < count; ++i) {
+      std::reverse(out + i * elem_size, out + (i + 1) * elem_size);
+    }
+  }
+  return count;
+}
+
+// Appends one or more varints to a pw::Vector struct member, accepting both
+// packed and unpacked encodings like StreamDecoder::ReadRepeatedVarintField().
+template <typename T>
+Status DecodeRepeatedVarint(std::byte* member,
+                            WireType wire_type,
+                            ConstByteSpan value_bytes,
+                            uint64_t value,
+                            VarintType type) {
+  auto& vector = *reinterpret_cast<Vector<T>*>(member);
+  if (vector.full()) {
+    return Status::ResourceExhausted();
+  }
+
+  if (wire_type == WireType::kDelimited) {
+    const size_t old_size = vector.size();
+    vector.resize(vector.capacity());
+    const StatusWithSize result = DecodePackedVarints(
+        value_bytes,
+        type,
+        as_writable_bytes(span(vector.data() + old_size, vector.size())),
+        sizeof(T));
+    vector.resize(old_size + result.size());
+    return result.status();
+  }
+  if (wire_type != WireType::kVarint) {
+    return Status::NotFound();
+  }
+
+  T element;
+  PW_TRY(StoreVarint(
+      value, type, reinterpret_cast<std::byte*>(&element), sizeof(element)));
+  vector.push_back(element);
+  return OkStatus();
+}
+
+// Appends one or more fixed-size values to a pw::Vector struct member,
+// accepting both packed and unpacked encodings like
+// StreamDecoder::ReadRepeatedFixedField().
+template <typename T>
+Status DecodeRepeatedFixed(std::byte* member,
+                           WireType wire_type,
+                           WireType element_wire_type,
+                           ConstByteSpan value_bytes) {
+  auto& vector = *reinterpret_cast<Vector<T>*>(member);
+  if (vector.full()) {
+    return Status::ResourceExhausted();
+  }
+
+  if (wire_type == WireType::kDelimited) {
+    const size_t old_size = vector.size();
+    if (value_bytes.size() > (vector.capacity() - old_size) * sizeof(T)) {
+      return Status::ResourceExhausted();
+    }
+    vector.resize(old_size + value_bytes.size() / sizeof(T));
+    CopyFixed(value_bytes,
+              reinterpret_cast<std::byte*>(vector.data() + old_size),
+              sizeof(T));
+    return OkStatus();
+  }
+  if (wire_type != element_wire_type) {
+    return Status::NotFound();
+  }
+
+  T element;
+  CopyFixed(value_bytes, reinterpret_cast<std::byte*>(&element), sizeof(T));
+  vector.push_back(element);
+  return OkStatus();
+}
+
+template <typename T>
+void AssignOptional(std::byte* member, T value) {
+  *reinterpret_cast<std::optional<T>*>(member) = value;
+}
+
+// Finds the table entry for a field number. Fields are usually encoded in the
+// order they're declared in, so the search starts at the entry of the previous
+// field that was found, which is then updated.
+const MessageField* FindField(span<const MessageField> table,
+                              uint32_t field_number,
+                              size_t& hint) {
+  for (size_t i = hint; i < table.size(); ++i) {
+    if (table[i].field_number() == field_number) {
+      hint = i;
+      return &table[i];
+    }
+  }
+  for (size_t i = 0; i < hint; ++i) {
+    if (table[i].field_number() == field_number) {
+      hint = i;
+      return &table[i];
+    }
+  }
+  return nullptr;
+}
+
+// Fields with callbacks are decoded by a StreamDecoder that reads only that
+// field, so that the callback is called exactly as StreamDecoder::Read() would.
+class CallbackFieldDecoder : public StreamDecoder {
+ public:
+  constexpr CallbackFieldDecoder(stream::Reader& reader)
+      : StreamDecoder(reader) {}
+
+  using StreamDecoder::Read;
+};
+
+Status DecodeCallbackField(ConstByteSpan field_bytes,
+                           span<std::byte> message,
+                           const MessageField& field) {
+  stream::MemoryReader reader(field_bytes);
+  CallbackFieldDecoder decoder(reader);
+  return decoder.Read(message, span(&field, 1));
+}
+
+Status DecodeMessage(ConstByteSpan proto,
+                     span<std::byte> message,
+                     span<const MessageField> table);
+
+// Decodes a field's value into its struct member. This mirrors
+// StreamDecoder::Read(), and switches on the expected wire type of the field,
+// not the actual, so that the encoded data doesn't influence how the struct
+// is written to.
+Status DecodeField(const MessageField& field,
+                   WireType wire_type,
+                   ConstByteSpan value_bytes,
+                   uint64_t value,
+                   span<std::byte> out) {
+  switch (field.wire_type()) {
+    case WireType::kFixed64:
+    case WireType::kFixed32: {
+      PW_CHECK(field.elem_size() == (field.wire_type() == WireType::kFixed32
+                                         ? sizeof(uint32_t)
+                                         : sizeof(uint64_t)),
+               "Mismatched message field type and size");
+      if (field.is_fixed_size()) {
+        // std::array of a fixed-size type, which must be packed.
+        PW_CHECK(field.is_repeated(), "Non-repeated fixed size field");
+        if (wire_type != WireType::kDelimited) {
+          return Status::NotFound();
+        }
+        if (out.size() < value_bytes.size()) {
+          return Status::ResourceExhausted();
+        }
+        CopyFixed(value_bytes, out.data(), field.elem_size());
+        return OkStatus();
+      }
+      if (field.is_repeated()) {
+        if (field.elem_size() == sizeof(uint64_t)) {
+          return DecodeRepeatedFixed<uint64_t>(
+              out.data(), wire_type, field.wire_type(), value_bytes);
+        }
+        return DecodeRepeatedFixed<uint32_t>(
+            out.data(), wire_type, field.wire_type(), value_bytes);
+      }
+      if (wire_type != field.wire_type()) {
+        return Status::NotFound();
+      }
+      if (field.is_optional()) {
+        if (field.elem_size() == sizeof(uint64_t)) {
+          uint64_t fixed;
+          CopyFixed(value_bytes, reinterpret_cast<std::byte*>(&fixed), 8);
+          AssignOptional(out.data(), fixed);
+        } else {
+          uint32_t fixed;
+          CopyFixed(value_bytes, reinterpret_cast<std::byte*>(&fixed), 4);
+          AssignOptional(out.data(), fixed);
+        }
+        return OkStatus();
+      }
+      PW_CHECK(out.size() == field.elem_size(),
+               "Mismatched message field type and size");
+      CopyFixed(value_bytes, out.data(), field.elem_size());
+      return OkStatus();
+    }
+
+    case WireType::kVarint: {
+      PW_CHECK(field.elem_size() == sizeof(uint64_t) ||
+                   field.elem_size() == sizeof(uint32_t) ||
+                   field.elem_size() == sizeof(bool),
+               "Mismatched message field type and size");
+      if (field.is_fixed_size()) {
+        // std::array of a varint type, which must be packed.
+        PW_CHECK(field.is_repeated(), "Non-repeated fixed size field");
+        if (wire_type != WireType::kDelimited) {
+          return Status::NotFound();
+        }
+        return DecodePackedVarints(
+                   value_bytes, field.varint_type(), out, field.elem_size())
+            .status();
+      }
+      if (field.is_repeated()) {
+        switch (field.elem_size()) {
+          case sizeof(uint64_t):
+            return DecodeRepeatedVarint<uint64_t>(
+                out.data(), wire_type, value_bytes, value, field.varint_type());
+          case sizeof(uint32_t):
+            return DecodeRepeatedVarint<uint32_t>(
+                out.data(), wire_type, value_bytes, value, field.varint_type());
+          default:
+            return DecodeRepeatedVarint<bool>(
+                out.data(), wire_type, value_bytes, value, field.varint_type());
+        }
+      }
+      if (wire_type != WireType::kVarint) {
+        return Status::NotFound();
+      }
+      if (field.is_optional()) {
+        switch (field.elem_size()) {
+          case sizeof(uint64_t): {
+            uint64_t varint;
+            PW_TRY(StoreVarint(value,
+                               field.varint_type(),
+                               reinterpret_cast<std::byte*>(&varint),
+                               sizeof(varint)));
+            AssignOptional(out.data(), varint);
+            break;
+          }
+          case sizeof(uint32_t): {
+            uint32_t varint;
+            PW_TRY(StoreVarint(value,
+                               field.varint_type(),
+                               reinterpret_cast<std::byte*>(&varint),
+                               sizeof(varint)));
+            AssignOptional(out.data(), varint);
+            break;
+          }
+          default:
+            AssignOptional(out.data(), value != 0u);
+            break;
+        }
+        return OkStatus();
+      }
+      PW_CHECK(out.size() == field.elem_size(),
+               "Mismatched message field type and size");
+      return StoreVarint(value, field.varint_type(), out.data(), out.size());
+    }
+
+    case WireType::kDelimited: {
+      PW_CHECK(!field.is_repeated(),
+               "Repeated delimited messages always require a callback");
+      if (wire_type != WireType::kDelimited) {
+        return Status::NotFound();
+      }
+      if (field.nested_message_fields() != nullptr) {
+        // Nested message. The struct member is an embedded struct, which is
+        // decoded from the field's value using its own table.
+        return DecodeMessage(
+            value_bytes, out, *field.nested_message_fields());
+      }
+
+      PW_CHECK(field.elem_size() == sizeof(std::byte),
+               "Mismatched message field type and size");
+      if (field.is_fixed_size()) {
+        // Fixed-length bytes field. Struct member is a std::array<std::byte>.
+        if (out.size() < value_bytes.size()) {
+          return Status::ResourceExhausted();
+        }
+        std::copy(value_bytes.begin(), value_bytes.end(), out.begin());
+      } else if (field.is_string()) {
+        auto& string = *reinterpret_cast<InlineString<>*>(out.data());
+        if (string.capacity() < value_bytes.size()) {
+          return Status::ResourceExhausted();
+        }
+        string.assign(reinterpret_cast<const char*>(value_bytes.data()),
+                      value_bytes.size());
+      } else {
+        auto& bytes = *reinterpret_cast<Vector<std::byte>*>(out.data());
+        if (bytes.capacity() < value_bytes.size()) {
+          return Status::ResourceExhausted();
+        }
+        bytes.resize(value_bytes.size());
+        std::memcpy(bytes.data(), value_bytes.data(), value_bytes.size());
+      }
+      return OkStatus();
+    }
+  }
+
+  return OkStatus();
+}
+
+Status DecodeMessage(ConstByteSpan proto,
+                     span<std::byte> message,
+                     span<const MessageField> table) {
+  size_t hint = 0;
+
+  while (!proto.empty()) {
+    const std::byte* const field_start = proto.data();
+
+    uint64_t key;
+    if (!ConsumeVarint(proto, key) || !FieldKey::IsValidKey(key)) {
+      return Status::DataLoss();
+    }
+    const FieldKey field_key(static_cast<uint32_t>(key));
+
+    // Find the extent of the field's value. Varints are decoded along the way,
+    // since that's the only way to find their size.
+    uint64_t value = 0;
+    size_t value_size = 0;
+    switch (field_key.wire_type()) {
+      case WireType::kVarint: {
+        ConstByteSpan rest = proto;
+        if (!ConsumeVarint(rest, value)) {
+          return Status::DataLoss();
+        }
+        value_size = proto.size() - rest.size();
+        break;
+      }
+      case WireType::kDelimited:
+        if (!ConsumeVarint(proto, value)) {
+          return Status::DataLoss();
+        }
+        // Check the length before narrowing it, so that lengths that do not
+        // fit in a size_t cannot wrap.
+        if (value > proto.size()) {
+          return Status::DataLoss();
+        }
+        value_size = static_cast<size_t>(value);
+        break;
+      case WireType::kFixed32:
+        value_size = sizeof(uint32_t);
+        break;
+      case WireType::kFixed64:
+        value_size = sizeof(uint64_t);
+        break;
+    }
+    if (proto.size() < value_size) {
+      return Status::DataLoss();
+    }
+    const ConstByteSpan value_bytes = proto.first(value_size);
+    proto = proto.subspan(value_size);
+
+    const MessageField* field =
+        FindField(table, field_key.field_number(), hint);
+    if (field == nullptr) {
+      // Unknown fields are skipped.
+      continue;
+    }
+
+    // Calculate the span of bytes corresponding to the structure field to
+    // output into.
+    const span<std::byte> out =
+        message.subspan(field->field_offset(), field->field_size());
+    PW_CHECK(out.begin() >= message.begin() && out.end() <= message.end());
+
+    if (field->use_callback()) {
+      PW_TRY(DecodeCallbackField(
+          ConstByteSpan(field_start,
+                        static_cast<size_t>(proto.data() - field_start)),
+          message,
+          *field));
+      continue;
+    }
+
+    PW_TRY(DecodeField(*field, field_key.wire_type(), value_bytes, value, out));
+  }
+
+  return OkStatus();
+}
+
+}  // namespace
 
 Status Decoder::Next() {
   if (!previous_field_consumed_) {
@@ -241,6 +710,14 @@ Status Decoder::ReadDelimited(span<const std::byte>* out) {
   return OkStatus();
 }
 
+Status Decoder::ReadMessage(span<std::byte> message,
+                            span<const internal::MessageField> table) {
+  const ConstByteSpan proto = proto_;
+  proto_ = proto_.subspan(proto_.size());
+  previous_field_consumed_ = true;
+  return DecodeMessage(proto, message, table);
+}
+
 Status CallbackDecoder::Decode(span<const std::byte> proto) {
   if (handler_ == nullptr || state_ != kReady) {
     return Status::FailedPrecondition();
@@ -0,0 +1,194 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "pw_assert/check.h"
+#include "pw_bytes/span.h"
+#include "pw_containers/vector.h"
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_preprocessor/compiler.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/internal/codegen.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_stream/memory_stream.h"
+
+namespace pw::protobuf {
+namespace {
+
+// A message struct and field table in the form that pw_protobuf generates for
+// an RPC request like pw.transfer.Chunk:
+//
+//   message Chunk {
+//     uint32 transfer_id = 1;
+//     optional uint32 pending_bytes = 2;
+//     optional uint32 max_chunk_size_bytes = 3;
+//     optional uint32 min_delay_microseconds = 4;
+//     uint64 offset = 5;
+//     bytes data = 6;  // max_size: 64
+//     optional uint64 remaining_bytes = 7;
+//     optional uint32 status = 8;
+//     uint32 window_end_offset = 9;
+//     optional Type type = 10;
+//     optional uint32 session_id = 11;
+//   }
+struct Chunk {
+  uint32_t transfer_id;
+  std::optional<uint32_t> pending_bytes;
+  std::optional<uint32_t> max_chunk_size_bytes;
+  std::optional<uint32_t> min_delay_microseconds;
+  uint64_t offset;
+  Vector<std::byte, 64> data;
+  std::optional<uint64_t> remaining_bytes;
+  std::optional<uint32_t> status;
+  uint32_t window_end_offset;
+  std::optional<uint32_t> type;
+  std::optional<uint32_t> session_id;
+};
+
+using internal::MessageField;
+using internal::VarintType;
+
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");
+
+// clang-format off
+constexpr MessageField kChunkFieldsArray[] = {
+  {1, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, false, false,
+   offsetof(Chunk, transfer_id), sizeof(Chunk::transfer_id), nullptr},
+  {2, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(Chunk, pending_bytes), sizeof(Chunk::pending_bytes), nullptr},
+  {3, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(Chunk, max_chunk_size_bytes), sizeof(Chunk::max_chunk_size_bytes),
+   nullptr},
+  {4, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(Chunk, min_delay_microseconds),
+   sizeof(Chunk::min_delay_microseconds), nullptr},
+  {5, WireType::kVarint, sizeof(uint64_t), VarintType::kUnsigned,
+   false, false, false, false, false,
+   offsetof(Chunk, offset), sizeof(Chunk::offset), nullptr},
+  {6, WireType::kDelimited, sizeof(std::byte), VarintType::kNormal,
+   false, false, false, false, false,
+   offsetof(Chunk, data), sizeof(Chunk::data), nullptr},
+  {7, WireType::kVarint, sizeof(uint64_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(Chunk, remaining_bytes), sizeof(Chunk::remaining_bytes), nullptr},
+  {8, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(Chunk, status), sizeof(Chunk::status), nullptr},
+  {9, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, false, false,
+   offsetof(Chunk, window_end_offset), sizeof(Chunk::window_end_offset),
+   nullptr},
+  {10, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(Chunk, type), sizeof(Chunk::type), nullptr},
+  {11, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(Chunk, session_id), sizeof(Chunk::session_id), nullptr},
+};
+// clang-format on
+constexpr span<const MessageField> kChunkFields = kChunkFieldsArray;
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+// Exposes StreamDecoder::Read(), as the generated StreamDecoder::Read(Message&)
+// does.
+class ChunkStreamDecoder : public StreamDecoder {
+ public:
+  constexpr ChunkStreamDecoder(stream::Reader& reader)
+      : StreamDecoder(reader) {}
+
+  Status Read(Chunk& chunk) {
+    return StreamDecoder::Read(as_writable_bytes(span(&chunk, 1)),
+                               kChunkFields);
+  }
+};
+
+std::array<std::byte, 128> buffer;
+
+// Encodes a chunk with data_size bytes of data. Control chunks have no data,
+// and set the flow control fields instead.
+ConstByteSpan EncodeChunk(size_t data_size) {
+  std::array<std::byte, 64> data;
+  for (size_t i = 0; i < data_size; ++i) {
+    data[i] = static_cast<std::byte>(i);
+  }
+
+  MemoryEncoder encoder(buffer);
+  encoder.WriteUint32(1, 3).IgnoreError();
+  if (data_size == 0u) {
+    encoder.WriteUint32(2, 8192).IgnoreError();
+    encoder.WriteUint32(3, 1024).IgnoreError();
+    encoder.WriteUint32(4, 500).IgnoreError();
+  }
+  encoder.WriteUint64(5, 123456).IgnoreError();
+  if (data_size != 0u) {
+    encoder.WriteBytes(6, span(data).first(data_size)).IgnoreError();
+    encoder.WriteUint64(7, 1000000).IgnoreError();
+  }
+  encoder.WriteUint32(9, 131072).IgnoreError();
+  encoder.WriteUint32(10, data_size == 0u ? 1 : 0).IgnoreError();
+  encoder.WriteUint32(11, 3).IgnoreError();
+  PW_CHECK_OK(encoder.status());
+
+  PW_LOG_INFO("Decoding %u bytes per iteration",
+              static_cast<unsigned>(encoder.size()));
+  return ConstByteSpan(encoder);
+}
+
+// Measures how long it takes to decode a chunk with StreamDecoder::Read()
+// through a stream::MemoryReader, as RPC did before Decoder::Read().
+void DecodeWithStreamDecoder(perf_test::State& state, size_t data_size) {
+  const ConstByteSpan proto = EncodeChunk(data_size);
+
+  Chunk chunk{};
+  while (state.KeepRunning()) {
+    stream::MemoryReader reader(proto);
+    ChunkStreamDecoder(reader).Read(chunk).IgnoreError();
+  }
+  PW_CHECK_UINT_EQ(chunk.offset, 123456);
+  PW_CHECK_UINT_EQ(chunk.data.size(), data_size);
+}
+
+// Measures how long it takes to decode a chunk with the table-driven
+// Decoder::Read().
+void DecodeWithDecoder(perf_test::State& state, size_t data_size) {
+  const ConstByteSpan proto = EncodeChunk(data_size);
+
+  Chunk chunk{};
+  while (state.KeepRunning()) {
+    Decoder(proto).Read(chunk, kChunkFields).IgnoreError();
+  }
+  PW_CHECK_UINT_EQ(chunk.offset, 123456);
+  PW_CHECK_UINT_EQ(chunk.data.size(), data_size);
+}
+
+PW_PERF_TEST(StreamDecoderControlChunk, DecodeWithStreamDecoder, 0);
+PW_PERF_TEST(StreamDecoderDataChunk, DecodeWithStreamDecoder, 64);
+
+PW_PERF_TEST(DecoderControlChunk, DecodeWithDecoder, 0);
+PW_PERF_TEST(DecoderDataChunk, DecodeWithDecoder, 64);
+
+}  // namespace
+}  // namespace pw::protobuf
@@ -14,9 +14,20 @@
 
 #include "pw_protobuf/decoder.h"
 
+#include <array>
+#include <cstddef>
 #include <cstring>
+#include <optional>
 
+#include "pw_bytes/array.h"
+#include "pw_containers/vector.h"
+#include "pw_preprocessor/compiler.h"
 #include "pw_preprocessor/util.h"
+#include "pw_protobuf/encoder.h"
+#include "pw_protobuf/internal/codegen.h"
+#include "pw_protobuf/stream_decoder.h"
+#include "pw_stream/memory_stream.h"
+#include "pw_string/string.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::protobuf {
@@ -364,5 +375,392 @@ TEST(CallbackDecoder, Decode_StopsOnNonOkStatus) {
   EXPECT_EQ(handler.field_three, 1111);
 }
 
+// Message structs and field tables in the form that pw_protobuf generates for
+// the following messages, which are decoded by Decoder::Read().
+//
+//   message Nested {
+//     uint32 id = 1;
+//     string name = 2;
+//   }
+//
+//   message TestMessage {
+//     uint32 uint32 = 1;
+//     sint32 sint32 = 2;
+//     int64 int64 = 3;
+//     bool boolean = 4;
+//     fixed32 fixed32 = 5;
+//     double fixed64 = 6;
+//     optional uint32 optional_uint32 = 7;
+//     string str = 8;
+//     bytes bytes = 9;
+//     bytes fixed_bytes = 10;         // max_size: 4, fixed_size: true
+//     repeated uint32 repeated = 11;  // max_count: 4
+//     repeated int32 packed = 12;     // max_count: 3, fixed_count: true
+//     repeated fixed32 fixed = 13;    // max_count: 4
+//     Nested nested = 14;
+//     repeated string callback = 15;
+//   }
+struct Nested {
+  uint32_t id;
+  InlineString<8> name;
+};
+
+struct TestMessage {
+  uint32_t uint32;
+  int32_t sint32;
+  int64_t int64;
+  bool boolean;
+  uint32_t fixed32;
+  double fixed64;
+  std::optional<uint32_t> optional_uint32;
+  InlineString<8> str;
+  Vector<std::byte, 4> bytes;
+  std::array<std::byte, 4> fixed_bytes;
+  Vector<uint32_t, 4> repeated;
+  std::array<int32_t, 3> packed;
+  Vector<uint32_t, 4> fixed;
+  Nested nested;
+  Callback<StreamEncoder, StreamDecoder> callback;
+};
+
+using internal::MessageField;
+using internal::VarintType;
+
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Winvalid-offsetof");
+
+// Each entry is the field number, wire type, element size, varint type,
+// is_string, is_fixed_size, is_repeated, is_optional, use_callback, and the
+// member's offset, size and nested message table.
+// clang-format off
+constexpr MessageField kNestedFieldsArray[] = {
+  {1, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, false, false,
+   offsetof(Nested, id), sizeof(Nested::id), nullptr},
+  {2, WireType::kDelimited, sizeof(char), VarintType::kNormal,
+   true, false, false, false, false,
+   offsetof(Nested, name), sizeof(Nested::name), nullptr},
+};
+constexpr span<const MessageField> kNestedFields = kNestedFieldsArray;
+
+constexpr MessageField kTestFieldsArray[] = {
+  {1, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, false, false,
+   offsetof(TestMessage, uint32), sizeof(TestMessage::uint32), nullptr},
+  {2, WireType::kVarint, sizeof(int32_t), VarintType::kZigZag,
+   false, false, false, false, false,
+   offsetof(TestMessage, sint32), sizeof(TestMessage::sint32), nullptr},
+  {3, WireType::kVarint, sizeof(int64_t), VarintType::kNormal,
+   false, false, false, false, false,
+   offsetof(TestMessage, int64), sizeof(TestMessage::int64), nullptr},
+  {4, WireType::kVarint, sizeof(bool), VarintType::kUnsigned,
+   false, false, false, false, false,
+   offsetof(TestMessage, boolean), sizeof(TestMessage::boolean), nullptr},
+  {5, WireType::kFixed32, sizeof(uint32_t), VarintType::kNormal,
+   false, false, false, false, false,
+   offsetof(TestMessage, fixed32), sizeof(TestMessage::fixed32), nullptr},
+  {6, WireType::kFixed64, sizeof(double), VarintType::kNormal,
+   false, false, false, false, false,
+   offsetof(TestMessage, fixed64), sizeof(TestMessage::fixed64), nullptr},
+  {7, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, false, true, false,
+   offsetof(TestMessage, optional_uint32),
+   sizeof(TestMessage::optional_uint32), nullptr},
+  {8, WireType::kDelimited, sizeof(char), VarintType::kNormal,
+   true, false, false, false, false,
+   offsetof(TestMessage, str), sizeof(TestMessage::str), nullptr},
+  {9, WireType::kDelimited, sizeof(std::byte), VarintType::kNormal,
+   false, false, false, false, false,
+   offsetof(TestMessage, bytes), sizeof(TestMessage::bytes), nullptr},
+  {10, WireType::kDelimited, sizeof(std::byte), VarintType::kNormal,
+   false, true, false, false, false,
+   offsetof(TestMessage, fixed_bytes),
+   sizeof(TestMessage::fixed_bytes), nullptr},
+  {11, WireType::kVarint, sizeof(uint32_t), VarintType::kUnsigned,
+   false, false, true, false, false,
+   offsetof(TestMessage, repeated), sizeof(TestMessage::repeated), nullptr},
+  {12, WireType::kVarint, sizeof(int32_t), VarintType::kNormal,
+   false, true, true, false, false,
+   offsetof(TestMessage, packed), sizeof(TestMessage::packed), nullptr},
+  {13, WireType::kFixed32, sizeof(uint32_t), VarintType::kNormal,
+   false, false, true, false, false,
+   offsetof(TestMessage, fixed), sizeof(TestMessage::fixed), nullptr},
+  {14, WireType::kDelimited, 0, VarintType::kNormal,
+   false, false, false, false, false,
+   offsetof(TestMessage, nested), sizeof(TestMessage::nested), &kNestedFields},
+  {15, WireType::kDelimited, 0, VarintType::kNormal,
+   false, false, false, false, true,
+   offsetof(TestMessage, callback), sizeof(TestMessage::callback), nullptr},
+};
+constexpr span<const MessageField> kTestFields = kTestFieldsArray;
+// clang-format on
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
+// Exposes StreamDecoder::Read() to compare with Decoder::Read(), as the
+// generated StreamDecoder::Read(Message&) does.
+class TestStreamDecoder : public StreamDecoder {
+ public:
+  constexpr TestStreamDecoder(stream::Reader& reader)
+      : StreamDecoder(reader) {}
+
+  Status Read(TestMessage& message) {
+    return StreamDecoder::Read(as_writable_bytes(span(&message, 1)),
+                               kTestFields);
+  }
+};
+
+// Encodes a TestMessage with every field set. The repeated field is encoded
+// both unpacked and packed.
+ConstByteSpan EncodeTest(ByteSpan buffer) {
+  MemoryEncoder encoder(buffer);
+  EXPECT_EQ(OkStatus(), encoder.WriteUint32(1, 42));
+  EXPECT_EQ(OkStatus(), encoder.WriteSint32(2, -1000));
+  EXPECT_EQ(OkStatus(), encoder.WriteInt64(3, -1));
+  EXPECT_EQ(OkStatus(), encoder.WriteBool(4, true));
+  EXPECT_EQ(OkStatus(), encoder.WriteFixed32(5, 0xdeadbeef));
+  EXPECT_EQ(OkStatus(), encoder.WriteDouble(6, 3.25));
+  EXPECT_EQ(OkStatus(), encoder.WriteUint32(7, 7));
+  EXPECT_EQ(OkStatus(), encoder.WriteString(8, "hello"));
+  EXPECT_EQ(OkStatus(),
+            encoder.WriteBytes(9, bytes::Array<0x01, 0x02, 0x03>()));
+  EXPECT_EQ(OkStatus(),
+            encoder.WriteBytes(10, bytes::Array<0xa0, 0xa1, 0xa2, 0xa3>()));
+  EXPECT_EQ(OkStatus(), encoder.WriteUint32(11, 1));
+  constexpr uint32_t kPackedRepeated[] = {2, 300};
+  EXPECT_EQ(OkStatus(), encoder.WritePackedUint32(11, kPackedRepeated));
+  constexpr int32_t kPacked[] = {7, 0, 150};
+  EXPECT_EQ(OkStatus(), encoder.WritePackedInt32(12, kPacked));
+  EXPECT_EQ(OkStatus(), encoder.WriteFixed32(13, 5));
+  constexpr uint32_t kFixed[] = {6, 7};
+  EXPECT_EQ(OkStatus(), encoder.WritePackedFixed32(13, kFixed));
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(14);
+    EXPECT_EQ(OkStatus(), nested.WriteUint32(1, 99));
+    EXPECT_EQ(OkStatus(), nested.WriteString(2, "nested"));
+  }
+  EXPECT_EQ(OkStatus(), encoder.WriteString(15, "one"));
+  EXPECT_EQ(OkStatus(), encoder.WriteString(15, "two"));
+  EXPECT_EQ(OkStatus(), encoder.status());
+  return ConstByteSpan(encoder);
+}
+
+// Sets a callback that counts the repeated strings in field 15.
+void CountCallbackStrings(TestMessage& message, int& count) {
+  message.callback.SetDecoder([&count](StreamDecoder& decoder) {
+    EXPECT_EQ(decoder.FieldNumber().value(), 15u);
+    std::array<char, 8> str{};
+    EXPECT_EQ(OkStatus(), decoder.ReadString(str).status());
+    count += 1;
+    return OkStatus();
+  });
+}
+
+void ExpectTestFields(const TestMessage& message) {
+  EXPECT_EQ(message.uint32, 42u);
+  EXPECT_EQ(message.sint32, -1000);
+  EXPECT_EQ(message.int64, -1);
+  EXPECT_TRUE(message.boolean);
+  EXPECT_EQ(message.fixed32, 0xdeadbeef);
+  EXPECT_EQ(message.fixed64, 3.25);
+  ASSERT_TRUE(message.optional_uint32.has_value());
+  EXPECT_EQ(message.optional_uint32.value(), 7u);
+  EXPECT_EQ(message.str, "hello");
+  ASSERT_EQ(message.bytes.size(), 3u);
+  EXPECT_EQ(message.bytes[2], std::byte{0x03});
+  EXPECT_EQ(message.fixed_bytes[0], std::byte{0xa0});
+  EXPECT_EQ(message.fixed_bytes[3], std::byte{0xa3});
+  ASSERT_EQ(message.repeated.size(), 3u);
+  EXPECT_EQ(message.repeated[0], 1u);
+  EXPECT_EQ(message.repeated[1], 2u);
+  EXPECT_EQ(message.repeated[2], 300u);
+  EXPECT_EQ(message.packed[0], 7);
+  EXPECT_EQ(message.packed[1], 0);
+  EXPECT_EQ(message.packed[2], 150);
+  ASSERT_EQ(message.fixed.size(), 3u);
+  EXPECT_EQ(message.fixed[0], 5u);
+  EXPECT_EQ(message.fixed[2], 7u);
+  EXPECT_EQ(message.nested.id, 99u);
+  EXPECT_EQ(message.nested.name, "nested");
+}
+
+TEST(Decoder, ReadMessage) {
+  std::array<std::byte, 128> buffer;
+  const ConstByteSpan proto = EncodeTest(buffer);
+
+  TestMessage message{};
+  int callback_count = 0;
+  CountCallbackStrings(message, callback_count);
+
+  Decoder decoder(proto);
+  EXPECT_EQ(OkStatus(), decoder.Read(message, kTestFields));
+  ExpectTestFields(message);
+  EXPECT_EQ(callback_count, 2);
+
+  // The whole message was consumed.
+  EXPECT_EQ(decoder.Next(), Status::OutOfRange());
+}
+
+TEST(Decoder, ReadMessage_MatchesStreamDecoder) {
+  std::array<std::byte, 128> buffer;
+  const ConstByteSpan proto = EncodeTest(buffer);
+
+  TestMessage stream_message{};
+  int stream_callback_count = 0;
+  CountCallbackStrings(stream_message, stream_callback_count);
+  stream::MemoryReader reader(proto);
+  EXPECT_EQ(OkStatus(), TestStreamDecoder(reader).Read(stream_message));
+
+  TestMessage message{};
+  int callback_count = 0;
+  CountCallbackStrings(message, callback_count);
+  EXPECT_EQ(OkStatus(), Decoder(proto).Read(message, kTestFields));
+
+  ExpectTestFields(stream_message);
+  EXPECT_EQ(message.uint32, stream_message.uint32);
+  EXPECT_EQ(message.sint32, stream_message.sint32);
+  EXPECT_EQ(message.int64, stream_message.int64);
+  EXPECT_EQ(message.optional_uint32, stream_message.optional_uint32);
+  EXPECT_EQ(message.str, stream_message.str);
+  EXPECT_EQ(message.repeated.size(), stream_message.repeated.size());
+  EXPECT_EQ(message.packed, stream_message.packed);
+  EXPECT_EQ(message.fixed.size(), stream_message.fixed.size());
+  EXPECT_EQ(message.nested.name, stream_message.nested.name);
+  EXPECT_EQ(callback_count, stream_callback_count);
+}
+
+TEST(Decoder, ReadMessage_FromCurrentField) {
+  std::array<std::byte, 128> buffer;
+  const ConstByteSpan proto = EncodeTest(buffer);
+
+  TestMessage message{};
+  int callback_count = 0;
+  CountCallbackStrings(message, callback_count);
+
+  // Fields before the cursor are not decoded into the struct.
+  Decoder decoder(proto);
+  EXPECT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(OkStatus(), decoder.Next());
+  EXPECT_EQ(OkStatus(), decoder.Read(message, kTestFields));
+  EXPECT_EQ(message.uint32, 0u);
+  EXPECT_EQ(message.sint32, -1000);
+  EXPECT_EQ(message.nested.id, 99u);
+}
+
+TEST(Decoder, ReadMessage_SkipsUnknownFields) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // uint32 = 42
+    0x08, 0x2a,
+    // unknown varint field 16 = 1
+    0x80, 0x01, 0x01,
+    // unknown delimited field 17 = "ab"
+    0x8a, 0x01, 0x02, 'a', 'b',
+    // unknown fixed32 field 18
+    0x95, 0x01, 0x01, 0x02, 0x03, 0x04,
+    // str = "hi"
+    0x42, 0x02, 'h', 'i',
+  };
+  // clang-format on
+
+  TestMessage message{};
+  EXPECT_EQ(OkStatus(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+  EXPECT_EQ(message.uint32, 42u);
+  EXPECT_EQ(message.str, "hi");
+}
+
+TEST(Decoder, ReadMessage_Truncated) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // str = "hello", but only 3 bytes are present.
+    0x42, 0x05, 'h', 'e', 'l',
+  };
+  // clang-format on
+
+  TestMessage message{};
+  EXPECT_EQ(Status::DataLoss(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+}
+
+TEST(Decoder, ReadMessage_LengthTooLarge) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // str with a length of 2^32 + 4, which wraps to 4 if narrowed to 32 bits.
+    0x42, 0x84, 0x80, 0x80, 0x80, 0x10, 'a', 'b', 'c', 'd',
+  };
+  // clang-format on
+
+  TestMessage message{};
+  EXPECT_EQ(Status::DataLoss(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+  EXPECT_EQ(message.str, "");
+}
+
+TEST(Decoder, ReadMessage_BadVarint) {
+  // uint32 with an unterminated varint.
+  constexpr uint8_t encoded_proto[] = {0x08, 0xff, 0xff};
+
+  TestMessage message{};
+  EXPECT_EQ(Status::DataLoss(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+}
+
+TEST(Decoder, ReadMessage_StringTooLarge) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // str = "too large" doesn't fit in InlineString<8>.
+    0x42, 0x09, 't', 'o', 'o', ' ', 'l', 'a', 'r', 'g', 'e',
+  };
+  // clang-format on
+
+  TestMessage message{};
+  EXPECT_EQ(Status::ResourceExhausted(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+}
+
+TEST(Decoder, ReadMessage_RepeatedFull) {
+  // clang-format off
+  constexpr uint8_t encoded_proto[] = {
+    // repeated = [1, 2, 3, 4, 5] doesn't fit in Vector<uint32_t, 4>.
+    0x5a, 0x05, 0x01, 0x02, 0x03, 0x04, 0x05,
+  };
+  // clang-format on
+
+  TestMessage message{};
+  EXPECT_EQ(Status::ResourceExhausted(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+  EXPECT_EQ(message.repeated.size(), 4u);
+}
+
+TEST(Decoder, ReadMessage_WrongWireType) {
+  // uint32 encoded as a fixed32.
+  constexpr uint8_t encoded_proto[] = {0x0d, 0x01, 0x00, 0x00, 0x00};
+
+  TestMessage message{};
+  EXPECT_EQ(Status::NotFound(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+}
+
+TEST(Decoder, ReadMessage_VarintOutOfRange) {
+  // uint32 = 2^32
+  constexpr uint8_t encoded_proto[] = {0x08, 0x80, 0x80, 0x80, 0x80, 0x10};
+
+  TestMessage message{};
+  EXPECT_EQ(Status::FailedPrecondition(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+}
+
+TEST(Decoder, ReadMessage_CallbackError) {
+  // callback = "one"
+  constexpr uint8_t encoded_proto[] = {0x7a, 0x03, 'o', 'n', 'e'};
+
+  TestMessage message{};
+  message.callback.SetDecoder(
+      [](StreamDecoder&) { return Status::Unimplemented(); });
+  EXPECT_EQ(Status::Unimplemented(),
+            Decoder(as_bytes(span(encoded_proto))).Read(message, kTestFields));
+}
+
 }  // namespace
 }  // namespace pw::protobuf
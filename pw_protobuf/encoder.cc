@@ -37,8 +37,23 @@ namespace pw::protobuf {
 
 using internal::VarintType;
 
+namespace {
+
+// Encodes a varint that is padded with continuation bytes to exactly fill the
+// output buffer. The value must fit in the buffer.
+void EncodePaddedVarint(uint64_t value, ByteSpan out) {
+  for (size_t i = 0; i + 1 < out.size(); ++i) {
+    out[i] = static_cast<std::byte>((value & 0x7f) | 0x80);
+    value >>= 7;
+  }
+  out.back() = static_cast<std::byte>(value);
+}
+
+}  // namespace
+
 StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number,
-                                              bool write_when_empty) {
+                                              bool write_when_empty,
+                                              size_t max_size_bytes) {
   PW_CHECK(!nested_encoder_open());
 
   nested_field_number_ = field_number;
@@ -60,10 +75,18 @@ StreamEncoder StreamEncoder::GetNestedEncoder(uint32_t field_number,
   max_size = std::min(varint::MaxValueInBytes(config::kMaxVarintSize),
                       static_cast<uint64_t>(max_size));
 
+  // Only reserve as much space for the length prefix as the expected size of
+  // the nested message needs, so it can be closed without moving it. The
+  // capacity of the nested buffer is the same regardless, which leaves room to
+  // move the message forward if it turns out to be larger than expected.
+  const size_t prefix_size =
+      key_size + std::min(varint::EncodedSize(max_size_bytes),
+                          config::kMaxVarintSize);
+
   ByteSpan nested_buffer;
   if (max_size > 0) {
     nested_buffer = ByteSpan(
-        memory_writer_.data() + reserved_size + memory_writer_.bytes_written(),
+        memory_writer_.data() + prefix_size + memory_writer_.bytes_written(),
         max_size);
   } else {
     nested_buffer = ByteSpan();
@@ -119,10 +142,51 @@ void StreamEncoder::CloseNestedMessage(StreamEncoder& nested) {
     return;
   }
 
+  // Nested encoders of an encoder that writes to its own buffer encode
+  // directly into that buffer, so the message only needs a prefix.
+  if (&writer_ == &memory_writer_) {
+    status_ = CloseNestedMessageInPlace(temp_field_number, nested);
+    return;
+  }
+
   status_ = WriteLengthDelimitedField(temp_field_number,
                                       nested.memory_writer_.WrittenData());
 }
 
+Status StreamEncoder::CloseNestedMessageInPlace(uint32_t field_number,
+                                                const StreamEncoder& nested) {
+  const size_t nested_size = nested.memory_writer_.bytes_written();
+  PW_TRY(UpdateStatusForWrite(field_number, WireType::kDelimited, nested_size));
+
+  std::byte* const prefix =
+      memory_writer_.data() + memory_writer_.bytes_written();
+  const size_t reserved_size =
+      static_cast<size_t>(nested.memory_writer_.data() - prefix);
+
+  const uint64_t key = FieldKey(field_number, WireType::kDelimited);
+  const size_t key_size = varint::EncodedSize(key);
+  size_t length_size = varint::EncodedSize(nested_size);
+  if (nested_length_encoding_ == NestedLengthEncoding::kFixedWidth &&
+      key_size + length_size < reserved_size) {
+    length_size = reserved_size - key_size;
+  }
+
+  // If the prefix is a different size than the space reserved for it, move
+  // the message into place. It is never moved forward past the end of this
+  // encoder's buffer, since UpdateStatusForWrite() checked that it fits.
+  const size_t prefix_size = key_size + length_size;
+  if (prefix_size != reserved_size && nested_size != 0u) {
+    std::memmove(
+        prefix + prefix_size, nested.memory_writer_.data(), nested_size);
+  }
+
+  varint::Encode(key, ByteSpan(prefix, key_size));
+  EncodePaddedVarint(nested_size, ByteSpan(prefix + key_size, length_size));
+  return memory_writer_.Seek(
+      static_cast<ptrdiff_t>(prefix_size + nested_size),
+      stream::Stream::Whence::kCurrent);
+}
+
 Status StreamEncoder::WriteVarintField(uint32_t field_number, uint64_t value) {
   PW_TRY(UpdateStatusForWrite(
       field_number, WireType::kVarint, varint::EncodedSize(value)));
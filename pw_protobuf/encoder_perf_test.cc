@@ -12,12 +12,19 @@
 // License for the specific language governing permissions and limitations under
 // the License.
 
+#include <array>
+#include <cstddef>
+
+#include "pw_assert/check.h"
 #include "pw_bytes/span.h"
+#include "pw_log/log.h"
 #include "pw_perf_test/perf_test.h"
 #include "pw_protobuf/encoder.h"
+#include "pw_protobuf/serialized_size.h"
 #include "pw_span/span.h"
 #include "pw_status/status.h"
 #include "pw_stream/memory_stream.h"
+#include "pw_varint/varint.h"
 
 namespace pw::protobuf {
 namespace {
@@ -34,5 +41,131 @@ void BasicIntegerPerformance(pw::perf_test::State& state, uint32_t value) {
 PW_PERF_TEST(SmallIntegerEncoding, BasicIntegerPerformance, 1);
 PW_PERF_TEST(LargerIntegerEncoding, BasicIntegerPerformance, 4000000000);
 
+// The nested message workloads encode a chain of messages, each of which holds
+// a bytes field and the next message in the chain:
+//
+//   message Nested {
+//     bytes payload = 1;
+//     Nested next = 2;
+//   }
+constexpr uint32_t kPayloadField = 1;
+constexpr uint32_t kNextField = 2;
+constexpr size_t kPayloadSize = 24;
+constexpr size_t kMaxDepth = 8;
+
+// How the nested encoders are created.
+enum class Mode {
+  kDefault,     // GetNestedEncoder()
+  kSizeHint,    // GetNestedEncoderWithSizeHint() with the exact size
+  kFixedWidth,  // NestedLengthEncoding::kFixedWidth
+};
+
+// Returns the encoded size of a chain of `depth` Nested messages.
+constexpr size_t NestedSize(size_t depth) {
+  size_t size = SizeOfFieldBytes(kPayloadField, kPayloadSize);
+  if (depth > 1) {
+    size += SizeOfDelimitedField(kNextField, NestedSize(depth - 1));
+  }
+  return size;
+}
+
+// The sizes of chains of each depth, used as the size hints.
+constexpr auto kNestedSizes = [] {
+  std::array<size_t, kMaxDepth + 1> sizes{};
+  for (size_t depth = 1; depth <= kMaxDepth; ++depth) {
+    sizes[depth] = NestedSize(depth);
+  }
+  return sizes;
+}();
+
+constexpr std::array<std::byte, kPayloadSize> kPayload = {};
+
+std::array<std::byte, SizeOfDelimitedField(kNextField, NestedSize(kMaxDepth)) +
+                          kMaxDepth * config::kMaxVarintSize>
+    encode_buffer;
+std::array<std::byte, MaxScratchBufferSize(NestedSize(kMaxDepth), kMaxDepth)>
+    scratch_buffer;
+
+void EncodeNested(StreamEncoder& encoder, size_t depth, Mode mode) {
+  StreamEncoder nested = mode == Mode::kSizeHint
+                             ? encoder.GetNestedEncoderWithSizeHint(
+                                   kNextField, kNestedSizes[depth])
+                             : encoder.GetNestedEncoder(kNextField);
+  nested.WriteBytes(kPayloadField, kPayload).IgnoreError();
+  if (depth > 1) {
+    EncodeNested(nested, depth - 1, mode);
+  }
+}
+
+// Logs how many bytes of nested messages are moved into place for each encode,
+// which is every nested message whose length prefix does not exactly fill the
+// space reserved for it, and how much scratch space a StreamEncoder needs. A
+// StreamEncoder also copies the outermost message to its stream.
+void LogNestedStats(size_t depth, Mode mode) {
+  size_t bytes_moved = 0;
+  size_t messages_moved = 0;
+  for (size_t i = 1; i <= depth; ++i) {
+    const size_t length_size = varint::EncodedSize(NestedSize(i));
+    const size_t reserved_size = mode == Mode::kSizeHint
+                                     ? length_size
+                                     : size_t{config::kMaxVarintSize};
+    if (mode != Mode::kFixedWidth && length_size != reserved_size) {
+      bytes_moved += NestedSize(i);
+      messages_moved += 1;
+    }
+  }
+  PW_LOG_INFO(
+      "Encoding %u nested messages: %u bytes moved in %u copies; StreamEncoder "
+      "scratch buffer is %u bytes",
+      static_cast<unsigned>(depth),
+      static_cast<unsigned>(bytes_moved),
+      static_cast<unsigned>(messages_moved),
+      static_cast<unsigned>(MaxScratchBufferSize(NestedSize(depth), depth)));
+}
+
+// Measures how long it takes to encode nested messages with a MemoryEncoder,
+// which encodes them directly into the output buffer.
+void NestedToMemory(perf_test::State& state, size_t depth, Mode mode) {
+  LogNestedStats(depth, mode);
+
+  while (state.KeepRunning()) {
+    MemoryEncoder encoder(encode_buffer);
+    if (mode == Mode::kFixedWidth) {
+      encoder.SetNestedLengthEncoding(
+          StreamEncoder::NestedLengthEncoding::kFixedWidth);
+    }
+    EncodeNested(encoder, depth, mode);
+    PW_CHECK_OK(encoder.status());
+  }
+}
+
+// Measures how long it takes to encode nested messages with a StreamEncoder,
+// which encodes them in its scratch buffer before writing them to the stream.
+void NestedToStream(perf_test::State& state, size_t depth, Mode mode) {
+  LogNestedStats(depth, mode);
+
+  while (state.KeepRunning()) {
+    stream::MemoryWriter writer(encode_buffer);
+    StreamEncoder encoder(writer, scratch_buffer);
+    if (mode == Mode::kFixedWidth) {
+      encoder.SetNestedLengthEncoding(
+          StreamEncoder::NestedLengthEncoding::kFixedWidth);
+    }
+    EncodeNested(encoder, depth, mode);
+    PW_CHECK_OK(encoder.status());
+  }
+}
+
+PW_PERF_TEST(Nested2ToMemory, NestedToMemory, 2, Mode::kDefault);
+PW_PERF_TEST(Nested8ToMemory, NestedToMemory, 8, Mode::kDefault);
+PW_PERF_TEST(Nested2ToMemorySizeHint, NestedToMemory, 2, Mode::kSizeHint);
+PW_PERF_TEST(Nested8ToMemorySizeHint, NestedToMemory, 8, Mode::kSizeHint);
+PW_PERF_TEST(Nested2ToMemoryFixedWidth, NestedToMemory, 2, Mode::kFixedWidth);
+PW_PERF_TEST(Nested8ToMemoryFixedWidth, NestedToMemory, 8, Mode::kFixedWidth);
+
+PW_PERF_TEST(Nested8ToStream, NestedToStream, 8, Mode::kDefault);
+PW_PERF_TEST(Nested8ToStreamSizeHint, NestedToStream, 8, Mode::kSizeHint);
+PW_PERF_TEST(Nested8ToStreamFixedWidth, NestedToStream, 8, Mode::kFixedWidth);
+
 }  // namespace
 }  // namespace pw::protobuf
@@ -14,6 +14,7 @@
 
 #include "pw_protobuf/encoder.h"
 
+#include "pw_bytes/array.h"
 #include "pw_bytes/span.h"
 #include "pw_span/span.h"
 #include "pw_stream/memory_stream.h"
@@ -540,5 +541,170 @@ TEST(StreamEncoder, ManualCloseEncoderWrites) {
   ASSERT_EQ(parent.size(), kExpectedSize);
 }
 
+// Writes a NestedProto with two pairs to the encoder, returning its status.
+Status WriteNestedProto(StreamEncoder& encoder,
+                        size_t max_size_hint = 0,
+                        size_t max_pair_size_hint = 0) {
+  StreamEncoder nested_proto =
+      max_size_hint == 0u ? encoder.GetNestedEncoder(kTestProtoNestedField)
+                          : encoder.GetNestedEncoderWithSizeHint(
+                                kTestProtoNestedField, max_size_hint);
+  auto get_pair_encoder = [&nested_proto, max_pair_size_hint]() {
+    return max_pair_size_hint == 0u
+               ? nested_proto.GetNestedEncoder(kNestedProtoPairField)
+               : nested_proto.GetNestedEncoderWithSizeHint(
+                     kNestedProtoPairField, max_pair_size_hint);
+  };
+
+  nested_proto.WriteString(kNestedProtoHelloField, "world").IgnoreError();
+  {
+    StreamEncoder pair = get_pair_encoder();
+    pair.WriteString(kDoubleNestedProtoKeyField, "version").IgnoreError();
+    pair.WriteString(kDoubleNestedProtoValueField, "2.9.1").IgnoreError();
+  }
+  nested_proto.WriteUint32(kNestedProtoIdField, 999).IgnoreError();
+  {
+    StreamEncoder pair = get_pair_encoder();
+    pair.WriteString(kDoubleNestedProtoKeyField, "device").IgnoreError();
+    pair.WriteString(kDoubleNestedProtoValueField, "left-soc").IgnoreError();
+  }
+  nested_proto.CloseEncoder();
+  return encoder.status();
+}
+
+// clang-format off
+constexpr uint8_t kEncodedNestedProto[] = {
+  // nested header (key, size)
+  0x32, 0x30,
+  // nested.hello
+  0x0a, 0x05, 'w', 'o', 'r', 'l', 'd',
+  // nested.pair[0] header (key, size)
+  0x1a, 0x10,
+  // nested.pair[0].key
+  0x0a, 0x07, 'v', 'e', 'r', 's', 'i', 'o', 'n',
+  // nested.pair[0].value
+  0x12, 0x05, '2', '.', '9', '.', '1',
+  // nested.id
+  0x10, 0xe7, 0x07,
+  // nested.pair[1] header (key, size)
+  0x1a, 0x12,
+  // nested.pair[1].key
+  0x0a, 0x06, 'd', 'e', 'v', 'i', 'c', 'e',
+  // nested.pair[1].value
+  0x12, 0x08, 'l', 'e', 'f', 't', '-', 's', 'o', 'c',
+};
+// clang-format on
+
+TEST(MemoryEncoder, Nested) {
+  std::byte encode_buffer[64];
+  MemoryEncoder encoder(encode_buffer);
+
+  ASSERT_EQ(WriteNestedProto(encoder), OkStatus());
+  ASSERT_EQ(encoder.size(), sizeof(kEncodedNestedProto));
+  EXPECT_EQ(std::memcmp(encoder.data(),
+                        kEncodedNestedProto,
+                        sizeof(kEncodedNestedProto)),
+            0);
+}
+
+TEST(MemoryEncoder, NestedWithSizeHint) {
+  std::byte encode_buffer[64];
+  MemoryEncoder encoder(encode_buffer);
+
+  ASSERT_EQ(WriteNestedProto(encoder, 0x30, 0x12), OkStatus());
+  ASSERT_EQ(encoder.size(), sizeof(kEncodedNestedProto));
+  EXPECT_EQ(std::memcmp(encoder.data(),
+                        kEncodedNestedProto,
+                        sizeof(kEncodedNestedProto)),
+            0);
+}
+
+TEST(MemoryEncoder, NestedLargerThanSizeHint) {
+  constexpr auto kValue = bytes::Initialized<200>(0xaa);
+  // The field, plus room for the nested encoder's reserved length prefix.
+  std::byte encode_buffer[1 + 2 + 1 + 2 + kValue.size() + 2];
+  MemoryEncoder encoder(encode_buffer);
+
+  {
+    StreamEncoder nested =
+        encoder.GetNestedEncoderWithSizeHint(kTestProtoNestedField, 16);
+    ASSERT_EQ(nested.WriteBytes(kNestedProtoHelloField, kValue), OkStatus());
+  }
+  ASSERT_EQ(encoder.status(), OkStatus());
+  ASSERT_EQ(encoder.size(), 1 + 2 + 1 + 2 + kValue.size());
+
+  // The length of the nested message needs two bytes rather than one.
+  constexpr uint8_t kHeader[] = {0x32, 0xcb, 0x01, 0x0a, 0xc8, 0x01};
+  EXPECT_EQ(std::memcmp(encoder.data(), kHeader, sizeof(kHeader)), 0);
+  EXPECT_EQ(std::memcmp(encoder.data() + sizeof(kHeader),
+                        kValue.data(),
+                        kValue.size()),
+            0);
+}
+
+TEST(MemoryEncoder, NestedFixedWidthLength) {
+  std::byte encode_buffer[64];
+  MemoryEncoder encoder(encode_buffer);
+  encoder.SetNestedLengthEncoding(
+      StreamEncoder::NestedLengthEncoding::kFixedWidth);
+
+  {
+    StreamEncoder nested = encoder.GetNestedEncoder(kTestProtoNestedField);
+    ASSERT_EQ(nested.WriteUint32(kNestedProtoIdField, 999), OkStatus());
+    {
+      // Nested encoders inherit the length encoding.
+      StreamEncoder pair = nested.GetNestedEncoder(kNestedProtoPairField);
+      ASSERT_EQ(pair.WriteString(kDoubleNestedProtoKeyField, "k"), OkStatus());
+    }
+  }
+  ASSERT_EQ(encoder.status(), OkStatus());
+
+  // Lengths are padded to the maximum varint size, so the nested messages are
+  // encoded where they were written.
+  ASSERT_EQ(encoder.size(), 1 + config::kMaxVarintSize + 3 + 1 +
+                                config::kMaxVarintSize + 3);
+  ConstByteSpan result(encoder);
+  uint64_t length = 0;
+  ASSERT_EQ(result[0], std::byte{0x32});
+  ASSERT_EQ(varint::Decode(result.subspan(1), &length),
+            config::kMaxVarintSize);
+  EXPECT_EQ(length, 3 + 1 + config::kMaxVarintSize + 3);
+  ASSERT_EQ(result[1 + config::kMaxVarintSize + 3], std::byte{0x1a});
+  ASSERT_EQ(varint::Decode(result.subspan(1 + config::kMaxVarintSize + 3 + 1),
+                           &length),
+            config::kMaxVarintSize);
+  EXPECT_EQ(length, 3u);
+}
+
+TEST(MemoryEncoder, NestedFixedWidthLengthWithSizeHint) {
+  std::byte encode_buffer[64];
+  MemoryEncoder encoder(encode_buffer);
+  encoder.SetNestedLengthEncoding(
+      StreamEncoder::NestedLengthEncoding::kFixedWidth);
+
+  // Lengths are padded to the size that the hints require, which matches the
+  // minimal encoding for this message.
+  ASSERT_EQ(WriteNestedProto(encoder, 0x30, 0x12), OkStatus());
+  ASSERT_EQ(encoder.size(), sizeof(kEncodedNestedProto));
+  EXPECT_EQ(std::memcmp(encoder.data(),
+                        kEncodedNestedProto,
+                        sizeof(kEncodedNestedProto)),
+            0);
+}
+
+TEST(StreamEncoder, NestedWithSizeHint) {
+  std::byte encode_buffer[MaxScratchBufferSize(0x30, 2)];
+  std::byte dest_buffer[64];
+  MemoryWriter writer(dest_buffer);
+  StreamEncoder encoder(writer, encode_buffer);
+
+  ASSERT_EQ(WriteNestedProto(encoder, 0x30, 0x12), OkStatus());
+  ASSERT_EQ(writer.bytes_written(), sizeof(kEncodedNestedProto));
+  EXPECT_EQ(std::memcmp(writer.data(),
+                        kEncodedNestedProto,
+                        sizeof(kEncodedNestedProto)),
+            0);
+}
+
 }  // namespace
 }  // namespace pw::protobuf
@@ -16,6 +16,7 @@
 #include <string_view>
 
 #include "pw_bytes/span.h"
+#include "pw_protobuf/internal/codegen.h"
 #include "pw_protobuf/wire_format.h"
 #include "pw_result/result.h"
 #include "pw_span/span.h"
@@ -146,10 +147,38 @@ class Decoder {
     previous_field_consumed_ = true;
   }
 
+  // Decodes the fields from the current cursor to the end of the proto into a
+  // code generated message struct, using the message's generated field table.
+  //
+  //   pwpb::Config::Message config{};
+  //   Decoder decoder(proto);
+  //   PW_TRY(decoder.Read(config, pwpb::Config::kMessageFields));
+  //
+  // Values are decoded directly from memory, which is much faster than
+  // StreamDecoder::Read(). Unknown fields are skipped. Callbacks for fields
+  // that use them are given a StreamDecoder positioned at the field, which
+  // can only read that field.
+  //
+  // Returns:
+  //                   OK: The message was decoded.
+  //            DATA_LOSS: Invalid protobuf data.
+  //            NOT_FOUND: A field's wire type does not match the struct.
+  //   RESOURCE_EXHAUSTED: A repeated, string, or bytes field doesn't fit.
+  //  FAILED_PRECONDITION: A varint doesn't fit in its struct member.
+  //
+  // Errors returned by callbacks are returned as is.
+  template <typename Message>
+  Status Read(Message& message, span<const internal::MessageField> table) {
+    return ReadMessage(as_writable_bytes(span(&message, 1)), table);
+  }
+
  private:
   // Allow only the FindRaw function to access the raw bytes of the field.
   friend Result<ConstByteSpan> FindRaw(ConstByteSpan, uint32_t);
 
+  // MessageView indexes fields by their position in the message.
+  friend class MessageView;
+
   // Returns the raw field value. The decoder MUST be at a valid field.
   ConstByteSpan RawFieldBytes() { return GetFieldSize().ValueBytes(proto_); }
 
@@ -200,6 +229,9 @@ class Decoder {
 
   Status ReadDelimited(span<const std::byte>* out);
 
+  Status ReadMessage(span<std::byte> message,
+                     span<const internal::MessageField> table);
+
   span<const std::byte> proto_;
   bool previous_field_consumed_;
 };
@@ -17,6 +17,7 @@
 #include <array>
 #include <cstddef>
 #include <cstring>
+#include <limits>
 #include <string_view>
 
 #include "pw_assert/assert.h"
@@ -120,6 +121,7 @@ class StreamEncoder {
   constexpr StreamEncoder(stream::Writer& writer, ByteSpan scratch_buffer)
       : status_(OkStatus()),
         write_when_empty_(true),
+        nested_length_encoding_(NestedLengthEncoding::kMinimal),
         parent_(nullptr),
         nested_field_number_(0),
         memory_writer_(scratch_buffer),
@@ -163,6 +165,34 @@ class StreamEncoder {
 
   enum class EmptyEncoderBehavior { kWriteFieldNumber, kWriteNothing };
 
+  // How the length prefix of a nested message is encoded.
+  //
+  // Nested messages are encoded directly after space reserved for their key
+  // and length prefix. When an encoder writes to memory (a MemoryEncoder, or
+  // any nested encoder), the prefix is written to the reserved space when the
+  // nested encoder is closed, and the nested message is only moved if the
+  // prefix does not exactly fill that space.
+  enum class NestedLengthEncoding {
+    // Lengths are encoded in as few bytes as possible. The output is the
+    // canonical encoding, but nested messages are moved into place when their
+    // length prefix is smaller than the space reserved for it.
+    kMinimal,
+
+    // Lengths are padded with continuation bytes to fill the reserved space,
+    // so nested messages are never moved. Padded varints are valid protobuf,
+    // but the output is slightly larger and is not canonical.
+    kFixedWidth,
+  };
+
+  // Sets how this encoder and the nested encoders it creates encode the
+  // lengths of nested messages. The default is NestedLengthEncoding::kMinimal.
+  //
+  // Precondition: Encoder has no active child encoder.
+  void SetNestedLengthEncoding(NestedLengthEncoding encoding) {
+    PW_ASSERT(!nested_encoder_open());
+    nested_length_encoding_ = encoding;
+  }
+
   // Creates a nested encoder with the provided field number. Once this is
   // called, the parent encoder is locked and not available for use until the
   // nested encoder is finalized (either explicitly or through destruction).
@@ -179,6 +209,31 @@ class StreamEncoder {
         empty_encoder_behavior == EmptyEncoderBehavior::kWriteFieldNumber);
   }
 
+  // Creates a nested encoder for a submessage that encodes to at most
+  // `max_size_bytes`. Only enough space for the length of a message of that
+  // size is reserved ahead of it, so a nested message that is encoded to
+  // memory does not have to be moved when its encoder is closed. Generated
+  // encoders pass the submessage's kMaxEncodedSizeBytes.
+  //
+  // The size is only a hint. A larger nested message is still encoded
+  // correctly, but is moved into place when its encoder is closed.
+  //
+  // Precondition: Encoder has no active child encoder.
+  //
+  // Postcondition: Until the nested child encoder has been destroyed, this
+  //     encoder cannot be used.
+  StreamEncoder GetNestedEncoderWithSizeHint(
+      uint32_t field_number,
+      size_t max_size_bytes,
+      EmptyEncoderBehavior empty_encoder_behavior =
+          EmptyEncoderBehavior::kWriteFieldNumber) {
+    return GetNestedEncoder(
+        field_number,
+        /*write_when_empty=*/empty_encoder_behavior ==
+            EmptyEncoderBehavior::kWriteFieldNumber,
+        max_size_bytes);
+  }
+
   // Returns the current encoder's status.
   //
   // Precondition: Encoder has no active child encoder.
@@ -627,6 +682,7 @@ class StreamEncoder {
   constexpr StreamEncoder(StreamEncoder&& other)
       : status_(other.status_),
         write_when_empty_(true),
+        nested_length_encoding_(other.nested_length_encoding_),
         parent_(other.parent_),
         nested_field_number_(other.nested_field_number_),
         memory_writer_(std::move(other.memory_writer_)),
@@ -651,16 +707,30 @@ class StreamEncoder {
   // Protected method to create a nested encoder, specifying whether the field
   // should be written when no fields were added to the nested encoder. Exposed
   // using an enum in the public API, for better readability.
-  StreamEncoder GetNestedEncoder(uint32_t field_number, bool write_when_empty);
+  //
+  // `max_size_bytes` is the expected maximum size of the nested message, as in
+  // GetNestedEncoderWithSizeHint(), or kUnknownNestedSize if it is not known.
+  StreamEncoder GetNestedEncoder(uint32_t field_number,
+                                 bool write_when_empty,
+                                 size_t max_size_bytes = kUnknownNestedSize);
 
  private:
   friend class MemoryEncoder;
 
+  // Passed to GetNestedEncoder() when the size of the nested message is not
+  // known, in which case the maximum length prefix is reserved.
+  static constexpr size_t kUnknownNestedSize =
+      std::numeric_limits<size_t>::max();
+
   constexpr StreamEncoder(StreamEncoder& parent,
                           ByteSpan scratch_buffer,
                           bool write_when_empty = true)
       : status_(OkStatus()),
         write_when_empty_(write_when_empty),
+        // A MemoryEncoder is its own parent, and starts with the default.
+        nested_length_encoding_(&parent == this
+                                    ? NestedLengthEncoding::kMinimal
+                                    : parent.nested_length_encoding_),
         parent_(&parent),
         nested_field_number_(0),
         memory_writer_(scratch_buffer),
@@ -681,6 +751,12 @@ class StreamEncoder {
   // encoder destructor.
   void CloseNestedMessage(StreamEncoder& nested);
 
+  // Finishes a nested message that was encoded to this encoder's own buffer,
+  // after the space reserved for its key and length prefix, by writing the
+  // prefix in front of it.
+  Status CloseNestedMessageInPlace(uint32_t field_number,
+                                   const StreamEncoder& nested);
+
   // Implementation for encoding all varint field types.
   Status WriteVarintField(uint32_t field_number, uint64_t value);
 
@@ -798,6 +874,10 @@ class StreamEncoder {
   // were written, the field is not written.
   bool write_when_empty_;
 
+  // How the lengths of nested messages are encoded. Inherited by nested
+  // encoders.
+  NestedLengthEncoding nested_length_encoding_;
+
   // If this is a nested encoder, this points to the encoder that created it.
   // For user-created MemoryEncoders, parent_ points to this object as an
   // optimization for the MemoryEncoder and nested encoders to use the same
@@ -0,0 +1,174 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+/// @file pw_protobuf/view.h
+///
+/// A view is a read-only accessor for a serialized message in memory. Code
+/// generated ``View`` classes derive from ``MessageView`` and provide a typed
+/// ``Get*()`` accessor for each field. Nothing is decoded up front, and
+/// ``string``, ``bytes``, and submessage fields are returned as spans into the
+/// original buffer, so a view needs neither the RAM for a decoded message
+/// struct nor a copy of its data.
+///
+/// Each accessor scans the message for its field. To read many fields of a
+/// large message, a view can first build an index of where each of its fields
+/// is in one pass, after which accessors go straight to the field.
+///
+/// @code{.cpp}
+///
+///   pw::Status PrintCustomer(pw::ConstByteSpan serialized_customer) {
+///     Customer::View customer(serialized_customer);
+///
+///     Customer::View::Index index;
+///     PW_TRY(customer.BuildIndex(index));
+///
+///     PW_TRY_ASSIGN(std::string_view name, customer.GetName());
+///     PW_TRY_ASSIGN(Address::View address, customer.GetAddress());
+///     PW_TRY_ASSIGN(uint32_t zip, address.GetZipCode());
+///
+///     PW_LOG_INFO("%.*s lives in %u",
+///                 static_cast<int>(name.size()), name.data(),
+///                 static_cast<unsigned>(zip));
+///     return pw::OkStatus();
+///   }
+///
+/// @endcode
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+
+#include "pw_bytes/span.h"
+#include "pw_protobuf/decoder.h"
+#include "pw_result/result.h"
+#include "pw_span/span.h"
+#include "pw_status/status.h"
+#include "pw_status/try.h"
+
+namespace pw::protobuf {
+
+/// The offsets of a message's fields, as recorded by
+/// ``MessageView::BuildIndex()``. Code generated views define this as
+/// ``View::Index``.
+template <size_t kFieldCount>
+using MessageViewIndex = std::array<uint32_t, kFieldCount>;
+
+/// Base class for code generated message views.
+///
+/// Like the ``Find*()`` functions, accessors read the first occurrence of a
+/// field. A view does not own its buffer or index, which must outlive it.
+class MessageView {
+ public:
+  constexpr MessageView() = default;
+
+  constexpr explicit MessageView(ConstByteSpan message) : message_(message) {}
+
+  constexpr MessageView(const MessageView&) = default;
+  constexpr MessageView& operator=(const MessageView&) = default;
+
+  /// Returns the serialized message this view reads from.
+  constexpr ConstByteSpan data() const { return message_; }
+
+  /// Returns true if ``BuildIndex()`` has been called successfully.
+  constexpr bool indexed() const { return index_ != nullptr; }
+
+ protected:
+  /// Scans the message once, storing the offset of the first occurrence of
+  /// each field in ``field_numbers`` to the corresponding entry of ``index``.
+  /// Afterwards, accessors look fields up in the index instead of scanning.
+  ///
+  /// @returns @rst
+  ///
+  /// .. pw-status-codes::
+  ///
+  ///    OK: The index was built.
+  ///
+  ///    DATA_LOSS: The message is not a valid protobuf. The view is not
+  ///    indexed.
+  ///
+  /// @endrst
+  Status BuildIndex(span<const uint32_t> field_numbers, span<uint32_t> index);
+
+  /// Reads the first occurrence of a field with a ``Decoder::Read*()``
+  /// function. ``slot`` is the field's position in the view's list of fields.
+  template <typename T, auto kReadFn>
+  Result<T> Read(uint32_t field_number, size_t slot) const {
+    T output;
+    Decoder decoder(message_);
+    PW_TRY(FindField(decoder, field_number, slot));
+    PW_TRY((decoder.*kReadFn)(&output));
+    return output;
+  }
+
+  /// Reads the first occurrence of a submessage field into a view.
+  template <typename View>
+  Result<View> ReadMessage(uint32_t field_number, size_t slot) const {
+    PW_TRY_ASSIGN(const ConstByteSpan message,
+                  (Read<ConstByteSpan, &Decoder::ReadBytes>(field_number,
+                                                            slot)));
+    return View(message);
+  }
+
+  /// Calls ``function`` with each occurrence of a repeated ``string``,
+  /// ``bytes``, or submessage field, converted to a ``T``, in order. Stops
+  /// early and returns the first error ``function`` returns.
+  template <typename T, typename Function>
+  Status ForEachDelimited(uint32_t field_number,
+                          size_t slot,
+                          Function&& function) const {
+    Decoder decoder(message_);
+    Status status = FindField(decoder, field_number, slot);
+    if (status.IsNotFound()) {
+      return OkStatus();
+    }
+    PW_TRY(status);
+
+    do {
+      if (decoder.FieldNumber() != field_number) {
+        continue;
+      }
+      ConstByteSpan value;
+      PW_TRY(decoder.ReadBytes(&value));
+      PW_TRY(function(FromDelimited<T>(value)));
+    } while ((status = decoder.Next()).ok());
+
+    return status.IsOutOfRange() ? OkStatus() : status;
+  }
+
+ private:
+  static constexpr uint32_t kNotPresent = std::numeric_limits<uint32_t>::max();
+
+  // Positions the decoder at the first occurrence of a field, using the index
+  // if there is one. Returns NOT_FOUND if the field is not present.
+  Status FindField(Decoder& decoder, uint32_t field_number, size_t slot) const;
+
+  template <typename T>
+  static T FromDelimited(ConstByteSpan value) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+      return std::string_view(reinterpret_cast<const char*>(value.data()),
+                              value.size());
+    } else {
+      return T(value);
+    }
+  }
+
+  ConstByteSpan message_;
+  const uint32_t* index_ = nullptr;
+};
+
+}  // namespace pw::protobuf
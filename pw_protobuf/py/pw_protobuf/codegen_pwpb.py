@@ -575,10 +575,16 @@ class SubMessageEncoderMethod(ProtoMethod):
         return []
 
     def body(self) -> list[str]:
-        line = 'return {}::StreamEncoder({}::GetNestedEncoder({}));'.format(
-            self._relative_type_namespace(), self._base_class, self.field_cast()
-        )
-        return [line]
+        # Pass the submessage's maximum size so that no more space than needed
+        # is reserved for its length, which lets it be encoded in place.
+        namespace = self._relative_type_namespace()
+        return [
+            f'return {namespace}::StreamEncoder(',
+            f'    {self._base_class}::GetNestedEncoder(',
+            f'        {self.field_cast()},',
+            '        /*write_when_empty=*/true,',
+            f'        {namespace}::kMaxEncodedSizeBytes));',
+        ]
 
     # Submessage methods are not defined within the class itself because the
     # submessage class may not yet have been defined.
@@ -2322,6 +2328,168 @@ class EnumProperty(MessageProperty):
         return 'SizeOfFieldEnum'
 
 
+class ViewMethod(ProtoMethod):
+    """Base class for a message view accessor.
+
+    View accessors have the following format (for the proto field foo):
+
+        Result<{ctype}> GetFoo() const {
+          return Read<{ctype}, &Decoder::Read{type}>(
+              static_cast<uint32_t>(Fields::kFoo), {slot});
+        }
+
+    where slot is the field's position in the message, which indexes the
+    view's optional field offset index.
+    """
+
+    def __init__(
+        self,
+        field: ProtoMessageField,
+        scope: ProtoNode,
+        root: ProtoNode,
+        base_class: str,
+        result_type: str = '',
+        decoder_fn: str = '',
+    ):
+        super().__init__(field, scope, root, base_class)
+        self._result_type_name = result_type
+        self._decoder_fn_name = decoder_fn
+
+    def name(self) -> str:
+        return 'Get{}'.format(self._field.name())
+
+    def should_appear(self) -> bool:
+        # Like the Find functions, views read single fields.
+        return not self._field.is_repeated()
+
+    def return_type(self, from_root: bool = False) -> str:
+        return '::pw::Result<{}>'.format(self._result_type(from_root))
+
+    def _result_type(self, from_root: bool = False) -> str:
+        return self._result_type_name
+
+    def params(self) -> list[tuple[str, str]]:
+        return []
+
+    def template(self) -> str | None:  # pylint: disable=no-self-use
+        """Template parameters of the method, if any."""
+        return None
+
+    def slot(self) -> int:
+        """The field's position in the message's View::kFieldNumbers."""
+        numbers = [field.number() for field in self._scope.fields()]
+        return numbers.index(self._field.number())
+
+    def body(self) -> list[str]:
+        return [
+            f'return Read<{self._result_type()}, '
+            f'&{PROTOBUF_NAMESPACE}::Decoder::{self._decoder_fn_name}>(',
+            f'    {self.field_cast()}, {self.slot()});',
+        ]
+
+    def in_class_definition(self) -> bool:
+        return True
+
+
+class EnumViewMethod(ViewMethod):
+    """View accessor which reads a proto enum value."""
+
+    def _result_type(self, from_root: bool = False) -> str:
+        return self._relative_type_namespace(from_root)
+
+    def body(self) -> list[str]:
+        return [
+            '::pw::Result<uint32_t> result = '
+            f'Read<uint32_t, &{PROTOBUF_NAMESPACE}::Decoder::ReadUint32>(',
+            f'    {self.field_cast()}, {self.slot()});',
+            'if (!result.ok()) {',
+            '  return result.status();',
+            '}',
+            f'return static_cast<{self._result_type()}>(result.value());',
+        ]
+
+
+class SubMessageViewMethod(ViewMethod):
+    """View accessor which returns a view of a proto submessage."""
+
+    def _result_type(self, from_root: bool = False) -> str:
+        return '{}::View'.format(self._relative_type_namespace(from_root))
+
+    def body(self) -> list[str]:
+        return [
+            f'return ReadMessage<{self._result_type()}>('
+            f'{self.field_cast()}, {self.slot()});',
+        ]
+
+    # The submessage's view class may not yet have been defined.
+    def in_class_definition(self) -> bool:
+        return False
+
+
+class RepeatedViewMethod(ViewMethod):
+    """View accessor which iterates over a repeated string, bytes, or
+    submessage field.
+
+    The function is called with each element in order, and returns a
+    pw::Status; iteration stops at the first error.
+    """
+
+    def name(self) -> str:
+        return 'ForEach{}'.format(self._field.name())
+
+    def should_appear(self) -> bool:
+        return self._field.is_repeated()
+
+    def return_type(self, from_root: bool = False) -> str:
+        return '::pw::Status'
+
+    def params(self) -> list[tuple[str, str]]:
+        return [('Function&&', 'function')]
+
+    def template(self) -> str | None:
+        return 'template <typename Function>'
+
+    def body(self) -> list[str]:
+        return [
+            f'return ForEachDelimited<{self._result_type()}>(',
+            f'    {self.field_cast()}, {self.slot()}, '
+            'std::forward<Function>(function));',
+        ]
+
+
+class RepeatedSubMessageViewMethod(RepeatedViewMethod):
+    """View accessor which iterates over a repeated submessage field."""
+
+    def _result_type(self, from_root: bool = False) -> str:
+        return '{}::View'.format(self._relative_type_namespace(from_root))
+
+    # The submessage's view class may not yet have been defined.
+    def in_class_definition(self) -> bool:
+        return False
+
+
+def _view_methods(result_type: str, decoder_fn: str) -> list:
+    """Returns view method factories for a field type read by decoder_fn."""
+
+    def view_method(field, scope, root, base_class):
+        return ViewMethod(
+            field, scope, root, base_class, result_type, decoder_fn
+        )
+
+    return [view_method]
+
+
+def _delimited_view_methods(result_type: str, decoder_fn: str) -> list:
+    """Returns view method factories for a string or bytes field type."""
+
+    def repeated_view_method(field, scope, root, base_class):
+        return RepeatedViewMethod(
+            field, scope, root, base_class, result_type, decoder_fn
+        )
+
+    return _view_methods(result_type, decoder_fn) + [repeated_view_method]
+
+
 # Mapping of protobuf field types to their method definitions.
 PROTO_FIELD_WRITE_METHODS: dict[int, list] = {
     descriptor_pb2.FieldDescriptorProto.TYPE_DOUBLE: [
@@ -2554,6 +2722,59 @@ PROTO_FIELD_FIND_METHODS: dict[int, list] = {
     ],
 }
 
+PROTO_FIELD_VIEW_METHODS: dict[int, list] = {
+    descriptor_pb2.FieldDescriptorProto.TYPE_DOUBLE: _view_methods(
+        'double', 'ReadDouble'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FLOAT: _view_methods(
+        'float', 'ReadFloat'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT32: _view_methods(
+        'int32_t', 'ReadInt32'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT32: _view_methods(
+        'int32_t', 'ReadSint32'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED32: _view_methods(
+        'int32_t', 'ReadSfixed32'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_INT64: _view_methods(
+        'int64_t', 'ReadInt64'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SINT64: _view_methods(
+        'int64_t', 'ReadSint64'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_SFIXED64: _view_methods(
+        'int64_t', 'ReadSfixed64'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT32: _view_methods(
+        'uint32_t', 'ReadUint32'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED32: _view_methods(
+        'uint32_t', 'ReadFixed32'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_UINT64: _view_methods(
+        'uint64_t', 'ReadUint64'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_FIXED64: _view_methods(
+        'uint64_t', 'ReadFixed64'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_BOOL: _view_methods(
+        'bool', 'ReadBool'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_BYTES: _delimited_view_methods(
+        '::pw::ConstByteSpan', 'ReadBytes'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_STRING: _delimited_view_methods(
+        'std::string_view', 'ReadString'
+    ),
+    descriptor_pb2.FieldDescriptorProto.TYPE_MESSAGE: [
+        SubMessageViewMethod,
+        RepeatedSubMessageViewMethod,
+    ],
+    descriptor_pb2.FieldDescriptorProto.TYPE_ENUM: [EnumViewMethod],
+}
+
 PROTO_FIELD_PROPERTIES: dict[int, Type[MessageProperty]] = {
     descriptor_pb2.FieldDescriptorProto.TYPE_DOUBLE: DoubleProperty,
     descriptor_pb2.FieldDescriptorProto.TYPE_FLOAT: FloatProperty,
@@ -2750,6 +2971,105 @@ def define_not_in_class_methods(
             output.write_line('}')
 
 
+def generate_view_for_message(
+    message: ProtoMessage, root: ProtoNode, output: OutputFile
+) -> None:
+    """Creates a C++ class to read a serialized protobuf message in place."""
+    assert message.type() == ProtoNode.Type.MESSAGE
+
+    base_class = f'{PROTOBUF_NAMESPACE}::MessageView'
+    field_numbers = [str(field.number()) for field in message.fields()]
+
+    output.write_line(
+        f'class {message.cpp_namespace(root=root)}::View '
+        f': public {base_class} {{'
+    )
+    output.write_line(' public:')
+
+    with output.indent():
+        output.write_line(
+            f'using Index = {PROTOBUF_NAMESPACE}::'
+            f'MessageViewIndex<{len(field_numbers)}>;'
+        )
+        output.write_line()
+        output.write_line(f'using {base_class}::MessageView;')
+
+        output.write_line()
+        output.write_line('::pw::Status BuildIndex(Index& index) {')
+        with output.indent():
+            output.write_line(
+                f'return {base_class}::BuildIndex(kFieldNumbers, index);'
+            )
+        output.write_line('}')
+
+        for field in message.fields():
+            for method_class in PROTO_FIELD_VIEW_METHODS[field.type()]:
+                method = method_class(field, message, root, base_class)
+                if not method.should_appear():
+                    continue
+
+                output.write_line()
+                template = method.template()
+                if template is not None:
+                    output.write_line(template)
+                method_signature = (
+                    f'{method.return_type()} '
+                    f'{method.name()}({method.param_string()}) const'
+                )
+
+                if not method.in_class_definition():
+                    # Method will be defined outside of the class at the end of
+                    # the file.
+                    output.write_line(f'{method_signature};')
+                    continue
+
+                output.write_line(f'{method_signature} {{')
+                with output.indent():
+                    for line in method.body():
+                        output.write_line(line)
+                output.write_line('}')
+
+    output.write_line()
+    output.write_line(' private:')
+    with output.indent():
+        output.write_line(
+            f'static constexpr std::array<uint32_t, {len(field_numbers)}> '
+            f'kFieldNumbers = {{{", ".join(field_numbers)}}};'
+        )
+
+    output.write_line('};')
+
+
+def define_not_in_class_view_methods(
+    message: ProtoMessage, root: ProtoNode, output: OutputFile
+) -> None:
+    """Defines methods for a message view that were previously declared."""
+    assert message.type() == ProtoNode.Type.MESSAGE
+
+    base_class = f'{PROTOBUF_NAMESPACE}::MessageView'
+
+    for field in message.fields():
+        for method_class in PROTO_FIELD_VIEW_METHODS[field.type()]:
+            method = method_class(field, message, root, base_class)
+            if not method.should_appear() or method.in_class_definition():
+                continue
+
+            output.write_line()
+            template = method.template()
+            if template is not None:
+                output.write_line(template)
+            class_name = f'{message.cpp_namespace(root=root)}::View'
+            method_signature = (
+                f'inline {method.return_type(from_root=True)} '
+                f'{class_name}::{method.name()}({method.param_string()}) const'
+            )
+            output.write_line(f'{method_signature} {{')
+            with output.indent():
+                for line in method.body():
+                    output.write_line(line)
+            output.write_line('}')
+
+
 def _common_value_prefix(proto_enum: ProtoEnum) -> str:
     """Calculate the common prefix of all enum values.
 
@@ -2900,6 +3220,7 @@ def forward_declare(
     # Declare the message's decoder classes.
     output.write_line()
     output.write_line('class StreamDecoder;')
+    output.write_line('class View;')
 
     # Declare the message's enums.
     for child in message.children():
@@ -3188,7 +3509,8 @@ def generate_code_for_package(
     output.write_line('#include <cstddef>')
     output.write_line('#include <cstdint>')
     output.write_line('#include <optional>')
-    output.write_line('#include <string_view>\n')
+    output.write_line('#include <string_view>')
+    output.write_line('#include <utility>\n')
     output.write_line('#include "pw_assert/assert.h"')
     output.write_line('#include "pw_containers/vector.h"')
     output.write_line('#include "pw_preprocessor/compiler.h"')
@@ -3197,6 +3519,7 @@ def generate_code_for_package(
     output.write_line('#include "pw_protobuf/internal/codegen.h"')
     output.write_line('#include "pw_protobuf/serialized_size.h"')
     output.write_line('#include "pw_protobuf/stream_decoder.h"')
+    output.write_line('#include "pw_protobuf/view.h"')
     output.write_line('#include "pw_result/result.h"')
     output.write_line('#include "pw_span/span.h"')
     output.write_line('#include "pw_status/status.h"')
@@ -3256,6 +3579,8 @@ def generate_code_for_package(
         generate_class_for_message(
             message, package, output, ClassType.STREAMING_DECODER
         )
+        output.write_line()
+        generate_view_for_message(message, package, output)
         messages.append(message)
 
     # Run a second pass through the messages, this time defining all of the
@@ -3270,6 +3595,7 @@ def generate_code_for_package(
         define_not_in_class_methods(
             message, package, output, ClassType.STREAMING_DECODER
         )
+        define_not_in_class_view_methods(message, package, output)
 
     if package.cpp_namespace():
         output.write_line(f'\n}}  // namespace {package.cpp_namespace()}')
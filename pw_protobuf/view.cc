@@ -0,0 +1,77 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "pw_protobuf/view.h"
+
+#include <algorithm>
+
+#include "pw_assert/check.h"
+#include "pw_protobuf/find.h"
+
+namespace pw::protobuf {
+
+Status MessageView::BuildIndex(span<const uint32_t> field_numbers,
+                               span<uint32_t> index) {
+  PW_CHECK_UINT_EQ(field_numbers.size(), index.size());
+  std::fill(index.begin(), index.end(), kNotPresent);
+  index_ = nullptr;
+
+  Decoder decoder(message_);
+  Status status;
+  size_t slot = 0;
+
+  while ((status = decoder.Next()).ok()) {
+    const uint32_t field_number = decoder.FieldNumber();
+
+    // Fields are usually encoded in the order they're declared in, so start
+    // looking from the previous field's slot.
+    size_t i = 0;
+    for (; i < field_numbers.size(); ++i) {
+      if (field_numbers[slot] == field_number) {
+        break;
+      }
+      slot = slot + 1 < field_numbers.size() ? slot + 1 : 0;
+    }
+    if (i == field_numbers.size()) {
+      continue;  // Unknown fields are skipped.
+    }
+
+    if (index[slot] == kNotPresent) {
+      index[slot] =
+          static_cast<uint32_t>(decoder.proto_.data() - message_.data());
+    }
+  }
+
+  if (!status.IsOutOfRange()) {
+    return Status::DataLoss();
+  }
+  index_ = index.data();
+  return OkStatus();
+}
+
+Status MessageView::FindField(Decoder& decoder,
+                              uint32_t field_number,
+                              size_t slot) const {
+  if (index_ == nullptr) {
+    return internal::AdvanceToField(decoder, field_number);
+  }
+
+  if (index_[slot] == kNotPresent) {
+    return Status::NotFound();
+  }
+  decoder.Reset(message_.subspan(index_[slot]));
+  return decoder.Next();
+}
+
+}  // namespace pw::protobuf
@@ -16,6 +16,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <limits>
 
 #include "pw_assert/assert.h"
 #include "pw_assert/check.h"
@@ -32,6 +33,7 @@ using iterator = PrefixedEntryRingBufferMulti::iterator;
 
 void PrefixedEntryRingBufferMulti::Clear() {
   write_idx_ = 0;
+  reserved_ = false;
   for (Reader& reader : readers_) {
     reader.read_idx_ = 0;
     reader.entry_count_ = 0;
@@ -89,6 +91,7 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
   if (buffer_ == nullptr) {
     return Status::FailedPrecondition();
   }
+  reserved_ = false;
 
   // Prepare a single buffer that can hold both the user preamble and entry
   // length.
@@ -103,6 +106,102 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
                                span(preamble_buf).subspan(user_preamble_bytes));
   size_t total_write_bytes =
       user_preamble_bytes + length_bytes + data.size_bytes();
+  PW_TRY(MakeSpace(total_write_bytes, pop_front_if_needed));
+
+  // Write the new entry into the ring buffer.
+  RawWrite(span(preamble_buf, user_preamble_bytes + length_bytes));
+  RawWrite(data);
+
+  // Update all readers of the new count.
+  for (Reader& reader : readers_) {
+    reader.entry_count_++;
+  }
+  return OkStatus();
+}
+
+Result<PrefixedEntryRingBufferMulti::Reservation>
+PrefixedEntryRingBufferMulti::InternalReserve(size_t max_size,
+                                              uint32_t user_preamble_data,
+                                              bool pop_front_if_needed) {
+  if (buffer_ == nullptr) {
+    return Status::FailedPrecondition();
+  }
+  reserved_ = false;
+  if (max_size > std::numeric_limits<uint32_t>::max()) {
+    return Status::OutOfRange();
+  }
+
+  // The length varint is written by Commit(), so leave room for the longest
+  // one that may be needed.
+  const size_t user_preamble_bytes =
+      user_preamble_ ? varint::EncodedSize(user_preamble_data) : 0;
+  const size_t length_bytes = varint::EncodedSize(max_size);
+  PW_TRY(MakeSpace(user_preamble_bytes + length_bytes + max_size,
+                   pop_front_if_needed));
+
+  reserved_ = true;
+  reserved_user_preamble_ = user_preamble_data;
+  reserved_length_bytes_ = length_bytes;
+  reserved_data_bytes_ = max_size;
+
+  size_t data_idx =
+      IncrementIndex(write_idx_, user_preamble_bytes + length_bytes);
+  if (data_idx == buffer_bytes_) {
+    data_idx = 0;
+  }
+  const size_t bytes_until_wrap = buffer_bytes_ - data_idx;
+  if (max_size <= bytes_until_wrap) {
+    return Reservation{
+        .first = span(buffer_ + data_idx, max_size),
+        .second = span<byte>(),
+    };
+  }
+  return Reservation{
+      .first = span(buffer_ + data_idx, bytes_until_wrap),
+      .second = span(buffer_, max_size - bytes_until_wrap),
+  };
+}
+
+Status PrefixedEntryRingBufferMulti::Commit(size_t size) {
+  if (!reserved_) {
+    return Status::FailedPrecondition();
+  }
+  if (size > reserved_data_bytes_) {
+    return Status::InvalidArgument();
+  }
+  reserved_ = false;
+
+  byte preamble_buf[varint::kMaxVarint32SizeBytes * 2];
+  size_t user_preamble_bytes = 0;
+  if (user_preamble_) {
+    user_preamble_bytes =
+        varint::Encode<uint32_t>(reserved_user_preamble_, preamble_buf);
+  }
+
+  // The data was written after a length varint sized for the reservation.
+  // Encode the actual length with continuation bytes to fill that space, which
+  // decodes to the same value.
+  size_t length = size;
+  for (size_t i = 0; i + 1 < reserved_length_bytes_; ++i) {
+    preamble_buf[user_preamble_bytes + i] =
+        static_cast<byte>((length & 0x7f) | 0x80);
+    length >>= 7;
+  }
+  preamble_buf[user_preamble_bytes + reserved_length_bytes_ - 1] =
+      static_cast<byte>(length);
+
+  RawWrite(span(preamble_buf, user_preamble_bytes + reserved_length_bytes_));
+  write_idx_ = IncrementIndex(write_idx_, size);
+
+  // Update all readers of the new count.
+  for (Reader& reader : readers_) {
+    reader.entry_count_++;
+  }
+  return OkStatus();
+}
+
+Status PrefixedEntryRingBufferMulti::MakeSpace(size_t total_write_bytes,
+                                               bool pop_front_if_needed) {
   if (buffer_bytes_ < total_write_bytes) {
     return Status::OutOfRange();
   }
@@ -117,15 +216,6 @@ Status PrefixedEntryRingBufferMulti::InternalPushBack(
     // TryPushBack() case: don't evict items.
     return Status::ResourceExhausted();
   }
-
-  // Write the new entry into the ring buffer.
-  RawWrite(span(preamble_buf, user_preamble_bytes + length_bytes));
-  RawWrite(data);
-
-  // Update all readers of the new count.
-  for (Reader& reader : readers_) {
-    reader.entry_count_++;
-  }
   return OkStatus();
 }
 
@@ -263,6 +353,8 @@ Status PrefixedEntryRingBufferMulti::InternalDering(Reader& dering_reader) {
     return Status::FailedPrecondition();
   }
 
+  reserved_ = false;
+
   auto buffer_span = span(buffer_, buffer_bytes_);
   std::rotate(
       buffer_span.begin(),
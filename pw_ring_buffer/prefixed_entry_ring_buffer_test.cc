@@ -534,6 +534,163 @@ TEST(PrefixedEntryRingBuffer, Iterator) {
   EXPECT_EQ(validated_entries, entry_count);
 }
 
+// Writes bytes counting up from start into a reservation.
+void FillReservation(const PrefixedEntryRingBufferMulti::Reservation& space,
+                     size_t size,
+                     uint8_t start) {
+  PW_CHECK_UINT_LE(size, space.size());
+  for (size_t i = 0; i < size; ++i) {
+    const byte value = static_cast<byte>(start + i);
+    if (i < space.first.size()) {
+      space.first[i] = value;
+    } else {
+      space.second[i - space.first.size()] = value;
+    }
+  }
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_NoBuffer) {
+  PrefixedEntryRingBuffer ring;
+  EXPECT_EQ(ring.Reserve(4).status(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.TryReserve(4).status(), Status::FailedPrecondition());
+  EXPECT_EQ(ring.Commit(0), Status::FailedPrecondition());
+}
+
+TEST(PrefixedEntryRingBuffer, Reserve_TooLarge) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[16];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  EXPECT_EQ(ring.Reserve(16).status(), Status::OutOfRange());
+  EXPECT_EQ(ring.Reserve(15).status(), OkStatus());
+}
+
+void ReserveCommitTest(bool user_data) {
+  PrefixedEntryRingBuffer ring(user_data);
+  byte test_buffer[single_entry_test_buffer_size];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  constexpr size_t kReserveSize = 12;
+  bool wrapped = false;
+  for (size_t i = 0; i < kSingleEntryCycles; ++i) {
+    const size_t size = i % kReserveSize;
+    const uint32_t preamble = static_cast<uint32_t>(i);
+
+    Result<PrefixedEntryRingBufferMulti::Reservation> space =
+        ring.Reserve(kReserveSize, preamble);
+    ASSERT_EQ(space.status(), OkStatus());
+    ASSERT_EQ(space->size(), kReserveSize);
+    wrapped = wrapped || !space->second.empty();
+
+    FillReservation(*space, size, static_cast<uint8_t>(i));
+    ASSERT_EQ(ring.Commit(size), OkStatus());
+
+    // Reserve and commit are interleaved with reads, so there is at most one
+    // other entry in the buffer.
+    if (ring.EntryCount() > 1) {
+      ASSERT_EQ(ring.PopFront(), OkStatus());
+    }
+    ASSERT_EQ(ring.EntryCount(), 1u);
+    ASSERT_EQ(ring.FrontEntryDataSizeBytes(), size);
+
+    byte entry_buffer[kReserveSize];
+    uint32_t user_preamble = 0;
+    size_t bytes_read = 0;
+    ASSERT_EQ(
+        ring.PeekFrontWithPreamble(entry_buffer, user_preamble, bytes_read),
+        OkStatus());
+    ASSERT_EQ(bytes_read, size);
+    if (user_data) {
+      EXPECT_EQ(user_preamble, preamble);
+    }
+    for (size_t j = 0; j < size; ++j) {
+      EXPECT_EQ(entry_buffer[j], static_cast<byte>(i + j));
+    }
+  }
+  EXPECT_TRUE(wrapped);
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveCommitNoUserData) {
+  ReserveCommitTest(false);
+}
+
+TEST(PrefixedEntryRingBuffer, ReserveCommitYesUserData) {
+  ReserveCommitTest(true);
+}
+
+TEST(PrefixedEntryRingBuffer, Commit_LengthPaddedToReservation) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[256];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // A 200 byte entry needs a two byte length varint, which a 3 byte entry
+  // keeps.
+  Result<PrefixedEntryRingBufferMulti::Reservation> space = ring.Reserve(200);
+  ASSERT_EQ(space.status(), OkStatus());
+  FillReservation(*space, 3, 7);
+  ASSERT_EQ(ring.Commit(3), OkStatus());
+
+  EXPECT_EQ(ring.FrontEntryDataSizeBytes(), 3u);
+  EXPECT_EQ(ring.FrontEntryTotalSizeBytes(), 5u);
+  EXPECT_EQ(ring.TotalUsedBytes(), 5u);
+
+  byte entry_buffer[3];
+  size_t bytes_read = 0;
+  ASSERT_EQ(ring.PeekFront(entry_buffer, &bytes_read), OkStatus());
+  EXPECT_EQ(bytes_read, 3u);
+  EXPECT_EQ(entry_buffer[0], byte(7));
+  EXPECT_EQ(entry_buffer[2], byte(9));
+  EXPECT_EQ(ring.CheckForCorruption(), OkStatus());
+}
+
+TEST(PrefixedEntryRingBuffer, Commit_LargerThanReservation) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[kTestBufferSize];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  ASSERT_EQ(ring.Reserve(4).status(), OkStatus());
+  EXPECT_EQ(ring.Commit(5), Status::InvalidArgument());
+  EXPECT_EQ(ring.Commit(4), OkStatus());
+  EXPECT_EQ(ring.Commit(4), Status::FailedPrecondition());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+}
+
+TEST(PrefixedEntryRingBuffer, PushBack_InvalidatesReservation) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[kTestBufferSize];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  ASSERT_EQ(ring.Reserve(4).status(), OkStatus());
+  ASSERT_EQ(PushBack<int>(ring, 1), OkStatus());
+  EXPECT_EQ(ring.Commit(4), Status::FailedPrecondition());
+  EXPECT_EQ(ring.EntryCount(), 1u);
+  EXPECT_EQ(PeekFront<int>(ring), 1);
+}
+
+TEST(PrefixedEntryRingBuffer, TryReserve) {
+  PrefixedEntryRingBuffer ring;
+  byte test_buffer[kTestBufferSize];
+  ASSERT_EQ(ring.SetBuffer(test_buffer), OkStatus());
+
+  // Fill up the ring buffer with a constant.
+  int total_items = 0;
+  while (TryPushBack<int>(ring, 5).ok()) {
+    total_items++;
+  }
+
+  EXPECT_EQ(ring.TryReserve(sizeof(int)).status(),
+            Status::ResourceExhausted());
+  EXPECT_EQ(ring.Commit(0), Status::FailedPrecondition());
+
+  // Reserve() evicts the oldest entry instead.
+  Result<PrefixedEntryRingBufferMulti::Reservation> space =
+      ring.Reserve(sizeof(int));
+  ASSERT_EQ(space.status(), OkStatus());
+  FillReservation(*space, sizeof(int), 0);
+  EXPECT_EQ(ring.Commit(sizeof(int)), OkStatus());
+  EXPECT_EQ(ring.EntryCount(), static_cast<size_t>(total_items));
+}
+
 TEST(PrefixedEntryRingBufferMulti, TryPushBack) {
   PrefixedEntryRingBufferMulti ring;
   byte test_buffer[kTestBufferSize];
@@ -257,7 +257,11 @@ class PrefixedEntryRingBufferMulti {
       : buffer_(nullptr),
         buffer_bytes_(0),
         write_idx_(0),
-        user_preamble_(user_preamble) {}
+        user_preamble_(user_preamble),
+        reserved_(false),
+        reserved_user_preamble_(0),
+        reserved_length_bytes_(0),
+        reserved_data_bytes_(0) {}
 
   // Set the raw buffer to be used by the ring buffer.
   //
@@ -348,6 +352,60 @@ class PrefixedEntryRingBufferMulti {
     return TryPushBack(data, static_cast<uint32_t>(user_preamble_data));
   }
 
+  // Space for an entry's data reserved by Reserve(). Data is written to first
+  // and continues in second if the space wraps around the end of the buffer.
+  struct Reservation {
+    span<std::byte> first;
+    span<std::byte> second;
+
+    size_t size() const { return first.size() + second.size(); }
+  };
+
+  // Reserve space for an entry of up to max_size bytes, so that its data can be
+  // written directly into the ring buffer rather than copied from another
+  // buffer. Call Commit() once the data is written to add the entry. If
+  // available space is less than the size of the entry, silently pop and
+  // discard oldest stored data chunks until space is available.
+  //
+  // The reservation is invalidated by any other call that modifies the ring
+  // buffer, including another Reserve(), before Commit() is called.
+  //
+  // Preamble argument is a caller-provided value prepended to the front of the
+  // entry, as in PushBack().
+  //
+  // Return values:
+  // OK - The returned reservation holds max_size bytes.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - An entry of max_size bytes is greater than buffer size.
+  Result<Reservation> Reserve(size_t max_size,
+                              uint32_t user_preamble_data = 0) {
+    return InternalReserve(max_size, user_preamble_data, true);
+  }
+
+  // Reserve space for an entry of up to max_size bytes if there is space
+  // available. See Reserve().
+  //
+  // Return values:
+  // OK - The returned reservation holds max_size bytes.
+  // FAILED_PRECONDITION - Buffer not initialized.
+  // OUT_OF_RANGE - An entry of max_size bytes is greater than buffer size.
+  // RESOURCE_EXHAUSTED - The ring buffer doesn't have space for the entry
+  // without popping off existing elements.
+  Result<Reservation> TryReserve(size_t max_size,
+                                 uint32_t user_preamble_data = 0) {
+    return InternalReserve(max_size, user_preamble_data, false);
+  }
+
+  // Add the entry whose data was written to the space returned by the last
+  // Reserve() or TryReserve(). The entry holds the first size bytes of the
+  // reservation, and the remaining bytes are returned to the ring buffer.
+  //
+  // Return values:
+  // OK - The entry was added to the ring buffer.
+  // FAILED_PRECONDITION - There is no reservation to commit.
+  // INVALID_ARGUMENT - size is larger than the reservation.
+  Status Commit(size_t size);
+
   // Get the size in bytes of all the current entries in the ring buffer,
   // including preamble and data chunk.
   size_t TotalUsedBytes() const { return buffer_bytes_ - RawAvailableBytes(); }
@@ -444,6 +502,22 @@ class PrefixedEntryRingBufferMulti {
                           uint32_t user_preamble_data,
                           bool pop_front_if_needed);
 
+  // Reserve implementation, which optionally discards front elements to fit
+  // the reserved element.
+  Result<Reservation> InternalReserve(size_t max_size,
+                                      uint32_t user_preamble_data,
+                                      bool pop_front_if_needed);
+
+  // Makes total_write_bytes available after the write index, optionally
+  // discarding front elements to do so.
+  //
+  // Return values:
+  // OK - The space is available.
+  // OUT_OF_RANGE - total_write_bytes is greater than buffer size.
+  // RESOURCE_EXHAUSTED - Elements would have to be discarded, and
+  // pop_front_if_needed is false.
+  Status MakeSpace(size_t total_write_bytes, bool pop_front_if_needed);
+
   // Internal function to pop all of the slowest readers. This function may pop
   // multiple readers if multiple are slow.
   //
@@ -500,6 +574,13 @@ class PrefixedEntryRingBufferMulti {
   size_t write_idx_;
   const bool user_preamble_;
 
+  // The entry reserved by Reserve(), if any. Its length varint is written by
+  // Commit(), padded to the number of bytes needed for the reserved size.
+  bool reserved_;
+  uint32_t reserved_user_preamble_;
+  size_t reserved_length_bytes_;
+  size_t reserved_data_bytes_;
+
   // List of attached readers.
   IntrusiveList<Reader> readers_;
 
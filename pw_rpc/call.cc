@@ -152,13 +152,26 @@ void Call::MoveFrom(Call& other) {
   on_error_ = std::move(other.on_error_);
   on_next_ = std::move(other.on_next_);
 
-  // Mark the other call inactive, unregister it, and register this one.
+  // Unregister the other call and mark it inactive, then register this one.
+  // The other call must be unregistered while its IDs are still set.
+  endpoint().UnregisterCall(other);
   other.MarkClosed();
 
-  endpoint().UnregisterCall(other);
   endpoint().RegisterUniqueCall(*this);
 }
 
+void Call::set_id(uint32_t id) {
+  if constexpr (cfg::kCallIndexBuckets > 1u) {
+    if (active_locked()) {
+      endpoint().UnregisterCall(*this);
+      id_ = id;
+      endpoint().RegisterUniqueCall(*this);
+      return;
+    }
+  }
+  id_ = id;
+}
+
 void Call::WaitUntilReadyForMove(Call& destination, Call& source) {
   do {
     // Wait for the source's callbacks to finish if it is active.
@@ -263,8 +276,22 @@ void Call::HandlePayload(ConstByteSpan payload) {
     return;
   }
 
+  InvokeOnNext(payload);
+
+  // Clean up calls in case decoding failed.
+  endpoint_->CleanUpCalls();
+}
+
+bool Call::TryHandlePayloadInBatch(ConstByteSpan payload) {
+  if (CallbacksAreRunning()) {
+    return false;
+  }
+  InvokeOnNext(payload);
+  return true;
+}
+
+void Call::InvokeOnNext(ConstByteSpan payload) {
   if (on_next_ == nullptr) {
-    rpc_lock().unlock();
     return;
   }
 
@@ -288,9 +315,6 @@ void Call::HandlePayload(ConstByteSpan payload) {
   if (active_locked() && id() == original_id && on_next_ == nullptr) {
     on_next_ = std::move(on_next_local);
   }
-
-  // Clean up calls in case decoding failed.
-  endpoint_->CleanUpCalls();
 }
 
 void Call::CloseClientCall() {
@@ -0,0 +1,155 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_perf_test/perf_test.h"
+#include "pw_rpc/channel.h"
+#include "pw_rpc/internal/call_context.h"
+#include "pw_rpc/internal/lock.h"
+#include "pw_rpc/internal/packet.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_rpc_private/fake_server_reader_writer.h"
+#include "pw_rpc_private/test_method.h"
+
+namespace pw::rpc {
+
+class TestService : public Service {
+ public:
+  constexpr TestService(uint32_t id) : Service(id, method) {}
+
+  static constexpr internal::TestMethodUnion method =
+      internal::TestMethod(8, MethodType::kBidirectionalStreaming);
+};
+
+namespace internal {
+namespace {
+
+using test::FakeServerReaderWriter;
+
+constexpr uint32_t kChannelId = 1;
+constexpr uint32_t kServiceId = 16;
+constexpr uint32_t kMethodId = 8;
+constexpr size_t kMaxOpenCalls = 256;
+
+// Discards all packets sent by the server.
+class NullChannelOutput : public ChannelOutput {
+ public:
+  constexpr NullChannelOutput() : ChannelOutput("NullChannelOutput") {}
+
+  Status Send(span<const std::byte>) override { return OkStatus(); }
+};
+
+NullChannelOutput output;
+std::array<rpc::Channel, 1> channels{Channel::Create<kChannelId>(&output)};
+Server server(channels);
+TestService service(kServiceId);
+std::array<FakeServerReaderWriter, kMaxOpenCalls> calls;
+
+// Measures how long the server takes to route a client stream packet to the
+// first of `open_calls` calls on the same channel. Calls are searched newest
+// first, so this is the worst case for the default single-list call lookup.
+// Compare results with PW_RPC_CALL_INDEX_BUCKETS set to 1 and to a value near
+// the number of open calls.
+void ClientStreamDispatch(perf_test::State& state, size_t open_calls) {
+  server.RegisterService(service);
+
+  for (size_t i = 0; i < open_calls; ++i) {
+    rpc_lock().lock();
+    FakeServerReaderWriter call(CallContext(server,
+                                            kChannelId,
+                                            service,
+                                            TestService::method.method(),
+                                            static_cast<uint32_t>(i + 1))
+                                    .ClaimLocked());
+    rpc_lock().unlock();
+    calls[i] = std::move(call);
+  }
+
+  std::array<std::byte, 32> buffer;
+  const Result<ConstByteSpan> packet =
+      Packet(pwpb::PacketType::CLIENT_STREAM,
+             kChannelId,
+             kServiceId,
+             kMethodId,
+             /*call_id=*/1)
+          .Encode(buffer);
+
+  while (state.KeepRunning()) {
+    server.ProcessPacket(*packet).IgnoreError();
+  }
+
+  // Unregistering the service aborts all of its calls.
+  server.UnregisterService(service);
+}
+
+// Measures how long the server takes to process a burst of kBurstSize client
+// stream packets for one call, either one at a time with ProcessPacket or as a
+// batch with ProcessPackets. Divide kBurstSize by the reported time to get
+// packets per second.
+constexpr size_t kBurstSize = 16;
+
+void ClientStreamBurst(perf_test::State& state, bool batched) {
+  server.RegisterService(service);
+
+  rpc_lock().lock();
+  FakeServerReaderWriter call(CallContext(server,
+                                          kChannelId,
+                                          service,
+                                          TestService::method.method(),
+                                          /*call_id=*/1)
+                                  .ClaimLocked());
+  rpc_lock().unlock();
+  calls[0] = std::move(call);
+  calls[0].set_on_next([](ConstByteSpan) {});
+
+  std::array<std::byte, 32> buffer;
+  const Result<ConstByteSpan> packet =
+      Packet(pwpb::PacketType::CLIENT_STREAM,
+             kChannelId,
+             kServiceId,
+             kMethodId,
+             /*call_id=*/1)
+          .Encode(buffer);
+
+  std::array<ConstByteSpan, kBurstSize> packets;
+  packets.fill(*packet);
+
+  while (state.KeepRunning()) {
+    if (batched) {
+      server.ProcessPackets(packets).IgnoreError();
+    } else {
+      for (ConstByteSpan data : packets) {
+        server.ProcessPacket(data).IgnoreError();
+      }
+    }
+  }
+
+  server.UnregisterService(service);
+}
+
+PW_PERF_TEST(ClientStreamDispatch1Call, ClientStreamDispatch, 1);
+PW_PERF_TEST(ClientStreamDispatch16Calls, ClientStreamDispatch, 16);
+PW_PERF_TEST(ClientStreamDispatch64Calls, ClientStreamDispatch, 64);
+PW_PERF_TEST(ClientStreamDispatch256Calls, ClientStreamDispatch, 256);
+
+PW_PERF_TEST(ClientStreamBurstOneAtATime, ClientStreamBurst, false);
+PW_PERF_TEST(ClientStreamBurstBatched, ClientStreamBurst, true);
+
+}  // namespace
+}  // namespace internal
+}  // namespace pw::rpc
@@ -119,9 +119,32 @@ TEST_F(ServerWriterTest, DefaultConstruct_Closed) {
 
 TEST_F(ServerWriterTest, Construct_RegistersWithServer) {
   RpcLockGuard lock;
-  IntrusiveList<Call>::iterator call = context_.server().FindCall(kPacket);
-  ASSERT_NE(call, context_.server().calls_end());
-  EXPECT_EQ(static_cast<void*>(&*call), static_cast<void*>(&writer_));
+  Call* call = context_.server().FindCall(kPacket);
+  ASSERT_NE(call, nullptr);
+  EXPECT_EQ(static_cast<void*>(call), static_cast<void*>(&writer_));
+}
+
+TEST_F(ServerWriterTest, ManyCalls_EachFoundByCallId) {
+  std::array<FakeServerWriter, 3> writers;
+  for (size_t i = 0; i < writers.size(); ++i) {
+    rpc_lock().lock();
+    FakeServerWriter writer_temp(
+        context_.get(static_cast<uint32_t>(i + 1)).ClaimLocked());
+    rpc_lock().unlock();
+    writers[i] = std::move(writer_temp);
+  }
+
+  RpcLockGuard lock;
+  for (size_t i = 0; i < writers.size(); ++i) {
+    const Packet packet(pwpb::PacketType::REQUEST,
+                        kChannelId,
+                        kServiceId,
+                        kMethodId,
+                        static_cast<uint32_t>(i + 1));
+    Call* call = context_.server().FindCall(packet);
+    ASSERT_NE(call, nullptr);
+    EXPECT_EQ(static_cast<void*>(call), static_cast<void*>(&writers[i]));
+  }
 }
 
 TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
@@ -135,13 +158,13 @@ TEST_F(ServerWriterTest, Destruct_RemovesFromServer) {
   }
 
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
 }
 
 TEST_F(ServerWriterTest, Finish_RemovesFromServer) {
   EXPECT_EQ(OkStatus(), writer_.Finish());
   RpcLockGuard lock;
-  EXPECT_EQ(context_.server().FindCall(kPacket), context_.server().calls_end());
+  EXPECT_EQ(context_.server().FindCall(kPacket), nullptr);
 }
 
 TEST_F(ServerWriterTest, Finish_SendsResponse) {
@@ -18,6 +18,8 @@
 #include "pw_rpc/internal/channel.h"
 // clang-format on
 
+#include <array>
+
 #include "pw_assert/check.h"
 #include "pw_bytes/span.h"
 #include "pw_log/log.h"
@@ -66,6 +68,19 @@ Result<uint32_t> ExtractChannelId(ConstByteSpan packet) {
 namespace internal {
 
 Status Channel::Send(const Packet& packet) {
+  if (output().supports_gathered_send() && !packet.payload().empty()) {
+    std::array<std::byte, Packet::kMinEncodedSizeWithoutPayload> header_buffer;
+    const Result<ConstByteSpan> header = packet.EncodeHeader(header_buffer);
+    PW_DCHECK_OK(header.status());
+
+    const Status sent = output().SendGathered(*header, packet.payload());
+    if (!sent.IsUnimplemented()) {
+      // The payload may have been encoded into the encoding buffer.
+      encoding_buffer.ReleaseIfAllocated();
+      return HandleSendResult(sent);
+    }
+  }
+
   ByteSpan buffer = encoding_buffer.GetPacketBuffer(packet.payload().size());
   Result encoded = packet.Encode(buffer);
 
@@ -81,7 +96,10 @@ Status Channel::Send(const Packet& packet) {
 
   Status sent = output().Send(encoded.value());
   encoding_buffer.Release();
+  return HandleSendResult(sent);
+}
 
+Status Channel::HandleSendResult(Status sent) const {
   if (!sent.ok()) {
     PW_LOG_DEBUG("Channel %u failed to send packet with status %u",
                  static_cast<unsigned>(id()),
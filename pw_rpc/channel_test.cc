@@ -14,10 +14,15 @@
 
 #include "pw_rpc/channel.h"
 
+#include <algorithm>
+#include <array>
 #include <cstddef>
 
+#include "pw_rpc/internal/channel.h"
+#include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_rpc/internal/test_utils.h"
+#include "pw_status/try.h"
 #include "pw_unit_test/framework.h"
 
 namespace pw::rpc::internal {
@@ -190,5 +195,116 @@ TEST(ExtractChannelId, ChangeChannelIdNoChannelFound) {
   EXPECT_EQ(ChangeEncodedChannelId(packet, 127), Status::DataLoss());
 }
 
+// Records packets sent with either Send() or SendGathered().
+class GatheredOutput : public ChannelOutput {
+ public:
+  GatheredOutput(Status gathered_status = OkStatus())
+      : ChannelOutput("GatheredOutput", /*supports_gathered_send=*/true),
+        gathered_status_(gathered_status) {}
+
+  Status Send(span<const std::byte> buffer) override {
+    contiguous_sends += 1;
+    return Record(buffer, {});
+  }
+
+  Status SendGathered(span<const std::byte> header,
+                      span<const std::byte> payload) override {
+    if (gathered_status_.IsUnimplemented()) {
+      return gathered_status_;
+    }
+    gathered_sends += 1;
+    payload_data = payload.data();
+    PW_TRY(Record(header, payload));
+    return gathered_status_;
+  }
+
+  Result<Packet> last_packet() const {
+    return Packet::FromBuffer(span(buffer_).first(size_));
+  }
+
+  size_t contiguous_sends = 0;
+  size_t gathered_sends = 0;
+  const std::byte* payload_data = nullptr;
+
+ private:
+  Status Record(ConstByteSpan first, ConstByteSpan second) {
+    if (first.size() + second.size() > buffer_.size()) {
+      return Status::ResourceExhausted();
+    }
+    std::copy(first.begin(), first.end(), buffer_.begin());
+    std::copy(second.begin(), second.end(), buffer_.begin() + first.size());
+    size_ = first.size() + second.size();
+    return OkStatus();
+  }
+
+  Status gathered_status_;
+  std::array<std::byte, 64> buffer_;
+  size_t size_ = 0;
+};
+
+constexpr std::array<std::byte, 3> kPayload = {
+    std::byte{1}, std::byte{2}, std::byte{3}};
+
+Status SendPacket(Channel& channel, const Packet& packet) {
+  RpcLockGuard lock;
+  return channel.Send(packet);
+}
+
+TEST(Channel, Send_GatheredOutput_PassesPayloadWithoutCopying) {
+  GatheredOutput output;
+  Channel channel(1, &output);
+
+  const Packet packet(
+      pwpb::PacketType::SERVER_STREAM, 1, 42, 100, 7, kPayload);
+  ASSERT_EQ(OkStatus(), SendPacket(channel, packet));
+
+  EXPECT_EQ(output.gathered_sends, 1u);
+  EXPECT_EQ(output.contiguous_sends, 0u);
+  EXPECT_EQ(output.payload_data, kPayload.data());
+
+  const Result<Packet> sent = output.last_packet();
+  ASSERT_EQ(OkStatus(), sent.status());
+  EXPECT_EQ(sent->type(), pwpb::PacketType::SERVER_STREAM);
+  EXPECT_EQ(sent->call_id(), 7u);
+  ASSERT_EQ(sent->payload().size(), kPayload.size());
+  EXPECT_TRUE(std::equal(
+      kPayload.begin(), kPayload.end(), sent->payload().begin()));
+}
+
+TEST(Channel, Send_GatheredOutput_NoPayload_SendsContiguous) {
+  GatheredOutput output;
+  Channel channel(1, &output);
+
+  ASSERT_EQ(OkStatus(), SendPacket(channel, kTestPacket));
+
+  EXPECT_EQ(output.gathered_sends, 0u);
+  EXPECT_EQ(output.contiguous_sends, 1u);
+}
+
+TEST(Channel, Send_GatheredOutputUnimplemented_FallsBackToSend) {
+  GatheredOutput output(Status::Unimplemented());
+  Channel channel(1, &output);
+
+  const Packet packet(
+      pwpb::PacketType::SERVER_STREAM, 1, 42, 100, 7, kPayload);
+  ASSERT_EQ(OkStatus(), SendPacket(channel, packet));
+
+  EXPECT_EQ(output.gathered_sends, 0u);
+  EXPECT_EQ(output.contiguous_sends, 1u);
+  const Result<Packet> sent = output.last_packet();
+  ASSERT_EQ(OkStatus(), sent.status());
+  EXPECT_EQ(sent->payload().size(), kPayload.size());
+}
+
+TEST(Channel, Send_GatheredOutputFails_ReturnsUnknown) {
+  GatheredOutput output(Status::Unavailable());
+  Channel channel(1, &output);
+
+  const Packet packet(
+      pwpb::PacketType::SERVER_STREAM, 1, 42, 100, 7, kPayload);
+  EXPECT_EQ(Status::Unknown(), SendPacket(channel, packet));
+  EXPECT_EQ(output.contiguous_sends, 0u);
+}
+
 }  // namespace
 }  // namespace pw::rpc::internal
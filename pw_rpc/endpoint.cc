@@ -87,10 +87,18 @@ void YieldRpcLock() {
 
 Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
                                        Packet::Destination destination) {
+  Result<Packet> result = DecodePacket(data, destination);
+  if (result.status().IsDataLoss()) {
+    PW_LOG_WARN("Failed to decode pw_rpc packet");
+  }
+  return result;
+}
+
+Result<Packet> Endpoint::DecodePacket(span<const std::byte> data,
+                                      Packet::Destination destination) {
   Result<Packet> result = Packet::FromBuffer(data);
 
   if (!result.ok()) {
-    PW_LOG_WARN("Failed to decode pw_rpc packet");
     return Status::DataLoss();
   }
 
@@ -98,7 +106,6 @@ Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
 
   if (packet.channel_id() == Channel::kUnassignedChannelId ||
       packet.service_id() == 0 || packet.method_id() == 0) {
-    PW_LOG_WARN("Received malformed pw_rpc packet");
     return Status::DataLoss();
   }
 
@@ -111,46 +118,101 @@ Result<Packet> Endpoint::ProcessPacket(span<const std::byte> data,
 
 void Endpoint::RegisterCall(Call& new_call) {
   // Mark any exisitng duplicate calls as cancelled.
-  auto [before_call, call] = FindIteratorsForCall(new_call);
-  if (call != calls_.end()) {
-    CloseCallAndMarkForCleanup(before_call, call, Status::Cancelled());
+  Call* call = FindCallByIds(new_call.channel_id_locked(),
+                             new_call.service_id(),
+                             new_call.method_id(),
+                             new_call.id());
+  if (call != nullptr) {
+    CloseCallAndMarkForCleanup(*call, Status::Cancelled());
   }
 
   // Register the new call.
-  calls_.push_front(new_call);
+  RegisterUniqueCall(new_call);
 }
 
-std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-Endpoint::FindIteratorsForCall(uint32_t channel_id,
-                               uint32_t service_id,
-                               uint32_t method_id,
-                               uint32_t call_id) {
-  auto previous = calls_.before_begin();
-  auto call = calls_.begin();
-
-  while (call != calls_.end()) {
-    if (channel_id == call->channel_id_locked() &&
-        service_id == call->service_id() && method_id == call->method_id()) {
-      if (call_id == call->id() || call_id == kOpenCallId ||
+Call* Endpoint::FindCallByIds(uint32_t channel_id,
+                              uint32_t service_id,
+                              uint32_t method_id,
+                              uint32_t call_id) {
+  // A packet with an open call ID matches any call for the method, regardless
+  // of its call ID, so every bucket must be searched.
+  if (call_id == kOpenCallId || call_id == kLegacyOpenCallId) {
+    for (IntrusiveList<Call>& bucket : calls_) {
+      Call* call = FindCallInBucket(
+          bucket, channel_id, service_id, method_id, call_id);
+      if (call != nullptr) {
+        return call;
+      }
+    }
+    return nullptr;
+  }
+
+  Call* call =
+      FindCallInBucket(BucketFor(channel_id, service_id, method_id, call_id),
+                       channel_id,
+                       service_id,
+                       method_id,
+                       call_id);
+
+  if constexpr (cfg::kCallIndexBuckets > 1u) {
+    // Unrequested calls with an open call ID are hashed by that ID, so they
+    // may be in a different bucket than the requested call ID.
+    if (call == nullptr) {
+      call = ClaimOpenCall(
+          kOpenCallId, channel_id, service_id, method_id, call_id);
+    }
+    if (call == nullptr) {
+      call = ClaimOpenCall(
+          kLegacyOpenCallId, channel_id, service_id, method_id, call_id);
+    }
+  }
+
+  return call;
+}
+
+Call* Endpoint::FindCallInBucket(IntrusiveList<Call>& bucket,
+                                 uint32_t channel_id,
+                                 uint32_t service_id,
+                                 uint32_t method_id,
+                                 uint32_t call_id) {
+  for (Call& call : bucket) {
+    if (channel_id == call.channel_id_locked() &&
+        service_id == call.service_id() && method_id == call.method_id()) {
+      if (call_id == call.id() || call_id == kOpenCallId ||
           call_id == kLegacyOpenCallId) {
-        break;
+        return &call;
       }
-      if (call->id() == kOpenCallId || call->id() == kLegacyOpenCallId) {
+      if (call.id() == kOpenCallId || call.id() == kLegacyOpenCallId) {
         // Calls with ID of `kOpenCallId` were unrequested, and
         // are updated to have the call ID of the first matching request.
         //
         // kLegacyOpenCallId is used for compatibility with old servers
         // which do not specify a Call ID but expect to be able to send
         // unrequested responses.
-        call->set_id(call_id);
-        break;
+        call.set_id(call_id);
+        return &call;
       }
     }
-    previous = call;
-    ++call;
   }
+  return nullptr;
+}
 
-  return {previous, call};
+Call* Endpoint::ClaimOpenCall(uint32_t open_call_id,
+                              uint32_t channel_id,
+                              uint32_t service_id,
+                              uint32_t method_id,
+                              uint32_t call_id) {
+  IntrusiveList<Call>& bucket =
+      BucketFor(channel_id, service_id, method_id, open_call_id);
+
+  for (Call& call : bucket) {
+    if (call.id() == open_call_id && channel_id == call.channel_id_locked() &&
+        service_id == call.service_id() && method_id == call.method_id()) {
+      call.set_id(call_id);  // Moves the call to the bucket for call_id.
+      return &call;
+    }
+  }
+  return nullptr;
 }
 
 Status Endpoint::CloseChannel(uint32_t channel_id) {
@@ -172,17 +234,21 @@ Status Endpoint::CloseChannel(uint32_t channel_id) {
 }
 
 void Endpoint::AbortCalls(AbortIdType type, uint32_t id) {
-  auto previous = calls_.before_begin();
-  auto current = calls_.begin();
-
-  while (current != calls_.end()) {
-    if (id == (type == AbortIdType::kChannel ? current->channel_id_locked()
-                                             : current->service_id())) {
-      current =
-          CloseCallAndMarkForCleanup(previous, current, Status::Aborted());
-    } else {
-      previous = current;
-      ++current;
+  for (IntrusiveList<Call>& bucket : calls_) {
+    auto previous = bucket.before_begin();
+    auto current = bucket.begin();
+
+    while (current != bucket.end()) {
+      if (id == (type == AbortIdType::kChannel ? current->channel_id_locked()
+                                               : current->service_id())) {
+        Call& call = *current;
+        current = bucket.erase_after(previous);
+        call.CloseAndMarkForCleanupFromEndpoint(Status::Aborted());
+        to_cleanup_.push_front(call);
+      } else {
+        previous = current;
+        ++current;
+      }
     }
   }
 }
@@ -216,9 +282,11 @@ void Endpoint::RemoveAllCalls() {
 
   // Close all calls without invoking on_error callbacks, since the calls should
   // have been closed before the Endpoint was deleted.
-  while (!calls_.empty()) {
-    calls_.front().CloseFromDeletedEndpoint();
-    calls_.pop_front();
+  for (IntrusiveList<Call>& bucket : calls_) {
+    while (!bucket.empty()) {
+      bucket.front().CloseFromDeletedEndpoint();
+      bucket.pop_front();
+    }
   }
   while (!to_cleanup_.empty()) {
     to_cleanup_.front().CloseFromDeletedEndpoint();
@@ -16,6 +16,9 @@
 
 #include "pw_log/log.h"
 #include "pw_protobuf/decoder.h"
+#include "pw_protobuf/wire_format.h"
+#include "pw_status/try.h"
+#include "pw_varint/varint.h"
 
 namespace pw::rpc::internal {
 
@@ -112,6 +115,28 @@ Result<ConstByteSpan> Packet::Encode(ByteSpan buffer) const {
   return rpc_packet.status();
 }
 
+Result<ConstByteSpan> Packet::EncodeHeader(ByteSpan buffer) const {
+  Packet header = *this;
+  header.payload_ = {};
+  PW_TRY_ASSIGN(ConstByteSpan fields, header.Encode(buffer));
+
+  // Protobuf fields may appear in any order, so the payload is encoded last.
+  ByteSpan remaining = buffer.subspan(fields.size());
+  const size_t key_size = varint::Encode(
+      uint32_t(protobuf::FieldKey(
+          static_cast<uint32_t>(RpcPacket::Fields::kPayload),
+          protobuf::WireType::kDelimited)),
+      remaining);
+  const size_t length_size =
+      key_size == 0 ? 0
+                    : varint::Encode(payload_.size(), remaining.subspan(key_size));
+
+  if (length_size == 0) {
+    return Status::ResourceExhausted();
+  }
+  return ConstByteSpan(buffer.first(fields.size() + key_size + length_size));
+}
+
 size_t Packet::MinEncodedSizeBytes() const {
   size_t reserved_size = 0;
 
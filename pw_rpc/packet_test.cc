@@ -97,6 +97,40 @@ TEST(Packet, Encode_BufferTooSmall) {
   EXPECT_EQ(Status::ResourceExhausted(), result.status());
 }
 
+TEST(Packet, EncodeHeader_HeaderAndPayloadDecodeToPacket) {
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 7, kPayload);
+
+  byte header_buffer[Packet::kMinEncodedSizeWithoutPayload];
+  const Result<ConstByteSpan> header = packet.EncodeHeader(header_buffer);
+  ASSERT_EQ(OkStatus(), header.status());
+  ASSERT_EQ(header->size() + kPayload.size(), kEncoded.size());
+
+  byte buffer[64];
+  std::memcpy(buffer, header->data(), header->size());
+  std::memcpy(buffer + header->size(), kPayload.data(), kPayload.size());
+
+  const Result<Packet> decoded = Packet::FromBuffer(
+      span(buffer, header->size() + kPayload.size()));
+  ASSERT_EQ(OkStatus(), decoded.status());
+  EXPECT_EQ(decoded->type(), PacketType::RESPONSE);
+  EXPECT_EQ(decoded->channel_id(), 1u);
+  EXPECT_EQ(decoded->service_id(), 42u);
+  EXPECT_EQ(decoded->method_id(), 100u);
+  EXPECT_EQ(decoded->call_id(), 7u);
+  ASSERT_EQ(decoded->payload().size(), kPayload.size());
+  EXPECT_EQ(0,
+            std::memcmp(
+                decoded->payload().data(), kPayload.data(), kPayload.size()));
+}
+
+TEST(Packet, EncodeHeader_BufferTooSmall) {
+  Packet packet(PacketType::RESPONSE, 1, 42, 100, 7, kPayload);
+
+  // Large enough for every field except the payload key and length.
+  byte buffer[kEncoded.size() - kPayload.size() - 2];
+  EXPECT_EQ(Status::ResourceExhausted(), packet.EncodeHeader(buffer).status());
+}
+
 TEST(Packet, Decode_ValidPacket) {
   auto result = Packet::FromBuffer(kEncoded);
   ASSERT_TRUE(result.ok());
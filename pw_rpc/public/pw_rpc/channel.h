@@ -99,9 +99,14 @@ class ChannelOutput {
   // imposes no limits on the MTU.
   static constexpr size_t kUnlimited = std::numeric_limits<size_t>::max();
 
+  // The size of the largest header passed to SendGathered().
+  static constexpr size_t kMaxGatheredHeaderSizeBytes =
+      internal::Packet::kMinEncodedSizeWithoutPayload;
+
   // Creates a channel output with the provided name. The name is used for
   // logging only.
-  constexpr ChannelOutput(const char* name) : name_(name) {}
+  constexpr ChannelOutput(const char* name)
+      : ChannelOutput(name, /*supports_gathered_send=*/false) {}
 
   virtual ~ChannelOutput() = default;
 
@@ -134,8 +139,39 @@ class ChannelOutput {
   virtual Status Send(span<const std::byte> buffer)
       PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) = 0;
 
+  // Sends an encoded RPC packet that is split into a header and a payload.
+  // Concatenating the two produces the same bytes that would be passed to
+  // Send(). Only called if the output was created with supports_gathered_send
+  // set, and only for packets with a payload.
+  //
+  // Outputs that can transmit discontiguous buffers, such as with
+  // scatter-gather I/O or by framing the parts separately, implement this so
+  // that payloads are passed from the caller to the transport without being
+  // copied into pw_rpc's encoding buffer. If this returns UNIMPLEMENTED, pw_rpc
+  // encodes the packet into a contiguous buffer and calls Send() instead.
+  //
+  // The same rules as for Send() apply: the RPC lock is held, no pw_rpc APIs
+  // may be accessed, and neither buffer may be accessed after this returns.
+  virtual Status SendGathered(span<const std::byte> /* header */,
+                              span<const std::byte> /* payload */)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(internal::rpc_lock()) {
+    return Status::Unimplemented();
+  }
+
+  // Returns whether pw_rpc should call SendGathered() for packets with a
+  // payload before falling back to Send().
+  constexpr bool supports_gathered_send() const {
+    return supports_gathered_send_;
+  }
+
+ protected:
+  // Creates a channel output that may implement SendGathered().
+  constexpr ChannelOutput(const char* name, bool supports_gathered_send)
+      : name_(name), supports_gathered_send_(supports_gathered_send) {}
+
  private:
   const char* name_;
+  bool supports_gathered_send_;
 };
 
 class Channel {
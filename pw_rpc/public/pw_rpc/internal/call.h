@@ -152,7 +152,9 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
 
   uint32_t id() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) { return id_; }
 
-  void set_id(uint32_t id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) { id_ = id; }
+  // Updates the call ID. Active calls are moved to the endpoint bucket for
+  // their new ID.
+  void set_id(uint32_t id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
   // Public function for accessing the channel ID of this call. Set to 0 when
   // the call is closed.
@@ -275,6 +277,17 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
   // Precondition: rpc_lock() must be held.
   void HandlePayload(ConstByteSpan payload) PW_UNLOCK_FUNCTION(rpc_lock());
 
+  // Handles a payload like HandlePayload, but returns with rpc_lock() held so
+  // the caller can continue routing packets without reacquiring it. The lock
+  // is still released while on_next runs. Returns false without doing anything
+  // if a callback is running for this call, in which case the payload must be
+  // passed to HandlePayload instead.
+  //
+  // Calls may be left awaiting cleanup, so the caller must eventually release
+  // the lock with Endpoint::CleanUpCalls().
+  bool TryHandlePayloadInBatch(ConstByteSpan payload)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   // Handles an error condition for the call. This closes the call and calls the
   // on_error callback, if set.
   void HandleError(Status status) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -569,6 +582,11 @@ class Call : public IntrusiveList<Call>::Item, private rpc::Writer {
                                           Status status)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
+  // Invokes on_next with the payload, if it is set. The lock is released while
+  // the callback runs, unless the callback decodes the payload to a struct.
+  void InvokeOnNext(ConstByteSpan payload)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
   bool CallbacksAreRunning() const PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
     return callbacks_executing_ != 0u;
   }
@@ -34,6 +34,10 @@ class Channel : public rpc::Channel {
   using rpc::Channel::set_channel_id;
 
   Status Send(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+ private:
+  // Logs a failed send and converts its status to the one returned by Send().
+  Status HandleSendResult(Status sent) const;
 };
 
 }  // namespace pw::rpc::internal
@@ -230,6 +230,19 @@ static_assert(
 #define PW_RPC_ENCODING_BUFFER_SIZE_BYTES 512
 #endif  // PW_RPC_ENCODING_BUFFER_SIZE_BYTES
 
+/// Number of buckets in each endpoint's table of active calls. Must be a power
+/// of two.
+///
+/// By default, an endpoint keeps its active calls in a single list, so finding
+/// the call for an incoming packet is O(n) in the number of open calls. Setting
+/// this to a larger value hashes calls by channel, service, method, and call ID
+/// into that many intrusive lists, which makes lookups O(1) on average for
+/// endpoints with many concurrent calls. Each bucket costs one pointer per
+/// endpoint; no dynamic allocation is performed.
+#ifndef PW_RPC_CALL_INDEX_BUCKETS
+#define PW_RPC_CALL_INDEX_BUCKETS 1
+#endif  // PW_RPC_CALL_INDEX_BUCKETS
+
 /// The log level to use for this module. Logs below this level are omitted.
 #ifndef PW_RPC_CONFIG_LOG_LEVEL
 #define PW_RPC_CONFIG_LOG_LEVEL PW_LOG_LEVEL_INFO
@@ -259,8 +272,15 @@ inline constexpr size_t kNanopbStructMinBufferSize =
 inline constexpr size_t kEncodingBufferSizeBytes =
     PW_RPC_ENCODING_BUFFER_SIZE_BYTES;
 
+inline constexpr size_t kCallIndexBuckets = PW_RPC_CALL_INDEX_BUCKETS;
+
+static_assert(kCallIndexBuckets > 0u &&
+                  (kCallIndexBuckets & (kCallIndexBuckets - 1)) == 0u,
+              "PW_RPC_CALL_INDEX_BUCKETS must be a power of two");
+
 #undef PW_RPC_NANOPB_STRUCT_MIN_BUFFER_SIZE
 #undef PW_RPC_ENCODING_BUFFER_SIZE_BYTES
+#undef PW_RPC_CALL_INDEX_BUCKETS
 
 }  // namespace pw::rpc::cfg
 
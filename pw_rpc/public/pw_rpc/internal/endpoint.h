@@ -13,7 +13,9 @@
 // the License.
 #pragma once
 
-#include <tuple>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 
 #include "pw_assert/assert.h"
 #include "pw_containers/intrusive_list.h"
@@ -21,6 +23,7 @@
 #include "pw_rpc/internal/call.h"
 #include "pw_rpc/internal/channel.h"
 #include "pw_rpc/internal/channel_list.h"
+#include "pw_rpc/internal/config.h"
 #include "pw_rpc/internal/lock.h"
 #include "pw_rpc/internal/packet.h"
 #include "pw_span/span.h"
@@ -72,7 +75,11 @@ class Endpoint {
   // Returns the number calls in the RPC calls list.
   size_t active_call_count() const PW_LOCKS_EXCLUDED(rpc_lock()) {
     RpcLockGuard lock;
-    return calls_.size();
+    size_t count = 0;
+    for (const IntrusiveList<Call>& bucket : calls_) {
+      count += bucket.size();
+    }
+    return count;
   }
 
   // Claims that `rpc_lock()` is held, returning a wrapped endpoint.
@@ -112,25 +119,24 @@ class Endpoint {
                        channels.size())) {}
 
   // Parses an RPC packet and sets ongoing_call to the matching call, if any.
-  // Returns the parsed packet or an error.
+  // Returns the parsed packet or an error, which is logged.
   Result<Packet> ProcessPacket(span<const std::byte> data,
                                Packet::Destination destination)
       PW_LOCKS_EXCLUDED(rpc_lock());
 
-  // Finds a call object for an ongoing call associated with this packet, if
-  // any. The iterator will be calls_end() if no match was found.
-  IntrusiveList<Call>::iterator FindCall(const Packet& packet)
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return std::get<1>(FindIteratorsForCall(packet.channel_id(),
-                                            packet.service_id(),
-                                            packet.method_id(),
-                                            packet.call_id()));
-  }
+  // Parses an RPC packet as ProcessPacket does, but does not log errors. Does
+  // not access any state guarded by rpc_lock(), so it may be called with or
+  // without the lock held.
+  static Result<Packet> DecodePacket(span<const std::byte> data,
+                                     Packet::Destination destination);
 
-  // Used to check if a call iterator is valid or not.
-  IntrusiveList<Call>::const_iterator calls_end() const
-      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return calls_.end();
+  // Finds a call object for an ongoing call associated with this packet, if
+  // any. Returns nullptr if no match was found.
+  Call* FindCall(const Packet& packet) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return FindCallByIds(packet.channel_id(),
+                         packet.service_id(),
+                         packet.method_id(),
+                         packet.call_id());
   }
 
   // Aborts calls associated with a particular service. Calls to
@@ -146,22 +152,11 @@ class Endpoint {
   // This method is protected so it can be exposed in tests.
   void CloseCallAndMarkForCleanup(Call& call, Status error)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    // Remove the call before closing it, since closing clears the IDs that
+    // select its bucket.
+    BucketFor(call).remove(call);
     call.CloseAndMarkForCleanupFromEndpoint(error);
-    calls_.remove(call);
-    to_cleanup_.push_front(call);
-  }
-
-  // Iterator version of CloseCallAndMarkForCleanup. Returns the iterator to the
-  // item after the closed call.
-  IntrusiveList<Call>::iterator CloseCallAndMarkForCleanup(
-      IntrusiveList<Call>::iterator before_call,
-      IntrusiveList<Call>::iterator call_iterator,
-      Status error) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    Call& call = *call_iterator;
-    call.CloseAndMarkForCleanupFromEndpoint(error);
-    auto next = calls_.erase_after(before_call);
     to_cleanup_.push_front(call);
-    return next;
   }
 
  private:
@@ -199,7 +194,7 @@ class Endpoint {
   // Registers a call that is known to be unique. The calls list is NOT checked
   // for existing calls.
   void RegisterUniqueCall(Call& call) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    calls_.push_front(call);
+    BucketFor(call).push_front(call);
   }
 
   void CleanUpCall(Call& call) PW_UNLOCK_FUNCTION(rpc_lock()) {
@@ -208,27 +203,72 @@ class Endpoint {
     call.CleanUpFromEndpoint();
   }
 
-  // Removes the provided call from the call registry.
+  // Removes the provided call from the call registry. The call's channel,
+  // service, method, and call IDs must not have changed since it was
+  // registered.
   void UnregisterCall(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    bool closed_call_was_in_list = calls_.remove(call);
+    bool closed_call_was_in_list = BucketFor(call).remove(call);
     PW_DASSERT(closed_call_was_in_list);
   }
 
-  std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(uint32_t channel_id,
-                       uint32_t service_id,
-                       uint32_t method_id,
-                       uint32_t call_id)
+  Call* FindCallByIds(uint32_t channel_id,
+                      uint32_t service_id,
+                      uint32_t method_id,
+                      uint32_t call_id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Finds a matching call in a single bucket. Calls with an open call ID are
+  // assigned call_id when matched.
+  static Call* FindCallInBucket(IntrusiveList<Call>& bucket,
+                                uint32_t channel_id,
+                                uint32_t service_id,
+                                uint32_t method_id,
+                                uint32_t call_id)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
 
-  std::tuple<IntrusiveList<Call>::iterator, IntrusiveList<Call>::iterator>
-  FindIteratorsForCall(const Call& call)
+  // Finds a call with an open call ID in the bucket for that open ID. If found,
+  // the call is assigned call_id and moved to its new bucket.
+  Call* ClaimOpenCall(uint32_t open_call_id,
+                      uint32_t channel_id,
+                      uint32_t service_id,
+                      uint32_t method_id,
+                      uint32_t call_id) PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock());
+
+  // Selects the bucket in calls_ for a call with these IDs.
+  static constexpr size_t BucketIndex(uint32_t channel_id,
+                                      uint32_t service_id,
+                                      uint32_t method_id,
+                                      uint32_t call_id) {
+    if constexpr (cfg::kCallIndexBuckets == 1u) {
+      static_cast<void>(channel_id);
+      static_cast<void>(service_id);
+      static_cast<void>(method_id);
+      static_cast<void>(call_id);
+      return 0;
+    } else {
+      // Service and method IDs are already hashes; mix in the small channel
+      // and call IDs so that consecutive call IDs land in different buckets.
+      uint32_t hash = service_id ^ (method_id * 0x9e3779b9u);
+      hash ^= (channel_id * 0x85ebca6bu) + call_id;
+      hash ^= hash >> 16;
+      return (hash * 0x45d9f3bu) & (cfg::kCallIndexBuckets - 1);
+    }
+  }
+
+  IntrusiveList<Call>& BucketFor(uint32_t channel_id,
+                                 uint32_t service_id,
+                                 uint32_t method_id,
+                                 uint32_t call_id)
+      PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
+    return calls_[BucketIndex(channel_id, service_id, method_id, call_id)];
+  }
+
+  IntrusiveList<Call>& BucketFor(const Call& call)
       PW_EXCLUSIVE_LOCKS_REQUIRED(rpc_lock()) {
-    return FindIteratorsForCall(call.channel_id_locked(),
-                                call.service_id(),
-                                call.method_id(),
-                                call.id());
+    return BucketFor(call.channel_id_locked(),
+                     call.service_id(),
+                     call.method_id(),
+                     call.id());
   }
 
   // Silently closes all calls. Called by the destructor. This is a
@@ -244,9 +284,11 @@ class Endpoint {
 
   ChannelList channels_ PW_GUARDED_BY(rpc_lock());
 
-  // List of all active calls associated with this endpoint. Calls are added to
-  // this list when they start and removed from it when they finish.
-  IntrusiveList<Call> calls_ PW_GUARDED_BY(rpc_lock());
+  // All active calls associated with this endpoint, hashed into
+  // PW_RPC_CALL_INDEX_BUCKETS lists by their IDs. Calls are added when they
+  // start and removed when they finish.
+  std::array<IntrusiveList<Call>, cfg::kCallIndexBuckets> calls_
+      PW_GUARDED_BY(rpc_lock());
 
   // List of all inactive calls that need to have their on_error callbacks
   // called. Calling on_error requires releasing the RPC lock, so calls are
@@ -110,6 +110,13 @@ class Packet {
   // Encodes the packet into its wire format. Returns the encoded size.
   Result<ConstByteSpan> Encode(ByteSpan buffer) const;
 
+  // Encodes every field of the packet except the payload's contents, ending
+  // with the payload's key and length. Appending the payload to the returned
+  // header produces a complete encoded packet, so the payload can be sent
+  // without copying it. A buffer of kMinEncodedSizeWithoutPayload bytes is
+  // always large enough.
+  Result<ConstByteSpan> EncodeHeader(ByteSpan buffer) const;
+
   // Determines the space required to encode the packet proto fields for a
   // response, excluding the payload. This may be used to split the buffer into
   // reserved space and available space for the payload.
@@ -98,6 +98,23 @@ class Server : public internal::Endpoint {
   Status ProcessPacket(ConstByteSpan packet_data)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  // Processes a batch of RPC packets, such as a burst of frames delivered by a
+  // transport. Packets are processed in order, with the same results as calling
+  // ProcessPacket for each of them, but the RPC mutex is held while routing the
+  // whole batch. It is only released while user callbacks run, which pw_rpc
+  // never invokes with the mutex held.
+  //
+  // Client stream packets for active calls are the fast path: the mutex is
+  // acquired once per packet instead of twice. Other packets are handled as in
+  // ProcessPacket.
+  //
+  // Every packet is processed, even if an earlier one fails. Returns OK if all
+  // packets were processed, or the status ProcessPacket would have returned
+  // for the first packet that was not. Packets that fail to decode are logged
+  // once the mutex is released, as a single warning for the batch.
+  Status ProcessPackets(span<const ConstByteSpan> packets)
+      PW_LOCKS_EXCLUDED(internal::rpc_lock());
+
  private:
   friend class internal::Call;
   friend class ServerTestHelper;
@@ -190,12 +207,12 @@ class Server : public internal::Endpoint {
 
   void HandleCompletionRequest(const internal::Packet& packet,
                                internal::Channel& channel,
-                               IntrusiveList<internal::Call>::iterator call)
+                               internal::Call* call)
       const PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   void HandleClientStreamPacket(const internal::Packet& packet,
                                 internal::Channel& channel,
-                                IntrusiveList<internal::Call>::iterator call)
+                                internal::Call* call)
       const PW_UNLOCK_FUNCTION(internal::rpc_lock());
 
   template <typename... OtherServices>
@@ -211,6 +228,9 @@ class Server : public internal::Endpoint {
   Status ProcessPacket(internal::Packet packet)
       PW_LOCKS_EXCLUDED(internal::rpc_lock());
 
+  Status ProcessPacketLocked(const internal::Packet& packet)
+      PW_UNLOCK_FUNCTION(internal::rpc_lock());
+
   // Remove these internal::Endpoint functions from the public interface.
   using Endpoint::active_call_count;
   using Endpoint::ClaimLocked;
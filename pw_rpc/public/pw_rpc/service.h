@@ -13,6 +13,8 @@
 // the License.
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <limits>
 
@@ -24,6 +26,23 @@
 #include "pw_span/span.h"
 
 namespace pw::rpc {
+namespace internal {
+
+// Returns true if the method IDs are in strictly ascending order, as required
+// to look up methods with a binary search. Generated services static_assert
+// this for their method ID tables.
+template <size_t kMethodCount>
+constexpr bool MethodIdsAreSorted(
+    const std::array<uint32_t, kMethodCount>& method_ids) {
+  for (size_t i = 1; i < kMethodCount; ++i) {
+    if (method_ids[i - 1] >= method_ids[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace internal
 
 // Base class for all RPC services. This cannot be instantiated directly; use a
 // generated subclass instead.
@@ -48,15 +67,28 @@ class Service : public IntrusiveList<Service>::Item {
   // a `const internal::MethodUnion*`.
   template <typename T, size_t kMethodCount>
   constexpr Service(uint32_t id, const std::array<T, kMethodCount>& methods)
-      : id_(id),
-        methods_(methods.data()),
-        method_size_(sizeof(T)),
-        method_count_(static_cast<uint16_t>(kMethodCount)) {
-    PW_MODIFY_DIAGNOSTICS_PUSH();
-    // GCC 10 emits spurious -Wtype-limits warnings for the static_assert.
-    PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wtype-limits");
-    static_assert(kMethodCount <= std::numeric_limits<uint16_t>::max());
-    PW_MODIFY_DIAGNOSTICS_POP();
+      : Service(id, methods.data(), sizeof(T), kMethodCount, nullptr) {
+    CheckMethodCount<kMethodCount>();
+  }
+
+  // Constructs a service with a table of method IDs. The IDs must be in the
+  // same order as the methods and sorted in ascending order, which allows
+  // methods to be found with a binary search. Generated services sort their
+  // methods by ID, check the order with internal::MethodIdsAreSorted, and use
+  // this constructor.
+  //
+  // Note: This constructor is not for direct use outside of pigweed, and
+  // is not considered part of the public API.
+  template <typename T, size_t kMethodCount>
+  constexpr Service(uint32_t id,
+                    const std::array<T, kMethodCount>& methods,
+                    const std::array<uint32_t, kMethodCount>& sorted_method_ids)
+      : Service(id,
+                methods.data(),
+                sizeof(T),
+                kMethodCount,
+                sorted_method_ids.data()) {
+    CheckMethodCount<kMethodCount>();
   }
 
   // For use by tests with only one method.
@@ -65,17 +97,42 @@ class Service : public IntrusiveList<Service>::Item {
   // is not considered part of the public API.
   template <typename T>
   constexpr Service(uint32_t id, const T& method)
-      : id_(id), methods_(&method), method_size_(sizeof(T)), method_count_(1) {}
+      : Service(id, &method, sizeof(T), 1, nullptr) {}
 
  private:
   friend class Server;
   friend class ServiceTestHelper;
 
+  constexpr Service(uint32_t id,
+                    const internal::MethodUnion* methods,
+                    size_t method_size,
+                    size_t method_count,
+                    const uint32_t* method_ids)
+      : id_(id),
+        methods_(methods),
+        method_ids_(method_ids),
+        method_size_(static_cast<uint16_t>(method_size)),
+        method_count_(static_cast<uint16_t>(method_count)) {}
+
+  template <size_t kMethodCount>
+  static constexpr void CheckMethodCount() {
+    PW_MODIFY_DIAGNOSTICS_PUSH();
+    // GCC 10 emits spurious -Wtype-limits warnings for the static_assert.
+    PW_MODIFY_DIAGNOSTIC_GCC(ignored, "-Wtype-limits");
+    static_assert(kMethodCount <= std::numeric_limits<uint16_t>::max());
+    PW_MODIFY_DIAGNOSTICS_POP();
+  }
+
   // Finds the method with the provided method_id. Returns nullptr if no match.
   const internal::Method* FindMethod(uint32_t method_id) const;
 
+  // Returns the method at the provided index in the methods_ array.
+  const internal::Method& MethodAt(size_t index) const;
+
   const uint32_t id_;
   const internal::MethodUnion* const methods_;
+  // Sorted IDs of the methods in methods_, or nullptr if not provided.
+  const uint32_t* const method_ids_;
   const uint16_t method_size_;
   const uint16_t method_count_;
 };
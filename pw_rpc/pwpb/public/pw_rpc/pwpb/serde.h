@@ -15,9 +15,9 @@
 
 #include <array>
 
+#include "pw_protobuf/decoder.h"
 #include "pw_protobuf/encoder.h"
 #include "pw_protobuf/internal/codegen.h"
-#include "pw_protobuf/stream_decoder.h"
 #include "pw_span/span.h"
 #include "pw_stream/null_stream.h"
 
@@ -56,10 +56,12 @@ class PwpbSerde {
     return StatusWithSize(result, output.bytes_written() + 16);
   }
 
-  // Decodes a serialized protobuf into a pw_protobuf message struct.
+  // Decodes a serialized protobuf into a pw_protobuf message struct. The
+  // buffer is decoded in place with the table-driven protobuf::Decoder, rather
+  // than through a stream.
   template <typename Message>
   Status Decode(ConstByteSpan buffer, Message& message) const {
-    return Decoder(buffer).Read(as_writable_bytes(span(&message, 1)), table_);
+    return protobuf::Decoder(buffer).Read(message, *table_);
   }
 
  private:
@@ -81,19 +83,6 @@ class PwpbSerde {
     using protobuf::StreamEncoder::Write;  // Make this method public
   };
 
-  class Decoder : public protobuf::StreamDecoder {
-   public:
-    constexpr Decoder(ConstByteSpan buffer)
-        : protobuf::StreamDecoder(reader_), reader_(buffer) {}
-
-    Status Read(ByteSpan message, PwpbMessageDescriptor table) {
-      return protobuf::StreamDecoder::Read(message, *table);
-    }
-
-   private:
-    stream::MemoryReader reader_;
-  };
-
   PwpbMessageDescriptor table_;
 };
 
@@ -400,7 +400,7 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
     with gen.indent():
         gen.line(
             'constexpr Service() : '
-            f'{base_class}(kServiceId, kPwRpcMethods) {{}}'
+            f'{base_class}(kServiceId, kPwRpcMethods, kPwRpcMethodIds) {{}}'
         )
 
     gen.line()
@@ -410,37 +410,57 @@ def _generate_service(gen: CodeGenerator, service: ProtoService) -> None:
         gen.line('friend class ::pw::rpc::internal::MethodLookup;')
         gen.line()
 
-        # Generate the method table
+        # Generate the method table, sorted by method ID so that the server
+        # can binary search for methods.
+        methods = _methods_sorted_by_id(service)
+
         gen.line(
             'static constexpr std::array<'
             f'{RPC_NAMESPACE}::internal::{gen.method_union_name()},'
-            f' {len(service.methods())}> kPwRpcMethods = {{'
+            f' {len(methods)}> kPwRpcMethods = {{'
         )
 
         with gen.indent(4):
-            for method in service.methods():
+            for method in methods:
                 gen.method_descriptor(method)
 
         gen.line('};\n')
 
         # Generate the method lookup table
-        _method_lookup_table(gen, service)
+        _method_lookup_table(gen, methods)
 
     gen.line('};')
 
 
-def _method_lookup_table(gen: CodeGenerator, service: ProtoService) -> None:
-    """Generates array of method IDs for looking up methods at compile time."""
+def _methods_sorted_by_id(service: ProtoService) -> list[ProtoServiceMethod]:
+    """Returns the service's methods in ascending order of their IDs."""
+    return sorted(service.methods(), key=lambda m: ids.calculate(m.name()))
+
+
+def _method_lookup_table(
+    gen: CodeGenerator, methods: list[ProtoServiceMethod]
+) -> None:
+    """Generates a sorted array of method IDs for looking up methods.
+
+    The IDs are in the same order as the kPwRpcMethods table. They are used to
+    look up methods at compile time and by the server to binary search for
+    methods at run time.
+    """
     gen.line(
         'static constexpr std::array<uint32_t, '
-        f'{len(service.methods())}> kPwRpcMethodIds = {{'
+        f'{len(methods)}> kPwRpcMethodIds = {{'
     )
 
     with gen.indent(4):
-        for method in service.methods():
+        for method in methods:
             gen.line(f'{get_id(method)},  // Hash of "{method.name()}"')
 
     gen.line('};')
+    gen.line(
+        f'static_assert({RPC_NAMESPACE}::internal::MethodIdsAreSorted('
+        'kPwRpcMethodIds),'
+    )
+    gen.line('              "Method IDs must be sorted for binary search");')
 
 
 class StubGenerator(abc.ABC):
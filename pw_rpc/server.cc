@@ -39,9 +39,56 @@ Status Server::ProcessPacket(ConstByteSpan packet_data) {
   return ProcessPacket(packet);
 }
 
+Status Server::ProcessPackets(span<const ConstByteSpan> packets) {
+  Status result;
+  size_t decode_failures = 0;
+
+  internal::rpc_lock().lock();
+
+  for (ConstByteSpan packet_data : packets) {
+    // Decode without logging, since the lock is held. Failures are logged once
+    // the batch is done.
+    Result<Packet> packet = DecodePacket(packet_data, Packet::kServer);
+    if (!packet.ok()) {
+      if (packet.status().IsDataLoss()) {
+        decode_failures += 1;
+      }
+      result.Update(packet.status());
+      continue;
+    }
+
+    // Deliver client stream payloads without releasing the lock to route them.
+    if (packet->type() == PacketType::CLIENT_STREAM) {
+      internal::Call* call = FindCall(*packet);
+      if (call != nullptr && call->has_client_stream() &&
+          !call->client_requested_completion() &&
+          call->TryHandlePayloadInBatch(packet->payload())) {
+        continue;
+      }
+    }
+
+    // Everything else, including errors, is handled exactly as in
+    // ProcessPacket, which releases the lock.
+    result.Update(ProcessPacketLocked(*packet));
+    internal::rpc_lock().lock();
+  }
+
+  CleanUpCalls();
+
+  if (decode_failures != 0u) {
+    PW_LOG_WARN("Failed to decode %u of %u pw_rpc packets",
+                static_cast<unsigned>(decode_failures),
+                static_cast<unsigned>(packets.size()));
+  }
+  return result;
+}
+
 Status Server::ProcessPacket(internal::Packet packet) {
   internal::rpc_lock().lock();
+  return ProcessPacketLocked(packet);
+}
 
+Status Server::ProcessPacketLocked(const internal::Packet& packet) {
   // Verbose log for debugging.
   // PW_LOG_DEBUG("RPC server received packet type %u for %u:%08x/%08x",
   //              static_cast<unsigned>(packet.type()),
@@ -82,14 +129,14 @@ Status Server::ProcessPacket(internal::Packet packet) {
     return OkStatus();
   }
 
-  IntrusiveList<internal::Call>::iterator call = FindCall(packet);
+  internal::Call* call = FindCall(packet);
 
   switch (packet.type()) {
     case PacketType::CLIENT_STREAM:
       HandleClientStreamPacket(packet, *channel, call);
       break;
     case PacketType::CLIENT_ERROR:
-      if (call != calls_end()) {
+      if (call != nullptr) {
         call->HandleError(packet.status());
       } else {
         internal::rpc_lock().unlock();
@@ -133,8 +180,8 @@ std::tuple<Service*, const internal::Method*> Server::FindMethodLocked(
 void Server::HandleCompletionRequest(
     const internal::Packet& packet,
     internal::Channel& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
@@ -162,8 +209,8 @@ void Server::HandleCompletionRequest(
 void Server::HandleClientStreamPacket(
     const internal::Packet& packet,
     internal::Channel& channel,
-    IntrusiveList<internal::Call>::iterator call) const {
-  if (call == calls_end()) {
+    internal::Call* call) const {
+  if (call == nullptr) {
     channel.Send(Packet::ServerError(packet, Status::FailedPrecondition()))
         .IgnoreError();  // Errors are logged in Channel::Send.
     internal::rpc_lock().unlock();
@@ -16,6 +16,7 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 
 #include "pw_assert/check.h"
 #include "pw_rpc/internal/call.h"
@@ -679,6 +680,40 @@ TEST_F(BidiMethod, ClientStream_CallsLegacyOpenIdOnCallWithDifferentId) {
   EXPECT_EQ(responder_.as_server_call().id(), kSecondCallId);
 }
 
+TEST_F(BidiMethod, ClientStream_OpenIdCallFoundByClaimedIdInAnyBucket) {
+  // When PW_RPC_CALL_INDEX_BUCKETS is greater than 1, calls are hashed by call
+  // ID, so most of these IDs select a different bucket than the open call ID.
+  // Claiming the call must move it to the bucket for its new ID.
+  for (uint32_t call_id = 1; call_id <= 16; ++call_id) {
+    internal::CallContext context(server_,
+                                  channels_[0].id(),
+                                  service_42_,
+                                  service_42_.method(100),
+                                  internal::kOpenCallId);
+    internal::rpc_lock().lock();
+    auto temp_responder =
+        internal::test::FakeServerReaderWriter(context.ClaimLocked());
+    internal::rpc_lock().unlock();
+    responder_ = std::move(temp_responder);
+
+    int received = 0;
+    responder_.set_on_next([&received](ConstByteSpan) { ++received; });
+
+    // The first packet claims the call, and the second finds it by its new ID.
+    for (int i = 0; i < 2; ++i) {
+      ASSERT_EQ(OkStatus(),
+                server_.ProcessPacket(PacketForRpc(
+                    PacketType::CLIENT_STREAM, {}, "hello", call_id)));
+    }
+
+    EXPECT_EQ(output_.total_packets(), 0u);
+    EXPECT_EQ(received, 2);
+
+    internal::RpcLockGuard lock;
+    EXPECT_EQ(responder_.as_server_call().id(), call_id);
+  }
+}
+
 TEST_F(BidiMethod, UnregsiterService_AbortsActiveCalls) {
   ASSERT_TRUE(responder_.active());
 
@@ -692,6 +727,99 @@ TEST_F(BidiMethod, UnregsiterService_AbortsActiveCalls) {
   EXPECT_EQ(Status::Aborted(), on_error_status);
 }
 
+class BidiMethodBatch : public BidiMethod {
+ protected:
+  // Encodes a packet for the BidiMethod call into the next batch buffer.
+  ConstByteSpan EncodeBatchPacket(PacketType type,
+                                  const char* payload = "",
+                                  Status status = OkStatus()) {
+    ByteSpan buffer = span(buffers_[packet_count_++]);
+    return Packet(type,
+                  1,
+                  42,
+                  100,
+                  kDefaultCallId,
+                  as_bytes(span(payload, std::strlen(payload))),
+                  status)
+        .Encode(buffer)
+        .value_or(ConstByteSpan());
+  }
+
+ private:
+  std::array<std::array<byte, 32>, 4> buffers_;
+  size_t packet_count_ = 0;
+};
+
+TEST_F(BidiMethodBatch, ProcessPackets_ClientStreams_CallsCallbackForEach) {
+  struct {
+    std::array<char, 4> data;
+    size_t count;
+  } received{};
+  responder_.set_on_next([&received](ConstByteSpan payload) {
+    ASSERT_EQ(payload.size(), 1u);
+    received.data[received.count++] = static_cast<char>(payload[0]);
+  });
+
+  const std::array<ConstByteSpan, 3> packets = {
+      EncodeBatchPacket(PacketType::CLIENT_STREAM, "a"),
+      EncodeBatchPacket(PacketType::CLIENT_STREAM, "b"),
+      EncodeBatchPacket(PacketType::CLIENT_STREAM, "c"),
+  };
+  ASSERT_EQ(OkStatus(), server_.ProcessPackets(packets));
+
+  EXPECT_EQ(output_.total_packets(), 0u);
+  ASSERT_EQ(received.count, 3u);
+  EXPECT_EQ(received.data[0], 'a');
+  EXPECT_EQ(received.data[1], 'b');
+  EXPECT_EQ(received.data[2], 'c');
+}
+
+TEST_F(BidiMethodBatch, ProcessPackets_MixedPackets_HandledInOrder) {
+  size_t payloads = 0;
+  responder_.set_on_next([&payloads](ConstByteSpan) { payloads += 1; });
+  Status error = OkStatus();
+  responder_.set_on_error([&error](Status status) { error = status; });
+
+  const std::array<ConstByteSpan, 3> packets = {
+      EncodeBatchPacket(PacketType::CLIENT_STREAM, "a"),
+      EncodeBatchPacket(PacketType::CLIENT_ERROR, "", Status::Cancelled()),
+      EncodeBatchPacket(PacketType::CLIENT_STREAM, "b"),
+  };
+  ASSERT_EQ(OkStatus(), server_.ProcessPackets(packets));
+
+  EXPECT_EQ(payloads, 1u);
+  EXPECT_EQ(error, Status::Cancelled());
+  EXPECT_FALSE(responder_.active());
+
+  // The last packet arrived after the call was cancelled.
+  ASSERT_EQ(output_.total_packets(), 1u);
+  const Packet& packet =
+      static_cast<internal::test::FakeChannelOutput&>(output_).last_packet();
+  EXPECT_EQ(packet.type(), PacketType::SERVER_ERROR);
+  EXPECT_EQ(packet.status(), Status::FailedPrecondition());
+}
+
+TEST_F(BidiMethodBatch, ProcessPackets_InvalidPacket_ProcessesTheRest) {
+  size_t payloads = 0;
+  responder_.set_on_next([&payloads](ConstByteSpan) { payloads += 1; });
+
+  constexpr byte kGarbage[] = {byte{0xff}, byte{0xff}, byte{0xff}};
+  const std::array<ConstByteSpan, 3> packets = {
+      EncodeBatchPacket(PacketType::CLIENT_STREAM, "a"),
+      kGarbage,
+      EncodeBatchPacket(PacketType::CLIENT_STREAM, "b"),
+  };
+  EXPECT_EQ(Status::DataLoss(), server_.ProcessPackets(packets));
+
+  EXPECT_EQ(payloads, 2u);
+  EXPECT_EQ(output_.total_packets(), 0u);
+}
+
+TEST_F(BasicServer, ProcessPackets_Empty) {
+  EXPECT_EQ(OkStatus(), server_.ProcessPackets({}));
+  EXPECT_EQ(output_.total_packets(), 0u);
+}
+
 TEST_F(BidiMethod, ClientRequestedCompletion_CallsCallback) {
   bool called = false;
 #if PW_RPC_COMPLETION_REQUEST_CALLBACK
@@ -14,12 +14,22 @@
 
 #include "pw_rpc/service.h"
 
+#include <algorithm>
 #include <cstddef>
 #include <type_traits>
 
 namespace pw::rpc {
 
 const internal::Method* Service::FindMethod(uint32_t method_id) const {
+  if (method_ids_ != nullptr) {
+    const uint32_t* const end = method_ids_ + method_count_;
+    const uint32_t* const id = std::lower_bound(method_ids_, end, method_id);
+    if (id == end || *id != method_id) {
+      return nullptr;
+    }
+    return &MethodAt(static_cast<size_t>(id - method_ids_));
+  }
+
   const internal::MethodUnion* method_impl = methods_;
 
   for (size_t i = 0; i < method_count_; ++i) {
@@ -36,4 +46,11 @@ const internal::Method* Service::FindMethod(uint32_t method_id) const {
   return nullptr;
 }
 
+const internal::Method& Service::MethodAt(size_t index) const {
+  const auto raw = reinterpret_cast<const std::byte*>(methods_);
+  return reinterpret_cast<const internal::MethodUnion*>(raw +
+                                                         index * method_size_)
+      ->method();
+}
+
 }  // namespace pw::rpc
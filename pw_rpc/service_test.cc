@@ -80,6 +80,44 @@ TEST(Service, MultipleMethods_FindMethod_NotPresent) {
   EXPECT_EQ(ServiceTestHelper::FindMethod(service, 999), nullptr);
 }
 
+class SortedTestService : public Service {
+ public:
+  constexpr SortedTestService() : Service(0xabcd, kMethods, kMethodIds) {}
+
+  static constexpr std::array<ServiceTestMethodUnion, 5> kMethods = {
+      ServiceTestMethod(2, 'a'),
+      ServiceTestMethod(30, 'b'),
+      ServiceTestMethod(123, 'c'),
+      ServiceTestMethod(456, 'd'),
+      ServiceTestMethod(0xffffffff, 'e'),
+  };
+  static constexpr std::array<uint32_t, 5> kMethodIds = {
+      2, 30, 123, 456, 0xffffffff};
+  static_assert(internal::MethodIdsAreSorted(kMethodIds));
+};
+
+static_assert(internal::MethodIdsAreSorted(std::array<uint32_t, 0>{}));
+static_assert(internal::MethodIdsAreSorted(std::array<uint32_t, 1>{7}));
+static_assert(!internal::MethodIdsAreSorted(std::array<uint32_t, 3>{1, 3, 2}));
+static_assert(!internal::MethodIdsAreSorted(std::array<uint32_t, 2>{5, 5}));
+
+TEST(Service, SortedMethods_FindMethod_Present) {
+  SortedTestService service;
+  for (size_t i = 0; i < SortedTestService::kMethods.size(); ++i) {
+    EXPECT_EQ(
+        ServiceTestHelper::FindMethod(service, SortedTestService::kMethodIds[i]),
+        &SortedTestService::kMethods[i].method());
+  }
+}
+
+TEST(Service, SortedMethods_FindMethod_NotPresent) {
+  SortedTestService service;
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 3), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 457), nullptr);
+  EXPECT_EQ(ServiceTestHelper::FindMethod(service, 0xfffffffe), nullptr);
+}
+
 class EmptyTestService : public Service {
  public:
   constexpr EmptyTestService() : Service(0xabcd, kMethods) {}
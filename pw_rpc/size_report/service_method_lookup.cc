@@ -0,0 +1,123 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+// Registers a raw service with 16 methods with a server. If
+// USE_SORTED_METHOD_IDS is set, the service provides a sorted method ID table,
+// as generated services do, so the server finds methods with a binary search.
+// Otherwise, methods are found with a linear search.
+//
+// Service::FindMethod contains both searches and picks one at run time, so both
+// builds of this file link the same lookup code. Comparing them measures the
+// sorted method ID table and the code that passes it to the Service, not the
+// difference between the two searches.
+
+#include <array>
+
+#include "pw_assert/check.h"
+#include "pw_bloat/bloat_this_binary.h"
+#include "pw_log/log.h"
+#include "pw_rpc/raw/internal/method_union.h"
+#include "pw_rpc/raw/server_reader_writer.h"
+#include "pw_rpc/server.h"
+#include "pw_rpc/service.h"
+#include "pw_sys_io/sys_io.h"
+
+#ifndef USE_SORTED_METHOD_IDS
+#define USE_SORTED_METHOD_IDS 0
+#endif  // USE_SORTED_METHOD_IDS
+
+int volatile* unoptimizable;
+
+class Output : public pw::rpc::ChannelOutput {
+ public:
+  Output() : ChannelOutput("output") {}
+
+  pw::Status Send(pw::span<const std::byte> buffer) override {
+    return pw::sys_io::WriteBytes(buffer).status();
+  }
+};
+
+namespace my_product {
+
+using pw::rpc::MethodType;
+using pw::rpc::internal::GetRawMethodFor;
+using pw::rpc::internal::RawMethodUnion;
+
+// Mirrors the structure of a generated raw service.
+template <typename Implementation>
+class LookupServiceBase : public pw::rpc::Service {
+ protected:
+#if USE_SORTED_METHOD_IDS
+  constexpr LookupServiceBase() : Service(0x1234, kMethods, kMethodIds) {}
+#else
+  constexpr LookupServiceBase() : Service(0x1234, kMethods) {}
+#endif  // USE_SORTED_METHOD_IDS
+
+ private:
+  template <uint32_t kId>
+  static constexpr RawMethodUnion Method() {
+    return GetRawMethodFor<&Implementation::Handle, MethodType::kUnary>(kId);
+  }
+
+  static constexpr std::array<RawMethodUnion, 16> kMethods = {
+      Method<0x0473e7f5>(), Method<0x0bdd7c11>(), Method<0x1e58a0a9>(),
+      Method<0x2b0e2d3c>(), Method<0x3f5b1c2e>(), Method<0x4a9d6e01>(),
+      Method<0x5c7c8a13>(), Method<0x6e00b2f7>(), Method<0x7a31c45d>(),
+      Method<0x8d4f9b20>(), Method<0x9e1a0c66>(), Method<0xa5b3d7e8>(),
+      Method<0xb8c2f419>(), Method<0xc9e4a53b>(), Method<0xdaf6170c>(),
+      Method<0xfe2854d1>(),
+  };
+
+#if USE_SORTED_METHOD_IDS
+  static constexpr std::array<uint32_t, 16> kMethodIds = {
+      0x0473e7f5, 0x0bdd7c11, 0x1e58a0a9, 0x2b0e2d3c, 0x3f5b1c2e, 0x4a9d6e01,
+      0x5c7c8a13, 0x6e00b2f7, 0x7a31c45d, 0x8d4f9b20, 0x9e1a0c66, 0xa5b3d7e8,
+      0xb8c2f419, 0xc9e4a53b, 0xdaf6170c, 0xfe2854d1,
+  };
+#endif  // USE_SORTED_METHOD_IDS
+};
+
+class LookupService final : public LookupServiceBase<LookupService> {
+ public:
+  void Handle(pw::ConstByteSpan request, pw::rpc::RawUnaryResponder&) {
+    *unoptimizable = static_cast<int>(request.size());
+  }
+};
+
+Output output;
+pw::rpc::Channel channels[] = {pw::rpc::Channel::Create<1>(&output)};
+pw::rpc::Server server(channels);
+LookupService service;
+
+}  // namespace my_product
+
+int main() {
+  pw::bloat::BloatThisBinary();
+
+  // Ensure we are paying the cost for log and assert.
+  PW_CHECK_INT_GE(*unoptimizable, 0, "Ensure this CHECK logic stays");
+  PW_LOG_INFO("We care about optimizing: %d", *unoptimizable);
+
+  std::byte packet_buffer[128];
+  pw::sys_io::ReadBytes(packet_buffer)
+      .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+  pw::sys_io::WriteBytes(packet_buffer)
+      .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+
+  my_product::server.RegisterService(my_product::service);
+  my_product::server.ProcessPacket(packet_buffer)
+      .IgnoreError();  // TODO: b/242598609 - Handle Status properly
+
+  return static_cast<int>(packet_buffer[92]);
+}
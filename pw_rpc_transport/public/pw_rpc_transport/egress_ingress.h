@@ -39,12 +39,17 @@ void LogIngressSendFailure(uint32_t channel_id, Status status);
 
 }  // namespace internal
 
+static_assert(SimpleRpcPacketEncoder<1>::kMaxGatheredHeaderSize >=
+                  ChannelOutput::kMaxGatheredHeaderSizeBytes,
+              "Gathered packets must fit any pw_rpc packet header");
+
 // Ties RPC transport and RPC frame encoder together.
 template <typename Encoder>
 class RpcEgress : public RpcEgressHandler, public ChannelOutput {
  public:
   RpcEgress(std::string_view channel_name, RpcFrameSender& transport)
-      : ChannelOutput(channel_name.data()), transport_(transport) {}
+      : ChannelOutput(channel_name.data(), Encoder::kSupportsGatheredEncode),
+        transport_(transport) {}
 
   // Implements both rpc::ChannelOutput and RpcEgressHandler. Encodes the
   // provided packet using the target transport's MTU as max frame size and
@@ -72,6 +77,20 @@ class RpcEgress : public RpcEgressHandler, public ChannelOutput {
   // Implements ChannelOutput.
   Status Send(ConstByteSpan buffer) override { return SendRpcPacket(buffer); }
 
+  // Implements ChannelOutput. If the encoder supports it, frames the packet's
+  // header and payload separately so the payload reaches the transport
+  // without being copied.
+  Status SendGathered(ConstByteSpan header, ConstByteSpan payload) override {
+    std::lock_guard lock(mutex_);
+    return encoder_.EncodeGathered(header,
+                                   payload,
+                                   transport_.MaximumTransmissionUnit(),
+                                   [this](RpcFrame& frame) {
+                                     // See the comment in SendRpcPacket().
+                                     return transport_.Send(frame);
+                                   });
+  }
+
  private:
   sync::Mutex mutex_;
   RpcFrameSender& transport_;
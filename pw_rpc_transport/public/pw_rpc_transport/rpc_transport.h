@@ -60,12 +60,25 @@ using OnRpcPacketDecodedCallback = pw::Function<void(ConstByteSpan)>;
 template <class Encoder>
 class RpcPacketEncoder {
  public:
+  // Whether the encoder implements EncodeGathered(). Encoders that do shadow
+  // this with `true`.
+  static constexpr bool kSupportsGatheredEncode = false;
+
   Status Encode(ConstByteSpan rpc_packet,
                 size_t max_frame_size,
                 OnRpcFrameEncodedCallback&& callback) {
     return static_cast<Encoder*>(this)->Encode(
         rpc_packet, max_frame_size, std::move(callback));
   }
+
+  // Encodes an RPC packet that is split into a header and a payload without
+  // joining them first. Encoders that cannot do this return UNIMPLEMENTED.
+  Status EncodeGathered(ConstByteSpan /* packet_header */,
+                        ConstByteSpan /* packet_payload */,
+                        size_t /* max_frame_size */,
+                        OnRpcFrameEncodedCallback&& /* callback */) {
+    return Status::Unimplemented();
+  }
 };
 
 // RpcPacketDecoder finds and decodes RPC frames in the provided buffer. Once
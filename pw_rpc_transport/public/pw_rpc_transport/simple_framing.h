@@ -13,6 +13,9 @@
 // the License.
 #pragma once
 
+#include <algorithm>
+#include <array>
+
 #include "pw_assert/assert.h"
 #include "pw_bytes/span.h"
 #include "pw_rpc_transport/rpc_transport.h"
@@ -54,6 +57,12 @@ class SimpleRpcPacketEncoder
   static constexpr size_t kHeaderSize = 4;
   static constexpr uint16_t kFrameMarker = 0x27f1;
 
+  // Large enough for the header of any pw_rpc packet passed to
+  // EncodeGathered().
+  static constexpr size_t kMaxGatheredHeaderSize = 40;
+
+  static constexpr bool kSupportsGatheredEncode = true;
+
   // Encodes `packet` with a simple framing protocol and split the resulting
   // frame into chunks of `RpcFrame`s where every `RpcFrame` is no longer than
   // `max_frame_size`. Calls `callback` for for each of the resulting
@@ -61,28 +70,51 @@ class SimpleRpcPacketEncoder
   Status Encode(ConstByteSpan rpc_packet,
                 size_t max_frame_size,
                 OnRpcFrameEncodedCallback&& callback) {
-    if (rpc_packet.size() > kMaxPacketSize) {
+    return EncodeGathered({}, rpc_packet, max_frame_size, std::move(callback));
+  }
+
+  // Encodes an RPC packet that is split into a header and a payload, as passed
+  // to `ChannelOutput::SendGathered()`. The first frame's header holds the
+  // framing header followed by the packet header, so the payload is framed
+  // without being copied. Returns UNIMPLEMENTED if the packet header does not
+  // fit in the first frame; the caller must then join the packet and call
+  // Encode() instead.
+  Status EncodeGathered(ConstByteSpan packet_header,
+                        ConstByteSpan packet_payload,
+                        size_t max_frame_size,
+                        OnRpcFrameEncodedCallback&& callback) {
+    const size_t packet_size = packet_header.size() + packet_payload.size();
+    if (packet_size > kMaxPacketSize) {
       return Status::FailedPrecondition();
     }
     if (max_frame_size <= kHeaderSize) {
       return Status::FailedPrecondition();
     }
+    if (packet_header.size() > kMaxGatheredHeaderSize ||
+        packet_header.size() > max_frame_size - kHeaderSize) {
+      return Status::Unimplemented();
+    }
 
     // First frame. This is the only frame that contains a header.
-    const auto first_frame_size =
-        std::min(max_frame_size - kHeaderSize, rpc_packet.size());
+    const auto first_frame_size = std::min(
+        max_frame_size - kHeaderSize - packet_header.size(),
+        packet_payload.size());
 
-    std::array<std::byte, kHeaderSize> header{
+    std::array<std::byte, kHeaderSize + kMaxGatheredHeaderSize> header{
         std::byte{kFrameMarker & 0xff},
         std::byte{(kFrameMarker >> 8) & 0xff},
-        static_cast<std::byte>(rpc_packet.size() & 0xff),
-        static_cast<std::byte>((rpc_packet.size() >> 8) & 0xff),
+        static_cast<std::byte>(packet_size & 0xff),
+        static_cast<std::byte>((packet_size >> 8) & 0xff),
     };
+    std::copy(packet_header.begin(),
+              packet_header.end(),
+              header.begin() + kHeaderSize);
 
-    RpcFrame frame{.header = span(header),
-                   .payload = rpc_packet.first(first_frame_size)};
+    RpcFrame frame{
+        .header = span(header).first(kHeaderSize + packet_header.size()),
+        .payload = packet_payload.first(first_frame_size)};
     PW_TRY(callback(frame));
-    auto remaining = rpc_packet.subspan(first_frame_size);
+    auto remaining = packet_payload.subspan(first_frame_size);
 
     // Second and subsequent frames (if any).
     while (!remaining.empty()) {
@@ -107,6 +107,80 @@ TEST(SimpleRpcFrameEncodeDecodeTest, EncodeThenDecode) {
   }
 }
 
+TEST(SimpleRpcFrameEncodeDecodeTest, EncodeGatheredThenDecode) {
+  constexpr size_t kPacketHeaderSize = 12;
+
+  for (auto test_case : kTestCases) {
+    const size_t packet_size = test_case.packet_size;
+    const size_t max_frame_size = test_case.max_frame_size;
+    if (max_frame_size < SimpleRpcPacketEncoder<kMaxPacketSize>::kHeaderSize +
+                             kPacketHeaderSize ||
+        packet_size < kPacketHeaderSize) {
+      continue;
+    }
+    PW_LOG_INFO("EncodeGatheredThenDecode: packet_size = %d, "
+                "max_frame_size = %d",
+                static_cast<int>(packet_size),
+                static_cast<int>(max_frame_size));
+
+    std::vector<std::byte> src(packet_size);
+    MakePacket(src);
+    const ConstByteSpan packet_header = span(src).first(kPacketHeaderSize);
+    const ConstByteSpan packet_payload = span(src).subspan(kPacketHeaderSize);
+
+    struct {
+      ConstByteSpan payload;
+      std::vector<std::byte> bytes;
+    } encoded{packet_payload, {}};
+    std::vector<std::byte> decoded;
+
+    SimpleRpcPacketEncoder<kMaxPacketSize> encoder;
+
+    ASSERT_EQ(
+        encoder.EncodeGathered(
+            packet_header,
+            packet_payload,
+            max_frame_size,
+            [&encoded](RpcFrame& frame) {
+              // Payload bytes are passed through without being copied.
+              EXPECT_GE(frame.payload.data(), encoded.payload.data());
+              EXPECT_LE(frame.payload.data() + frame.payload.size(),
+                        encoded.payload.data() + encoded.payload.size());
+              CopyFrame(frame, encoded.bytes);
+              return OkStatus();
+            }),
+        OkStatus());
+
+    SimpleRpcPacketDecoder<kMaxPacketSize> decoder;
+
+    ASSERT_EQ(decoder.Decode(encoded.bytes,
+                             [&decoded](ConstByteSpan packet) {
+                               std::copy(packet.begin(),
+                                         packet.end(),
+                                         std::back_inserter(decoded));
+                             }),
+              OkStatus());
+
+    ASSERT_EQ(decoded.size(), src.size());
+    EXPECT_TRUE(std::equal(src.begin(), src.end(), decoded.begin()));
+  }
+}
+
+TEST(SimpleRpcFrameEncodeDecodeTest, EncodeGatheredHeaderLargerThanFrame) {
+  std::array<std::byte, 8> packet_header{};
+  std::array<std::byte, 8> packet_payload{};
+
+  SimpleRpcPacketEncoder<kMaxPacketSize> encoder;
+  EXPECT_EQ(encoder.EncodeGathered(
+                packet_header,
+                packet_payload,
+                /*max_frame_size=*/SimpleRpcPacketEncoder<
+                    kMaxPacketSize>::kHeaderSize +
+                    packet_header.size() - 1,
+                [](RpcFrame&) { return OkStatus(); }),
+            Status::Unimplemented());
+}
+
 TEST(SimpleRpcFrameEncodeDecodeTest, OneByteAtTimeDecoding) {
   for (auto test_case : kTestCases) {
     const size_t packet_size = test_case.packet_size;
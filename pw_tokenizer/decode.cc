@@ -90,6 +90,40 @@ std::string ErrorMessage(ArgStatus status,
   return result;
 }
 
+PW_MODIFY_DIAGNOSTICS_PUSH();
+PW_MODIFY_DIAGNOSTIC(ignored, "-Wformat-nonliteral");
+
+// Appends a value formatted with snprintf to the output. Returns false and
+// leaves the output unchanged if formatting fails.
+template <typename ArgumentType>
+bool AppendFormatted(std::string& output,
+                     const char* format,
+                     ArgumentType value) {
+  // Most arguments are short, so print into some extra space at the end of the
+  // output first, and only call snprintf again if that was too small.
+  constexpr size_t kInitialSpace = 32;
+
+  const size_t start = output.size();
+  output.resize(start + kInitialSpace);
+  const int value_size =
+      std::snprintf(output.data() + start, kInitialSpace, format, value);
+
+  if (value_size < 0) {
+    output.resize(start);
+    return false;
+  }
+
+  if (static_cast<size_t>(value_size) >= kInitialSpace) {
+    output.resize(start + value_size + 1);
+    std::snprintf(output.data() + start, value_size + 1, format, value);
+  }
+
+  output.resize(start + value_size);
+  return true;
+}
+
+PW_MODIFY_DIAGNOSTICS_POP();
+
 }  // namespace
 
 DecodedArg::DecodedArg(ArgStatus error,
@@ -147,7 +181,7 @@ StringSegment StringSegment::ParseFormatSpec(const char* format) {
     return StringSegment();
   }
 
-  return {std::string_view(format, i + 1), type, VarargSize(length, spec)};
+  return {0, i + 1, type, VarargSize(length, spec)};
 }
 
 StringSegment::ArgSize StringSegment::VarargSize(std::array<char, 2> length,
@@ -172,9 +206,9 @@ StringSegment::ArgSize StringSegment::VarargSize(std::array<char, 2> length,
 }
 
 DecodedArg StringSegment::DecodeString(
-    const span<const uint8_t>& arguments) const {
+    const char* buffer, const span<const uint8_t>& arguments) const {
   if (arguments.empty()) {
-    return DecodedArg(ArgStatus::kMissing, text_);
+    return DecodedArg(ArgStatus::kMissing, text(buffer));
   }
 
   ArgStatus status =
@@ -187,7 +221,7 @@ DecodedArg StringSegment::DecodeString(
     span<const uint8_t> arg_val = arguments.subspan(1);
     return DecodedArg(
         status,
-        text_,
+        text(buffer),
         arguments.size(),
         {reinterpret_cast<const char*>(arg_val.data()), arg_val.size()});
   }
@@ -198,13 +232,13 @@ DecodedArg StringSegment::DecodeString(
     value.append("[...]");
   }
 
-  return DecodedArg::FromValue(text_.c_str(), value.c_str(), 1 + size, status);
+  return DecodedArg::FromValue(spec(buffer), value.c_str(), 1 + size, status);
 }
 
 DecodedArg StringSegment::DecodeInteger(
-    const span<const uint8_t>& arguments) const {
+    const char* buffer, const span<const uint8_t>& arguments) const {
   if (arguments.empty()) {
-    return DecodedArg(ArgStatus::kMissing, text_);
+    return DecodedArg(ArgStatus::kMissing, text(buffer));
   }
 
   int64_t value;
@@ -212,7 +246,7 @@ DecodedArg StringSegment::DecodeInteger(
 
   if (bytes == 0u) {
     return DecodedArg(ArgStatus::kDecodeError,
-                      text_,
+                      text(buffer),
                       std::min(varint::kMaxVarint64SizeBytes,
                                static_cast<size_t>(arguments.size())));
   }
@@ -224,46 +258,47 @@ DecodedArg StringSegment::DecodeInteger(
 
   if (local_size_ == k32Bit) {
     return DecodedArg::FromValue(
-        text_.c_str(), static_cast<uint32_t>(value), bytes);
+        spec(buffer), static_cast<uint32_t>(value), bytes);
   }
-  return DecodedArg::FromValue(text_.c_str(), value, bytes);
+  return DecodedArg::FromValue(spec(buffer), value, bytes);
 }
 
 DecodedArg StringSegment::DecodeFloatingPoint(
-    const span<const uint8_t>& arguments) const {
+    const char* buffer, const span<const uint8_t>& arguments) const {
   static_assert(sizeof(float) == 4u);
   if (arguments.size() < sizeof(float)) {
-    return DecodedArg(ArgStatus::kMissing, text_);
+    return DecodedArg(ArgStatus::kMissing, text(buffer));
   }
 
   float value;
   std::memcpy(&value, arguments.data(), sizeof(value));
-  return DecodedArg::FromValue(text_.c_str(), value, sizeof(value));
+  return DecodedArg::FromValue(spec(buffer), value, sizeof(value));
 }
 
-DecodedArg StringSegment::Decode(const span<const uint8_t>& arguments) const {
+DecodedArg StringSegment::Decode(const char* buffer,
+                                 const span<const uint8_t>& arguments) const {
   switch (type_) {
     case kLiteral:
-      return DecodedArg(text_);
+      return DecodedArg(text(buffer));
     case kPercent:
       return DecodedArg("%");
     case kString:
-      return DecodeString(arguments);
+      return DecodeString(buffer, arguments);
     case kSignedInt:
     case kUnsigned32:
     case kUnsigned64:
-      return DecodeInteger(arguments);
+      return DecodeInteger(buffer, arguments);
     case kFloatingPoint:
-      return DecodeFloatingPoint(arguments);
+      return DecodeFloatingPoint(buffer, arguments);
   }
 
-  return DecodedArg(ArgStatus::kDecodeError, text_);
+  return DecodedArg(ArgStatus::kDecodeError, text(buffer));
 }
 
-DecodedArg StringSegment::Skip() const {
+DecodedArg StringSegment::Skip(const char* buffer) const {
   switch (type_) {
     case kLiteral:
-      return DecodedArg(text_);
+      return DecodedArg(text(buffer));
     case kPercent:
       return DecodedArg("%");
     case kString:
@@ -272,8 +307,147 @@ DecodedArg StringSegment::Skip() const {
     case kUnsigned64:
     case kFloatingPoint:
     default:
-      return DecodedArg(ArgStatus::kSkipped, text_);
+      return DecodedArg(ArgStatus::kSkipped, text(buffer));
+  }
+}
+
+ArgStatus StringSegment::AppendString(const char* buffer,
+                                      const span<const uint8_t>& arguments,
+                                      std::string& output,
+                                      size_t& raw_size_bytes) const {
+  raw_size_bytes = 0;
+  if (arguments.empty()) {
+    output.append(text(buffer));
+    return ArgStatus::kMissing;
+  }
+
+  ArgStatus status =
+      (arguments[0] & 0x80u) == 0u ? ArgStatus::kOk : ArgStatus::kTruncated;
+
+  const uint_fast8_t size = arguments[0] & 0x7Fu;
+
+  if (arguments.size() - 1 < size) {
+    status.Update(ArgStatus::kDecodeError);
+    raw_size_bytes = arguments.size();
+    output.append(text(buffer));
+    return status;
+  }
+
+  // The string is at most 127 bytes, so copy it to the stack to null terminate
+  // it, along with the truncation marker.
+  constexpr std::string_view kTruncated = "[...]";
+  std::array<char, 0x7F + kTruncated.size() + 1> value;
+  std::memcpy(value.data(), arguments.data() + 1, size);
+  size_t value_size = size;
+
+  if (status.HasError(ArgStatus::kTruncated)) {
+    std::memcpy(value.data() + size, kTruncated.data(), kTruncated.size());
+    value_size += kTruncated.size();
+  }
+  value[value_size] = '\0';
+
+  raw_size_bytes = 1 + size;
+  if (!AppendFormatted(output, spec(buffer), value.data())) {
+    output.append(text(buffer));
+    status.Update(ArgStatus::kDecodeError);
   }
+  return status;
+}
+
+ArgStatus StringSegment::AppendInteger(const char* buffer,
+                                       const span<const uint8_t>& arguments,
+                                       std::string& output,
+                                       size_t& raw_size_bytes) const {
+  raw_size_bytes = 0;
+  if (arguments.empty()) {
+    output.append(text(buffer));
+    return ArgStatus::kMissing;
+  }
+
+  int64_t value;
+  const size_t bytes = varint::Decode(as_bytes(arguments), &value);
+
+  if (bytes == 0u) {
+    raw_size_bytes = std::min(varint::kMaxVarint64SizeBytes,
+                              static_cast<size_t>(arguments.size()));
+    output.append(text(buffer));
+    return ArgStatus::kDecodeError;
+  }
+
+  // Unsigned ints need to be masked to their bit width due to sign extension.
+  if (type_ == kUnsigned32) {
+    value &= 0xFFFFFFFFu;
+  }
+
+  raw_size_bytes = bytes;
+  const bool formatted =
+      local_size_ == k32Bit
+          ? AppendFormatted(output, spec(buffer), static_cast<uint32_t>(value))
+          : AppendFormatted(output, spec(buffer), value);
+  if (!formatted) {
+    output.append(text(buffer));
+    return ArgStatus::kDecodeError;
+  }
+  return ArgStatus::kOk;
+}
+
+ArgStatus StringSegment::AppendFloatingPoint(
+    const char* buffer,
+    const span<const uint8_t>& arguments,
+    std::string& output,
+    size_t& raw_size_bytes) const {
+  raw_size_bytes = 0;
+  if (arguments.size() < sizeof(float)) {
+    output.append(text(buffer));
+    return ArgStatus::kMissing;
+  }
+
+  float value;
+  std::memcpy(&value, arguments.data(), sizeof(value));
+  raw_size_bytes = sizeof(value);
+  if (!AppendFormatted(output, spec(buffer), value)) {
+    output.append(text(buffer));
+    return ArgStatus::kDecodeError;
+  }
+  return ArgStatus::kOk;
+}
+
+ArgStatus StringSegment::AppendTo(const char* buffer,
+                                  const span<const uint8_t>& arguments,
+                                  std::string& output,
+                                  size_t& raw_size_bytes) const {
+  switch (type_) {
+    case kLiteral:
+      raw_size_bytes = 0;
+      output.append(text(buffer));
+      return ArgStatus::kOk;
+    case kPercent:
+      raw_size_bytes = 0;
+      output.push_back('%');
+      return ArgStatus::kOk;
+    case kString:
+      return AppendString(buffer, arguments, output, raw_size_bytes);
+    case kSignedInt:
+    case kUnsigned32:
+    case kUnsigned64:
+      return AppendInteger(buffer, arguments, output, raw_size_bytes);
+    case kFloatingPoint:
+      return AppendFloatingPoint(buffer, arguments, output, raw_size_bytes);
+  }
+
+  raw_size_bytes = 0;
+  output.append(text(buffer));
+  return ArgStatus::kDecodeError;
+}
+
+ArgStatus StringSegment::AppendSkippedTo(const char* buffer,
+                                         std::string& output) const {
+  if (type_ == kPercent) {
+    output.push_back('%');
+    return ArgStatus::kOk;
+  }
+  output.append(text(buffer));
+  return type_ == kLiteral ? ArgStatus::kOk : ArgStatus::kSkipped;
 }
 
 std::string DecodedFormatString::value() const {
@@ -316,35 +490,51 @@ FormatString::FormatString(const char* format) {
         !spec.empty()) {
       // Add the text segment seen so far (if any).
       if (text_start < format) {
-        segments_.emplace_back(
-            std::string_view(text_start, format - text_start));
+        const std::string_view text(text_start, format - text_start);
+        AddSegment(text, StringSegment(0, text.size()));
       }
 
-      // Move along the index and text segment start.
-      format += spec.text().size();
+      // Add the format specifier that was just found, and move along the index
+      // and text segment start.
+      AddSegment(std::string_view(format, spec.size()), spec);
+      format += spec.size();
       text_start = format;
-
-      // Add the format specifier that was just found.
-      segments_.push_back(std::move(spec));
     } else {
       format += 1;
     }
   }
 
   if (text_start < format) {
-    segments_.emplace_back(std::string_view(text_start, format - text_start));
+    const std::string_view text(text_start, format - text_start);
+    AddSegment(text, StringSegment(0, text.size()));
   }
 }
 
+void FormatString::AddSegment(std::string_view text, StringSegment segment) {
+  segment.set_offset(buffer_.size());
+  buffer_.append(text);
+  buffer_.push_back('\0');
+  segments_.push_back(segment);
+}
+
+std::string FormatString::value() const {
+  std::string output;
+  for (const StringSegment& segment : segments_) {
+    output.append(segment.text(buffer_.c_str()));
+  }
+  return output;
+}
+
 DecodedFormatString FormatString::Format(span<const uint8_t> arguments) const {
   std::vector<DecodedArg> results;
+  results.reserve(segments_.size());
   bool skip = false;
 
   for (const auto& segment : segments_) {
     if (skip) {
-      results.push_back(segment.Skip());
+      results.push_back(segment.Skip(buffer_.c_str()));
     } else {
-      results.push_back(segment.Decode(arguments));
+      results.push_back(segment.Decode(buffer_.c_str(), arguments));
       arguments = arguments.subspan(results.back().raw_size_bytes());
 
       // If an error occurred, skip decoding the remaining arguments.
@@ -357,4 +547,35 @@ DecodedFormatString FormatString::Format(span<const uint8_t> arguments) const {
   return DecodedFormatString(std::move(results), arguments.size());
 }
 
+FormatResult FormatString::FormatTo(span<const uint8_t> arguments,
+                                    std::string& output) const {
+  FormatResult result;
+  bool skip = false;
+
+  for (const auto& segment : segments_) {
+    ArgStatus status;
+    if (skip) {
+      status = segment.AppendSkippedTo(buffer_.c_str(), output);
+    } else {
+      size_t raw_size_bytes;
+      status =
+          segment.AppendTo(buffer_.c_str(), arguments, output, raw_size_bytes);
+      arguments = arguments.subspan(raw_size_bytes);
+
+      // If an error occurred, skip decoding the remaining arguments.
+      skip = !status.ok();
+    }
+
+    if (segment.is_argument()) {
+      result.argument_count_ += 1;
+    }
+    if (!status.ok()) {
+      result.decoding_errors_ += 1;
+    }
+  }
+
+  result.remaining_bytes_ = arguments.size();
+  return result;
+}
+
 }  // namespace pw::tokenizer
@@ -77,6 +77,81 @@ TEST(TokenizedStringDecode, TokenizedStringDecodingTestCases) {
   }
 }
 
+// Checks that FormatTo produces the same string and statistics as Format.
+void ExpectFormatToMatchesFormat(const char* format, std::string_view args) {
+  const FormatString format_string(format);
+  const DecodedFormatString decoded = format_string.Format(args);
+
+  std::string output = "existing";
+  const FormatResult result = format_string.FormatTo(
+      span(reinterpret_cast<const uint8_t*>(args.data()), args.size()),
+      output);
+
+  ASSERT_EQ(output, "existing" + decoded.value());
+  ASSERT_EQ(result.ok(), decoded.ok());
+  ASSERT_EQ(result.remaining_bytes(), decoded.remaining_bytes());
+  ASSERT_EQ(result.argument_count(), decoded.argument_count());
+  ASSERT_EQ(result.decoding_errors(), decoded.decoding_errors());
+}
+
+TEST(TokenizedStringDecode, FormatTo_TokenizedStringDecodingTestCases) {
+  for (const auto& [format, expected, args] :
+       test::tokenized_string_decoding::kTestData) {
+    static_cast<void>(expected);
+    if (FormatIsSupported(format)) {
+      ExpectFormatToMatchesFormat(format, args);
+    }
+  }
+}
+
+TEST(TokenizedStringDecode, FormatTo_VarintDecodeTestCases) {
+  for (const auto& [d_fmt, d_expected, u_fmt, u_expected, data] :
+       test::varint_decoding::kTestData) {
+    static_cast<void>(d_expected);
+    static_cast<void>(u_expected);
+    if (FormatIsSupported(d_fmt)) {
+      ExpectFormatToMatchesFormat(d_fmt, data);
+      ExpectFormatToMatchesFormat(u_fmt, data);
+    }
+  }
+}
+
+TEST(TokenizedStringDecode, FormatTo_LongValues) {
+  ExpectFormatToMatchesFormat("%s!", "\x7f" + std::string(0x7f, 'x'));
+  ExpectFormatToMatchesFormat("%s!", "\xff" + std::string(0x7f, 'x'));
+  ExpectFormatToMatchesFormat("%64d", "\x01");
+  ExpectFormatToMatchesFormat("%-64s|", "\x03" "abc");
+}
+
+TEST(TokenizedStringDecode, FormatTo_Errors) {
+  ExpectFormatToMatchesFormat("The %d %s", "\x80");
+  ExpectFormatToMatchesFormat("The %d %s", "\6\x0amusketeer");
+  ExpectFormatToMatchesFormat("The %d %s", "");
+  ExpectFormatToMatchesFormat("%d%% of %f", "\x02\x01");
+  ExpectFormatToMatchesFormat("Hello %s", "\5helloworld");
+}
+
+TEST(TokenizedStringDecode, Value_MatchesOriginalFormatString) {
+  for (const char* format : {"",
+                             "Hello %s",
+                             "%d%% of %f",
+                             "No arguments",
+                             "%-5.3llx%%%c literal % %z %",
+                             "Trailing text after %u is kept"}) {
+    EXPECT_EQ(FormatString(format).value(), format);
+  }
+}
+
+TEST(TokenizedStringDecode, CopiedFormatString_FormatsTheSame) {
+  FormatString copy("This is replaced");
+  {
+    const FormatString original("The %d %s");
+    copy = original;
+  }
+  EXPECT_EQ(copy.Format("\6\x0amusketeers").value(), "The 3 musketeers");
+  EXPECT_EQ(copy.value(), "The %d %s");
+}
+
 TEST(TokenizedStringDecode, FullyDecodeInput_ZeroRemainingBytes) {
   auto result = kOneArg.Format("\5hello");
   EXPECT_EQ(result.value(), "Hello hello");
@@ -15,8 +15,11 @@
 #include "pw_tokenizer/detokenize.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <cctype>
 #include <cstring>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -115,13 +118,17 @@ std::string UnknownTokenMessage(uint32_t value) {
   return output;
 }
 
-// Decoding result with the date removed, for sorting.
-using DecodingResult = std::pair<DecodedFormatString, uint32_t>;
+// Decoding result with the date removed, for sorting. The result is a
+// DecodedFormatString or a FormatResult.
+template <typename Result>
+using DecodingResult = std::pair<Result, uint32_t>;
 
 // Determines if one result is better than the other if collisions occurred.
 // Returns true if lhs is preferred over rhs. This logic should match the
 // collision resolution logic in detokenize.py.
-bool IsBetterResult(const DecodingResult& lhs, const DecodingResult& rhs) {
+template <typename Result>
+bool IsBetterResult(const DecodingResult<Result>& lhs,
+                    const DecodingResult<Result>& rhs) {
   // Favor the result for which decoding succeeded.
   if (lhs.first.ok() != rhs.first.ok()) {
     return lhs.first.ok();
@@ -165,21 +172,109 @@ constexpr bool IsPrintableAscii(std::string_view data) {
 
 }  // namespace
 
+// A fixed-size, insert-only hash table of the parsed format strings for tokens
+// in a mapped database. Entries are never removed or replaced, so the returned
+// entries remain valid for the lifetime of the cache. Slots are claimed with a
+// compare-and-swap, so a mapped Detokenizer can be used from multiple threads
+// without a lock, like a Detokenizer with a hash table.
+//
+// Tokens are already hashes, so the low bits of a token select its slot. When
+// all of the slots a token may occupy are taken, the token is not cached.
+class Detokenizer::FormatCache {
+ public:
+  FormatCache() = default;
+
+  FormatCache(const FormatCache&) = delete;
+  FormatCache& operator=(const FormatCache&) = delete;
+
+  ~FormatCache() {
+    for (std::atomic<Entry*>& slot : slots_) {
+      delete slot.load(std::memory_order_relaxed);
+    }
+  }
+
+  // Returns the cached entries for a token, or nullptr if it is not cached.
+  const std::vector<TokenizedStringEntry>* Find(uint32_t token) const {
+    for (size_t i = 0; i < kMaxProbes; ++i) {
+      const Entry* entry =
+          slots_[Slot(token, i)].load(std::memory_order_acquire);
+      if (entry == nullptr) {
+        return nullptr;
+      }
+      if (entry->token == token) {
+        return &entry->entries;
+      }
+    }
+    return nullptr;
+  }
+
+  // Caches the entries for a token, and returns the cached entries. If another
+  // thread cached the token first, returns its entries instead. If the token
+  // cannot be cached, returns nullptr and leaves entries unmodified.
+  const std::vector<TokenizedStringEntry>* Insert(
+      uint32_t token, std::vector<TokenizedStringEntry>& entries) {
+    auto new_entry = std::make_unique<Entry>(Entry{token, {}});
+
+    for (size_t i = 0; i < kMaxProbes; ++i) {
+      std::atomic<Entry*>& slot = slots_[Slot(token, i)];
+      Entry* entry = slot.load(std::memory_order_acquire);
+
+      if (entry == nullptr) {
+        new_entry->entries = std::move(entries);
+        if (slot.compare_exchange_strong(entry,
+                                         new_entry.get(),
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+          return &new_entry.release()->entries;
+        }
+        entries = std::move(new_entry->entries);
+        // Another thread claimed the slot; entry now holds its Entry.
+      }
+
+      if (entry->token == token) {
+        return &entry->entries;
+      }
+    }
+    return nullptr;
+  }
+
+ private:
+  // The number of slots. Replayed logs are dominated by a few hundred tokens,
+  // so this is enough to cache them with room to spare.
+  static constexpr size_t kSlots = 1024;
+
+  // How many slots to try for a token before giving up.
+  static constexpr size_t kMaxProbes = 16;
+
+  struct Entry {
+    uint32_t token;
+    std::vector<TokenizedStringEntry> entries;
+  };
+
+  static constexpr size_t Slot(uint32_t token, size_t probe) {
+    return (token + probe) % kSlots;
+  }
+
+  std::array<std::atomic<Entry*>, kSlots> slots_{};
+};
+
 DetokenizedString::DetokenizedString(
     uint32_t token,
     const span<const TokenizedStringEntry>& entries,
     const span<const std::byte>& arguments)
     : token_(token), has_token_(true) {
-  std::vector<DecodingResult> results;
+  std::vector<DecodingResult<DecodedFormatString>> results;
 
   for (const auto& [format, date_removed] : entries) {
-    results.push_back(DecodingResult{
+    results.push_back(DecodingResult<DecodedFormatString>{
         format.Format(span(reinterpret_cast<const uint8_t*>(arguments.data()),
                            arguments.size())),
         date_removed});
   }
 
-  std::sort(results.begin(), results.end(), IsBetterResult);
+  std::sort(results.begin(),
+            results.end(),
+            IsBetterResult<DecodedFormatString>);
 
   for (auto& result : results) {
     matches_.push_back(std::move(result.first));
@@ -199,11 +294,20 @@ std::string DetokenizedString::BestStringWithErrors() const {
 }
 
 Detokenizer::Detokenizer(const TokenDatabase& database) {
+  database_.reserve(database.size());
   for (const auto& entry : database) {
     database_[entry.token].emplace_back(entry.string, entry.date_removed);
   }
 }
 
+Detokenizer Detokenizer::FromMappedDatabase(const TokenDatabase& database) {
+  Detokenizer detokenizer(
+      std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>>{});
+  detokenizer.mapped_database_ = database;
+  detokenizer.format_cache_ = std::make_shared<FormatCache>();
+  return detokenizer;
+}
+
 Result<Detokenizer> Detokenizer::FromElfSection(
     span<const std::byte> elf_section) {
   size_t index = 0;
@@ -244,14 +348,93 @@ DetokenizedString Detokenizer::Detokenize(
   uint32_t token = bytes::ReadInOrder<uint32_t>(
       endian::little, encoded.data(), encoded.size());
 
+  const span<const std::byte> arguments = encoded.size() < sizeof(token)
+                                              ? span<const std::byte>()
+                                              : encoded.subspan(sizeof(token));
+
+  std::vector<TokenizedStringEntry> mapped_entries;
+  return DetokenizedString(token, Lookup(token, mapped_entries), arguments);
+}
+
+void Detokenizer::DetokenizeBatch(span<const span<const std::byte>> messages,
+                                  DetokenizedBatch& batch) const {
+  batch.ends_.reserve(batch.ends_.size() + messages.size());
+  for (const span<const std::byte>& message : messages) {
+    AppendDetokenized(message, batch);
+  }
+}
+
+void Detokenizer::AppendDetokenized(span<const std::byte> message,
+                                    DetokenizedBatch& batch) const {
+  AppendBestString(message, batch.buffer_);
+  batch.ends_.push_back(batch.buffer_.size());
+}
+
+span<const TokenizedStringEntry> Detokenizer::Lookup(
+    uint32_t token, std::vector<TokenizedStringEntry>& mapped_entries) const {
+  if (mapped_database_.ok()) {
+    if (const auto* cached = format_cache_->Find(token); cached != nullptr) {
+      return *cached;
+    }
+
+    for (const auto& entry : mapped_database_.Find(token)) {
+      mapped_entries.emplace_back(entry.string, entry.date_removed);
+    }
+
+    // Only cache tokens that are in the database, so that corrupt or unknown
+    // tokens do not fill the cache.
+    if (!mapped_entries.empty()) {
+      if (const auto* cached = format_cache_->Insert(token, mapped_entries);
+          cached != nullptr) {
+        return *cached;
+      }
+    }
+    return mapped_entries;
+  }
+
   const auto result = database_.find(token);
+  return result == database_.end() ? span<const TokenizedStringEntry>()
+                                   : span(result->second);
+}
 
-  return DetokenizedString(
-      token,
-      result == database_.end() ? span<TokenizedStringEntry>()
-                                : span(result->second),
-      encoded.size() < sizeof(token) ? span<const std::byte>()
-                                     : encoded.subspan(sizeof(token)));
+void Detokenizer::AppendBestString(span<const std::byte> encoded,
+                                   std::string& output) const {
+  // The token is missing from the encoded data; there is nothing to do.
+  if (encoded.empty()) {
+    return;
+  }
+
+  const uint32_t token = bytes::ReadInOrder<uint32_t>(
+      endian::little, encoded.data(), encoded.size());
+
+  const span<const uint8_t> arguments =
+      encoded.size() < sizeof(token)
+          ? span<const uint8_t>()
+          : span(reinterpret_cast<const uint8_t*>(encoded.data()),
+                 encoded.size())
+                .subspan(sizeof(token));
+
+  std::vector<TokenizedStringEntry> mapped_entries;
+  const span<const TokenizedStringEntry> entries =
+      Lookup(token, mapped_entries);
+
+  // Format each candidate after the best one so far, and keep whichever is
+  // better, so that only the best string remains in the output.
+  const size_t start = output.size();
+  std::optional<DecodingResult<FormatResult>> best;
+
+  for (const auto& [format, date_removed] : entries) {
+    const size_t candidate_start = output.size();
+    DecodingResult<FormatResult> result(format.FormatTo(arguments, output),
+                                        date_removed);
+
+    if (!best.has_value() || IsBetterResult(result, *best)) {
+      output.erase(start, candidate_start - start);
+      best = result;
+    } else {
+      output.resize(candidate_start);
+    }
+  }
 }
 
 DetokenizedString Detokenizer::DetokenizeBase64Message(
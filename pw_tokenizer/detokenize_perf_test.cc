@@ -0,0 +1,106 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+#include "pw_tokenizer/detokenize.h"
+#include "pw_tokenizer/token_database.h"
+
+namespace pw::tokenizer {
+namespace {
+
+using namespace std::literals::string_view_literals;
+
+constexpr char kDatabase[] =
+    "TOKENS\0\0"
+    "\x04\x00\x00\x00"
+    "\0\0\0\0"
+    "\x01\x00\x00\x00----"
+    "\x02\x00\x00\x00----"
+    "\x03\x00\x00\x00----"
+    "\x04\x00\x00\x00----"
+    "Battery at %d%%\0"
+    "Connected to %s on channel %u\0"
+    "Sensor %s read %f after %d retries\0"
+    "Heartbeat\0";
+
+// A log stream with a mix of messages with and without arguments.
+constexpr std::array kMessages = {
+    "\x01\x00\x00\x00\xb4\x01"sv,
+    "\x02\x00\x00\x00\x08pw-guest\x16"sv,
+    "\x03\x00\x00\x00\x04temp\x00\x00\xc8\x41\x06"sv,
+    "\x04\x00\x00\x00"sv,
+    "\x01\x00\x00\x00\x0e"sv,
+    "\x03\x00\x00\x00\x08humidity\x66\x66\x46\x42\x00"sv,
+    "\x02\x00\x00\x00\x0bupstream-ap\x02"sv,
+    "\x04\x00\x00\x00"sv,
+};
+
+std::array<span<const std::byte>, kMessages.size()> messages;
+
+// Sets up the spans for the messages to detokenize.
+void SetUpMessages() {
+  for (size_t i = 0; i < kMessages.size(); ++i) {
+    messages[i] = as_bytes(span(kMessages[i]));
+  }
+  PW_LOG_INFO("Detokenizing %u messages per iteration",
+              static_cast<unsigned>(messages.size()));
+}
+
+// Measures how long it takes to detokenize each message into a std::string
+// with Detokenize().BestString().
+void DetokenizeEach(perf_test::State& state) {
+  const Detokenizer detokenizer(TokenDatabase::Create<kDatabase>());
+  SetUpMessages();
+
+  size_t total_size = 0;
+  while (state.KeepRunning()) {
+    total_size = 0;
+    for (span<const std::byte> message : messages) {
+      total_size += detokenizer.Detokenize(message).BestString().size();
+    }
+  }
+  PW_CHECK_UINT_NE(total_size, 0);
+}
+
+// Measures how long it takes to detokenize the messages into a reused
+// DetokenizedBatch.
+void DetokenizeBatch(perf_test::State& state, bool mapped) {
+  const TokenDatabase database = TokenDatabase::Create<kDatabase>();
+  const Detokenizer detokenizer =
+      mapped ? Detokenizer::FromMappedDatabase(database) : Detokenizer(database);
+  SetUpMessages();
+
+  DetokenizedBatch batch;
+  while (state.KeepRunning()) {
+    batch.clear();
+    detokenizer.DetokenizeBatch(messages, batch);
+  }
+  PW_CHECK_UINT_EQ(batch.size(), messages.size());
+  PW_CHECK(batch[0] == "Battery at 90%");
+}
+
+PW_PERF_TEST(DetokenizeEachMessage, DetokenizeEach);
+PW_PERF_TEST(DetokenizeMessageBatch, DetokenizeBatch, false);
+PW_PERF_TEST(DetokenizeMappedMessageBatch, DetokenizeBatch, true);
+
+}  // namespace
+}  // namespace pw::tokenizer
@@ -14,6 +14,7 @@
 
 #include "pw_tokenizer/detokenize.h"
 
+#include <array>
 #include <string_view>
 
 #include "pw_tokenizer/example_binary_with_tokenized_strings.h"
@@ -276,6 +277,56 @@ TEST_F(DetokenizeWithArgs, DecodingError) {
             "Now there are " ERR("%d ERROR") " of " ERR("%s SKIPPED") "!");
 }
 
+TEST_F(DetokenizeWithArgs, Batch) {
+  constexpr std::array kMessages = {
+      "\x0A\x0B\x0C\x0D\5force\4Luke"sv,
+      "\x0E\x0F\x00\x01\4\4them"sv,
+      ""sv,
+      "\x23\xab\xc9\x87"sv,
+      "\xAA\xAA\xAA\xAA\xfc\x01"sv,
+      "\x0A\x0B\x0C\x0D\5force"sv,
+      "\x0E\x0F\x00\x01\xFF"sv,
+      "\xDD\xDD\xDD\xDD\xfe\xff\xff\xff\x1f"sv,
+  };
+  std::array<span<const std::byte>, kMessages.size()> messages;
+  for (size_t i = 0; i < kMessages.size(); ++i) {
+    messages[i] = as_bytes(span(kMessages[i]));
+  }
+
+  DetokenizedBatch batch;
+  detok_.DetokenizeBatch(messages, batch);
+
+  ASSERT_EQ(batch.size(), kMessages.size());
+  for (size_t i = 0; i < kMessages.size(); ++i) {
+    EXPECT_EQ(batch[i], detok_.Detokenize(kMessages[i]).BestString());
+  }
+  EXPECT_EQ(batch[0], "Use the force, Luke.");
+  EXPECT_EQ(batch[2], "");
+  EXPECT_EQ(batch[3], "");
+  EXPECT_EQ(batch[5], "Use the force, %s.");
+}
+
+TEST_F(DetokenizeWithArgs, Batch_AppendAndClear) {
+  DetokenizedBatch batch;
+  EXPECT_TRUE(batch.empty());
+
+  detok_.AppendDetokenized(as_bytes(span("\x0E\x0F\x00\x01\4\4them"sv)),
+                           batch);
+  detok_.AppendDetokenized(as_bytes(span("\xAA\xAA\xAA\xAA\xfc\x01"sv)),
+                           batch);
+  ASSERT_EQ(batch.size(), 2u);
+  EXPECT_EQ(batch[0], "Now there are 2 of them!");
+  EXPECT_EQ(batch[1], "~!");
+
+  batch.clear();
+  EXPECT_TRUE(batch.empty());
+
+  detok_.AppendDetokenized(as_bytes(span("\xAA\xAA\xAA\xAA\xfc\x01"sv)),
+                           batch);
+  ASSERT_EQ(batch.size(), 1u);
+  EXPECT_EQ(batch[0], "~!");
+}
+
 constexpr char kDataWithCollisions[] =
     "TOKENS\0\0"
     "\x0F\x00\x00\x00"
@@ -375,5 +426,127 @@ TEST_F(DetokenizeWithCollisions, Collision_TracksAllMatches) {
   EXPECT_EQ(result.matches().size(), 7u);
 }
 
+TEST_F(DetokenizeWithCollisions, Batch_ChoosesBestResult) {
+  constexpr std::array kMessages = {
+      "\0\0\0\0"sv,
+      "\0\0\0\0\x01"sv,
+      "\0\0\0\0\x80"sv,
+      "\0\0\0\0\4Hey!\x04"sv,
+      "\0\0\0\0\x80\x80\x80\x80\x00"sv,
+      "\0\0\0\0\x08?"sv,
+      "\xBB\xBB\xBB\xBB\x00"sv,
+      "\xCC\xCC\xCC\xCC\2Yo\5?"sv,
+      "\xDD\xDD\xDD\xDD\x01\x02\x01\x04\x05"sv,
+      "\0\0\0\0\x01\x00\x01\x02"sv,
+      "\xAA\xAA\xAA\xAA"sv,
+  };
+
+  DetokenizedBatch batch;
+  for (std::string_view message : kMessages) {
+    detok_.AppendDetokenized(as_bytes(span(message)), batch);
+  }
+
+  ASSERT_EQ(batch.size(), kMessages.size());
+  for (size_t i = 0; i < kMessages.size(); ++i) {
+    EXPECT_EQ(batch[i], detok_.Detokenize(kMessages[i]).BestString());
+  }
+}
+
+// The first five entries of kTestDatabase, with a string index.
+constexpr char kIndexedTestDatabase[] =
+    "TOKENS\0\0"
+    "\x05\x00\x00\x00"  // Number of tokens in this database.
+    "\x53\x00\x00\x00"  // Offset of the string index.
+    "\x01\x00\x00\x00----"
+    "\x05\x00\x00\x00----"
+    "\xFF\x00\x00\x00----"
+    "\xFF\xEE\xEE\xDD----"
+    "\xEE\xEE\xEE\xEE----"
+    "One\0"
+    "TWO\0"
+    "333\0"
+    "FOUR\0"
+    "$AQAAAA==\0"
+    "\x00\x00\x00\x00"
+    "\x04\x00\x00\x00"
+    "\x08\x00\x00\x00"
+    "\x0C\x00\x00\x00"
+    "\x11\x00\x00\x00";
+
+constexpr TokenDatabase kIndexedTestDb =
+    TokenDatabase::Create<kIndexedTestDatabase>();
+static_assert(kIndexedTestDb.has_string_index());
+
+TEST(DetokenizeMapped, Indexed) {
+  const Detokenizer detok = Detokenizer::FromMappedDatabase(kIndexedTestDb);
+  EXPECT_EQ(detok.Detokenize("\1\0\0\0"sv).BestString(), "One");
+  EXPECT_EQ(detok.Detokenize("\5\0\0\0"sv).BestString(), "TWO");
+  EXPECT_EQ(detok.Detokenize("\xff\x00\x00\x00"sv).BestString(), "333");
+  EXPECT_EQ(detok.Detokenize("\xff\xee\xee\xdd"sv).BestString(), "FOUR");
+  EXPECT_EQ(detok.DetokenizeText(ONE TWO NEST_ONE), "OneTWOOne");
+
+  EXPECT_FALSE(detok.Detokenize("\0\0\0\0"sv).ok());
+  EXPECT_FALSE(detok.Detokenize("\2\0\0\0"sv).ok());
+  EXPECT_FALSE(detok.Detokenize("\xff\xff\xff\xff"sv).ok());
+}
+
+TEST(DetokenizeMapped, NotIndexed) {
+  const Detokenizer detok =
+      Detokenizer::FromMappedDatabase(TokenDatabase::Create<kTestDatabase>());
+  EXPECT_EQ(detok.Detokenize("\1\0\0\0"sv).BestString(), "One");
+  EXPECT_EQ(detok.Detokenize("\xff\xee\xee\xdd"sv).BestString(), "FOUR");
+  EXPECT_FALSE(detok.Detokenize("\2\0\0\0"sv).ok());
+}
+
+TEST(DetokenizeMapped, Collisions) {
+  const Detokenizer detok = Detokenizer::FromMappedDatabase(kWithCollisions);
+  EXPECT_EQ(detok.Detokenize("\0\0\0\0"sv).matches().size(), 7u);
+  EXPECT_EQ(detok.Detokenize("\0\0\0\0\4Hey!\x04"sv).BestString(),
+            "Two args Hey! 2");
+  EXPECT_EQ(detok.Detokenize("\xAA\xAA\xAA\xAA"sv).BestString(),
+            "This one is present");
+}
+
+TEST(DetokenizeMapped, Batch) {
+  const Detokenizer detok = Detokenizer::FromMappedDatabase(kIndexedTestDb);
+  DetokenizedBatch batch;
+  detok.AppendDetokenized(as_bytes(span("\5\0\0\0"sv)), batch);
+  detok.AppendDetokenized(as_bytes(span("\2\0\0\0"sv)), batch);
+  detok.AppendDetokenized(as_bytes(span("\xff\xee\xee\xdd"sv)), batch);
+
+  ASSERT_EQ(batch.size(), 3u);
+  EXPECT_EQ(batch[0], "TWO");
+  EXPECT_EQ(batch[1], "");
+  EXPECT_EQ(batch[2], "FOUR");
+}
+
+TEST(DetokenizeMapped, RepeatedLookups_UseCachedFormatStrings) {
+  const Detokenizer detok = Detokenizer::FromMappedDatabase(kWithCollisions);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(detok.Detokenize("\0\0\0\0"sv).matches().size(), 7u);
+    EXPECT_EQ(detok.Detokenize("\0\0\0\0\4Hey!\x04"sv).BestString(),
+              "Two args Hey! 2");
+    EXPECT_EQ(detok.Detokenize("\xDD\xDD\xDD\xDD\x01\x02\x01\x04\x05"sv)
+                  .BestString(),
+              "Five -1 1 -1 2 %s");
+    EXPECT_FALSE(detok.Detokenize("\x12\x34\x56\x78"sv).ok());
+  }
+}
+
+TEST(DetokenizeMapped, Copy_SharesCache) {
+  const Detokenizer detok = Detokenizer::FromMappedDatabase(kIndexedTestDb);
+  EXPECT_EQ(detok.Detokenize("\5\0\0\0"sv).BestString(), "TWO");
+
+  const Detokenizer copy(detok);
+  EXPECT_EQ(copy.Detokenize("\5\0\0\0"sv).BestString(), "TWO");
+  EXPECT_EQ(copy.Detokenize("\xff\x00\x00\x00"sv).BestString(), "333");
+  EXPECT_EQ(detok.Detokenize("\xff\x00\x00\x00"sv).BestString(), "333");
+}
+
+TEST(DetokenizeMapped, InvalidDatabase) {
+  const Detokenizer detok = Detokenizer::FromMappedDatabase(TokenDatabase());
+  EXPECT_FALSE(detok.Detokenize("\1\0\0\0"sv).ok());
+}
+
 }  // namespace
 }  // namespace pw::tokenizer
@@ -26,7 +26,9 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -77,8 +79,44 @@ class DetokenizedString {
   std::vector<DecodedFormatString> matches_;
 };
 
-/// Decodes and detokenizes from a token database. This class builds a hash
-/// table of tokens to give `O(1)` token lookups.
+/// The results of detokenizing messages with `Detokenizer::DetokenizeBatch` or
+/// `Detokenizer::AppendDetokenized`. The detokenized strings are stored
+/// back-to-back in a single buffer. Clearing the batch keeps its memory, so a
+/// batch that is reused does not allocate once it has grown to fit the
+/// messages.
+class DetokenizedBatch {
+ public:
+  DetokenizedBatch() = default;
+
+  /// The number of detokenized messages in the batch.
+  size_t size() const { return ends_.size(); }
+
+  bool empty() const { return ends_.empty(); }
+
+  /// Returns the best detokenized string for a message, as
+  /// `DetokenizedString::BestString()` would. The `string_view` is invalidated
+  /// when the batch is modified.
+  std::string_view operator[](size_t index) const {
+    const size_t start = index == 0u ? 0u : ends_[index - 1];
+    return std::string_view(buffer_).substr(start, ends_[index] - start);
+  }
+
+  /// Removes all messages from the batch, but keeps its memory.
+  void clear() {
+    buffer_.clear();
+    ends_.clear();
+  }
+
+ private:
+  friend class Detokenizer;
+
+  std::string buffer_;
+  std::vector<size_t> ends_;
+};
+
+/// Decodes and detokenizes from a token database. By default, this class builds
+/// a hash table of tokens to give `O(1)` token lookups. Alternately, it can
+/// look up tokens directly in a `TokenDatabase` (see `FromMappedDatabase`).
 class Detokenizer {
  public:
   /// Constructs a detokenizer from a `TokenDatabase`. The `TokenDatabase` is
@@ -92,6 +130,20 @@ class Detokenizer {
           database)
       : database_(std::move(database)) {}
 
+  /// Constructs a detokenizer that looks up tokens directly in a
+  /// `TokenDatabase` rather than copying it into a hash table. Construction
+  /// takes constant time and only allocates a small, fixed-size cache, which
+  /// makes this suitable for very large databases, such as a binary database
+  /// in a memory-mapped file.
+  ///
+  /// Lookups are `O(log n)` if the database has a string index and `O(n)`
+  /// otherwise, so the database should be created with a string index. The
+  /// format strings of the first tokens that are looked up are parsed once and
+  /// cached, so that frequent tokens are only looked up in the database once.
+  /// Unlike the other constructors, the database's memory is referenced by the
+  /// `Detokenizer` and must remain valid for its lifetime.
+  static Detokenizer FromMappedDatabase(const TokenDatabase& database);
+
   /// Constructs a detokenizer from the `.pw_tokenizer.entries` section of an
   /// ELF binary.
   static Result<Detokenizer> FromElfSection(span<const std::byte> elf_section);
@@ -120,6 +172,20 @@ class Detokenizer {
     return Detokenize(span(static_cast<const std::byte*>(encoded), size_bytes));
   }
 
+  /// Decodes and detokenizes a sequence of binary encoded messages, and
+  /// appends the best string for each one to `batch`. The strings are the same
+  /// as `Detokenize(message).BestString()`, but are formatted directly into the
+  /// batch's buffer, so no memory is allocated for each message. This is much
+  /// faster than `Detokenize` when decoding many messages, such as logs.
+  void DetokenizeBatch(span<const span<const std::byte>> messages,
+                       DetokenizedBatch& batch) const;
+
+  /// Detokenizes a single message and appends its best string to `batch`, as
+  /// `DetokenizeBatch` does for each message. This can be used to stream
+  /// messages into a batch.
+  void AppendDetokenized(span<const std::byte> message,
+                         DetokenizedBatch& batch) const;
+
   /// Decodes and detokenizes a Base64-encoded message. Returns a
   /// `DetokenizedString` that stores all possible detokenized string results.
   DetokenizedString DetokenizeBase64Message(std::string_view text) const;
@@ -164,7 +230,27 @@ class Detokenizer {
       const span<const std::byte>& optionally_tokenized_data);
 
  private:
+  // Returns the entries for a token. For a mapped database, entries that could
+  // not be cached are stored in mapped_entries, which must outlive the
+  // returned span.
+  span<const TokenizedStringEntry> Lookup(
+      uint32_t token, std::vector<TokenizedStringEntry>& mapped_entries) const;
+
+  // Appends the best string for a message to output.
+  void AppendBestString(span<const std::byte> encoded,
+                        std::string& output) const;
+
+  // Parsed format strings for tokens found in a mapped database.
+  class FormatCache;
+
   std::unordered_map<uint32_t, std::vector<TokenizedStringEntry>> database_;
+
+  // Set if created with FromMappedDatabase(), in which case database_ is empty.
+  TokenDatabase mapped_database_;
+
+  // The cache is shared by copies of a mapped Detokenizer, which refer to the
+  // same database.
+  std::shared_ptr<FormatCache> format_cache_;
 };
 
 /// @}
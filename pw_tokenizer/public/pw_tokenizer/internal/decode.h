@@ -17,6 +17,7 @@
 // the Detokenizer class, defined in pw_tokenizer/detokenize.h.
 #pragma once
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
@@ -86,7 +87,7 @@ class DecodedArg {
 
   // Constructs a DecodedArg that represents a string literal in the format
   // string (plain text or % character).
-  DecodedArg(const std::string& literal)
+  DecodedArg(std::string_view literal)
       : value_(literal), raw_data_size_bytes_(0) {}
 
   // Constructs a DecodedArg that encountered an error during decoding.
@@ -121,29 +122,61 @@ class DecodedArg {
 
 // Represents a segment of a printf-style format string. Each StringSegment
 // contains either literal text or a format specifier.
+//
+// To keep parsed format strings compact, a StringSegment does not store its
+// text. Instead, it refers to a range of the buffer in the FormatString that
+// owns it, and that buffer is passed to each of its functions. Each segment's
+// text is null terminated in the buffer, so format specifiers can be passed
+// directly to snprintf.
 class StringSegment {
  public:
   // Parses a format specifier from the text and returns a StringSegment that
   // represents it. Returns an empty StringSegment if no valid format specifier
-  // was found.
+  // was found. The returned segment refers to the start of the buffer.
   static StringSegment ParseFormatSpec(const char* format);
 
   // Creates a StringSegment that represents a piece of plain text.
-  StringSegment(std::string_view text) : StringSegment(text, kLiteral) {}
+  StringSegment(size_t offset, size_t size)
+      : StringSegment(offset, size, kLiteral) {}
 
   // Returns the DecodedArg with this StringSegment decoded according to the
   // provided arguments.
-  DecodedArg Decode(const span<const uint8_t>& arguments) const;
+  DecodedArg Decode(const char* buffer,
+                    const span<const uint8_t>& arguments) const;
 
   // Skips decoding this StringSegment. Literals and %% are expanded as normal.
-  DecodedArg Skip() const;
+  DecodedArg Skip(const char* buffer) const;
+
+  // Decodes this StringSegment and appends it to the output as it would appear
+  // in DecodedFormatString::value(), without creating a DecodedArg. Sets
+  // raw_size_bytes to the number of argument bytes that were decoded.
+  ArgStatus AppendTo(const char* buffer,
+                     const span<const uint8_t>& arguments,
+                     std::string& output,
+                     size_t& raw_size_bytes) const;
+
+  // Appends this StringSegment to the output as Skip() would, and returns the
+  // status Skip() would.
+  ArgStatus AppendSkippedTo(const char* buffer, std::string& output) const;
+
+  // True if this segment is a conversion specifier other than %%.
+  bool is_argument() const { return type_ != kLiteral && type_ != kPercent; }
 
-  bool empty() const { return text_.empty(); }
+  bool empty() const { return size_ == 0u; }
 
-  const std::string& text() const { return text_; }
+  // The length of this segment's text, excluding the null terminator.
+  size_t size() const { return size_; }
+
+  // Moves this segment to a different offset in the buffer.
+  void set_offset(size_t offset) { offset_ = static_cast<uint32_t>(offset); }
+
+  // Returns this segment's text from the FormatString's buffer.
+  std::string_view text(const char* buffer) const {
+    return std::string_view(buffer + offset_, size_);
+  }
 
  private:
-  enum Type {
+  enum Type : uint8_t {
     kLiteral,
     kPercent,  // %% format specifier
     kString,
@@ -163,21 +196,46 @@ class StringSegment {
 
   static ArgSize VarargSize(std::array<char, 2> length, char spec);
 
-  StringSegment() : type_(kLiteral) {}
+  StringSegment() : StringSegment(0, 0) {}
+
+  StringSegment(size_t offset, size_t size, Type type)
+      : StringSegment(offset, size, type, VarargSize<void*>()) {}
 
-  StringSegment(std::string_view text, Type type)
-      : StringSegment(text, type, VarargSize<void*>()) {}
+  StringSegment(size_t offset, size_t size, Type type, ArgSize local_size)
+      : offset_(static_cast<uint32_t>(offset)),
+        size_(static_cast<uint32_t>(size)),
+        type_(type),
+        local_size_(local_size) {}
 
-  StringSegment(std::string_view text, Type type, ArgSize local_size)
-      : text_(text), type_(type), local_size_(local_size) {}
+  // Returns the null-terminated format specifier to pass to snprintf.
+  const char* spec(const char* buffer) const { return buffer + offset_; }
 
-  DecodedArg DecodeString(const span<const uint8_t>& arguments) const;
+  DecodedArg DecodeString(const char* buffer,
+                          const span<const uint8_t>& arguments) const;
 
-  DecodedArg DecodeInteger(const span<const uint8_t>& arguments) const;
+  DecodedArg DecodeInteger(const char* buffer,
+                           const span<const uint8_t>& arguments) const;
 
-  DecodedArg DecodeFloatingPoint(const span<const uint8_t>& arguments) const;
+  DecodedArg DecodeFloatingPoint(const char* buffer,
+                                 const span<const uint8_t>& arguments) const;
 
-  std::string text_;
+  ArgStatus AppendString(const char* buffer,
+                         const span<const uint8_t>& arguments,
+                         std::string& output,
+                         size_t& raw_size_bytes) const;
+
+  ArgStatus AppendInteger(const char* buffer,
+                          const span<const uint8_t>& arguments,
+                          std::string& output,
+                          size_t& raw_size_bytes) const;
+
+  ArgStatus AppendFloatingPoint(const char* buffer,
+                                const span<const uint8_t>& arguments,
+                                std::string& output,
+                                size_t& raw_size_bytes) const;
+
+  uint32_t offset_;     // Start of this segment's text in the buffer.
+  uint32_t size_;       // Length of the text, excluding its null terminator.
   Type type_;
   ArgSize local_size_;  // Arg size to use for snprintf on this machine.
 };
@@ -221,8 +279,35 @@ class DecodedFormatString {
   size_t remaining_bytes_;
 };
 
-// Represents a printf-style format string. The string is stored as a vector of
-// StringSegments.
+// The outcome of decoding a tokenized message with FormatString::FormatTo.
+// Provides the same statistics as a DecodedFormatString, without the decoded
+// arguments.
+class FormatResult {
+ public:
+  constexpr FormatResult() = default;
+
+  bool ok() const { return remaining_bytes() == 0u && decoding_errors() == 0u; }
+
+  // Returns the number of bytes that remained after decoding.
+  size_t remaining_bytes() const { return remaining_bytes_; }
+
+  // Returns the number of arguments in the format string. %% is not included.
+  size_t argument_count() const { return argument_count_; }
+
+  // Returns the number of arguments that failed to decode.
+  size_t decoding_errors() const { return decoding_errors_; }
+
+ private:
+  friend class FormatString;
+
+  size_t remaining_bytes_ = 0;
+  size_t argument_count_ = 0;
+  size_t decoding_errors_ = 0;
+};
+
+// Represents a printf-style format string. The format string is parsed once,
+// when the FormatString is constructed, into a list of StringSegments. The text
+// of all segments is stored in a single buffer.
 class FormatString {
  public:
   // Constructs a FormatString from a null-terminated format string.
@@ -237,7 +322,21 @@ class FormatString {
                        arguments.size()));
   }
 
+  // Returns the original format string.
+  std::string value() const;
+
+  // Formats this format string according to the provided encoded arguments and
+  // appends the result, equivalent to Format(arguments).value(), to output.
+  // Unlike Format, this does not allocate, other than to grow output.
+  FormatResult FormatTo(span<const uint8_t> arguments,
+                        std::string& output) const;
+
  private:
+  // Copies text to the buffer with a null terminator and adds a segment for it.
+  void AddSegment(std::string_view text, StringSegment segment);
+
+  // The text of each segment, each followed by a null terminator.
+  std::string buffer_;
   std::vector<StringSegment> segments_;
 };
 
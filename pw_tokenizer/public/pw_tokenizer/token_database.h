@@ -51,7 +51,7 @@ namespace pw::tokenizer {
 ///        0     6  Magic number (``TOKENS``)
 ///        6     2  Version (``00 00``)
 ///        8     4  Entry count
-///       12     4  Reserved
+///       12     4  String index offset (0 if none)
 ///   ======  ====  =========================
 ///
 ///   ======  ====  ==================================
@@ -69,8 +69,15 @@ namespace pw::tokenizer {
 /// Entries are sorted by token. A string table with a null-terminated string
 /// for each entry in order follows the entries.
 ///
-/// Entries are accessed by iterating over the database. A O(n) `Find` function
-/// is also provided. In typical use, a `TokenDatabase` is preprocessed by a
+/// A database may optionally end with a string index: the little-endian offset
+/// of each entry's string from the start of the string table, as 4 bytes per
+/// entry in entry order. The header stores the offset of the string index from
+/// the start of the database, or 0 if there is none. Readers ignore data after
+/// the string table, so an indexed database is still a valid v0 database.
+///
+/// Entries are accessed by iterating over the database. A `Find` function is
+/// also provided, which is `O(log n)` if the database has a string index and
+/// `O(n)` otherwise. In typical use, a `TokenDatabase` is preprocessed by a
 /// `pw::tokenizer::Detokenizer` into a `std::unordered_map`.
 class TokenDatabase {
  private:
@@ -214,12 +221,14 @@ class TokenDatabase {
   };
 
   /// Returns true if the provided data is a valid token database. This checks
-  /// the magic number (`TOKENS`), version (which must be `0`), and that there
-  /// is is one string for each entry in the database. A database with extra
+  /// the magic number (`TOKENS`), version (which must be `0`), that there is
+  /// one string for each entry in the database, and that the string index,
+  /// if any, refers to strings in the string table. A database with extra
   /// strings or other trailing data is considered valid.
   template <typename ByteArray>
   static constexpr bool IsValid(const ByteArray& bytes) {
-    return HasValidHeader(bytes) && EachEntryHasAString(bytes);
+    return HasValidHeader(bytes) && EachEntryHasAString(bytes) &&
+           HasValidStringIndex(bytes);
   }
 
   /// Creates a `TokenDatabase` and checks if the provided data is valid at
@@ -241,6 +250,10 @@ class TokenDatabase {
     static_assert(EachEntryHasAString<decltype(kDatabaseBytes)>(kDatabaseBytes),
                   "The database must have at least one string for each entry.");
 
+    static_assert(HasValidStringIndex<decltype(kDatabaseBytes)>(kDatabaseBytes),
+                  "The string index must follow the string table and refer to "
+                  "a string within it for each entry.");
+
     return TokenDatabase(std::data(kDatabaseBytes));
   }
 
@@ -258,9 +271,13 @@ class TokenDatabase {
                : TokenDatabase();  // Invalid database.
   }
   /// Creates a database with no data. `ok()` returns false.
-  constexpr TokenDatabase() : begin_{.data = nullptr}, end_{.data = nullptr} {}
+  constexpr TokenDatabase()
+      : begin_{.data = nullptr},
+        end_{.data = nullptr},
+        index_{.data = nullptr} {}
 
-  /// Returns all entries associated with this token. This is `O(n)`.
+  /// Returns all entries associated with this token. This is `O(log n)` if the
+  /// database has a string index, and `O(n)` otherwise.
   Entries Find(uint32_t token) const;
 
   /// Returns the total number of entries (unique token-string pairs).
@@ -272,6 +289,9 @@ class TokenDatabase {
   /// be empty, but it has an intact header and a string for each entry.
   constexpr bool ok() const { return begin_.data != nullptr; }
 
+  /// True if this database has a string index, so `Find` can binary search.
+  constexpr bool has_string_index() const { return index_.data != nullptr; }
+
   /// Returns an iterator for the first token entry.
   constexpr iterator begin() const { return iterator(begin_.data, end_.data); }
 
@@ -283,7 +303,7 @@ class TokenDatabase {
     std::array<char, 6> magic;
     uint16_t version;
     uint32_t entry_count;
-    uint32_t reserved;
+    uint32_t string_index_offset;
   };
 
   static_assert(sizeof(Header) == 2 * sizeof(RawEntry));
@@ -326,6 +346,34 @@ class TokenDatabase {
     return string_count >= entries;
   }
 
+  template <typename ByteArray>
+  static constexpr bool HasValidStringIndex(const ByteArray& bytes) {
+    const size_type entries = ReadEntryCount(std::data(bytes));
+    const size_type index = ReadStringIndexOffset(std::data(bytes));
+
+    if (index == 0u) {
+      return true;
+    }
+
+    // The index must follow the string table, which must end with a null
+    // terminator so that every string is terminated before the index. Compare
+    // against the remaining size so that a corrupt header cannot overflow.
+    if (index <= StringTable(entries) || index > std::size(bytes) ||
+        entries > (std::size(bytes) - index) / sizeof(uint32_t) ||
+        std::data(bytes)[index - 1] != '\0') {
+      return false;
+    }
+
+    const size_type string_table_size = index - StringTable(entries);
+    for (size_type i = 0; i < entries; ++i) {
+      if (ReadUint32(std::data(bytes) + index + i * sizeof(uint32_t)) >=
+          string_table_size) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   // Reads the number of entries from a database header. Cast to the bytes to
   // uint8_t to avoid sign extension if T is signed.
   template <typename T>
@@ -334,6 +382,13 @@ class TokenDatabase {
     return ReadUint32(bytes);
   }
 
+  // Reads the offset of the string index from a database header, or 0 if the
+  // database has no string index.
+  template <typename T>
+  static constexpr uint32_t ReadStringIndexOffset(const T* header_bytes) {
+    return ReadUint32(header_bytes + offsetof(Header, string_index_offset));
+  }
+
   // Calculates the offset of the string table.
   static constexpr size_type StringTable(size_type entries) {
     return sizeof(Header) + entries * sizeof(RawEntry);
@@ -347,7 +402,10 @@ class TokenDatabase {
   template <typename Byte>
   constexpr TokenDatabase(const Byte bytes[])
       : TokenDatabase(bytes + sizeof(Header),
-                      bytes + StringTable(ReadEntryCount(bytes))) {
+                      bytes + StringTable(ReadEntryCount(bytes)),
+                      ReadStringIndexOffset(bytes) == 0u
+                          ? nullptr
+                          : bytes + ReadStringIndexOffset(bytes)) {
     static_assert(sizeof(Byte) == 1u);
   }
 
@@ -355,22 +413,36 @@ class TokenDatabase {
   // use unions. Instead of using a reinterpret_cast to change the byte pointer
   // to a RawEntry pointer, have a separate overload for each byte pointer type
   // and store them in a union.
-  constexpr TokenDatabase(const char* begin, const char* end)
-      : begin_{.data = begin}, end_{.data = end} {}
-
-  constexpr TokenDatabase(const unsigned char* begin, const unsigned char* end)
-      : begin_{.unsigned_data = begin}, end_{.unsigned_data = end} {}
-
-  constexpr TokenDatabase(const signed char* begin, const signed char* end)
-      : begin_{.signed_data = begin}, end_{.signed_data = end} {}
+  constexpr TokenDatabase(const char* begin,
+                          const char* end,
+                          const char* index)
+      : begin_{.data = begin}, end_{.data = end}, index_{.data = index} {}
+
+  constexpr TokenDatabase(const unsigned char* begin,
+                          const unsigned char* end,
+                          const unsigned char* index)
+      : begin_{.unsigned_data = begin},
+        end_{.unsigned_data = end},
+        index_{.unsigned_data = index} {}
+
+  constexpr TokenDatabase(const signed char* begin,
+                          const signed char* end,
+                          const signed char* index)
+      : begin_{.signed_data = begin},
+        end_{.signed_data = end},
+        index_{.signed_data = index} {}
+
+  // Returns an iterator to the entry at the specified position, using the
+  // string index to find its string. Requires a string index.
+  iterator IndexedEntry(size_type position) const;
 
   // Store the beginning and end pointers as a union to avoid breaking constexpr
-  // rules for reinterpret_cast.
+  // rules for reinterpret_cast. The string table starts at end_.
   union {
     const char* data;
     const unsigned char* unsigned_data;
     const signed char* signed_data;
-  } begin_, end_;
+  } begin_, end_, index_;
 };
 
 }  // namespace pw::tokenizer
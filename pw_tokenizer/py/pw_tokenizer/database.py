@@ -285,6 +285,7 @@ def _handle_create(
     include: list,
     exclude: list,
     replace: list,
+    string_index: bool,
 ) -> None:
     """Creates a token database file from one or more ELF files."""
     if not force and database.exists():
@@ -318,7 +319,7 @@ def _handle_create(
         if output_type == 'csv':
             tokens.write_csv(db, fd)
         elif output_type == 'binary':
-            tokens.write_binary(db, fd)
+            tokens.write_binary(db, fd, string_index=string_index)
         else:
             raise ValueError(f'Unknown database type "{output_type}"')
 
@@ -562,6 +563,14 @@ def _parse_args():
         action='store_true',
         help='Overwrite the database if it exists.',
     )
+    subparser.add_argument(
+        '--string-index',
+        action='store_true',
+        help=(
+            'For binary databases, append an index of string offsets so that '
+            'C++ token lookups can binary search the database.'
+        ),
+    )
     subparser.add_argument(
         '-i',
         '--include',
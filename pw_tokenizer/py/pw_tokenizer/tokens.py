@@ -396,8 +396,9 @@ class _BinaryFileFormat(NamedTuple):
     """Attributes of the binary token database file format."""
 
     magic: bytes = b'TOKENS\0\0'
-    header: struct.Struct = struct.Struct('<8sI4x')
+    header: struct.Struct = struct.Struct('<8sII')
     entry: struct.Struct = struct.Struct('<IBBH')
+    string_offset: struct.Struct = struct.Struct('<I')
 
 
 BINARY_FORMAT = _BinaryFileFormat()
@@ -443,7 +444,7 @@ def _check_that_file_is_csv_database(path: Path) -> None:
 
 def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
     """Parses TokenizedStringEntries from a binary token database file."""
-    magic, entry_count = BINARY_FORMAT.header.unpack(
+    magic, entry_count, _ = BINARY_FORMAT.header.unpack(
         fd.read(BINARY_FORMAT.header.size)
     )
 
@@ -483,13 +484,47 @@ def parse_binary(fd: BinaryIO) -> Iterable[TokenizedStringEntry]:
         yield TokenizedStringEntry(token, string, DEFAULT_DOMAIN, removed)
 
 
-def write_binary(database: Database, fd: BinaryIO) -> None:
-    """Writes the database as packed binary to the provided binary file."""
-    entries = sorted(database.entries())
+def binary_database_has_string_index(fd: BinaryIO) -> bool:
+    """True if the binary database has a string index after its strings."""
+    fd.seek(0)
+    _, _, string_index_offset = BINARY_FORMAT.header.unpack(
+        fd.read(BINARY_FORMAT.header.size)
+    )
+    fd.seek(0)
+    return string_index_offset != 0
 
-    fd.write(BINARY_FORMAT.header.pack(BINARY_FORMAT.magic, len(entries)))
+
+def write_binary(
+    database: Database, fd: BinaryIO, *, string_index: bool = False
+) -> None:
+    """Writes the database as packed binary to the provided binary file.
+
+    If string_index is True, an index of string offsets is appended after the
+    string table, which allows C++ lookups to binary search the database.
+    """
+    entries = sorted(database.entries())
 
     string_table = bytearray()
+    string_offsets = bytearray()
+
+    for entry in entries:
+        string_offsets += BINARY_FORMAT.string_offset.pack(len(string_table))
+        string_table += entry.string.encode()
+        string_table.append(0)
+
+    string_index_offset = 0
+    if string_index and entries:
+        string_index_offset = (
+            BINARY_FORMAT.header.size
+            + len(entries) * BINARY_FORMAT.entry.size
+            + len(string_table)
+        )
+
+    fd.write(
+        BINARY_FORMAT.header.pack(
+            BINARY_FORMAT.magic, len(entries), string_index_offset
+        )
+    )
 
     for entry in entries:
         if entry.date_removed:
@@ -504,9 +539,6 @@ def write_binary(database: Database, fd: BinaryIO) -> None:
             removed_month = 0xFF
             removed_year = 0xFFFF
 
-        string_table += entry.string.encode()
-        string_table.append(0)
-
         fd.write(
             BINARY_FORMAT.entry.pack(
                 entry.token, removed_day, removed_month, removed_year
@@ -515,6 +547,9 @@ def write_binary(database: Database, fd: BinaryIO) -> None:
 
     fd.write(string_table)
 
+    if string_index_offset:
+        fd.write(string_offsets)
+
 
 class DatabaseFile(Database):
     """A token database that is associated with a particular file.
@@ -561,13 +596,14 @@ class DatabaseFile(Database):
 
 class _BinaryDatabase(DatabaseFile):
     def __init__(self, path: Path, fd: BinaryIO) -> None:
+        self._string_index = binary_database_has_string_index(fd)
         super().__init__(path, parse_binary(fd))
 
     def write_to_file(self, *, rewrite: bool = False) -> None:
         """Exports in the binary format to the original path."""
         del rewrite  # Binary databases are always rewritten
         with self.path.open('wb') as fd:
-            write_binary(self, fd)
+            write_binary(self, fd, string_index=self._string_index)
 
     def add_and_discard_temporary(
         self, entries: Iterable[TokenizedStringEntry], commit: str
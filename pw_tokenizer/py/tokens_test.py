@@ -556,6 +556,53 @@ class TokenDatabaseTest(unittest.TestCase):
 
         self.assertEqual(str(db), CSV_DATABASE)
 
+    def test_binary_format_write_string_index(self) -> None:
+        db = read_db_from_csv(CSV_DATABASE)
+
+        with io.BytesIO() as fd:
+            tokens.write_binary(db, fd, string_index=True)
+            indexed_db = fd.getvalue()
+
+        # The string index is appended to the unindexed database.
+        index_offset = len(BINARY_DATABASE)
+        self.assertEqual(
+            indexed_db[: len(BINARY_DATABASE)],
+            BINARY_DATABASE[:12]
+            + index_offset.to_bytes(4, 'little')
+            + BINARY_DATABASE[16:],
+        )
+
+        string_table = BINARY_DATABASE[16 + 16 * 8 :]
+        index = indexed_db[index_offset:]
+        self.assertEqual(len(index), 16 * 4)
+
+        offsets = [
+            int.from_bytes(index[i : i + 4], 'little')
+            for i in range(0, len(index), 4)
+        ]
+        strings = [
+            string_table[offset : string_table.index(b'\0', offset)].decode()
+            for offset in offsets
+        ]
+        self.assertEqual(strings, [e.string for e in sorted(db.entries())])
+
+    def test_binary_format_parse_string_index(self) -> None:
+        db = read_db_from_csv(CSV_DATABASE)
+
+        with io.BytesIO() as fd:
+            tokens.write_binary(db, fd, string_index=True)
+            fd.seek(0)
+            self.assertTrue(tokens.binary_database_has_string_index(fd))
+            parsed = tokens.Database(tokens.parse_binary(fd))
+
+        self.assertEqual(str(parsed), CSV_DATABASE)
+
+    def test_binary_format_empty_database_has_no_string_index(self) -> None:
+        with io.BytesIO() as fd:
+            tokens.write_binary(tokens.Database(), fd, string_index=True)
+            self.assertEqual(len(fd.getvalue()), 16)
+            self.assertFalse(tokens.binary_database_has_string_index(fd))
+
 
 class TestDatabaseFile(unittest.TestCase):
     """Tests the DatabaseFile class."""
@@ -568,6 +615,20 @@ class TestDatabaseFile(unittest.TestCase):
     def tearDown(self) -> None:
         self._path.unlink()
 
+    def test_update_binary_file_keeps_string_index(self) -> None:
+        with self._path.open('wb') as fd:
+            tokens.write_binary(
+                read_db_from_csv(CSV_DATABASE), fd, string_index=True
+            )
+
+        db = tokens.DatabaseFile.load(self._path)
+        db.add([tokens.TokenizedStringEntry(0xFFFFFFFF, 'New entry!')])
+        db.write_to_file()
+
+        with self._path.open('rb') as fd:
+            self.assertTrue(tokens.binary_database_has_string_index(fd))
+            self.assertEqual(len(tokens.Database(tokens.parse_binary(fd))), 17)
+
     def test_update_csv_file(self) -> None:
         self._path.write_text(CSV_DATABASE)
         db = tokens.DatabaseFile.load(self._path)
@@ -25,6 +25,29 @@ TokenDatabase::Entry TokenDatabase::Entries::operator[](size_t index) const {
 }
 
 TokenDatabase::Entries TokenDatabase::Find(const uint32_t token) const {
+  if (has_string_index()) {
+    // Entries are sorted by token, so binary search for the first match.
+    size_type first = 0;
+    size_type count = size();
+    while (count > 0u) {
+      const size_type step = count / 2;
+      if (ReadUint32(begin_.data + (first + step) * sizeof(RawEntry)) < token) {
+        first += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+
+    size_type last = first;
+    while (last < size() &&
+           ReadUint32(begin_.data + last * sizeof(RawEntry)) == token) {
+      ++last;
+    }
+
+    return Entries(IndexedEntry(first), IndexedEntry(last));
+  }
+
   iterator first = begin();
   while (first != end() && token > first->token) {
     ++first;
@@ -38,4 +61,14 @@ TokenDatabase::Entries TokenDatabase::Find(const uint32_t token) const {
   return Entries(first, last);
 }
 
+TokenDatabase::iterator TokenDatabase::IndexedEntry(size_type position) const {
+  if (position == size()) {
+    return end();
+  }
+  const uint32_t string_offset =
+      ReadUint32(index_.data + position * sizeof(uint32_t));
+  return iterator(begin_.data + position * sizeof(RawEntry),
+                  end_.data + string_offset);
+}
+
 }  // namespace pw::tokenizer
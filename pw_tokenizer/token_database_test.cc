@@ -125,6 +125,43 @@ TEST(TokenDatabase, ValidCheck) {
                              "WXYZdate"
                              "WXYZdate"
                              "hi\0hello\0"sv));
+
+  // String indexes.
+  static_assert(
+      TokenDatabase::IsValid("TOKENS\0\0\x01\x00\x00\x00\x1B\0\0\0"
+                             "WXYZdate"
+                             "hi\0"
+                             "\0\0\0\0"sv));
+  // The string offset is past the end of the string table.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x01\x00\x00\x00\x1B\0\0\0"
+                              "WXYZdate"
+                              "hi\0"
+                              "\x03\0\0\0"sv));
+  // The index does not follow the string table.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x01\x00\x00\x00\x18\0\0\0"
+                              "WXYZdate"
+                              "hi\0"
+                              "\0\0\0\0"sv));
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x01\x00\x00\x00\x1C\0\0\0"
+                              "WXYZdate"
+                              "hi\0!"
+                              "\0\0\0\0"sv));
+  // The index is truncated.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x01\x00\x00\x00\x1B\0\0\0"
+                              "WXYZdate"
+                              "hi\0"
+                              "\0\0\0"sv));
+  // The index is past the end of the data. Its end would wrap around to 1 if
+  // computed in a 32-bit size_t.
+  static_assert(
+      !TokenDatabase::IsValid("TOKENS\0\0\x01\x00\x00\x00\xFD\xFF\xFF\xFF"
+                              "WXYZdate"
+                              "hi\0"
+                              "\0\0\0\0"sv));
 }
 
 TEST(TokenDatabase, Iterator) {
@@ -259,6 +296,76 @@ TEST(TokenDatabase, MultipleEntriesWithSameToken) {
   }
 }
 
+// The same entries as kCollisionsData, with different tokens, and a string
+// index after the string table.
+constexpr char kIndexedData[] =
+    "TOKENS\0\0\x05\0\0\0\x4F\0\0\0"
+    "\x01\0\0\0date"
+    "\x02\0\0\0date"
+    "\x02\0\0\0date"
+    "\x05\0\0\0date"
+    "\xFF\0\0\0date"
+    "hi!\0goodbye\0:)\0one\0two\0"
+    "\x00\0\0\0"
+    "\x04\0\0\0"
+    "\x0C\0\0\0"
+    "\x0F\0\0\0"
+    "\x13\0\0\0";
+
+constexpr TokenDatabase kIndexed = TokenDatabase::Create<kIndexedData>();
+static_assert(kIndexed.size() == 5u);
+static_assert(kIndexed.has_string_index());
+static_assert(!kBasicDatabase.has_string_index());
+
+TEST(TokenDatabase, Indexed_SingleEntryLookup) {
+  auto match = kIndexed.Find(1);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_EQ(match.begin()->token, 1u);
+  EXPECT_STREQ(match[0].string, "hi!");
+
+  match = kIndexed.Find(5);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_STREQ(match[0].string, "one");
+
+  match = kIndexed.Find(0xff);
+  ASSERT_EQ(match.size(), 1u);
+  EXPECT_STREQ(match[0].string, "two");
+  EXPECT_EQ(match.end(), kIndexed.end());
+}
+
+TEST(TokenDatabase, Indexed_MultipleEntriesWithSameToken) {
+  TokenDatabase::Entries match = kIndexed.Find(2);
+
+  EXPECT_EQ(match.begin()->token, 2u);
+  EXPECT_EQ(match.end()->token, 5u);
+  ASSERT_EQ(match.size(), 2u);
+
+  EXPECT_STREQ(match[0].string, "goodbye");
+  EXPECT_STREQ(match[1].string, ":)");
+
+  for (const auto& entry : match) {
+    EXPECT_EQ(entry.token, 2u);
+  }
+}
+
+TEST(TokenDatabase, Indexed_NonPresent) {
+  EXPECT_TRUE(kIndexed.Find(0).empty());
+  EXPECT_TRUE(kIndexed.Find(3).empty());
+  EXPECT_TRUE(kIndexed.Find(6).empty());
+  EXPECT_TRUE(kIndexed.Find(0x100).empty());
+  EXPECT_TRUE(kIndexed.Find(0xFFFFFFFFu).empty());
+}
+
+TEST(TokenDatabase, Indexed_MatchesIteration) {
+  for (const auto& entry : kIndexed) {
+    bool found = false;
+    for (const auto& match : kIndexed.Find(entry.token)) {
+      found = found || match.string == entry.string;
+    }
+    EXPECT_TRUE(found);
+  }
+}
+
 TEST(TokenDatabase, Empty) {
   constexpr TokenDatabase empty_db = TokenDatabase::Create<kEmptyData>();
   static_assert(empty_db.size() == 0u);
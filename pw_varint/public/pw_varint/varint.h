@@ -301,6 +301,48 @@ inline size_t Decode(const span<const std::byte>& input, uint64_t* value) {
   return pw_varint_Decode64(input.data(), input.size(), value);
 }
 
+/// @brief Decodes consecutive varints, such as the values of a packed repeated
+/// protobuf field. If reading into signed integers, the values are ZigZag
+/// decoded.
+///
+/// Decoding stops when `output` is full, `input` is exhausted, or a varint is
+/// invalid or incomplete. Compare the returned size with `input.size()` to
+/// check that all of the input was decoded.
+///
+/// This is faster than calling `Decode` in a loop, since the input size is
+/// only checked once per varint until the last few bytes of the input.
+///
+/// @param input The varints to decode.
+///
+/// @param output Where to store the decoded values.
+///
+/// @param decoded_count Set to the number of values decoded.
+///
+/// @returns The number of bytes of `input` that held the decoded values.
+size_t DecodeMany(span<const std::byte> input,
+                  span<uint64_t> output,
+                  size_t* decoded_count);
+
+/// @overload
+size_t DecodeMany(span<const std::byte> input,
+                  span<int64_t> output,
+                  size_t* decoded_count);
+
+/// @brief Encodes a sequence of integers as consecutive varints, such as the
+/// values of a packed repeated protobuf field. Signed integers are ZigZag
+/// encoded.
+///
+/// @param input The values to encode.
+///
+/// @param output The buffer to encode the values to.
+///
+/// @returns The number of bytes written, or 0 if the values did not all fit
+/// in `output`.
+size_t EncodeMany(span<const uint64_t> input, span<std::byte> output);
+
+/// @overload
+size_t EncodeMany(span<const int64_t> input, span<std::byte> output);
+
 /// Describes a custom varint format.
 enum class Format {
   kZeroTerminatedLeastSignificant = PW_VARINT_ZERO_TERMINATED_LEAST_SIGNIFICANT,
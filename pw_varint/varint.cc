@@ -16,6 +16,8 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <type_traits>
 
 namespace pw {
 namespace varint {
@@ -126,5 +128,111 @@ extern "C" size_t pw_varint_EncodedSizeBytes(uint64_t integer) {
   return EncodedSize(integer);
 }
 
+namespace {
+
+// Decodes a varint from input, which must have room for the largest varint, so
+// the input size is not checked for each byte. The loop over the bytes is
+// unrolled so that each byte's shift is a constant.
+template <size_t kIndex = 0>
+inline size_t DecodeUnchecked(const std::byte* input, uint64_t* value) {
+  if constexpr (kIndex == kMaxVarint64SizeBytes) {
+    return 0;  // The varint is too long.
+  } else {
+    if (!pw_varint_DecodeOneByte64(
+            static_cast<uint8_t>(input[kIndex]), kIndex, value)) {
+      return kIndex + 1;
+    }
+    return DecodeUnchecked<kIndex + 1>(input, value);
+  }
+}
+
+// Encodes a varint to output, which must have room for the largest varint.
+inline size_t EncodeUnchecked(uint64_t integer, std::byte* output) {
+  size_t written = 0;
+  while (integer >= 0x80u) {
+    output[written++] =
+        static_cast<std::byte>(pw_varint_EncodeOneByte64(&integer));
+  }
+  output[written++] = static_cast<std::byte>(integer);
+  return written;
+}
+
+template <typename T>
+size_t DecodeManyImpl(span<const std::byte> input,
+                      span<T> output,
+                      size_t* decoded_count) {
+  size_t read = 0;
+  size_t count = 0;
+
+  while (count < output.size() && read < input.size()) {
+    // Varints are decoded inline while there is room for the largest one, and
+    // with the bounds-checked decoder at the end of the input.
+    uint64_t value = 0;
+    const size_t size =
+        input.size() - read >= kMaxVarint64SizeBytes
+            ? DecodeUnchecked(input.data() + read, &value)
+            : pw_varint_Decode64(
+                  input.data() + read, input.size() - read, &value);
+    if (size == 0u) {
+      break;
+    }
+    if constexpr (std::is_signed_v<T>) {
+      output[count++] = ZigZagDecode(value);
+    } else {
+      output[count++] = value;
+    }
+    read += size;
+  }
+
+  *decoded_count = count;
+  return read;
+}
+
+template <typename T>
+size_t EncodeManyImpl(span<const T> input, span<std::byte> output) {
+  size_t written = 0;
+
+  for (T value : input) {
+    uint64_t integer;
+    if constexpr (std::is_signed_v<T>) {
+      integer = ZigZagEncode(value);
+    } else {
+      integer = value;
+    }
+    const size_t size =
+        output.size() - written >= kMaxVarint64SizeBytes
+            ? EncodeUnchecked(integer, output.data() + written)
+            : pw_varint_Encode64(
+                  integer, output.data() + written, output.size() - written);
+    if (size == 0u) {
+      return 0;
+    }
+    written += size;
+  }
+  return written;
+}
+
+}  // namespace
+
+size_t DecodeMany(span<const std::byte> input,
+                  span<uint64_t> output,
+                  size_t* decoded_count) {
+  return DecodeManyImpl(input, output, decoded_count);
+}
+
+size_t DecodeMany(span<const std::byte> input,
+                  span<int64_t> output,
+                  size_t* decoded_count) {
+  return DecodeManyImpl(input, output, decoded_count);
+}
+
+size_t EncodeMany(span<const uint64_t> input, span<std::byte> output) {
+  return EncodeManyImpl(input, output);
+}
+
+size_t EncodeMany(span<const int64_t> input, span<std::byte> output) {
+  return EncodeManyImpl(input, output);
+}
+
 }  // namespace varint
 }  // namespace pw
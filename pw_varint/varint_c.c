@@ -14,18 +14,28 @@
 
 #include "pw_varint/varint.h"
 
-#define VARINT_ENCODE_FUNCTION_BODY(bits)                        \
-  size_t written = 0;                                            \
-  uint8_t* buffer = (uint8_t*)output;                            \
-                                                                 \
-  do {                                                           \
-    if (written >= output_size_bytes) {                          \
-      return 0u;                                                 \
-    }                                                            \
-    buffer[written++] = pw_varint_EncodeOneByte##bits(&integer); \
-  } while (integer != 0u);                                       \
-                                                                 \
-  buffer[written - 1] &= 0x7f;                                   \
+// If the output has room for the largest varint, the bytes are written without
+// checking the output size for each one.
+#define VARINT_ENCODE_FUNCTION_BODY(bits)                          \
+  size_t written = 0;                                              \
+  uint8_t* buffer = (uint8_t*)output;                              \
+                                                                   \
+  if (output_size_bytes >= PW_VARINT_MAX_INT##bits##_SIZE_BYTES) { \
+    while (integer >= 0x80u) {                                     \
+      buffer[written++] = pw_varint_EncodeOneByte##bits(&integer); \
+    }                                                              \
+    buffer[written++] = (uint8_t)integer;                          \
+    return written;                                                \
+  }                                                                \
+                                                                   \
+  do {                                                             \
+    if (written >= output_size_bytes) {                            \
+      return 0u;                                                   \
+    }                                                              \
+    buffer[written++] = pw_varint_EncodeOneByte##bits(&integer);   \
+  } while (integer != 0u);                                         \
+                                                                   \
+  buffer[written - 1] &= 0x7f;                                     \
   return written
 
 size_t pw_varint_Encode32(uint32_t integer,
@@ -64,14 +74,48 @@ size_t pw_varint_Encode64(uint64_t integer,
   *output = value;                                                            \
   return count
 
+// Decodes byte n of a varint if the input has room for the largest varint, so
+// the input size need not be checked for each byte. This is unrolled rather
+// than looped so that each byte's shift is a constant.
+#define VARINT_DECODE_BYTE_UNCHECKED(bits, n)                 \
+  if (!pw_varint_DecodeOneByte##bits(buffer[n], n, &value)) { \
+    *output = value;                                          \
+    return n + 1;                                             \
+  }
+
 size_t pw_varint_Decode32(const void* input,
                           size_t input_size_bytes,
                           uint32_t* output) {
+  if (input_size_bytes >= PW_VARINT_MAX_INT32_SIZE_BYTES) {
+    const uint8_t* buffer = (const uint8_t*)input;
+    uint32_t value = 0;
+    VARINT_DECODE_BYTE_UNCHECKED(32, 0);
+    VARINT_DECODE_BYTE_UNCHECKED(32, 1);
+    VARINT_DECODE_BYTE_UNCHECKED(32, 2);
+    VARINT_DECODE_BYTE_UNCHECKED(32, 3);
+    VARINT_DECODE_BYTE_UNCHECKED(32, 4);
+    return 0;  // The varint is too long.
+  }
   VARINT_DECODE_FUNCTION_BODY(32);
 }
 
 size_t pw_varint_Decode64(const void* input,
                           size_t input_size_bytes,
                           uint64_t* output) {
+  if (input_size_bytes >= PW_VARINT_MAX_INT64_SIZE_BYTES) {
+    const uint8_t* buffer = (const uint8_t*)input;
+    uint64_t value = 0;
+    VARINT_DECODE_BYTE_UNCHECKED(64, 0);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 1);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 2);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 3);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 4);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 5);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 6);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 7);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 8);
+    VARINT_DECODE_BYTE_UNCHECKED(64, 9);
+    return 0;  // The varint is too long.
+  }
   VARINT_DECODE_FUNCTION_BODY(64);
 }
@@ -0,0 +1,128 @@
+// Copyright 2024 The Pigweed Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License"); you may not
+// use this file except in compliance with the License. You may obtain a copy of
+// the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "pw_assert/check.h"
+#include "pw_log/log.h"
+#include "pw_perf_test/perf_test.h"
+#include "pw_span/span.h"
+#include "pw_varint/varint.h"
+
+namespace pw::varint {
+namespace {
+
+constexpr size_t kValueCount = 256;
+
+std::array<uint64_t, kValueCount> values;
+std::array<uint64_t, kValueCount> decoded;
+std::array<std::byte, kValueCount * kMaxVarint64SizeBytes> encoded;
+
+// Fills the values with a repeating mix of varint sizes and encodes them.
+// Returns the encoded values.
+span<const std::byte> Fill(span<const size_t> sizes) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    const size_t size = sizes[i % sizes.size()];
+    // The largest value that fits in `size` bytes, with some bits cleared.
+    const uint64_t max =
+        size >= 10u ? ~uint64_t{0} : (uint64_t{1} << (7 * size)) - 1;
+    values[i] = max - (i & 0x3f);
+  }
+
+  const size_t size = EncodeMany(span(values), encoded);
+  PW_CHECK_UINT_NE(size, 0);
+
+  // Divide the size by the reported time to get throughput. The size in bytes
+  // divided by the time in microseconds is MB/s.
+  PW_LOG_INFO("Coding %u values in %u bytes per iteration",
+              static_cast<unsigned>(values.size()),
+              static_cast<unsigned>(size));
+  return span(encoded).first(size);
+}
+
+// Measures how long it takes to decode the values one at a time with Decode.
+void DecodeOneAtATime(perf_test::State& state, span<const size_t> sizes) {
+  const span<const std::byte> data = Fill(sizes);
+
+  while (state.KeepRunning()) {
+    span<const std::byte> remaining = data;
+    for (uint64_t& value : decoded) {
+      remaining = remaining.subspan(Decode(remaining, &value));
+    }
+  }
+  PW_CHECK(decoded == values);
+}
+
+// Measures how long it takes to decode the values with DecodeMany.
+void DecodeBatch(perf_test::State& state, span<const size_t> sizes) {
+  const span<const std::byte> data = Fill(sizes);
+
+  size_t count = 0;
+  while (state.KeepRunning()) {
+    DecodeMany(data, decoded, &count);
+  }
+  PW_CHECK(decoded == values);
+}
+
+// Measures how long it takes to encode the values one at a time with Encode.
+void EncodeOneAtATime(perf_test::State& state, span<const size_t> sizes) {
+  Fill(sizes);
+
+  while (state.KeepRunning()) {
+    span<std::byte> remaining = encoded;
+    for (uint64_t value : values) {
+      remaining = remaining.subspan(Encode(value, remaining));
+    }
+  }
+}
+
+// Measures how long it takes to encode the values with EncodeMany.
+void EncodeBatch(perf_test::State& state, span<const size_t> sizes) {
+  Fill(sizes);
+
+  while (state.KeepRunning()) {
+    EncodeMany(span(values), encoded);
+  }
+}
+
+// Workloads of varints with the given sizes in bytes, repeated.
+constexpr std::array<size_t, 1> kOneByte = {1};
+constexpr std::array<size_t, 1> kTwoBytes = {2};
+constexpr std::array<size_t, 1> kTenBytes = {10};
+constexpr std::array<size_t, 8> kMixed = {1, 1, 2, 1, 3, 5, 1, 10};
+
+PW_PERF_TEST(DecodeOneAtATime1Byte, DecodeOneAtATime, kOneByte);
+PW_PERF_TEST(DecodeOneAtATime2Bytes, DecodeOneAtATime, kTwoBytes);
+PW_PERF_TEST(DecodeOneAtATime10Bytes, DecodeOneAtATime, kTenBytes);
+PW_PERF_TEST(DecodeOneAtATimeMixed, DecodeOneAtATime, kMixed);
+
+PW_PERF_TEST(DecodeBatch1Byte, DecodeBatch, kOneByte);
+PW_PERF_TEST(DecodeBatch2Bytes, DecodeBatch, kTwoBytes);
+PW_PERF_TEST(DecodeBatch10Bytes, DecodeBatch, kTenBytes);
+PW_PERF_TEST(DecodeBatchMixed, DecodeBatch, kMixed);
+
+PW_PERF_TEST(EncodeOneAtATime1Byte, EncodeOneAtATime, kOneByte);
+PW_PERF_TEST(EncodeOneAtATime2Bytes, EncodeOneAtATime, kTwoBytes);
+PW_PERF_TEST(EncodeOneAtATime10Bytes, EncodeOneAtATime, kTenBytes);
+PW_PERF_TEST(EncodeOneAtATimeMixed, EncodeOneAtATime, kMixed);
+
+PW_PERF_TEST(EncodeBatch1Byte, EncodeBatch, kOneByte);
+PW_PERF_TEST(EncodeBatch2Bytes, EncodeBatch, kTwoBytes);
+PW_PERF_TEST(EncodeBatch10Bytes, EncodeBatch, kTenBytes);
+PW_PERF_TEST(EncodeBatchMixed, EncodeBatch, kMixed);
+
+}  // namespace
+}  // namespace pw::varint
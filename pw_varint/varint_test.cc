@@ -14,11 +14,14 @@
 
 #include "pw_varint/varint.h"
 
+#include <array>
 #include <cinttypes>
 #include <cstdint>
 #include <cstring>
 #include <limits>
 
+#include "pw_bytes/array.h"
+#include "pw_containers/vector.h"
 #include "pw_fuzzer/fuzztest.h"
 #include "pw_unit_test/framework.h"
 
@@ -1158,5 +1161,196 @@ TEST(Varint, MaxValueInBytes) {
   static_assert(MaxValueInBytes(100) == std::numeric_limits<uint64_t>::max());
 }
 
+// Values at each varint size boundary, which exercise every byte position of
+// the word-at-a-time encoder and decoder.
+constexpr std::array<uint64_t, 20> kBoundaryValues = {
+    0u,
+    1u,
+    MaxValueInBytes(1),
+    MaxValueInBytes(1) + 1,
+    MaxValueInBytes(2),
+    MaxValueInBytes(2) + 1,
+    MaxValueInBytes(3),
+    MaxValueInBytes(3) + 1,
+    MaxValueInBytes(4),
+    MaxValueInBytes(4) + 1,
+    MaxValueInBytes(5),
+    MaxValueInBytes(5) + 1,
+    MaxValueInBytes(6),
+    MaxValueInBytes(6) + 1,
+    MaxValueInBytes(7),
+    MaxValueInBytes(7) + 1,
+    MaxValueInBytes(8),
+    MaxValueInBytes(8) + 1,
+    MaxValueInBytes(9) + 1,
+    std::numeric_limits<uint64_t>::max(),
+};
+
+// Decoding with the byte-at-a-time custom format decoder, which is never
+// accelerated, gives the expected result for plain LEB128.
+size_t ReferenceDecode(span<const std::byte> input, uint64_t* value) {
+  return Decode(input, value, Format::kZeroTerminatedMostSignificant);
+}
+
+TEST(Varint, EncodeDecode_AllSizes_WithAndWithoutTrailingBytes) {
+  for (uint64_t value : kBoundaryValues) {
+    // Fill the trailing bytes with continuation bits to make sure they are
+    // ignored.
+    std::array<std::byte, 2 * kMaxVarint64SizeBytes> buffer;
+    buffer.fill(std::byte{0xff});
+
+    const size_t size = EncodedSize(value);
+    ASSERT_EQ(size, Encode(value, buffer));
+    ASSERT_EQ(size, Encode(value, span(buffer).first(size)));
+    ASSERT_EQ(0u, Encode(value, span(buffer).first(size - 1)));
+
+    uint64_t expected = 0;
+    ASSERT_EQ(size, ReferenceDecode(buffer, &expected));
+    EXPECT_EQ(value, expected);
+
+    uint64_t padded = 0;
+    EXPECT_EQ(size, Decode(buffer, &padded));
+    EXPECT_EQ(value, padded);
+
+    uint64_t exact = 0;
+    EXPECT_EQ(size, Decode(span(buffer).first(size), &exact));
+    EXPECT_EQ(value, exact);
+
+    uint64_t truncated = 0;
+    EXPECT_EQ(0u, Decode(span(buffer).first(size - 1), &truncated));
+  }
+}
+
+TEST(Varint, Decode32_TooLong_WithAndWithoutTrailingBytes) {
+  // A 6-byte varint is too long for a uint32_t.
+  constexpr auto kSixBytes =
+      bytes::Array<0x80, 0x80, 0x80, 0x80, 0x80, 0x01, 0x00, 0x00>();
+  uint32_t value = 0;
+  EXPECT_EQ(0u, pw_varint_Decode32(kSixBytes.data(), kSixBytes.size(), &value));
+  EXPECT_EQ(0u, pw_varint_Decode32(kSixBytes.data(), 6, &value));
+
+  constexpr auto kFiveBytes =
+      bytes::Array<0xff, 0xff, 0xff, 0xff, 0x0f, 0xff, 0xff, 0xff>();
+  EXPECT_EQ(5u,
+            pw_varint_Decode32(kFiveBytes.data(), kFiveBytes.size(), &value));
+  EXPECT_EQ(std::numeric_limits<uint32_t>::max(), value);
+}
+
+void DecodeMatchesReference(const Vector<uint8_t>& data) {
+  const auto input = as_bytes(span(data.data(), data.size()));
+  uint64_t expected = 0;
+  const size_t expected_size = ReferenceDecode(input, &expected);
+
+  uint64_t actual = 0;
+  EXPECT_EQ(expected_size, Decode(input, &actual));
+  if (expected_size != 0u) {
+    EXPECT_EQ(expected, actual);
+  }
+}
+
+TEST(Varint, DecodeMatchesReference_Boundaries) {
+  for (uint64_t value : kBoundaryValues) {
+    Vector<uint8_t, kMaxVarint64SizeBytes + 2> data(data.max_size(), 0x80);
+    const size_t size =
+        Encode(value, as_writable_bytes(span(data.data(), data.size())));
+    for (size_t i = size; i <= data.max_size(); ++i) {
+      data.resize(i, 0x80);
+      DecodeMatchesReference(data);
+    }
+  }
+}
+
+FUZZ_TEST(Varint, DecodeMatchesReference)
+    .WithDomains(fuzzer::VectorOf<16>(fuzzer::Arbitrary<uint8_t>()));
+
+TEST(Varint, EncodeManyDecodeMany_Unsigned) {
+  std::array<std::byte, kBoundaryValues.size() * kMaxVarint64SizeBytes>
+      buffer;
+  const size_t encoded_size = EncodeMany(span(kBoundaryValues), buffer);
+
+  size_t expected_size = 0;
+  for (uint64_t value : kBoundaryValues) {
+    expected_size += EncodedSize(value);
+  }
+  ASSERT_EQ(expected_size, encoded_size);
+
+  std::array<uint64_t, kBoundaryValues.size()> decoded{};
+  size_t count = 0;
+  EXPECT_EQ(encoded_size,
+            DecodeMany(span(buffer).first(encoded_size), decoded, &count));
+  ASSERT_EQ(kBoundaryValues.size(), count);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(kBoundaryValues[i], decoded[i]);
+  }
+}
+
+TEST(Varint, EncodeManyDecodeMany_Signed) {
+  constexpr std::array<int64_t, 7> kValues = {
+      0,
+      -1,
+      1,
+      -64,
+      1'000'000,
+      std::numeric_limits<int64_t>::min(),
+      std::numeric_limits<int64_t>::max(),
+  };
+  std::array<std::byte, kValues.size() * kMaxVarint64SizeBytes> buffer;
+  const size_t encoded_size = EncodeMany(span(kValues), buffer);
+  ASSERT_NE(0u, encoded_size);
+
+  std::array<int64_t, kValues.size()> decoded{};
+  size_t count = 0;
+  EXPECT_EQ(encoded_size,
+            DecodeMany(span(buffer).first(encoded_size), decoded, &count));
+  ASSERT_EQ(kValues.size(), count);
+  for (size_t i = 0; i < count; ++i) {
+    EXPECT_EQ(kValues[i], decoded[i]);
+  }
+}
+
+TEST(Varint, EncodeMany_DoesNotFit) {
+  constexpr std::array<uint64_t, 3> kValues = {1, 300, 70000};
+  std::array<std::byte, 5> buffer;
+  EXPECT_EQ(0u, EncodeMany(span(kValues), buffer));
+  EXPECT_EQ(0u, EncodeMany(span(kValues), span<std::byte>()));
+}
+
+TEST(Varint, DecodeMany_StopsWhenOutputIsFull) {
+  constexpr auto kInput = bytes::Array<0x01, 0xac, 0x02, 0x03, 0x04>();
+  std::array<uint64_t, 2> decoded{};
+  size_t count = 0;
+  EXPECT_EQ(3u, DecodeMany(kInput, decoded, &count));
+  EXPECT_EQ(2u, count);
+  EXPECT_EQ(1u, decoded[0]);
+  EXPECT_EQ(300u, decoded[1]);
+}
+
+TEST(Varint, DecodeMany_StopsAtIncompleteVarint) {
+  constexpr auto kInput = bytes::Array<0x01, 0xac, 0x02, 0x80, 0x80>();
+  std::array<uint64_t, 4> decoded{};
+  size_t count = 0;
+  EXPECT_EQ(3u, DecodeMany(kInput, decoded, &count));
+  EXPECT_EQ(2u, count);
+}
+
+TEST(Varint, DecodeMany_StopsAtTooLongVarint) {
+  constexpr auto kInput = bytes::Array<0x01,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x80,
+                                       0x01>();
+  std::array<uint64_t, 4> decoded{};
+  size_t count = 0;
+  EXPECT_EQ(1u, DecodeMany(kInput, decoded, &count));
+  EXPECT_EQ(1u, count);
+}
+
 }  // namespace
 }  // namespace pw::varint